@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+namespace mccmod {
+
+enum class CircuitState {
+  kClosed,
+  kOpen,
+  kHalfOpen,
+};
+
+const char* CircuitStateName(CircuitState state);
+
+struct CircuitBreakerOptions {
+  // Consecutive failures that open a closed circuit.
+  int failure_threshold = 3;
+  // Wait before the first half-open probe; doubles after every failed probe.
+  uint64_t base_backoff_ms = 2000;
+  uint64_t max_backoff_ms = 60000;
+};
+
+// Guards calls to the telemetry receiver. Closed passes everything through;
+// after `failure_threshold` failures in a row the circuit opens and rejects
+// calls without touching the network until the backoff expires. The next
+// call is then let through as a single half-open probe: success closes the
+// circuit, failure reopens it with twice the backoff.
+// Times are steady-clock ms from the caller's Clock. Not thread-safe.
+class CircuitBreaker {
+ public:
+  explicit CircuitBreaker(const CircuitBreakerOptions& options = CircuitBreakerOptions{})
+      : options_(options) {}
+
+  // True if the caller may attempt a call now. In the open state this moves
+  // to half-open once the backoff has expired and admits exactly one probe.
+  bool Allow(uint64_t now_ms);
+  void RecordSuccess();
+  void RecordFailure(uint64_t now_ms);
+
+  CircuitState State() const { return state_; }
+  // When the open circuit admits its next probe.
+  uint64_t RetryAtMs() const { return retry_at_ms_; }
+  uint64_t Opens() const { return opens_; }
+  uint64_t Rejected() const { return rejected_; }
+
+ private:
+  void Open(uint64_t now_ms);
+
+  const CircuitBreakerOptions options_;
+  CircuitState state_ = CircuitState::kClosed;
+  int consecutive_failures_ = 0;
+  uint64_t backoff_ms_ = 0;
+  uint64_t retry_at_ms_ = 0;
+  bool probe_in_flight_ = false;
+  uint64_t opens_ = 0;
+  uint64_t rejected_ = 0;
+};
+
+}  // namespace mccmod
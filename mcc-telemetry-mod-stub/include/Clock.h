@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace mccmod {
+
+// Time source for the telemetry loops. Production code runs on SystemClock();
+// simulations swap in a VirtualClock so hours of lobby churn, heartbeats and
+// backoff play out as fast as the CPU allows.
+class Clock {
+ public:
+  virtual ~Clock() = default;
+
+  // Monotonic milliseconds from an arbitrary origin.
+  virtual uint64_t SteadyMs() = 0;
+  // Milliseconds since the Unix epoch.
+  virtual int64_t WallMs() = 0;
+  // Finer versions of the above for latency stamps. Clocks that only keep
+  // milliseconds, like VirtualClock, scale those.
+  virtual uint64_t SteadyUs() { return SteadyMs() * 1000; }
+  virtual int64_t WallUs() { return WallMs() * 1000; }
+  virtual void SleepUntil(uint64_t deadline_ms) = 0;
+  virtual bool IsVirtual() const { return false; }
+  // Registers a thread that sleeps on this clock; see VirtualClock. Call it
+  // before starting the thread and RemoveParticipant() as its loop exits.
+  // Real clocks ignore both.
+  virtual void AddParticipant() {}
+  virtual void RemoveParticipant() {}
+
+  void SleepFor(uint64_t duration_ms) { SleepUntil(SteadyMs() + duration_ms); }
+};
+
+Clock& SystemClock();
+
+// Clock used by code that is not handed one explicitly: GetIsoUtcNow(), the
+// sender's latency stamps and the overlay reader. Defaults to SystemClock().
+Clock& DefaultClock();
+// nullptr restores SystemClock(). Install before starting any thread that reads it.
+void SetDefaultClock(Clock* clock);
+
+// Discrete-event clock. Time stands still while any participant thread is
+// running and jumps to the earliest pending deadline once every participant
+// is asleep, so a loop that only sleeps runs its simulated schedule back to
+// back. Once any thread has registered, every thread that sleeps on the clock
+// must be a participant: an unregistered sleeper is counted against the
+// running ones and lets time jump under them. With none registered, a lone
+// sleeper advances time itself. Advance() moves time by hand, e.g. from a
+// test driver that registers itself so time only moves when it says.
+class VirtualClock : public Clock {
+ public:
+  // 2024-01-01T00:00:00Z; simulated timestamps stay recognisable.
+  static constexpr int64_t kDefaultEpochMs = 1704067200000;
+
+  explicit VirtualClock(int64_t start_wall_ms = kDefaultEpochMs) : wall_origin_ms_(start_wall_ms) {}
+
+  uint64_t SteadyMs() override;
+  int64_t WallMs() override;
+  void SleepUntil(uint64_t deadline_ms) override;
+  bool IsVirtual() const override { return true; }
+
+  void AddParticipant() override;
+  void RemoveParticipant() override;
+
+  void Advance(uint64_t duration_ms);
+  // Completed sleeps; a cheap measure of how much schedule was simulated.
+  uint64_t Wakeups();
+
+ private:
+  void AdvanceIfIdleLocked();
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  const int64_t wall_origin_ms_;
+  uint64_t now_ms_ = 0;
+  int participants_ = 0;
+  uint64_t wakeups_ = 0;
+  // Pending deadline -> number of threads sleeping on it.
+  std::map<uint64_t, int> sleepers_;
+  int sleeping_ = 0;
+};
+
+}  // namespace mccmod
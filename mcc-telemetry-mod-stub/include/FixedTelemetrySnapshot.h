@@ -0,0 +1,97 @@
+#pragma once
+
+#include "TelemetryContract.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace mccmod {
+
+// Up to N bytes stored inline; not NUL-terminated.
+template <size_t N>
+struct FixedString {
+  static_assert(N <= UINT16_MAX, "FixedString sizes are 16-bit.");
+  static constexpr size_t kCapacity = N;
+
+  uint16_t size = 0;
+  char data[N] = {};
+
+  std::string_view View() const { return std::string_view(data, size); }
+
+  // Copies up to N bytes, cutting at a UTF-8 character boundary. False if cut.
+  bool Assign(std::string_view value) {
+    size_t length = value.size();
+    if (length > N) {
+      length = N;
+      while (length > 0 && (static_cast<unsigned char>(value[length]) & 0xC0) == 0x80) --length;
+    }
+    for (size_t i = 0; i < length; ++i) data[i] = value[i];
+    size = static_cast<uint16_t>(length);
+    return length == value.size();
+  }
+};
+
+// Up to MaxItems strings packed into an inline blob, each as a one-byte
+// length followed by its bytes.
+template <size_t MaxItems, size_t Bytes>
+struct FixedStringList {
+  static_assert(Bytes <= UINT16_MAX && MaxItems <= UINT8_MAX, "FixedStringList sizes are 8/16-bit.");
+
+  uint8_t count = 0;
+  uint16_t used = 0;
+  char blob[Bytes] = {};
+
+  // False, leaving the list unchanged, if the item is over 255 bytes or does not fit.
+  bool Append(std::string_view item) {
+    if (count >= MaxItems || item.size() > UINT8_MAX || Bytes - used < item.size() + 1) return false;
+    blob[used++] = static_cast<char>(item.size());
+    for (char c : item) blob[used++] = c;
+    ++count;
+    return true;
+  }
+
+  template <typename Fn>
+  void ForEach(Fn&& fn) const {
+    size_t at = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+      const size_t length = static_cast<unsigned char>(blob[at]);
+      fn(std::string_view(blob + at + 1, length));
+      at += length + 1;
+    }
+  }
+};
+
+#define MCC_SCHEMA_FIXED_Bool(max) bool
+#define MCC_SCHEMA_FIXED_Int(max) int32_t
+#define MCC_SCHEMA_FIXED_String(max) FixedString<max>
+// Room for every item's length byte on top of the schema's total byte bound.
+#define MCC_SCHEMA_FIXED_StringList(max) FixedStringList<max, kTelemetryListMaxBytes + max>
+
+// TelemetrySnapshot without heap storage, laid out from the same schema.
+// Strings and lists sit inline at their schema bounds, so the struct can be
+// memcpy'd into shared memory, ring buffers and trace files. Anything that
+// passed ValidateSnapshot converts both ways losslessly. A field that did
+// not fit is cut short and flagged in `truncated`.
+struct FixedTelemetrySnapshot {
+#define MCC_SCHEMA_FIXED_MEMBER(type, member, key, min, max, flags) MCC_SCHEMA_FIXED_##type(max) member{};
+  MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_FIXED_MEMBER)
+#undef MCC_SCHEMA_FIXED_MEMBER
+
+  // Bit (1 << kTelemetryField_x) is set when field x was truncated.
+  uint32_t truncated = 0;
+
+  bool IsTruncated(TelemetryFieldIndex field) const { return (truncated & (1u << field)) != 0; }
+};
+
+static_assert(std::is_trivially_copyable<FixedTelemetrySnapshot>::value,
+              "FixedTelemetrySnapshot must stay memcpy-able.");
+static_assert(std::is_standard_layout<FixedTelemetrySnapshot>::value,
+              "FixedTelemetrySnapshot is shared across module boundaries.");
+
+// Returns false if any field was truncated; see `out->truncated`.
+bool ToFixedSnapshot(const TelemetrySnapshot& snapshot, FixedTelemetrySnapshot* out);
+void FromFixedSnapshot(const FixedTelemetrySnapshot& fixed, TelemetrySnapshot* out);
+
+}  // namespace mccmod
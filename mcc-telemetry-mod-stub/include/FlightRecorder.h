@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mccmod {
+
+constexpr uint32_t kFlightRecorderMagic = 0x52464D48;  // "HMFR"
+constexpr uint32_t kFlightRecorderVersion = 2;
+constexpr size_t kFlightNameBytes = 64;
+constexpr size_t kFlightPlayerSources = 4;
+constexpr size_t kFlightModeSources = 2;
+
+enum FlightRecordFlags : uint8_t {
+  kFlightConnected = 1 << 0,
+  kFlightInMenus = 1 << 1,
+  kFlightMapUpdated = 1 << 2,
+  kFlightModeUpdated = 1 << 3,
+  kFlightPlayersUpdated = 1 << 4,
+};
+
+// One reader tick as stored in the ring file. Plain data only: records are
+// copied straight into the mapping and decoded by the dump tool.
+struct FlightRecord {
+  uint64_t seq = 0;
+  uint64_t steady_ms = 0;
+  int64_t wall_ms = 0;
+  uint32_t pid = 0;
+  uint8_t flags = 0;
+  uint8_t player_candidate_count = 0;
+  uint8_t map_candidate_count = 0;
+  uint8_t mode_candidate_count = 0;
+  int32_t player_candidates[kFlightPlayerSources] = {};
+  int32_t player_count = 0;
+  float map_confidence = 0.0f;
+  float mode_confidence = 0.0f;
+  float player_confidence = 0.0f;
+  uint32_t read_us = 0;
+  uint32_t filter_us = 0;
+  uint32_t tick_us = 0;
+  char map_candidate[kFlightNameBytes] = {};
+  char mode_candidates[kFlightModeSources][kFlightNameBytes] = {};
+  char map_name[kFlightNameBytes] = {};
+  char mode_name[kFlightNameBytes] = {};
+  // Bit i set when source i (players.mcc, then players.reach.0-2) gave one of
+  // player_candidates, in order. Zero in version 1 files: sources unknown.
+  uint8_t player_source_mask = 0;
+  uint8_t reserved[3] = {};
+  // Written last; a record whose commit_seq does not match seq was torn by a crash.
+  uint64_t commit_seq = 0;
+};
+
+// Ring file layout: this header, then `capacity` FlightRecords.
+struct FlightFileHeader {
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t record_size = 0;
+  uint32_t capacity = 0;
+  uint64_t next_seq = 0;
+  uint8_t reserved[40] = {};
+};
+
+// Always-on ring of recent reader ticks in a memory-mapped file. The mapping
+// is shared with the OS page cache, so the last records survive a crash of
+// the reader. Single writer.
+class FlightRecorder {
+ public:
+  FlightRecorder() = default;
+  ~FlightRecorder();
+
+  FlightRecorder(const FlightRecorder&) = delete;
+  FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+  bool Open(const std::string& path, uint32_t capacity);
+  void Close();
+  bool IsOpen() const { return records_ != nullptr; }
+  void Append(FlightRecord record);
+
+ private:
+  FlightFileHeader* header_ = nullptr;
+  FlightRecord* records_ = nullptr;
+  size_t mapped_bytes_ = 0;
+  intptr_t file_ = -1;
+  intptr_t mapping_ = 0;
+};
+
+void CopyFlightString(char (&dest)[kFlightNameBytes], const std::string& value);
+// Returns committed records from a ring file, oldest first.
+bool ReadFlightRecords(const std::string& path, std::vector<FlightRecord>* out,
+                       std::string* error);
+std::string FlightRecordToJson(const FlightRecord& record);
+
+}  // namespace mccmod
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace mccmod {
+
+// XXH64 (xxHash, 64-bit). Fast, non-cryptographic, and stable across
+// platforms and releases, so hashes can be cached on disk and compared
+// between machines.
+uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0);
+
+inline uint64_t Hash64(std::string_view text, uint64_t seed = 0) {
+  return Hash64(text.data(), text.size(), seed);
+}
+
+}  // namespace mccmod
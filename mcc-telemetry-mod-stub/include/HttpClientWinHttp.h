@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace mccmod {
@@ -8,8 +9,38 @@ struct HttpResponse {
   bool ok = false;
   unsigned long status_code = 0;
   std::string error;
+  // Empty from the POSIX HttpPostJson(), which only reads the status line.
+  std::string body;
 };
 
+// WinHTTP on Windows; HttpClientPosix.cpp provides a plain-socket http://
+// version for the Linux reader build.
 HttpResponse HttpPostJson(const std::string& url, const std::string& json_body);
 
+// Keep-alive connection to one endpoint for callers that post at a high
+// rate. The socket (or WinHTTP connection) is reused across posts and
+// reopened once if the server dropped it. Not thread-safe; use one per thread.
+class HttpConnection {
+ public:
+  explicit HttpConnection(const std::string& url);
+  ~HttpConnection();
+
+  HttpConnection(const HttpConnection&) = delete;
+  HttpConnection& operator=(const HttpConnection&) = delete;
+
+  HttpResponse PostJson(const std::string& json_body);
+  // Times a new connection had to be opened, including the first.
+  uint64_t Connects() const { return connects_; }
+
+ private:
+  void Close();
+
+  std::string url_;
+  uint64_t connects_ = 0;
+  // Socket fd on Linux; WinHTTP session and connection handles on Windows.
+  intptr_t socket_ = -1;
+  void* session_ = nullptr;
+  void* connection_ = nullptr;
+};
+
 }  // namespace mccmod
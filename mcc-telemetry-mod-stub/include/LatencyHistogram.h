@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace mccmod {
+
+struct LatencySummary {
+  uint64_t count = 0;
+  uint64_t p50 = 0;
+  uint64_t p90 = 0;
+  uint64_t p99 = 0;
+  uint64_t max = 0;
+  double mean = 0.0;
+};
+
+// Log-linear histogram of non-negative values in any unit: each power of two
+// is split into 8 equal buckets, so a reported percentile is the upper edge
+// of its bucket and at most 12.5% above the true value. Record() is
+// lock-free and may be called from any thread; readers get a consistent
+// enough view for monitoring, not an atomic snapshot.
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+  static constexpr size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  LatencyHistogram() { Reset(); }
+
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void Record(uint64_t value);
+  void Reset();
+
+  uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+  // Upper edge of the bucket holding the q-th quantile (0..1); 0 when empty.
+  uint64_t Percentile(double q) const;
+  LatencySummary Summary() const;
+
+  static size_t BucketFor(uint64_t value);
+  static uint64_t BucketUpperEdge(size_t bucket);
+
+ private:
+  std::atomic<uint64_t> counts_[kBuckets];
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+}  // namespace mccmod
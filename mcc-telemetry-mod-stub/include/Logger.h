@@ -0,0 +1,249 @@
+#pragma once
+
+#include "Clock.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace mccmod {
+
+// Every message the DLL logs, declared once with its level, its rate limit
+// and its preformatted text. Call sites pass a LogId and the arguments; the
+// text is only assembled on the writer thread.
+//
+// MSG(id, level, per minute, format). `{}` in the format takes the next
+// argument. A per-minute limit of 0 means unlimited. Past the limit,
+// messages are counted instead of queued. The next admitted one says how
+// many were suppressed, and so does a summary line once the minute is over.
+#define MCC_LOG_MESSAGES(MSG)                                                                 \
+  MSG(kWorkerStarted, kInfo, 0, "Telemetry worker started.")                                  \
+  MSG(kWorkerStopped, kInfo, 0, "Telemetry worker stopped.")                                  \
+  MSG(kCircuitChanged, kWarning, 6, "Receiver circuit {}, {} snapshot(s) spooled.")           \
+  MSG(kApiUnavailable, kWarning, 1, "Official API unavailable. Adapter not wired yet.")       \
+  MSG(kInactiveSent, kInfo, 6, "Sent inactive snapshot due to safety gate.")                  \
+  MSG(kInactiveSpooled, kInfo, 6, "Spooled inactive snapshot due to safety gate.")            \
+  MSG(kSnapshotSpooled, kDebug, 1, "Receiver unreachable; spooled telemetry snapshot.")       \
+  MSG(kValidationFailed, kWarning, 6, "Snapshot validation failed: {}")                       \
+  MSG(kModScanDone, kDebug, 0, "Scanned {} mod(s), hashed {} bytes in {} ms.")                \
+  MSG(kMetricsUnavailable, kWarning, 0, "Metrics port {} unavailable; metrics not served.")
+
+enum class LogLevel : uint8_t {
+  kDebug,
+  kInfo,
+  kWarning,
+  kError,
+};
+
+const char* LogLevelName(LogLevel level);
+
+#define MCC_LOG_ID(id, level, per_minute, format) id,
+enum class LogId : uint16_t { MCC_LOG_MESSAGES(MCC_LOG_ID) kCount };
+#undef MCC_LOG_ID
+
+struct LogMessageInfo {
+  const char* name;
+  LogLevel level;
+  uint32_t per_minute;
+  const char* format;
+};
+
+#define MCC_LOG_INFO(id, level, per_minute, format) LogMessageInfo{#id, LogLevel::level, per_minute, format},
+inline constexpr LogMessageInfo kLogMessages[] = {MCC_LOG_MESSAGES(MCC_LOG_INFO)};
+#undef MCC_LOG_INFO
+
+inline const LogMessageInfo& GetLogMessageInfo(LogId id) {
+  return kLogMessages[static_cast<size_t>(id)];
+}
+
+// One argument of a log call. Text is copied into the record, so
+// temporaries are fine; it is truncated to fit kLogTextBytes.
+class LogArg {
+ public:
+  enum class Kind : uint8_t { kSigned, kUnsigned, kText };
+
+  template <typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+  LogArg(T value)  // NOLINT(google-explicit-constructor)
+      : kind_(std::is_signed_v<T> ? Kind::kSigned : Kind::kUnsigned), value_(static_cast<uint64_t>(value)) {}
+  LogArg(const char* text) : kind_(Kind::kText), text_(text ? text : "") {}  // NOLINT
+  LogArg(std::string_view text) : kind_(Kind::kText), text_(text) {}         // NOLINT
+  LogArg(const std::string& text) : kind_(Kind::kText), text_(text) {}       // NOLINT
+
+  Kind kind() const { return kind_; }
+  uint64_t value() const { return value_; }
+  std::string_view text() const { return text_; }
+
+ private:
+  Kind kind_;
+  uint64_t value_ = 0;
+  std::string_view text_;
+};
+
+constexpr size_t kMaxLogArgs = 4;
+// Text of all arguments of one record together.
+constexpr size_t kLogTextBytes = 88;
+
+// Receives finished lines on the writer thread only, so sinks need no locking.
+class LogSink {
+ public:
+  virtual ~LogSink() = default;
+  // `line` has no trailing newline.
+  virtual void Write(LogLevel level, std::string_view line) = 0;
+  // Called after each batch the writer drains.
+  virtual void Flush() {}
+};
+
+class StderrSink : public LogSink {
+ public:
+  void Write(LogLevel level, std::string_view line) override;
+  void Flush() override;
+};
+
+// Appends to `path`. Once it would grow past max_bytes it becomes path.1,
+// path.1 becomes path.2, and so on; the oldest of max_files is deleted.
+class RotatingFileSink : public LogSink {
+ public:
+  RotatingFileSink(std::string path, uint64_t max_bytes = 1024 * 1024, int max_files = 3);
+  ~RotatingFileSink() override;
+
+  void Write(LogLevel level, std::string_view line) override;
+  void Flush() override;
+
+ private:
+  void Open();
+  void Rotate();
+
+  const std::string path_;
+  const uint64_t max_bytes_;
+  const int max_files_;
+  std::FILE* file_ = nullptr;
+  uint64_t size_ = 0;
+};
+
+// OutputDebugStringA on Windows, where DebugView and debuggers pick it up;
+// a StderrSink elsewhere.
+std::unique_ptr<LogSink> MakeDebugOutputSink();
+
+struct LoggerOptions {
+  // Prefix of every line, e.g. "MccTelemetryMod".
+  std::string tag = "mcc";
+  // Records in the ring; rounded up to a power of two.
+  size_t capacity = 1024;
+  // How long the writer sleeps between drains when nobody calls Flush().
+  uint64_t drain_interval_ms = 200;
+  LogLevel min_level = LogLevel::kInfo;
+};
+
+struct LoggerStats {
+  // Accepted into the ring.
+  uint64_t logged = 0;
+  // Lines handed to the sinks, summaries included.
+  uint64_t written = 0;
+  // Held back by a message's rate limit.
+  uint64_t suppressed = 0;
+  // Lost because the ring was full.
+  uint64_t dropped = 0;
+};
+
+// Asynchronous logger. Log() checks the level and the message's rate limit,
+// then copies the ID, a steady timestamp and the arguments into a lock-free
+// bounded ring (multi-producer, single-consumer). It never allocates, locks
+// or blocks: when the ring is full the record is dropped and counted. A
+// background writer formats the records and hands the lines to the sinks.
+class Logger {
+ public:
+  explicit Logger(const LoggerOptions& options = LoggerOptions{}, Clock& clock = SystemClock());
+  ~Logger();
+
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+
+  // Sinks are fixed once Start() has run.
+  void AddSink(std::unique_ptr<LogSink> sink);
+  void Start();
+  // Writes out everything still queued, plus pending suppression counts.
+  void Stop();
+
+  void SetMinLevel(LogLevel level) { min_level_.store(level, std::memory_order_relaxed); }
+  // False if the message was filtered, rate limited or dropped.
+  bool Log(LogId id, std::initializer_list<LogArg> args = {});
+  // Blocks until everything logged before the call has reached the sinks.
+  void Flush();
+
+  LoggerStats GetStats() const;
+
+ private:
+  struct Record {
+    uint64_t steady_ms;
+    uint32_t suppressed;
+    LogId id;
+    uint8_t arg_count;
+    LogArg::Kind kinds[kMaxLogArgs];
+    uint8_t text_sizes[kMaxLogArgs];
+    uint64_t values[kMaxLogArgs];
+    char text[kLogTextBytes];
+  };
+
+  struct alignas(64) Cell {
+    std::atomic<uint64_t> sequence{0};
+    Record record;
+  };
+
+  struct alignas(64) RateState {
+    std::atomic<uint64_t> window_start_ms{0};
+    std::atomic<uint32_t> used{0};
+    // Held back since the last line that reported them.
+    std::atomic<uint32_t> pending{0};
+  };
+
+  // False when the message is over its limit; *suppressed takes the count
+  // the admitted message should report.
+  bool Admit(LogId id, uint64_t now_ms, uint32_t* suppressed);
+  bool Pop(Record* record);
+  void WriterLoop();
+  // Returns the number of records written.
+  size_t Drain(std::string* line);
+  // Summary lines for messages whose window ended with suppressions left;
+  // all of them when `all` is set.
+  void WriteSuppressionSummaries(uint64_t now_ms, bool all, std::string* line);
+  void WriteLine(LogLevel level, const std::string& line);
+  void FormatPrefix(uint64_t steady_ms, LogLevel level, std::string* line) const;
+
+  Clock& clock_;
+  const LoggerOptions options_;
+  std::atomic<LogLevel> min_level_;
+  std::vector<std::unique_ptr<LogSink>> sinks_;
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_ = 0;
+  alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+  alignas(64) uint64_t dequeue_pos_ = 0;
+
+  RateState rates_[static_cast<size_t>(LogId::kCount)];
+
+  std::atomic<uint64_t> logged_{0};
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> suppressed_{0};
+  std::atomic<uint64_t> dropped_{0};
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable drained_;
+  bool running_ = false;
+  bool wake_requested_ = false;
+  // Ring position the sinks have seen everything before.
+  uint64_t written_pos_ = 0;
+  std::thread writer_;
+};
+
+}  // namespace mccmod
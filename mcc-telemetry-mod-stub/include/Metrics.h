@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mccmod {
+
+// Lock-free metrics rendered in the Prometheus text format (version 0.0.4).
+// Registration takes a lock and returns a reference that stays valid for the
+// registry's lifetime; updates through it are single relaxed atomic RMWs, so
+// hot paths register once (e.g. into a function-local static struct) and
+// then only touch the reference.
+
+class MetricCounter {
+ public:
+  void Add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+  uint64_t Value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  alignas(64) std::atomic<uint64_t> value_{0};
+};
+
+class MetricGauge {
+ public:
+  void Set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+  void Add(int64_t delta) { value_.fetch_add(delta, std::memory_order_relaxed); }
+  int64_t Value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  alignas(64) std::atomic<int64_t> value_{0};
+};
+
+// Cumulative-bucket histogram with fixed upper bounds, in whatever integer
+// unit the name says (…_ms, …_us).
+class MetricHistogram {
+ public:
+  // `bounds` must be ascending; +Inf is implied.
+  explicit MetricHistogram(std::vector<uint64_t> bounds);
+
+  void Observe(uint64_t value);
+
+  const std::vector<uint64_t>& Bounds() const { return bounds_; }
+  // Per-bucket counts, not cumulative; the last is the +Inf bucket.
+  std::vector<uint64_t> BucketCounts() const;
+  // Sums the buckets; Observe() keeps no separate count.
+  uint64_t Count() const;
+  uint64_t Sum() const { return sum_.load(std::memory_order_relaxed); }
+
+ private:
+  const std::vector<uint64_t> bounds_;
+  std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+  alignas(64) std::atomic<uint64_t> sum_{0};
+};
+
+class MetricsRegistry {
+ public:
+  MetricsRegistry() = default;
+
+  MetricsRegistry(const MetricsRegistry&) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+  // `labels` is the inside of the braces, e.g. `result="ok"`. Asking again
+  // for the same name and labels returns the existing metric. A name keeps
+  // the type and help text it was first registered with.
+  MetricCounter& Counter(std::string_view name, std::string_view help, std::string_view labels = {});
+  MetricGauge& Gauge(std::string_view name, std::string_view help, std::string_view labels = {});
+  MetricHistogram& Histogram(std::string_view name, std::string_view help, std::vector<uint64_t> bounds,
+                             std::string_view labels = {});
+
+  // Runs at the start of every Render(), to copy stats kept elsewhere into
+  // gauges. Returns a handle for RemoveCollector().
+  int AddCollector(std::function<void()> collector);
+  void RemoveCollector(int handle);
+
+  std::string Render();
+
+ private:
+  enum class Type { kCounter, kGauge, kHistogram };
+
+  struct Series {
+    std::string labels;
+    std::unique_ptr<MetricCounter> counter;
+    std::unique_ptr<MetricGauge> gauge;
+    std::unique_ptr<MetricHistogram> histogram;
+  };
+
+  struct Family {
+    std::string name;
+    std::string help;
+    Type type;
+    std::vector<std::unique_ptr<Series>> series;
+  };
+
+  Series& FindOrAddLocked(std::string_view name, std::string_view help, Type type, std::string_view labels);
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Family>> families_;
+  // Separate from mutex_ so a collector may register metrics; RemoveCollector()
+  // waits for a Render() that is running the collector.
+  std::mutex collectors_mutex_;
+  std::vector<std::pair<int, std::function<void()>>> collectors_;
+  int next_collector_ = 1;
+};
+
+// The process-wide registry that the reader's and the DLL's metrics live in.
+MetricsRegistry& DefaultMetrics();
+
+// Serves a registry over HTTP on 127.0.0.1 only: GET /metrics answers with
+// the Prometheus text, anything else with 404 or 405. One connection at a
+// time, closed after each response; it is for a local scraper or curl.
+class MetricsServer {
+ public:
+  MetricsServer() = default;
+  ~MetricsServer();
+
+  MetricsServer(const MetricsServer&) = delete;
+  MetricsServer& operator=(const MetricsServer&) = delete;
+
+  // Port 0 picks a free port; Port() tells which.
+  bool Start(uint16_t port, MetricsRegistry& registry = DefaultMetrics());
+  void Stop();
+  uint16_t Port() const { return port_; }
+  uint64_t Scrapes() const { return scrapes_.load(std::memory_order_relaxed); }
+
+ private:
+  void AcceptLoop();
+  void Serve(intptr_t client);
+
+  MetricsRegistry* registry_ = nullptr;
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> scrapes_{0};
+  std::thread acceptor_;
+  intptr_t listener_ = -1;
+  uint16_t port_ = 0;
+};
+
+}  // namespace mccmod
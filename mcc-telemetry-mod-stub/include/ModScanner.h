@@ -0,0 +1,116 @@
+#pragma once
+
+#include "TelemetryContract.h"
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mccmod {
+
+// One installed mod: a top-level directory under a mod root, as the PC app's
+// modScanner.js sees it.
+struct ModInfo {
+  std::string name;
+  std::string root;
+  uint64_t files = 0;
+  uint64_t bytes = 0;
+  // Hash of every file's relative path, size and content hash.
+  uint64_t fingerprint = 0;
+};
+
+struct ModScanStats {
+  uint64_t directories = 0;
+  uint64_t files = 0;
+  uint64_t bytes = 0;
+  // Content actually read this scan; the rest came from the cache.
+  uint64_t bytes_hashed = 0;
+  uint64_t files_hashed = 0;
+  uint64_t cache_hits = 0;
+  // Files or directories that could not be listed, stat'ed or read.
+  uint64_t errors = 0;
+  uint64_t walk_ms = 0;
+  uint64_t hash_ms = 0;
+};
+
+struct ModScanResult {
+  // Sorted by name, then root.
+  std::vector<ModInfo> mods;
+  // Hash of every mod's name and fingerprint; 0 when no mods are installed.
+  uint64_t fingerprint = 0;
+  bool cancelled = false;
+  ModScanStats stats;
+};
+
+// 16 lowercase hex digits; empty for 0.
+std::string FormatModFingerprint(uint64_t fingerprint);
+
+// Fills snapshot->mods with the unique mod names that fit the schema's list
+// bounds, in name order, and snapshot->mods_fingerprint with the fingerprint
+// of the whole set, so two lobbies with the same names but different content
+// (or more mods than the list holds) still compare correctly.
+void ApplyModScan(const ModScanResult& result, TelemetrySnapshot* snapshot);
+
+// The Steam install's Mods folder and Documents\Halo MCC\Mods, as in
+// modScanner.js. MCC_MOD_PATHS overrides both: a list of roots separated by
+// ';' (and ':' outside Windows).
+std::vector<std::string> DefaultModRoots();
+
+// Walks the mod roots and fingerprints their content. Directories are listed
+// in parallel on a worker pool; file content is memory-mapped and hashed
+// with Hash64 in chunks, so a single large map pack also spreads across the
+// workers. A file whose size and modification time match the cache reuses
+// its hash, which makes rescans cost a directory walk. The cache can be
+// persisted between runs. Scan() is not reentrant; use one scanner per
+// thread.
+class ModScanner {
+ public:
+  // Content is hashed in independent chunks of this size; a file's hash is
+  // the hash of its chunk hashes when it spans more than one.
+  static constexpr uint64_t kChunkBytes = 16ull * 1024 * 1024;
+
+  // 0 uses every hardware thread.
+  explicit ModScanner(size_t threads = 0);
+  ~ModScanner();
+
+  ModScanner(const ModScanner&) = delete;
+  ModScanner& operator=(const ModScanner&) = delete;
+
+  // Missing roots are skipped. `cancel` is polled between directories and
+  // chunks; a cancelled result is incomplete and must not be published.
+  ModScanResult Scan(const std::vector<std::string>& roots,
+                     const std::atomic<bool>* cancel = nullptr);
+
+  // Tab-separated lines of path, size, mtime and hash. A missing or
+  // unreadable file leaves the cache empty.
+  bool LoadCache(const std::string& path);
+  // Written to a temporary file and renamed over `path`; skipped when
+  // nothing changed since the last load or save.
+  bool SaveCache(const std::string& path);
+  void ClearCache();
+  size_t CacheSize() const { return cache_.size(); }
+  size_t Threads() const { return threads_; }
+
+ private:
+  struct CacheEntry {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    uint64_t hash = 0;
+  };
+
+  // Runs `body(worker)` once on each pool thread and waits for all of them.
+  template <typename Body>
+  void RunOnAllWorkers(const Body& body);
+
+  size_t threads_;
+  WorkerPool pool_;
+  // Keyed by absolute UTF-8 path. Only files seen by the last scan are kept.
+  std::unordered_map<std::string, CacheEntry> cache_;
+  bool cache_dirty_ = false;
+};
+
+}  // namespace mccmod
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace mccmod {
+
+// Character classes of the map and gametype names the reader decodes, in the
+// "C" locale the reader runs in (it never calls setlocale).
+enum NameCharClass : uint8_t {
+  // 0x20-0x7E.
+  kNameCharPrintable = 1 << 0,
+  // A-Z, a-z: what std::isalpha accepts.
+  kNameCharAlpha = 1 << 1,
+  // Space, \t, \n, \v, \f, \r: what std::isspace accepts.
+  kNameCharSpace = 1 << 2,
+};
+
+constexpr std::array<uint8_t, 256> MakeNameCharClassTable() {
+  std::array<uint8_t, 256> table{};
+  for (int c = 0; c < 256; ++c) {
+    uint8_t bits = 0;
+    if (c >= 0x20 && c <= 0x7E) bits |= kNameCharPrintable;
+    if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) bits |= kNameCharAlpha;
+    if (c == ' ' || (c >= '\t' && c <= '\r')) bits |= kNameCharSpace;
+    table[static_cast<size_t>(c)] = bits;
+  }
+  return table;
+}
+
+inline constexpr std::array<uint8_t, 256> kNameCharClass = MakeNameCharClassTable();
+
+constexpr size_t kMaxNameTextBytes = 64;
+
+struct TextBounds {
+  size_t begin = 0;
+  size_t end = 0;
+};
+
+// Bounds of `text` with leading and trailing whitespace removed.
+TextBounds TrimmedBounds(std::string_view text);
+// Trims in place: no copy, no allocation.
+void TrimInPlace(std::string* text);
+
+// 1 to 64 bytes, all printable ASCII, at least one letter. This is the
+// character check the reader applies to map and mode candidates. It uses
+// SSE2 (AVX2 when the build targets it) 16 or 32 bytes at a time, and the
+// lookup table for the tail.
+bool IsLikelyNameText(std::string_view text);
+// The same check through the lookup table alone; the vector path must agree.
+bool IsLikelyNameTextScalar(std::string_view text);
+// Which vector path IsLikelyNameText() was built with: "avx2", "sse2" or "none".
+const char* NameClassifierIsa();
+
+// A map or mode field holds up to 64 bytes of UTF-8 or 64 UTF-16LE units.
+// UTF-16 is only tried on 2-byte aligned fields, so those are read (and
+// fingerprinted) at the full 128 bytes and odd ones at 64.
+constexpr size_t kNameFieldUtf16Bytes = 2 * kMaxNameTextBytes;
+constexpr size_t NameFieldReadBytes(uintptr_t address) {
+  return address % 2 == 0 ? kNameFieldUtf16Bytes : kMaxNameTextBytes;
+}
+
+// UTF-16LE code units to UTF-8; unpaired surrogates become U+FFFD, as
+// WideCharToMultiByte does.
+void Utf16LeToUtf8(const char* bytes, size_t units, std::string* out);
+
+// Decodes the `size` raw bytes of a field read at `address`: UTF-8 up to the
+// first NUL in the first 64 bytes. If `accept` rejects that, the address is
+// even and the leading bytes follow <printable> 00 pairs, the bytes are
+// decoded as UTF-16LE up to the first NUL unit instead, and that is kept if
+// `accept` takes it. Untrimmed. Reads nothing beyond `raw`; returns true if
+// the UTF-16 decode was kept.
+bool DecodeNameField(const char* raw, size_t size, uintptr_t address, bool (*accept)(std::string_view),
+                     std::string* out);
+
+}  // namespace mccmod
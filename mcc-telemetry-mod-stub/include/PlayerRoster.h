@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ReaderLayout.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mccmod {
+
+// A gamertag's 16 UTF-16 units take at most 48 bytes of UTF-8.
+constexpr size_t kRosterNameBytes = kPlayerEntryNameChars * 3;
+
+// Decoded roster as a struct of arrays: player i is names[i], teams[i] and
+// slots[i], in table order. Name slots are fixed width and zero-padded, and
+// rows past `count` stay zeroed, so the whole struct can be hashed or
+// compared as bytes.
+struct PlayerRoster {
+  uint8_t count = 0;
+  uint8_t name_lengths[kPlayerTableEntries] = {};
+  // kPlayerNoTeam in free-for-all modes.
+  uint8_t teams[kPlayerTableEntries] = {};
+  // The entry's index in the game's player table.
+  uint8_t slots[kPlayerTableEntries] = {};
+  char names[kPlayerTableEntries][kRosterNameBytes] = {};
+};
+
+// Decodes a player table of kPlayerTableBytes. Inactive entries and entries
+// whose name is empty or holds control characters are skipped.
+void DecodePlayerTable(const uint8_t* table, PlayerRoster* out);
+bool SameRoster(const PlayerRoster& a, const PlayerRoster& b);
+// Appends `[{"name":...,"team":...,"slot":...},...]`; a team of
+// kPlayerNoTeam is written as -1.
+void AppendRosterJson(const PlayerRoster& roster, std::string* out);
+
+struct RosterStats {
+  uint64_t updates = 0;
+  // Updates whose raw table differed from the last one and was decoded.
+  uint64_t decodes = 0;
+  // Decodes that changed the roster itself; stats churn alone does not.
+  uint64_t changes = 0;
+};
+
+// Follows the player table from tick to tick. The table is hashed on every
+// update and decoded only when the hash moves; the roster counts as changed
+// only when a name, team or slot does, so per-life stats changing in the
+// same entries do not wake up the output. Single-threaded.
+class RosterTracker {
+ public:
+  // `table` is kPlayerTableBytes read from the game. True if the roster changed.
+  bool Update(const uint8_t* table);
+  // Forgets the table and empties the roster, e.g. on a reconnect.
+  void Reset();
+
+  const PlayerRoster& Roster() const { return roster_; }
+  // Increments on every roster change; 0 until the first table is seen.
+  uint64_t Version() const { return version_; }
+  const RosterStats& Stats() const { return stats_; }
+
+ private:
+  bool primed_ = false;
+  uint64_t table_hash_ = 0;
+  uint64_t version_ = 0;
+  PlayerRoster roster_;
+  PlayerRoster scratch_;
+  RosterStats stats_;
+};
+
+}  // namespace mccmod
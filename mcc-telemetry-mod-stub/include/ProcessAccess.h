@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mccmod {
+
+using ProcessId = uint32_t;
+
+// Pids whose executable name matches one of `names`, case-insensitively.
+// Linux compares the basename of argv[0] (which also covers Windows-style
+// paths under Wine) and the kernel's comm name. Wine sets comm to the
+// Windows executable's name, cut to 15 characters, so for a Wine-hosted
+// process a 15-character comm also matches a longer name it starts.
+std::vector<ProcessId> FindProcessesByName(const std::vector<std::string>& names);
+
+// True if `pid` runs under Wine or Proton: its executable is a Wine loader
+// or preloader. Always false on Windows.
+bool IsWineHosted(ProcessId pid);
+
+// One entry of RemoteProcess::ReadBatch(). `ok` means all `size` bytes
+// were read.
+struct RemoteRead {
+  uintptr_t address = 0;
+  void* buffer = nullptr;
+  size_t size = 0;
+  size_t bytes_read = 0;
+  bool ok = false;
+  // Why the entry failed: an errno on Linux (EFAULT for an unmapped
+  // address), GetLastError() on Windows; 0 if it succeeded or no pid is
+  // open. Set here so callers need not rely on errno surviving the batch.
+  int error = 0;
+};
+
+// Read-only view of another process: ReadProcessMemory and Toolhelp on
+// Windows, process_vm_readv and /proc/<pid>/maps on Linux, including a
+// Windows process running under Wine or Proton.
+class RemoteProcess {
+ public:
+  RemoteProcess() = default;
+  ~RemoteProcess();
+
+  RemoteProcess(const RemoteProcess&) = delete;
+  RemoteProcess& operator=(const RemoteProcess&) = delete;
+
+  bool Open(ProcessId pid);
+  void Close();
+  bool IsOpen() const { return pid_ != 0; }
+  ProcessId Pid() const { return pid_; }
+  // HANDLE on Windows, pid elsewhere; the form QueryMemoryRegions expects.
+  intptr_t NativeHandle() const { return handle_; }
+
+  bool Read(uintptr_t address, void* buffer, size_t size, size_t* bytes_read) const;
+  // Reads every entry and returns how many succeeded. Linux issues them as
+  // one process_vm_readv, restarting after an entry that faults; Windows
+  // reads them one at a time.
+  size_t ReadBatch(RemoteRead* reads, size_t count) const;
+  // Load address of a module by file name, case-insensitively; 0 if not
+  // loaded. On Linux this is the file's offset-0 mapping that holds a PE
+  // header, which is how Wine maps a PE image; failing that, the file's
+  // lowest mapping.
+  uintptr_t FindModuleBase(const std::string& module_name) const;
+
+ private:
+  // "MZ" and a "PE\0\0" signature at e_lfanew.
+  bool HasPeHeader(uintptr_t address) const;
+
+  intptr_t handle_ = 0;
+  ProcessId pid_ = 0;
+};
+
+bool EqualsIgnoreCase(const std::string& a, const std::string& b);
+
+}  // namespace mccmod
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mccmod {
+
+// Memory layout the overlay reader samples, relative to module load
+// addresses. Shared with mcc_dummy_target so the two cannot drift apart.
+constexpr char kMccModuleName[] = "mcc-win64-shipping.exe";
+constexpr char kReachModuleName[] = "haloreach.dll";
+
+constexpr uintptr_t kMccPlayerCountOffset = 0x3F92E10;
+constexpr uintptr_t kReachPlayerCountOffsets[] = {0x2B07470, 0x2B08B50, 0x2C996A0};
+
+// Pointer to the shared telemetry block, and string fields inside it.
+constexpr uintptr_t kSharedTelemetryBaseOffset = 0x4001590;
+constexpr uintptr_t kMapNameOffset = 0x44D;
+constexpr uintptr_t kModeNameOffsetPrimary = 0x3C4;
+constexpr uintptr_t kModeNameOffsetSecondary = 0x8B8;
+
+// Player table inside the shared telemetry block: one fixed-size entry per
+// slot, read in one go. Unverified: this layout was not taken from a memory
+// dump of the game, and mcc_dummy_target writes it from these constants, so
+// the tests cannot catch it being wrong. The reader only reads it with
+// HMCC_READER_ROSTER=1 and drops a table whose active entries disagree with
+// the player count. An entry is a UTF-16LE gamertag, NUL-padded, then a
+// flags byte, the team (255 for none) and per-life stats the reader ignores.
+constexpr uintptr_t kPlayerTableOffset = 0xA00;
+constexpr size_t kPlayerTableEntries = 24;
+constexpr size_t kPlayerEntryStride = 0x28;
+constexpr size_t kPlayerTableBytes = kPlayerTableEntries * kPlayerEntryStride;
+constexpr size_t kPlayerEntryNameChars = 16;
+constexpr size_t kPlayerEntryFlagsOffset = 0x20;
+constexpr size_t kPlayerEntryTeamOffset = 0x21;
+constexpr size_t kPlayerEntryKillsOffset = 0x22;
+constexpr uint8_t kPlayerEntryActive = 1 << 0;
+constexpr uint8_t kPlayerNoTeam = 255;
+
+}  // namespace mccmod
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace mccmod {
+
+// Longest a failing address is backed off unless the caller caps it lower.
+constexpr uint64_t kRegionBackoffMaxMs = 60000;
+
+struct MemoryRegion {
+  uintptr_t base = 0;
+  uintptr_t end = 0;
+  bool readable = false;
+};
+
+// Regions around `address` in another process. `process` is a HANDLE with
+// PROCESS_QUERY_INFORMATION on Windows and a pid elsewhere. Windows answers
+// with the single region containing the address; Linux parses
+// /proc/<pid>/maps and returns the whole map, gaps included.
+bool QueryMemoryRegions(intptr_t process, uintptr_t address, std::vector<MemoryRegion>* out);
+
+struct RegionCacheStats {
+  uint64_t region_queries = 0;
+  uint64_t rejected_unmapped = 0;
+  uint64_t rejected_backoff = 0;
+  uint64_t read_failures = 0;
+  size_t backoff_addresses = 0;
+  // Failing reads that never reached the kernel, extrapolated to one hour.
+  double avoided_per_hour = 0.0;
+};
+
+// Screens remote reads before they cost a syscall. Reads outside committed
+// readable regions are rejected in user space, and an address that keeps
+// failing is retried on an exponential backoff. Regions are fetched lazily and
+// expire, so memory the target maps later is picked up. Single-threaded.
+class RegionCache {
+ public:
+  void Attach(intptr_t process, uint64_t now_ms);
+  // Drops regions and backoff state, e.g. after a module load or unload.
+  void Invalidate();
+
+  // True if a read of [address, address + size) should be attempted now.
+  bool Admit(uintptr_t address, size_t size, uint64_t now_ms);
+  // A failed read backs `address` off for 400 ms, doubling per failure up to
+  // `max_backoff_ms`. Fields that must recover within a few polls, such as
+  // names that are only valid in a match, pass a low cap.
+  void RecordResult(uintptr_t address, bool ok, uint64_t now_ms, uint64_t max_backoff_ms = kRegionBackoffMaxMs);
+  // Region lookup without touching the counters; used to notice unloaded modules.
+  bool IsReadable(uintptr_t address, uint64_t now_ms);
+
+  RegionCacheStats GetStats(uint64_t now_ms) const;
+
+ private:
+  struct Region {
+    uintptr_t base = 0;
+    uintptr_t end = 0;
+    bool readable = false;
+    uint64_t fetched_ms = 0;
+  };
+  struct Backoff {
+    uint32_t failures = 0;
+    uint64_t retry_at_ms = 0;
+  };
+
+  const Region* Lookup(uintptr_t address, uint64_t now_ms);
+  void Insert(const MemoryRegion& region, uint64_t now_ms);
+  // The region holding `address`, or regions_.end().
+  std::vector<Region>::iterator Containing(uintptr_t address);
+
+  intptr_t process_ = 0;
+  uint64_t attached_ms_ = 0;
+  // Sorted by base, no overlaps. A vector rather than a map, and a kept
+  // scratch vector for queries, so refreshing regions on the sampler's tick
+  // reuses storage instead of allocating.
+  std::vector<Region> regions_;
+  std::vector<MemoryRegion> fetched_;
+  std::unordered_map<uintptr_t, Backoff> backoff_;
+  RegionCacheStats stats_;
+};
+
+}  // namespace mccmod
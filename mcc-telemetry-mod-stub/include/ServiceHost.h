@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+namespace mccmod {
+
+// Helpers for running the reader as a headless background service.
+
+struct ResourceUsage {
+  uint64_t working_set_bytes = 0;
+  uint64_t cpu_ms = 0;  // user + kernel time of the whole process
+};
+
+bool GetProcessResourceUsage(ResourceUsage* out);
+// Drops the process below normal priority so it never competes with the game.
+// On Linux niceness is per thread; call this before starting any threads.
+bool LowerProcessPriority();
+// Hands unused pages back to the OS.
+void TrimWorkingSet();
+
+// Process-wide shutdown request. Windows listens for console control events
+// and the named event `Local\hmcc-reader-stop`; Linux for SIGINT and SIGTERM.
+void InstallShutdownHandlers();
+void RequestShutdown();
+bool IsShutdownRequested();
+// Sleeps up to timeout_ms; returns true as soon as shutdown is requested.
+bool WaitForShutdown(uint64_t timeout_ms);
+// Handle that turns ready once shutdown is requested, for waits that watch
+// it alongside a timer (TickScheduler::SetWakeHandle): the wake pipe's read
+// end on Linux, the stop event on Windows. -1 before InstallShutdownHandlers.
+// The stop event can be set from outside; WaitForShutdown(0) latches it.
+intptr_t ShutdownWakeHandle();
+// Asks an already running service to stop (Windows only; use kill elsewhere).
+bool SignalRunningService();
+
+struct ResourceLimits {
+  uint64_t max_working_set_bytes = 64ull * 1024 * 1024;
+  double max_cpu_ms_per_minute = 1500.0;  // 2.5% of one core
+  double max_wakeups_per_second = 50.0;
+};
+
+struct ResourceReport {
+  uint64_t working_set_bytes = 0;
+  double cpu_ms_per_minute = 0.0;
+  double wakeups_per_second = 0.0;
+  bool over_memory = false;
+  bool over_cpu = false;
+  bool over_wakeups = false;
+  uint32_t throttle = 1;
+  uint64_t trims = 0;
+};
+
+// Measures the process against ResourceLimits once per window. Over the CPU
+// or wakeup budget it doubles the throttle factor (up to kMaxThrottle) that
+// the caller stretches its poll interval by, and halves it again once usage
+// falls back under half the budget. Over the memory budget it trims the
+// working set.
+class ResourceBudget {
+ public:
+  static constexpr uint32_t kMaxThrottle = 4;
+
+  explicit ResourceBudget(const ResourceLimits& limits) : limits_(limits) {}
+
+  // `wakeups` is the caller's running total of loop wakeups.
+  const ResourceReport& Update(uint64_t now_ms, uint64_t wakeups);
+  // Same, against `usage` instead of a fresh GetProcessResourceUsage().
+  const ResourceReport& Update(uint64_t now_ms, uint64_t wakeups, const ResourceUsage& usage);
+  const ResourceReport& Report() const { return report_; }
+  const ResourceLimits& Limits() const { return limits_; }
+
+ private:
+  ResourceLimits limits_;
+  ResourceReport report_;
+  bool has_baseline_ = false;
+  uint64_t last_ms_ = 0;
+  uint64_t last_cpu_ms_ = 0;
+  uint64_t last_wakeups_ = 0;
+};
+
+}  // namespace mccmod
@@ -11,9 +11,20 @@ struct ModSettings {
   int update_interval_ms = 2000;
   std::string endpoint = "http://127.0.0.1:4760/telemetry";
   bool debug_mode = false;
+  // Fingerprint the installed mods and report them in every snapshot.
+  bool scan_mods = true;
+  // Serve Prometheus metrics on 127.0.0.1 at this port; 0 is off. Read once
+  // at Initialize().
+  int metrics_port = 0;
 };
 
 ModSettings LoadSettings();
 std::string GetDefaultSettingsPath();
+// Where snapshots wait while the receiver is unreachable; next to the settings file.
+std::string GetDefaultSpoolPath();
+// Mod content hashes from the last scan, so a restart only rehashes what changed.
+std::string GetDefaultModCachePath();
+// The DLL's rotating log; older files are kept as .1 and .2 beside it.
+std::string GetDefaultLogPath();
 
 }  // namespace mccmod
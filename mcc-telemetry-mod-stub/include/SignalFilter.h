@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace mccmod {
+
+// Thresholds for committing a signal value. With several independent sources
+// in agreement a value commits on the first tick; single-source or
+// conflicting reads fall back to streaks. A committed value stays until a
+// replacement clears these thresholds, which gives the filter its hysteresis.
+struct SignalFilterConfig {
+  int streak_ticks = 3;          // agreeing ticks required without a fast commit
+  int conflict_ticks = 3;        // agreeing ticks required while readings disagree
+  int fast_min_sources = 2;      // distinct sources that must report the winning value
+  float fast_confidence = 1.0f;  // share of readings that must report the winning value
+  bool fast_commit = true;       // false restores the plain streak filter
+};
+
+// The reader's defaults; HMCC_READER_{MAP,MODE,PLAYER}_FILTER override them.
+// The two mode offsets are one field and so one source: mode never fast-commits.
+constexpr SignalFilterConfig kMapFilterDefaults{3, 4, 2, 1.0f, true};
+constexpr SignalFilterConfig kModeFilterDefaults{3, 4, 2, 1.0f, true};
+constexpr SignalFilterConfig kPlayerFilterDefaults{2, 3, 3, 0.75f, true};
+
+// Reads "streak=3,conflict=4,sources=2,confidence=1.0,fast=1" over `config`;
+// keys left out keep their value. Returns false, leaving `config` as it was,
+// on an unknown key or an out-of-range value.
+bool ParseSignalFilterConfig(const std::string& spec, SignalFilterConfig* config);
+std::string FormatSignalFilterConfig(const SignalFilterConfig& config);
+
+constexpr size_t kMaxSignalCandidates = 4;
+constexpr uint8_t kMaxSignalSources = 32;
+
+// One tick's readings of a signal, each tagged with the source it came from.
+// Readings that share a source, such as two offsets of one field, vote as
+// one source. Fixed capacity, and slots keep their storage between ticks, so
+// filling it does not allocate once string slots have grown.
+template <typename T>
+struct SignalCandidates {
+  std::array<T, kMaxSignalCandidates> values{};
+  std::array<uint8_t, kMaxSignalCandidates> sources{};
+  size_t count = 0;
+
+  void Clear() { count = 0; }
+
+  // Ignores readings past capacity and source ids from kMaxSignalSources on.
+  void Add(const T& value, uint8_t source) {
+    if (count >= values.size() || source >= kMaxSignalSources) return;
+    values[count] = value;
+    sources[count] = source;
+    ++count;
+  }
+};
+
+template <typename T>
+struct SignalConsensus {
+  // Points into the candidates; null when there were none.
+  const T* value = nullptr;
+  int readings = 0;
+  int sources = 0;
+  int agreeing_readings = 0;
+  int agreeing_sources = 0;
+};
+
+inline int CountSourceBits(uint32_t mask) {
+  int bits = 0;
+  for (; mask != 0; mask &= mask - 1) ++bits;
+  return bits;
+}
+
+// The value reported by the most distinct sources, then by the most
+// readings; an exact tie goes to the value read first.
+template <typename T>
+SignalConsensus<T> ComputeConsensus(const SignalCandidates<T>& candidates) {
+  SignalConsensus<T> result;
+  result.readings = static_cast<int>(candidates.count);
+  uint32_t all_sources = 0;
+  for (size_t i = 0; i < candidates.count; ++i) all_sources |= uint32_t{1} << candidates.sources[i];
+  result.sources = CountSourceBits(all_sources);
+
+  for (size_t i = 0; i < candidates.count; ++i) {
+    const T& value = candidates.values[i];
+    bool counted = false;
+    for (size_t j = 0; j < i && !counted; ++j) counted = candidates.values[j] == value;
+    if (counted) continue;
+
+    uint32_t agreeing = 0;
+    int readings = 0;
+    for (size_t j = i; j < candidates.count; ++j) {
+      if (candidates.values[j] == value) {
+        agreeing |= uint32_t{1} << candidates.sources[j];
+        ++readings;
+      }
+    }
+    const int sources = CountSourceBits(agreeing);
+    if (sources > result.agreeing_sources ||
+        (sources == result.agreeing_sources && readings > result.agreeing_readings)) {
+      result.value = &value;
+      result.agreeing_sources = sources;
+      result.agreeing_readings = readings;
+    }
+  }
+  return result;
+}
+
+// Commits a signal value once its readings have held for the streak the
+// config requires. Before the first commit it reports the fallback value.
+template <typename T>
+class StableSignal {
+ public:
+  StableSignal(const SignalFilterConfig& config, T fallback) : config_(config), fallback_(std::move(fallback)) {}
+
+  void Reset() {
+    stable_ = T{};
+    last_candidate_ = T{};
+    streak_ = 0;
+    confidence_ = 0.0f;
+    sources_ = 0;
+    last_stable_ms_ = 0;
+    has_stable_ = false;
+    updated_this_tick_ = false;
+  }
+
+  const T& Update(const SignalCandidates<T>& candidates, uint64_t now_ms) {
+    updated_this_tick_ = false;
+    const SignalConsensus<T> consensus = ComputeConsensus(candidates);
+    confidence_ = consensus.readings > 0
+                      ? static_cast<float>(consensus.agreeing_readings) / static_cast<float>(consensus.readings)
+                      : 0.0f;
+    sources_ = consensus.sources;
+    if (!consensus.value) return Current();
+
+    if (*consensus.value == last_candidate_) {
+      ++streak_;
+    } else {
+      last_candidate_ = *consensus.value;
+      streak_ = 1;
+    }
+    if (streak_ >= RequiredStreak(consensus)) {
+      stable_ = last_candidate_;
+      last_stable_ms_ = now_ms;
+      has_stable_ = true;
+      updated_this_tick_ = true;
+    }
+    return Current();
+  }
+
+  int RequiredStreak(const SignalConsensus<T>& consensus) const {
+    if (!config_.fast_commit) return config_.streak_ticks;
+    if (consensus.readings > 1 && confidence_ < config_.fast_confidence) {
+      return std::max(config_.streak_ticks, config_.conflict_ticks);
+    }
+    if (consensus.sources > 1 && consensus.agreeing_sources >= config_.fast_min_sources) return 1;
+    return config_.streak_ticks;
+  }
+
+  const T& Current() const { return has_stable_ ? stable_ : fallback_; }
+  const SignalFilterConfig& Config() const { return config_; }
+  void SetConfig(const SignalFilterConfig& config) { config_ = config; }
+  // Share of last tick's readings that agreed with its winning value.
+  float Confidence() const { return confidence_; }
+  // Distinct sources with a reading last tick.
+  int Sources() const { return sources_; }
+  uint64_t LastStableMs() const { return last_stable_ms_; }
+  bool HasStable() const { return has_stable_; }
+  bool UpdatedThisTick() const { return updated_this_tick_; }
+
+ private:
+  SignalFilterConfig config_;
+  T fallback_;
+  T stable_{};
+  T last_candidate_{};
+  int streak_ = 0;
+  float confidence_ = 0.0f;
+  int sources_ = 0;
+  uint64_t last_stable_ms_ = 0;
+  bool has_stable_ = false;
+  bool updated_this_tick_ = false;
+};
+
+}  // namespace mccmod
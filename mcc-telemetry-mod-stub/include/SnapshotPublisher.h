@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mccmod {
+
+struct PublisherStats {
+  uint64_t published = 0;
+  uint64_t dropped = 0;
+  size_t subscribers = 0;
+};
+
+// Local pub/sub endpoint for reader snapshots: a named pipe on Windows and a
+// Unix domain socket elsewhere. Subscribers receive newline-delimited JSON,
+// starting with the latest snapshot as soon as they connect. Each subscriber
+// has a bounded queue; a slow subscriber drops its backlog and keeps only the
+// newest snapshot. Start() fails rather than take over a socket another
+// publisher is still listening on.
+class SnapshotPublisher {
+ public:
+  SnapshotPublisher();
+  ~SnapshotPublisher();
+
+  SnapshotPublisher(const SnapshotPublisher&) = delete;
+  SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+  bool Start(const std::string& endpoint, size_t client_queue_depth = 8);
+  void Stop();
+  void Publish(const std::string& snapshot_json);
+  PublisherStats GetStats() const;
+
+  static std::string GetDefaultEndpoint();
+
+ private:
+  struct Client;
+  using Message = std::shared_ptr<const std::string>;
+
+  void AcceptLoop();
+  void ClientLoop(Client* client);
+  void AddClient(intptr_t native_handle);
+  void ReapClients(bool all);
+
+  std::string endpoint_;
+  size_t client_queue_depth_ = 8;
+  std::atomic<bool> running_{false};
+  std::thread acceptor_;
+  intptr_t listener_ = -1;
+  intptr_t stop_event_ = 0;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Client>> clients_;
+  Message latest_;
+  uint64_t published_ = 0;
+  uint64_t dropped_ = 0;
+};
+
+}  // namespace mccmod
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mccmod {
+
+// Reuses between decodes at the reader's 200 ms poll: about five seconds.
+constexpr uint32_t kStringVerifyEvery = 25;
+
+struct StringFieldStats {
+  uint64_t lookups = 0;
+  // Answered from the cache; no decode ran.
+  uint64_t reused = 0;
+  // Full decodes: cold, changed bytes, or a verification.
+  uint64_t decoded = 0;
+  uint64_t verified = 0;
+  // Verifications whose result differed from the cached one, i.e. changes the
+  // fingerprint missed. Should stay 0.
+  uint64_t verify_changed = 0;
+};
+
+// The last decode of one remote string field, keyed by an XXH64 of the raw
+// bytes it came from and the address they were read at. Map and mode names
+// change a few times per match, so most ticks skip the decode, trim and
+// classification. Callers hash every byte the decode reads, so a change
+// always alters the fingerprint and reuse adds no detection latency. Every
+// `verify_every`th reuse decodes anyway as a check on that; a verification
+// that disagrees is counted in verify_changed. Single-threaded.
+class StringFieldCache {
+ public:
+  // `verify_every` 0 decodes on every lookup.
+  explicit StringFieldCache(uint32_t verify_every = kStringVerifyEvery) : verify_every_(verify_every) {}
+
+  // True if `raw`, read at `address`, matches the last stored decode and no
+  // verification is due; *accepted and *value then hold that decode. On false
+  // the caller decodes and hands the result to Store().
+  bool Lookup(uintptr_t address, const void* raw, size_t size, bool* accepted, std::string* value);
+  void Store(bool accepted, const std::string& value);
+  // Forgets the last decode, e.g. after a failed read or a reconnect.
+  void Reset();
+
+  const StringFieldStats& Stats() const { return stats_; }
+
+ private:
+  uint32_t verify_every_;
+  bool primed_ = false;
+  bool verifying_ = false;
+  uint32_t reuses_ = 0;
+  uint64_t fingerprint_ = 0;
+  uint64_t pending_fingerprint_ = 0;
+  bool accepted_ = false;
+  std::string value_;
+  StringFieldStats stats_;
+};
+
+}  // namespace mccmod
@@ -1,24 +1,73 @@
 #pragma once
 
+#include "TelemetrySchema.h"
+
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace mccmod {
 
+// Fields come from MCC_TELEMETRY_SCHEMA in TelemetrySchema.h.
 struct TelemetrySnapshot {
-  bool is_custom_game = false;
-  std::string map_name;
-  std::string game_mode;
-  int player_count = 0;
-  int max_players = 0;
-  std::string host_name;
-  std::vector<std::string> mods;
-  std::string timestamp_utc;
-  std::string session_id;
+#define MCC_SCHEMA_MEMBER(type, member, key, min, max, flags) MCC_SCHEMA_CPP_##type member{};
+  MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_MEMBER)
+#undef MCC_SCHEMA_MEMBER
+};
+
+// Idempotency key stamped on each post. `seq` increases per producer, so the
+// receiver can drop a retried or replayed envelope it has already applied.
+struct DeliveryId {
+  std::string producer;
+  uint64_t seq = 0;
 };
 
+// Where one envelope was along its path, in the producer's steady clock (µs),
+// for per-hop latency. sent_wall_us is the wall clock read with sent_us; it
+// places the receiver's wall-clock receipt time on the producer's timeline.
+// Zero means not stamped.
+struct DeliveryTrace {
+  uint64_t capture_us = 0;
+  uint64_t serialized_us = 0;
+  uint64_t sent_us = 0;
+  int64_t sent_wall_us = 0;
+};
+
+std::string EscapeJson(const std::string& input);
+// Appends `input` JSON-escaped, without quotes. Control characters become \u00XX.
+void AppendEscapedJson(const std::string& input, std::string* out);
+// Reads DefaultClock(), so simulated runs stamp simulated time.
 std::string GetIsoUtcNow();
 bool ValidateSnapshot(const TelemetrySnapshot& snapshot, std::string* error);
-std::string BuildTelemetryEnvelopeJson(const TelemetrySnapshot& snapshot);
+std::string BuildTelemetryEnvelopeJson(const TelemetrySnapshot& snapshot,
+                                       const DeliveryId* delivery = nullptr);
+// Appends `"trace":{...}` with the stamped fields of `trace` to an envelope
+// from BuildTelemetryEnvelopeJson(), as its last member.
+void AppendEnvelopeTrace(const DeliveryTrace& trace, std::string* envelope);
+// Adds sentUs and sentWallUs to the trace of an envelope that ends with one.
+// Returns false, leaving it as is, if it has no trace. Spooled envelopes are
+// stored without send stamps and get them again on every attempt.
+bool StampEnvelopeSent(uint64_t sent_us, int64_t sent_wall_us, std::string* envelope);
+// Reads the trace back out of an envelope; false if it has none.
+bool ParseEnvelopeTrace(const std::string& envelope, DeliveryTrace* trace);
+// Reads the receiver's "receivedWallUs" from an acknowledgement body.
+bool ParseReceivedWallUs(const std::string& ack_json, int64_t* received_wall_us);
+// Appends the schema fields as `"key":value` pairs, comma-separated and
+// without braces, for documents that embed a snapshot among their own fields.
+void AppendTelemetryFieldsJson(const TelemetrySnapshot& snapshot, std::string* out);
+
+// Parses a version 1.0 envelope (or a bare data object). Unknown keys are
+// skipped and missing fields keep their defaults. `delivery` may be null.
+bool ParseTelemetryEnvelopeJson(const std::string& json, TelemetrySnapshot* snapshot,
+                                DeliveryId* delivery, std::string* error);
+
+// Compact binary form: the schema fingerprint, then each field in schema
+// order. Bools take one byte, ints four bytes little-endian, and strings a
+// varint length followed by the bytes. Lists are a varint count followed by
+// their strings. EncodeTelemetrySnapshot appends to `out`.
+void EncodeTelemetrySnapshot(const TelemetrySnapshot& snapshot, std::string* out);
+// Returns bytes consumed, or 0 if the data is truncated or from another schema.
+size_t DecodeTelemetrySnapshot(const void* data, size_t size, TelemetrySnapshot* snapshot);
 
 }  // namespace mccmod
@@ -1,21 +1,51 @@
 #pragma once
 
+#include "Clock.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "ModScanner.h"
+
 #include <atomic>
+#include <memory>
+#include <mutex>
 #include <thread>
 
 namespace mccmod {
 
 class TelemetryMod {
  public:
+  // The worker paces itself on `clock`; simulations pass a VirtualClock.
+  explicit TelemetryMod(Clock& clock = SystemClock()) : clock_(clock) {}
+
   void Initialize();
   void Shutdown();
 
  private:
   void WorkerLoop();
+  // Rescans the mod folders in the background; a first scan can hash
+  // gigabytes, later ones mostly stat files against the cache.
+  void ModScanLoop();
+  // Fills mods (when the adapter reported none) and mods_fingerprint.
+  void ApplyLatestModScan(TelemetrySnapshot* snapshot);
 
+  Clock& clock_;
   bool initialized_ = false;
   std::atomic<bool> running_{false};
+  // Cancels a mod scan in progress.
+  std::atomic<bool> stopping_{false};
+  // Set by the worker when its last tick passed every gate; the mod scanner
+  // waits on it.
+  std::atomic<bool> emit_allowed_{false};
   std::thread worker_;
+  std::thread mod_scanner_;
+  // Lives from Initialize() to Shutdown(), outlasting both threads.
+  std::unique_ptr<Logger> logger_;
+  // Only when metricsPort is set.
+  std::unique_ptr<MetricsServer> metrics_server_;
+
+  std::mutex mods_mutex_;
+  bool have_mod_scan_ = false;
+  ModScanResult mod_scan_;
 };
 
 }  // namespace mccmod
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CircuitBreaker.h"
+#include "Clock.h"
+#include "HttpClientWinHttp.h"
+#include "LatencyHistogram.h"
+#include "TelemetryContract.h"
+#include "TelemetrySpool.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mccmod {
+
+struct TelemetryOutboxStats {
+  uint64_t posted = 0;
+  // Transport errors and 5xx; these count against the circuit.
+  uint64_t failed = 0;
+  // 4xx answers. The receiver is up but will never take the envelope, so it is dropped.
+  uint64_t refused = 0;
+  uint64_t spooled = 0;
+  uint64_t replayed = 0;
+  // Spooled records skipped by compaction at replay time or to make room on disk.
+  uint64_t compacted = 0;
+  uint64_t dropped = 0;
+  uint64_t spool_pending = 0;
+  uint64_t circuit_opens = 0;
+  CircuitState circuit = CircuitState::kClosed;
+};
+
+// Legs of a traced envelope's trip, each measured on one clock. Receipt is
+// the receiver's wall clock, matched against the wall clock read at send, so
+// it needs a receiver that acknowledges with "receivedWallUs".
+enum class DeliveryHop : uint8_t {
+  kCaptureToSerialize,
+  // Queueing, coalescing and time in the spool.
+  kSerializeToSend,
+  kSendToReceipt,
+  kSendToAck,
+  kCaptureToReceipt,
+  kCaptureToAck,
+};
+constexpr size_t kDeliveryHopCount = 6;
+
+// snake_case, e.g. "capture_to_receipt".
+const char* DeliveryHopName(DeliveryHop hop);
+// Per-hop latency in µs over every envelope this process delivered. Any thread.
+std::array<LatencySummary, kDeliveryHopCount> GetDeliveryLatency();
+
+// Delivers envelopes to the telemetry receiver over one keep-alive
+// connection. Every envelope gets a DeliveryId. While the circuit is open,
+// or anything older is still spooled, new envelopes go to the spool
+// instead of the network. Once a half-open probe succeeds, the spool is
+// replayed compacted and in order, so the receiver still sees every lobby
+// transition and ends on the latest state of each session. Replays reuse
+// the spooled bytes, which lets the receiver drop ones it already applied.
+// Not thread-safe; the sender thread owns it.
+class TelemetryOutbox {
+ public:
+  TelemetryOutbox(const std::string& endpoint, const std::string& spool_path,
+                  Clock& clock = DefaultClock(),
+                  const CircuitBreakerOptions& breaker = CircuitBreakerOptions{},
+                  uint64_t spool_max_bytes = TelemetrySpool::kDefaultMaxBytes);
+
+  TelemetryOutbox(const TelemetryOutbox&) = delete;
+  TelemetryOutbox& operator=(const TelemetryOutbox&) = delete;
+
+  // True once the snapshot reached the receiver, false if it was spooled.
+  // `captured_us` is when the snapshot was read, on the clock's SteadyUs();
+  // 0 means now. The envelope carries it and the send stamps in its trace.
+  bool Deliver(const TelemetrySnapshot& snapshot, uint64_t captured_us = 0);
+  // Replays the spool if the circuit lets a call through. True if the spool is now empty.
+  bool Flush();
+
+  const std::string& Endpoint() const { return endpoint_; }
+  const std::string& Producer() const { return producer_; }
+  TelemetryOutboxStats GetStats() const;
+
+ private:
+  // Stamps the send time into a traced envelope; records its hops once acknowledged.
+  bool Post(const std::string& json);
+  void RecordTrace(const DeliveryTrace& trace, uint64_t acked_us, const std::string& ack);
+  void Spool(SpoolRecord record);
+
+  const std::string endpoint_;
+  Clock& clock_;
+  HttpConnection connection_;
+  CircuitBreaker breaker_;
+  TelemetrySpool spool_;
+  std::string producer_;
+  uint64_t next_seq_ = 1;
+  TelemetryOutboxStats stats_;
+};
+
+}  // namespace mccmod
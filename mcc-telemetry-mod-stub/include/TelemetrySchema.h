@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mccmod {
+
+// The telemetry snapshot schema, declared once. Everything that touches a
+// snapshot field is expanded from this list: the TelemetrySnapshot struct,
+// ValidateSnapshot, the JSON serializer and parser, the binary codec, and
+// the JSON Schema that mcc_telemetry_schema writes for the receiver
+// (pc-app/contracts/telemetry.schema.json). Adding a field here adds it
+// everywhere.
+//
+// FIELD(type, member, json key, min, max, flags). For Int, min/max bound
+// the value. For String, they bound the length in bytes. For StringList,
+// they bound the item count. Each item is at most kTelemetryItemMaxBytes,
+// and all items together at most kTelemetryListMaxBytes. Order is wire
+// order for both JSON and binary.
+#define MCC_TELEMETRY_SCHEMA(FIELD)                                                  \
+  FIELD(Bool, is_custom_game, "isCustomGame", 0, 0, kFieldRequired)                  \
+  FIELD(String, map_name, "mapName", 0, 64, kFieldRequiredInCustomGame)              \
+  FIELD(String, game_mode, "gameMode", 0, 64, kFieldRequiredInCustomGame)            \
+  FIELD(String, playlist, "playlist", 0, 64, kFieldNone)                             \
+  FIELD(Int, player_count, "playerCount", 0, 32, kFieldNone)                         \
+  FIELD(Int, max_players, "maxPlayers", 0, 32, kFieldNone)                           \
+  FIELD(String, host_name, "hostName", 0, 64, kFieldNone)                            \
+  FIELD(StringList, mods, "mods", 0, 32, kFieldUniqueItems)                          \
+  FIELD(String, mods_fingerprint, "modsFingerprint", 0, 16, kFieldNone)              \
+  FIELD(String, timestamp_utc, "timestamp", 0, 32, kFieldDateTime)                   \
+  FIELD(String, session_id, "sessionID", 0, 128, kFieldNone)
+
+constexpr size_t kTelemetryItemMaxBytes = 128;
+// Sum of item lengths; lets a list live in FixedTelemetrySnapshot's inline blob.
+constexpr size_t kTelemetryListMaxBytes = 512;
+
+enum class SchemaType : uint8_t {
+  kBool,
+  kInt,
+  kString,
+  kStringList,
+};
+
+enum SchemaFieldFlags : uint32_t {
+  kFieldNone = 0,
+  // Must be present in every document. Native snapshots always have it.
+  kFieldRequired = 1 << 0,
+  // Must be non-empty when isCustomGame is true.
+  kFieldRequiredInCustomGame = 1 << 1,
+  kFieldUniqueItems = 1 << 2,
+  // ISO 8601 UTC; documented in the JSON Schema, not checked by the validator.
+  kFieldDateTime = 1 << 3,
+};
+
+#define MCC_SCHEMA_CPP_Bool bool
+#define MCC_SCHEMA_CPP_Int int
+#define MCC_SCHEMA_CPP_String std::string
+#define MCC_SCHEMA_CPP_StringList std::vector<std::string>
+
+#define MCC_SCHEMA_TYPE_Bool SchemaType::kBool
+#define MCC_SCHEMA_TYPE_Int SchemaType::kInt
+#define MCC_SCHEMA_TYPE_String SchemaType::kString
+#define MCC_SCHEMA_TYPE_StringList SchemaType::kStringList
+
+struct TelemetryFieldInfo {
+  const char* json_key;
+  SchemaType type;
+  int64_t min;
+  int64_t max;
+  uint32_t flags;
+};
+
+#define MCC_SCHEMA_FIELD_INFO(type, member, key, min, max, flags) \
+  TelemetryFieldInfo{key, MCC_SCHEMA_TYPE_##type, min, max, flags},
+inline constexpr TelemetryFieldInfo kTelemetryFields[] = {MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_FIELD_INFO)};
+#undef MCC_SCHEMA_FIELD_INFO
+
+constexpr size_t kTelemetryFieldCount = sizeof(kTelemetryFields) / sizeof(kTelemetryFields[0]);
+
+// Position of each field in the list, e.g. kTelemetryField_map_name.
+enum TelemetryFieldIndex : uint32_t {
+#define MCC_SCHEMA_FIELD_INDEX(type, member, key, min, max, flags) kTelemetryField_##member,
+  MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_FIELD_INDEX)
+#undef MCC_SCHEMA_FIELD_INDEX
+};
+
+static_assert(kTelemetryFieldCount <= 32, "Per-field bitmasks are 32 bits wide.");
+
+// FNV-1a over every field's key, type and bounds. Binary snapshots carry it,
+// so a decoder built from a different schema rejects them instead of
+// misreading them.
+constexpr uint32_t TelemetrySchemaFingerprint() {
+  uint32_t hash = 2166136261u;
+  auto mix = [&hash](uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+      hash = (hash ^ static_cast<uint8_t>(value >> (i * 8))) * 16777619u;
+    }
+  };
+  for (const TelemetryFieldInfo& field : kTelemetryFields) {
+    for (const char* c = field.json_key; *c; ++c) {
+      hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+    }
+    mix(static_cast<uint64_t>(field.type));
+    mix(static_cast<uint64_t>(field.min));
+    mix(static_cast<uint64_t>(field.max));
+    mix(field.flags);
+  }
+  mix(kTelemetryItemMaxBytes);
+  mix(kTelemetryListMaxBytes);
+  return hash;
+}
+
+constexpr uint32_t kTelemetrySchemaFingerprint = TelemetrySchemaFingerprint();
+
+}  // namespace mccmod
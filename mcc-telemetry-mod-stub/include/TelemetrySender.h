@@ -0,0 +1,71 @@
+#pragma once
+
+#include "FixedTelemetrySnapshot.h"
+#include "TelemetryContract.h"
+#include "TelemetryOutbox.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mccmod {
+
+struct TelemetrySenderStats {
+  uint64_t submitted = 0;
+  uint64_t sent = 0;
+  // Posts that did not reach the receiver and were spooled instead.
+  uint64_t failed = 0;
+  uint64_t coalesced = 0;
+  uint64_t rejected = 0;
+  // Steady-clock ms from capture to the receiver acknowledging the post.
+  uint64_t last_latency_ms = 0;
+  TelemetryOutboxStats delivery;
+};
+
+// Posts snapshots to the telemetry receiver from a background thread.
+// Snapshots are validated on submit; while a post is in flight only the
+// newest pending snapshot per session is kept, so one busy session cannot
+// coalesce away another's updates. Delivery goes through a TelemetryOutbox,
+// so an unreachable receiver trips its circuit and fills the spool instead
+// of costing a connect attempt per snapshot.
+class TelemetrySender {
+ public:
+  TelemetrySender() = default;
+  ~TelemetrySender();
+
+  TelemetrySender(const TelemetrySender&) = delete;
+  TelemetrySender& operator=(const TelemetrySender&) = delete;
+
+  // An empty spool_path keeps undelivered snapshots in memory only.
+  bool Start(const std::string& endpoint, const std::string& spool_path = "");
+  // Sends whatever is still pending, then stops the sender thread.
+  void Stop();
+  // `captured_us` is DefaultClock().SteadyUs() when the snapshot was read.
+  bool Submit(const TelemetrySnapshot& snapshot, uint64_t captured_us,
+              std::string* validation_error = nullptr);
+  TelemetrySenderStats GetStats() const;
+
+ private:
+  // Fixed layout, so queueing and coalescing copy without allocating.
+  struct Pending {
+    FixedTelemetrySnapshot snapshot;
+    uint64_t captured_us = 0;
+  };
+
+  void WorkerLoop();
+
+  std::unique_ptr<TelemetryOutbox> outbox_;
+  std::thread worker_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  bool running_ = false;
+  std::vector<Pending> pending_;
+  TelemetrySenderStats stats_;
+};
+
+}  // namespace mccmod
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace mccmod {
+
+struct SpoolRecord {
+  // Assigned by Append(); increases through the file.
+  uint64_t seq = 0;
+  std::string session_id;
+  // Records of one session whose keys differ are a transition (lobby opened,
+  // map or mode changed, lobby closed); compaction never merges across one.
+  std::string state_key;
+  // Envelope exactly as it will be posted, idempotency key included.
+  std::string json;
+};
+
+// Bounded, append-only store for envelopes the receiver could not take.
+// The file is a sequence of lines:
+//   R <tab> seq <tab> session <tab> state key <tab> envelope json
+//   A <tab> seq        (every record up to seq was delivered)
+// Appends and acks only ever add lines. The file is rewritten in just two
+// cases: it is truncated once everything is acked, and it is compacted when
+// an append would exceed max_bytes. If compaction alone does not make room,
+// the oldest records are dropped. A torn final line from a crash is
+// discarded on Open(). An empty path keeps the spool in memory only.
+// Not thread-safe.
+class TelemetrySpool {
+ public:
+  static constexpr uint64_t kDefaultMaxBytes = 1024 * 1024;
+
+  explicit TelemetrySpool(const std::string& path, uint64_t max_bytes = kDefaultMaxBytes);
+
+  TelemetrySpool(const TelemetrySpool&) = delete;
+  TelemetrySpool& operator=(const TelemetrySpool&) = delete;
+
+  // Loads undelivered records left by a previous run. False if the file
+  // exists but cannot be rewritten; the spool then works in memory.
+  bool Open();
+  // Assigns record->seq. False only if the record alone exceeds max_bytes.
+  bool Append(SpoolRecord* record);
+  // Pending records to replay, oldest first: for every session the latest
+  // record plus each record that starts a new state_key.
+  std::vector<SpoolRecord> Compacted() const;
+  // Marks every record up to and including `seq` as delivered.
+  void Ack(uint64_t seq);
+
+  size_t Pending() const { return pending_.size(); }
+  uint64_t Bytes() const { return bytes_; }
+  uint64_t Dropped() const { return dropped_; }
+  // Records removed by on-disk compaction because the file was full.
+  uint64_t CompactedAway() const { return compacted_away_; }
+
+ private:
+  static std::string FormatRecord(const SpoolRecord& record);
+  void WriteLine(const std::string& line);
+  // Replaces the file with the current pending records.
+  void Rewrite();
+  void MakeRoom(uint64_t needed);
+
+  const std::string path_;
+  const uint64_t max_bytes_;
+  std::ofstream out_;
+  std::deque<SpoolRecord> pending_;
+  uint64_t next_seq_ = 1;
+  uint64_t bytes_ = 0;
+  uint64_t dropped_ = 0;
+  uint64_t compacted_away_ = 0;
+};
+
+}  // namespace mccmod
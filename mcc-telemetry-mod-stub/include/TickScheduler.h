@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Clock.h"
+#include "LatencyHistogram.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace mccmod {
+
+enum class MissedTickPolicy : uint8_t {
+  // Drop deadlines that already passed and stay on the original phase.
+  kSkip,
+  // Run missed ticks back to back, up to max_catch_up in a row, then skip the rest.
+  kCatchUp,
+};
+
+const char* MissedTickPolicyName(MissedTickPolicy policy);
+
+struct TickSchedulerOptions {
+  uint64_t period_us = 200000;
+  MissedTickPolicy missed = MissedTickPolicy::kSkip;
+  uint32_t max_catch_up = 4;
+};
+
+struct TickSchedulerStats {
+  uint64_t ticks = 0;
+  // Deadlines dropped under kSkip, or past max_catch_up under kCatchUp.
+  uint64_t missed = 0;
+  // Ticks run late, back to back, under kCatchUp.
+  uint64_t caught_up = 0;
+  // Waits ended early by the wake handle.
+  uint64_t interrupted = 0;
+  // How far past its deadline each tick started, in microseconds.
+  LatencySummary lateness_us;
+  // False when the platform fell back to a coarse timer.
+  bool high_resolution = false;
+};
+
+// Paces a loop on absolute deadlines (anchor + n * period), so time spent in
+// the loop body never accumulates as drift. On Linux it sleeps with
+// clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME), or on an absolute timerfd
+// when a wake handle is set. On Windows it uses a high-resolution waitable
+// timer, which avoids the default 15.6 ms timer tick. On a virtual clock it
+// sleeps through Clock::SleepUntil, so simulations stay deterministic.
+// WaitNextTick() belongs to one thread; GetStats() may be called from any.
+class TickScheduler {
+ public:
+  explicit TickScheduler(const TickSchedulerOptions& options, Clock& clock = DefaultClock());
+  ~TickScheduler();
+
+  TickScheduler(const TickScheduler&) = delete;
+  TickScheduler& operator=(const TickScheduler&) = delete;
+
+  // Applies from the next deadline on.
+  void SetPeriodUs(uint64_t period_us);
+  uint64_t PeriodUs() const { return options_.period_us; }
+  // An fd that turns readable (Linux) or an event that turns signaled
+  // (Windows) ends a wait early, e.g. ShutdownWakeHandle(). -1 clears it.
+  void SetWakeHandle(intptr_t handle);
+  // Restarts the schedule so the next deadline is one period from now.
+  void Reset();
+
+  // Sleeps until the next deadline and applies the missed-tick policy.
+  // Returns false if the wake handle ended the wait; the deadline stands.
+  bool WaitNextTick();
+
+  TickSchedulerStats GetStats() const;
+
+ private:
+  uint64_t NowUs() const;
+  // False when woken early by the wake handle.
+  bool SleepUntilUs(uint64_t deadline_us);
+
+  Clock& clock_;
+  TickSchedulerOptions options_;
+  uint64_t deadline_us_ = 0;
+  uint32_t catch_up_run_ = 0;
+  intptr_t wake_handle_ = -1;
+  // Windows waitable timer, or Linux timerfd once a wake handle is set.
+  intptr_t timer_ = -1;
+  bool high_resolution_ = false;
+
+  std::atomic<uint64_t> ticks_{0};
+  std::atomic<uint64_t> missed_{0};
+  std::atomic<uint64_t> caught_up_{0};
+  std::atomic<uint64_t> interrupted_{0};
+  LatencyHistogram lateness_us_;
+};
+
+}  // namespace mccmod
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace mccmod {
+
+// The MCC titles, in the order the launcher lists them. Tags are the stems of
+// the title DLLs (haloreach.dll and so on).
+enum class MccTitle : uint8_t {
+  kHaloCE,
+  kHalo2,
+  kHalo3,
+  kHalo3Odst,
+  kHaloReach,
+  kHalo4,
+  kCount,
+};
+
+constexpr uint8_t TitleBit(MccTitle title) {
+  return static_cast<uint8_t>(1u << static_cast<unsigned>(title));
+}
+
+constexpr uint8_t kMultiplayerTitles = TitleBit(MccTitle::kHaloCE) | TitleBit(MccTitle::kHalo2) |
+                                       TitleBit(MccTitle::kHalo3) | TitleBit(MccTitle::kHaloReach) |
+                                       TitleBit(MccTitle::kHalo4);
+
+const char* TitleTag(MccTitle title);
+const char* TitleDisplayName(MccTitle title);
+
+// Canonical map and gametype names. IDs are stable across releases and never
+// reused: maps are title * 100 + n (Halo 2 Anniversary maps continue Halo 2's
+// run), gametypes start at 1001. Append new entries; do not renumber.
+// Lookups ignore case and everything but ASCII letters and digits, so
+// "sword_base" and "SWORD BASE" both find Sword Base.
+//
+// MAP(id, title, display name)
+#define MCC_CATALOG_MAPS(MAP)              \
+  MAP(101, kHaloCE, "Battle Creek")        \
+  MAP(102, kHaloCE, "Blood Gulch")         \
+  MAP(103, kHaloCE, "Boarding Action")     \
+  MAP(104, kHaloCE, "Chill Out")           \
+  MAP(105, kHaloCE, "Chiron TL-34")        \
+  MAP(106, kHaloCE, "Damnation")           \
+  MAP(107, kHaloCE, "Danger Canyon")       \
+  MAP(108, kHaloCE, "Death Island")        \
+  MAP(109, kHaloCE, "Derelict")            \
+  MAP(110, kHaloCE, "Gephyrophobia")       \
+  MAP(111, kHaloCE, "Hang 'Em High")       \
+  MAP(112, kHaloCE, "Ice Fields")          \
+  MAP(113, kHaloCE, "Infinity")            \
+  MAP(114, kHaloCE, "Longest")             \
+  MAP(115, kHaloCE, "Prisoner")            \
+  MAP(116, kHaloCE, "Rat Race")            \
+  MAP(117, kHaloCE, "Sidewinder")          \
+  MAP(118, kHaloCE, "Timberland")          \
+  MAP(119, kHaloCE, "Wizard")              \
+  MAP(201, kHalo2, "Ascension")            \
+  MAP(202, kHalo2, "Backwash")             \
+  MAP(203, kHalo2, "Beaver Creek")         \
+  MAP(204, kHalo2, "Burial Mounds")        \
+  MAP(205, kHalo2, "Coagulation")          \
+  MAP(206, kHalo2, "Colossus")             \
+  MAP(207, kHalo2, "Containment")          \
+  MAP(208, kHalo2, "Desolation")           \
+  MAP(209, kHalo2, "District")             \
+  MAP(210, kHalo2, "Elongation")           \
+  MAP(211, kHalo2, "Foundation")           \
+  MAP(212, kHalo2, "Gemini")               \
+  MAP(213, kHalo2, "Headlong")             \
+  MAP(214, kHalo2, "Ivory Tower")          \
+  MAP(215, kHalo2, "Lockout")              \
+  MAP(216, kHalo2, "Midship")              \
+  MAP(217, kHalo2, "Relic")                \
+  MAP(218, kHalo2, "Sanctuary")            \
+  MAP(219, kHalo2, "Terminal")             \
+  MAP(220, kHalo2, "Tombstone")            \
+  MAP(221, kHalo2, "Turf")                 \
+  MAP(222, kHalo2, "Uplift")               \
+  MAP(223, kHalo2, "Warlock")              \
+  MAP(224, kHalo2, "Waterworks")           \
+  MAP(225, kHalo2, "Zanzibar")             \
+  MAP(226, kHalo2, "Awash")                \
+  MAP(227, kHalo2, "Bloodline")            \
+  MAP(228, kHalo2, "Lockdown")             \
+  MAP(229, kHalo2, "Nebula")               \
+  MAP(230, kHalo2, "Remnant")              \
+  MAP(231, kHalo2, "Shrine")               \
+  MAP(232, kHalo2, "Stonetown")            \
+  MAP(233, kHalo2, "Warlord")              \
+  MAP(234, kHalo2, "Zenith")               \
+  MAP(301, kHalo3, "Assembly")             \
+  MAP(302, kHalo3, "Avalanche")            \
+  MAP(303, kHalo3, "Blackout")             \
+  MAP(304, kHalo3, "Citadel")              \
+  MAP(305, kHalo3, "Cold Storage")         \
+  MAP(306, kHalo3, "Construct")            \
+  MAP(307, kHalo3, "Epitaph")              \
+  MAP(308, kHalo3, "Foundry")              \
+  MAP(309, kHalo3, "Ghost Town")           \
+  MAP(310, kHalo3, "Guardian")             \
+  MAP(311, kHalo3, "Heretic")              \
+  MAP(312, kHalo3, "High Ground")          \
+  MAP(313, kHalo3, "Isolation")            \
+  MAP(314, kHalo3, "Last Resort")          \
+  MAP(315, kHalo3, "Longshore")            \
+  MAP(316, kHalo3, "Narrows")              \
+  MAP(317, kHalo3, "Orbital")              \
+  MAP(318, kHalo3, "Rat's Nest")           \
+  MAP(319, kHalo3, "Sandbox")              \
+  MAP(320, kHalo3, "Sandtrap")             \
+  MAP(321, kHalo3, "Snowbound")            \
+  MAP(322, kHalo3, "Standoff")             \
+  MAP(323, kHalo3, "The Pit")              \
+  MAP(324, kHalo3, "Valhalla")             \
+  MAP(401, kHalo3Odst, "Alpha Site")       \
+  MAP(402, kHalo3Odst, "Chasm Ten")        \
+  MAP(403, kHalo3Odst, "Crater")           \
+  MAP(404, kHalo3Odst, "Crater (Night)")   \
+  MAP(405, kHalo3Odst, "Last Exit")        \
+  MAP(406, kHalo3Odst, "Lost Platoon")     \
+  MAP(407, kHalo3Odst, "Rally (Night)")    \
+  MAP(408, kHalo3Odst, "Rally Point")      \
+  MAP(409, kHalo3Odst, "Security Zone")    \
+  MAP(410, kHalo3Odst, "Windward")         \
+  MAP(501, kHaloReach, "Boardwalk")        \
+  MAP(502, kHaloReach, "Boneyard")         \
+  MAP(503, kHaloReach, "Countdown")        \
+  MAP(504, kHaloReach, "Powerhouse")       \
+  MAP(505, kHaloReach, "Reflection")       \
+  MAP(506, kHaloReach, "Spire")            \
+  MAP(507, kHaloReach, "Sword Base")       \
+  MAP(508, kHaloReach, "Zealot")           \
+  MAP(509, kHaloReach, "Forge World")      \
+  MAP(510, kHaloReach, "Asylum")           \
+  MAP(511, kHaloReach, "Hemorrhage")       \
+  MAP(512, kHaloReach, "Paradiso")         \
+  MAP(513, kHaloReach, "Pinnacle")         \
+  MAP(514, kHaloReach, "The Cage")         \
+  MAP(515, kHaloReach, "Anchor 9")         \
+  MAP(516, kHaloReach, "Breakpoint")       \
+  MAP(517, kHaloReach, "Tempest")          \
+  MAP(518, kHaloReach, "Condemned")        \
+  MAP(519, kHaloReach, "Highlands")        \
+  MAP(520, kHaloReach, "Battle Canyon")    \
+  MAP(521, kHaloReach, "Breakneck")        \
+  MAP(522, kHaloReach, "High Noon")        \
+  MAP(523, kHaloReach, "Penance")          \
+  MAP(524, kHaloReach, "Ridgeline")        \
+  MAP(525, kHaloReach, "Solitary")         \
+  MAP(601, kHalo4, "Abandon")              \
+  MAP(602, kHalo4, "Adrift")               \
+  MAP(603, kHalo4, "Complex")              \
+  MAP(604, kHalo4, "Daybreak")             \
+  MAP(605, kHalo4, "Erosion")              \
+  MAP(606, kHalo4, "Exile")                \
+  MAP(607, kHalo4, "Harvest")              \
+  MAP(608, kHalo4, "Haven")                \
+  MAP(609, kHalo4, "Impact")               \
+  MAP(610, kHalo4, "Landfall")             \
+  MAP(611, kHalo4, "Longbow")              \
+  MAP(612, kHalo4, "Meltdown")             \
+  MAP(613, kHalo4, "Monolith")             \
+  MAP(614, kHalo4, "Outcast")              \
+  MAP(615, kHalo4, "Perdition")            \
+  MAP(616, kHalo4, "Pitfall")              \
+  MAP(617, kHalo4, "Ragnarok")             \
+  MAP(618, kHalo4, "Ravine")               \
+  MAP(619, kHalo4, "Shatter")              \
+  MAP(620, kHalo4, "Skyline")              \
+  MAP(621, kHalo4, "Solace")               \
+  MAP(622, kHalo4, "Vertigo")              \
+  MAP(623, kHalo4, "Vortex")               \
+  MAP(624, kHalo4, "Wreckage")
+
+#define MCC_CATALOG_H2_H3_REACH \
+  (TitleBit(MccTitle::kHalo2) | TitleBit(MccTitle::kHalo3) | TitleBit(MccTitle::kHaloReach))
+
+// MODE(id, title bitmask, display name)
+#define MCC_CATALOG_GAME_MODES(MODE)                                                          \
+  MODE(1001, kMultiplayerTitles, "Slayer")                                                    \
+  MODE(1002, kMultiplayerTitles, "Team Slayer")                                               \
+  MODE(1003, kMultiplayerTitles, "Capture the Flag")                                          \
+  MODE(1004, MCC_CATALOG_H2_H3_REACH, "Multi Flag")                                           \
+  MODE(1005, MCC_CATALOG_H2_H3_REACH, "One Flag")                                             \
+  MODE(1006, MCC_CATALOG_H2_H3_REACH, "Assault")                                              \
+  MODE(1007, MCC_CATALOG_H2_H3_REACH, "Neutral Bomb")                                         \
+  MODE(1008, MCC_CATALOG_H2_H3_REACH, "One Bomb")                                             \
+  MODE(1009, kMultiplayerTitles, "King of the Hill")                                          \
+  MODE(1010, MCC_CATALOG_H2_H3_REACH | TitleBit(MccTitle::kHalo4), "Crazy King")              \
+  MODE(1011, kMultiplayerTitles, "Oddball")                                                   \
+  MODE(1012, MCC_CATALOG_H2_H3_REACH, "Juggernaut")                                           \
+  MODE(1013, MCC_CATALOG_H2_H3_REACH, "Territories")                                          \
+  MODE(1014, TitleBit(MccTitle::kHalo3) | TitleBit(MccTitle::kHaloReach), "Infection")        \
+  MODE(1015, TitleBit(MccTitle::kHalo3), "VIP")                                               \
+  MODE(1016, TitleBit(MccTitle::kHaloCE), "Race")                                             \
+  MODE(1017, TitleBit(MccTitle::kHaloReach), "Headhunter")                                    \
+  MODE(1018, TitleBit(MccTitle::kHaloReach), "Stockpile")                                     \
+  MODE(1019, TitleBit(MccTitle::kHaloReach), "Invasion")                                      \
+  MODE(1020, MCC_CATALOG_H2_H3_REACH | TitleBit(MccTitle::kHalo4), "Forge")                   \
+  MODE(1021, TitleBit(MccTitle::kHalo3Odst) | TitleBit(MccTitle::kHaloReach), "Firefight")    \
+  MODE(1022, TitleBit(MccTitle::kHalo4), "Regicide")                                          \
+  MODE(1023, TitleBit(MccTitle::kHalo4), "Flood")                                             \
+  MODE(1024, TitleBit(MccTitle::kHalo4), "Dominion")                                          \
+  MODE(1025, TitleBit(MccTitle::kHalo4), "Extraction")                                        \
+  MODE(1026, TitleBit(MccTitle::kHalo4), "Ricochet")                                          \
+  MODE(1027, TitleBit(MccTitle::kHalo3) | TitleBit(MccTitle::kHaloReach) |                    \
+                 TitleBit(MccTitle::kHalo4),                                                  \
+       "Grifball")
+
+enum class CatalogKind : uint8_t {
+  kMap,
+  kGameMode,
+};
+
+struct CatalogEntry {
+  uint16_t id;
+  CatalogKind kind;
+  // TitleBit() of every title the entry belongs to; one bit for maps.
+  uint8_t titles;
+  const char* display_name;
+
+  // The lowest title in `titles`; for a map, its title.
+  constexpr MccTitle Title() const {
+    uint8_t title = 0;
+    while (title < static_cast<uint8_t>(MccTitle::kCount) && !(titles & (1u << title))) ++title;
+    return static_cast<MccTitle>(title);
+  }
+};
+
+#define MCC_CATALOG_MAP_ENTRY(id, title, name) \
+  CatalogEntry{id, CatalogKind::kMap, TitleBit(MccTitle::title), name},
+#define MCC_CATALOG_MODE_ENTRY(id, titles, name) CatalogEntry{id, CatalogKind::kGameMode, titles, name},
+inline constexpr CatalogEntry kCatalogMaps[] = {MCC_CATALOG_MAPS(MCC_CATALOG_MAP_ENTRY)};
+inline constexpr CatalogEntry kCatalogGameModes[] = {MCC_CATALOG_GAME_MODES(MCC_CATALOG_MODE_ENTRY)};
+#undef MCC_CATALOG_MAP_ENTRY
+#undef MCC_CATALOG_MODE_ENTRY
+
+// Perfect-hash lookups over the normalized names: one hash of the input and
+// one comparison, no allocation. nullptr when the name is not in the catalog.
+const CatalogEntry* FindCatalogMap(std::string_view name);
+const CatalogEntry* FindCatalogGameMode(std::string_view name);
+// Either kind; nullptr for an unknown or retired ID.
+const CatalogEntry* FindCatalogId(uint16_t id);
+
+}  // namespace mccmod
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace mccmod {
+
+// Lock-free single-producer/single-consumer triple buffer. The producer fills
+// WriteSlot() and publishes it; the consumer always takes the newest published
+// value and never blocks the producer. Unconsumed values are overwritten.
+template <typename T>
+class TripleBuffer {
+ public:
+  T& WriteSlot() { return slots_[write_]; }
+
+  void Publish() {
+    const uint8_t previous =
+        middle_.exchange(static_cast<uint8_t>(write_ | kFreshBit), std::memory_order_acq_rel);
+    write_ = previous & kIndexMask;
+  }
+
+  bool HasNew() const { return (middle_.load(std::memory_order_acquire) & kFreshBit) != 0; }
+
+  // Swaps the newest published value into ReadSlot(); false if nothing new.
+  bool Consume() {
+    if (!HasNew()) return false;
+    const uint8_t previous = middle_.exchange(read_, std::memory_order_acq_rel);
+    read_ = previous & kIndexMask;
+    return true;
+  }
+
+  const T& ReadSlot() const { return slots_[read_]; }
+
+ private:
+  static constexpr uint8_t kIndexMask = 0x3;
+  static constexpr uint8_t kFreshBit = 0x4;
+
+  std::array<T, 3> slots_{};
+  alignas(64) uint8_t write_ = 0;
+  alignas(64) std::atomic<uint8_t> middle_{1};
+  alignas(64) uint8_t read_ = 2;
+};
+
+}  // namespace mccmod
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mccmod {
+
+// Small fixed-size thread pool. Tasks run in submission order across the
+// workers; a task that blocks only ties up its own worker.
+class WorkerPool {
+ public:
+  WorkerPool() = default;
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  bool Start(size_t threads);
+  // Waits for running tasks to return; tasks still queued are dropped.
+  void Stop();
+  // Like Stop(), but gives up after timeout_ms and detaches the workers still
+  // inside a task, e.g. one blocked on a hung process. Returns false if any
+  // were detached; they exit when their task returns.
+  bool Stop(uint64_t timeout_ms);
+  bool Submit(std::function<void()> task);
+  size_t QueueDepth() const;
+  size_t Size() const { return workers_.size(); }
+
+ private:
+  // Shared with the workers, so a detached one can still finish its task,
+  // find the pool stopped and exit after the WorkerPool is gone.
+  struct State {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable exited;
+    std::deque<std::function<void()>> tasks;
+    bool running = false;
+    size_t live_workers = 0;
+  };
+
+  static void WorkerLoop(std::shared_ptr<State> state);
+
+  std::vector<std::thread> workers_;
+  std::shared_ptr<State> state_ = std::make_shared<State>();
+};
+
+}  // namespace mccmod
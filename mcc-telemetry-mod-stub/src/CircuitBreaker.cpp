@@ -0,0 +1,68 @@
+#include "CircuitBreaker.h"
+
+#include <algorithm>
+
+namespace mccmod {
+
+const char* CircuitStateName(CircuitState state) {
+  switch (state) {
+    case CircuitState::kClosed:
+      return "closed";
+    case CircuitState::kOpen:
+      return "open";
+    case CircuitState::kHalfOpen:
+      return "half-open";
+  }
+  return "unknown";
+}
+
+bool CircuitBreaker::Allow(uint64_t now_ms) {
+  switch (state_) {
+    case CircuitState::kClosed:
+      return true;
+    case CircuitState::kOpen:
+      if (now_ms < retry_at_ms_) {
+        ++rejected_;
+        return false;
+      }
+      state_ = CircuitState::kHalfOpen;
+      probe_in_flight_ = true;
+      return true;
+    case CircuitState::kHalfOpen:
+      if (probe_in_flight_) {
+        ++rejected_;
+        return false;
+      }
+      probe_in_flight_ = true;
+      return true;
+  }
+  return false;
+}
+
+void CircuitBreaker::RecordSuccess() {
+  state_ = CircuitState::kClosed;
+  consecutive_failures_ = 0;
+  backoff_ms_ = 0;
+  probe_in_flight_ = false;
+}
+
+void CircuitBreaker::RecordFailure(uint64_t now_ms) {
+  probe_in_flight_ = false;
+  if (state_ == CircuitState::kHalfOpen) {
+    backoff_ms_ = std::min(options_.max_backoff_ms, backoff_ms_ * 2);
+    Open(now_ms);
+    return;
+  }
+  if (state_ == CircuitState::kClosed && ++consecutive_failures_ >= options_.failure_threshold) {
+    backoff_ms_ = std::min(options_.max_backoff_ms, options_.base_backoff_ms);
+    Open(now_ms);
+  }
+}
+
+void CircuitBreaker::Open(uint64_t now_ms) {
+  if (state_ != CircuitState::kOpen) ++opens_;
+  state_ = CircuitState::kOpen;
+  retry_at_ms_ = now_ms + backoff_ms_;
+}
+
+}  // namespace mccmod
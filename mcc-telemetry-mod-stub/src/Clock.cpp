@@ -0,0 +1,120 @@
+#include "Clock.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace mccmod {
+namespace {
+
+class RealClock : public Clock {
+ public:
+  uint64_t SteadyMs() override {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+  }
+
+  int64_t WallMs() override {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+  }
+
+  uint64_t SteadyUs() override {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+  }
+
+  int64_t WallUs() override {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void SleepUntil(uint64_t deadline_ms) override {
+    const uint64_t now = SteadyMs();
+    if (deadline_ms > now) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(deadline_ms - now));
+    }
+  }
+};
+
+std::atomic<Clock*> g_default_clock{nullptr};
+
+}  // namespace
+
+Clock& SystemClock() {
+  static RealClock clock;
+  return clock;
+}
+
+Clock& DefaultClock() {
+  Clock* clock = g_default_clock.load(std::memory_order_acquire);
+  return clock ? *clock : SystemClock();
+}
+
+void SetDefaultClock(Clock* clock) {
+  g_default_clock.store(clock, std::memory_order_release);
+}
+
+uint64_t VirtualClock::SteadyMs() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return now_ms_;
+}
+
+int64_t VirtualClock::WallMs() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return wall_origin_ms_ + static_cast<int64_t>(now_ms_);
+}
+
+void VirtualClock::SleepUntil(uint64_t deadline_ms) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (deadline_ms <= now_ms_) return;
+
+  ++sleepers_[deadline_ms];
+  ++sleeping_;
+  AdvanceIfIdleLocked();
+  wake_.wait(lock, [this, deadline_ms] { return now_ms_ >= deadline_ms; });
+
+  auto it = sleepers_.find(deadline_ms);
+  if (--it->second == 0) sleepers_.erase(it);
+  --sleeping_;
+  ++wakeups_;
+}
+
+void VirtualClock::Advance(uint64_t duration_ms) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    now_ms_ += duration_ms;
+  }
+  wake_.notify_all();
+}
+
+void VirtualClock::AddParticipant() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++participants_;
+}
+
+void VirtualClock::RemoveParticipant() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  --participants_;
+  AdvanceIfIdleLocked();
+}
+
+uint64_t VirtualClock::Wakeups() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return wakeups_;
+}
+
+void VirtualClock::AdvanceIfIdleLocked() {
+  if (sleepers_.empty() || sleeping_ < participants_) return;
+  const uint64_t earliest = sleepers_.begin()->first;
+  if (earliest > now_ms_) {
+    now_ms_ = earliest;
+  }
+  wake_.notify_all();
+}
+
+}  // namespace mccmod
@@ -0,0 +1,70 @@
+#include "FixedTelemetrySnapshot.h"
+
+#include <limits>
+
+namespace mccmod {
+namespace {
+
+bool ToFixedField(bool value, bool* out) {
+  *out = value;
+  return true;
+}
+
+bool ToFixedField(int value, int32_t* out) {
+  static_assert(std::numeric_limits<int>::digits <= std::numeric_limits<int32_t>::digits,
+                "int fields must fit int32_t.");
+  *out = value;
+  return true;
+}
+
+template <size_t N>
+bool ToFixedField(const std::string& value, FixedString<N>* out) {
+  return out->Assign(value);
+}
+
+template <size_t MaxItems, size_t Bytes>
+bool ToFixedField(const std::vector<std::string>& value, FixedStringList<MaxItems, Bytes>* out) {
+  for (const std::string& item : value) {
+    if (!out->Append(item)) return false;
+  }
+  return true;
+}
+
+void FromFixedField(bool value, bool* out) {
+  *out = value;
+}
+
+void FromFixedField(int32_t value, int* out) {
+  *out = value;
+}
+
+template <size_t N>
+void FromFixedField(const FixedString<N>& value, std::string* out) {
+  out->assign(value.data, value.size);
+}
+
+template <size_t MaxItems, size_t Bytes>
+void FromFixedField(const FixedStringList<MaxItems, Bytes>& value, std::vector<std::string>* out) {
+  out->clear();
+  out->reserve(value.count);
+  value.ForEach([out](std::string_view item) { out->emplace_back(item); });
+}
+
+}  // namespace
+
+bool ToFixedSnapshot(const TelemetrySnapshot& snapshot, FixedTelemetrySnapshot* out) {
+  *out = FixedTelemetrySnapshot{};
+#define MCC_SCHEMA_TO_FIXED(type, member, key, min, max, flags) \
+  if (!ToFixedField(snapshot.member, &out->member)) out->truncated |= 1u << kTelemetryField_##member;
+  MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_TO_FIXED)
+#undef MCC_SCHEMA_TO_FIXED
+  return out->truncated == 0;
+}
+
+void FromFixedSnapshot(const FixedTelemetrySnapshot& fixed, TelemetrySnapshot* out) {
+#define MCC_SCHEMA_FROM_FIXED(type, member, key, min, max, flags) FromFixedField(fixed.member, &out->member);
+  MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_FROM_FIXED)
+#undef MCC_SCHEMA_FROM_FIXED
+}
+
+}  // namespace mccmod
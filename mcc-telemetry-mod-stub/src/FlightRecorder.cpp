@@ -0,0 +1,240 @@
+#include "FlightRecorder.h"
+
+#include "TelemetryContract.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <type_traits>
+
+namespace mccmod {
+
+namespace {
+
+static_assert(std::is_trivially_copyable<FlightRecord>::value,
+              "FlightRecord is copied into a file mapping");
+static_assert(sizeof(FlightFileHeader) == 64, "Flight recorder header layout changed");
+
+std::string FlightString(const char (&value)[kFlightNameBytes]) {
+  return std::string(value, strnlen(value, kFlightNameBytes));
+}
+
+}  // namespace
+
+FlightRecorder::~FlightRecorder() {
+  Close();
+}
+
+bool FlightRecorder::Open(const std::string& path, uint32_t capacity) {
+  Close();
+  if (path.empty() || capacity == 0) return false;
+
+  const size_t total_bytes = sizeof(FlightFileHeader) + static_cast<size_t>(capacity) * sizeof(FlightRecord);
+  void* view = nullptr;
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return false;
+
+  LARGE_INTEGER size{};
+  size.QuadPart = static_cast<LONGLONG>(total_bytes);
+  LARGE_INTEGER current{};
+  if (!GetFileSizeEx(file, &current) || current.QuadPart != size.QuadPart) {
+    if (!SetFilePointerEx(file, size, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+      CloseHandle(file);
+      return false;
+    }
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+  if (!mapping) {
+    CloseHandle(file);
+    return false;
+  }
+  view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, total_bytes);
+  if (!view) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+  file_ = reinterpret_cast<intptr_t>(file);
+  mapping_ = reinterpret_cast<intptr_t>(mapping);
+#else
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) return false;
+
+  struct stat info {};
+  if (fstat(fd, &info) != 0 ||
+      (static_cast<size_t>(info.st_size) != total_bytes &&
+       ftruncate(fd, static_cast<off_t>(total_bytes)) != 0)) {
+    close(fd);
+    return false;
+  }
+
+  view = mmap(nullptr, total_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (view == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+  file_ = fd;
+#endif
+
+  mapped_bytes_ = total_bytes;
+  header_ = static_cast<FlightFileHeader*>(view);
+  records_ = reinterpret_cast<FlightRecord*>(static_cast<char*>(view) + sizeof(FlightFileHeader));
+
+  // Keep appending to a compatible ring from a previous run; otherwise start fresh.
+  if (header_->magic != kFlightRecorderMagic || header_->version != kFlightRecorderVersion ||
+      header_->record_size != sizeof(FlightRecord) || header_->capacity != capacity) {
+    std::memset(view, 0, total_bytes);
+    header_->magic = kFlightRecorderMagic;
+    header_->version = kFlightRecorderVersion;
+    header_->record_size = sizeof(FlightRecord);
+    header_->capacity = capacity;
+  }
+  return true;
+}
+
+void FlightRecorder::Close() {
+  if (!header_) return;
+
+#if defined(_WIN32)
+  FlushViewOfFile(header_, 0);
+  UnmapViewOfFile(header_);
+  CloseHandle(reinterpret_cast<HANDLE>(mapping_));
+  CloseHandle(reinterpret_cast<HANDLE>(file_));
+#else
+  munmap(header_, mapped_bytes_);
+  close(static_cast<int>(file_));
+#endif
+
+  header_ = nullptr;
+  records_ = nullptr;
+  mapped_bytes_ = 0;
+  file_ = -1;
+  mapping_ = 0;
+}
+
+void FlightRecorder::Append(FlightRecord record) {
+  if (!records_) return;
+
+  const uint64_t seq = header_->next_seq + 1;
+  FlightRecord& slot = records_[(seq - 1) % header_->capacity];
+
+  record.seq = seq;
+  record.commit_seq = 0;
+  slot.commit_seq = 0;
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(&slot, &record, sizeof(FlightRecord));
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.commit_seq = seq;
+  header_->next_seq = seq;
+}
+
+void CopyFlightString(char (&dest)[kFlightNameBytes], const std::string& value) {
+  const size_t length = std::min(value.size(), kFlightNameBytes - 1);
+  std::memcpy(dest, value.data(), length);
+  dest[length] = '\0';
+}
+
+bool ReadFlightRecords(const std::string& path, std::vector<FlightRecord>* out,
+                       std::string* error) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) {
+    if (error) *error = "Cannot open " + path;
+    return false;
+  }
+
+  FlightFileHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      header.magic != kFlightRecorderMagic) {
+    if (error) *error = "Not a flight recorder file.";
+    return false;
+  }
+  // Version 1 records are the same size; their source mask was padding.
+  const bool version_1 = header.version == 1;
+  if ((header.version != kFlightRecorderVersion && !version_1) || header.record_size != sizeof(FlightRecord)) {
+    if (error) *error = "Unsupported flight recorder version.";
+    return false;
+  }
+
+  out->clear();
+  FlightRecord record;
+  for (uint32_t i = 0; i < header.capacity; ++i) {
+    if (!file.read(reinterpret_cast<char*>(&record), sizeof(record))) break;
+    if (record.seq != 0 && record.commit_seq == record.seq) {
+      if (version_1) record.player_source_mask = 0;
+      out->push_back(record);
+    }
+  }
+
+  std::sort(out->begin(), out->end(),
+            [](const FlightRecord& a, const FlightRecord& b) { return a.seq < b.seq; });
+  return true;
+}
+
+std::string FlightRecordToJson(const FlightRecord& record) {
+  auto flag = [&record](uint8_t bit) { return (record.flags & bit) ? "true" : "false"; };
+
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "{";
+  out << "\"seq\":" << record.seq << ",";
+  out << "\"steadyMs\":" << record.steady_ms << ",";
+  out << "\"wallMs\":" << record.wall_ms << ",";
+  out << "\"pid\":" << record.pid << ",";
+  out << "\"connected\":" << flag(kFlightConnected) << ",";
+  out << "\"inMenus\":" << flag(kFlightInMenus) << ",";
+  out << "\"candidates\":{";
+  out << "\"players\":[";
+  for (uint8_t i = 0; i < record.player_candidate_count && i < kFlightPlayerSources; ++i) {
+    if (i > 0) out << ",";
+    out << record.player_candidates[i];
+  }
+  out << "],";
+  out << "\"playerSourceMask\":" << static_cast<int>(record.player_source_mask) << ",";
+  out << "\"map\":[";
+  if (record.map_candidate_count > 0) {
+    out << "\"" << EscapeJson(FlightString(record.map_candidate)) << "\"";
+  }
+  out << "],";
+  out << "\"mode\":[";
+  for (uint8_t i = 0; i < record.mode_candidate_count && i < kFlightModeSources; ++i) {
+    if (i > 0) out << ",";
+    out << "\"" << EscapeJson(FlightString(record.mode_candidates[i])) << "\"";
+  }
+  out << "]},";
+  out << "\"playerCount\":" << record.player_count << ",";
+  out << "\"mapName\":\"" << EscapeJson(FlightString(record.map_name)) << "\",";
+  out << "\"modeName\":\"" << EscapeJson(FlightString(record.mode_name)) << "\",";
+  out << "\"updated\":{";
+  out << "\"map\":" << flag(kFlightMapUpdated) << ",";
+  out << "\"mode\":" << flag(kFlightModeUpdated) << ",";
+  out << "\"players\":" << flag(kFlightPlayersUpdated) << "},";
+  out << "\"confidence\":{";
+  out << "\"map\":" << record.map_confidence << ",";
+  out << "\"mode\":" << record.mode_confidence << ",";
+  out << "\"players\":" << record.player_confidence << "},";
+  out << "\"timingsUs\":{";
+  out << "\"read\":" << record.read_us << ",";
+  out << "\"filter\":" << record.filter_us << ",";
+  out << "\"tick\":" << record.tick_us << "}";
+  out << "}";
+  return out.str();
+}
+
+}  // namespace mccmod
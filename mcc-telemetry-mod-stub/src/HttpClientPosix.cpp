@@ -0,0 +1,293 @@
+#include "HttpClientWinHttp.h"
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cstdlib>
+#include <string>
+
+namespace mccmod {
+namespace {
+
+constexpr int kSocketTimeoutSeconds = 5;
+
+struct ParsedUrl {
+  std::string host;
+  std::string port = "80";
+  std::string path = "/";
+};
+
+// Plain http:// only; TLS endpoints need the WinHTTP build.
+bool ParseUrl(const std::string& url, ParsedUrl* out) {
+  const std::string scheme = "http://";
+  if (url.compare(0, scheme.size(), scheme) != 0) return false;
+
+  const std::string rest = url.substr(scheme.size());
+  const size_t slash = rest.find('/');
+  std::string authority = rest.substr(0, slash);
+  if (slash != std::string::npos) {
+    out->path = rest.substr(slash);
+  }
+
+  const size_t colon = authority.rfind(':');
+  if (colon != std::string::npos && authority.find(']') == std::string::npos) {
+    out->port = authority.substr(colon + 1);
+    authority.resize(colon);
+  }
+  out->host = authority;
+  return !out->host.empty() && !out->port.empty();
+}
+
+bool SendAll(int fd, const std::string& data) {
+  size_t offset = 0;
+  while (offset < data.size()) {
+    const ssize_t sent = send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+    if (sent <= 0) return false;
+    offset += static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+int Connect(const ParsedUrl& parsed) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* addresses = nullptr;
+  if (getaddrinfo(parsed.host.c_str(), parsed.port.c_str(), &hints, &addresses) != 0) {
+    return -1;
+  }
+
+  int fd = -1;
+  for (addrinfo* address = addresses; address; address = address->ai_next) {
+    fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+    if (fd < 0) continue;
+    timeval timeout{kSocketTimeoutSeconds, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) break;
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(addresses);
+  return fd;
+}
+
+std::string BuildRequest(const ParsedUrl& parsed, const std::string& json_body, bool keep_alive) {
+  std::string request = "POST " + parsed.path + " HTTP/1.1\r\n";
+  request += "Host: " + parsed.host + "\r\n";
+  request += "User-Agent: MccTelemetryMod/1.0\r\n";
+  request += "Content-Type: application/json\r\n";
+  request += "Content-Length: " + std::to_string(json_body.size()) + "\r\n";
+  request += keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+  request += json_body;
+  return request;
+}
+
+bool ParseStatusLine(const std::string& response, HttpResponse* result) {
+  const size_t space = response.find(' ');
+  if (response.compare(0, 5, "HTTP/") != 0 || space == std::string::npos) {
+    result->error = "Failed to read HTTP status code.";
+    return false;
+  }
+  result->status_code = std::strtoul(response.c_str() + space + 1, nullptr, 10);
+  result->ok = result->status_code >= 200 && result->status_code < 300;
+  if (!result->ok) {
+    result->error = "Receiver returned non-success status.";
+  }
+  return true;
+}
+
+std::string LowerCopy(std::string value) {
+  for (char& c : value) {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return value;
+}
+
+// Buffered reads off a kept-alive socket.
+class SocketReader {
+ public:
+  explicit SocketReader(int fd) : fd_(fd) {}
+
+  bool ReadLine(std::string* line) {
+    size_t end;
+    while ((end = buffer_.find("\r\n")) == std::string::npos) {
+      if (!Fill()) return false;
+    }
+    line->assign(buffer_, 0, end);
+    buffer_.erase(0, end + 2);
+    return true;
+  }
+
+  // Moves the next `bytes` bytes onto the end of *out.
+  bool Read(size_t bytes, std::string* out) {
+    while (buffer_.size() < bytes) {
+      if (!Fill()) return false;
+    }
+    out->append(buffer_, 0, bytes);
+    buffer_.erase(0, bytes);
+    return true;
+  }
+
+  // Whatever has arrived; for a body that runs to the end of the connection.
+  void TakeBuffered(std::string* out) {
+    out->append(buffer_);
+    buffer_.clear();
+  }
+
+  // Bytes that arrived past the response; nonzero means the stream is out of sync.
+  size_t Leftover() const { return buffer_.size(); }
+
+ private:
+  bool Fill() {
+    char chunk[4096];
+    const ssize_t received = recv(fd_, chunk, sizeof(chunk), 0);
+    if (received <= 0) return false;
+    buffer_.append(chunk, static_cast<size_t>(received));
+    return true;
+  }
+
+  int fd_;
+  std::string buffer_;
+};
+
+// Reads one whole response, body included, so the next one starts on a clean
+// stream. Clears *keep_alive when the server will not take another request.
+bool ReadResponse(int fd, HttpResponse* result, bool* keep_alive) {
+  SocketReader reader(fd);
+  std::string line;
+  if (!reader.ReadLine(&line) || !ParseStatusLine(line, result)) {
+    if (result->error.empty()) result->error = "Failed to read HTTP status code.";
+    return false;
+  }
+
+  long long content_length = -1;
+  bool chunked = false;
+  while (reader.ReadLine(&line) && !line.empty()) {
+    const size_t colon = line.find(':');
+    if (colon == std::string::npos) continue;
+    const std::string name = LowerCopy(line.substr(0, colon));
+    const std::string value = LowerCopy(line.substr(colon + 1));
+    if (name == "content-length") {
+      content_length = std::strtoll(value.c_str(), nullptr, 10);
+    } else if (name == "transfer-encoding" && value.find("chunked") != std::string::npos) {
+      chunked = true;
+    } else if (name == "connection" && value.find("close") != std::string::npos) {
+      *keep_alive = false;
+    }
+  }
+  if (!line.empty()) return false;
+
+  if (chunked) {
+    while (true) {
+      if (!reader.ReadLine(&line)) return false;
+      const size_t size = std::strtoul(line.c_str(), nullptr, 16);
+      if (size == 0) break;
+      if (!reader.Read(size, &result->body) || !reader.ReadLine(&line)) return false;
+    }
+    // Trailers, then the blank line that ends the message.
+    while (reader.ReadLine(&line) && !line.empty()) {
+    }
+  } else if (content_length >= 0) {
+    if (!reader.Read(static_cast<size_t>(content_length), &result->body)) return false;
+  } else {
+    // No framing: the body runs to the end of the connection. Keep what
+    // came with the headers and drop the connection.
+    reader.TakeBuffered(&result->body);
+    *keep_alive = false;
+  }
+  if (reader.Leftover() != 0) *keep_alive = false;
+  return true;
+}
+
+}  // namespace
+
+HttpResponse HttpPostJson(const std::string& url, const std::string& json_body) {
+  HttpResponse result;
+
+  ParsedUrl parsed;
+  if (!ParseUrl(url, &parsed)) {
+    result.error = "Failed to parse endpoint URL.";
+    return result;
+  }
+
+  const int fd = Connect(parsed);
+  if (fd < 0) {
+    result.error = "Connect failed.";
+    return result;
+  }
+
+  if (!SendAll(fd, BuildRequest(parsed, json_body, false))) {
+    close(fd);
+    result.error = "HTTP request failed.";
+    return result;
+  }
+
+  // Only the status line matters; read until it is complete.
+  std::string response;
+  char buffer[512];
+  while (response.find("\r\n") == std::string::npos) {
+    const ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+    if (received <= 0) break;
+    response.append(buffer, static_cast<size_t>(received));
+  }
+  close(fd);
+
+  ParseStatusLine(response, &result);
+  return result;
+}
+
+HttpConnection::HttpConnection(const std::string& url) : url_(url) {}
+
+HttpConnection::~HttpConnection() {
+  Close();
+}
+
+void HttpConnection::Close() {
+  if (socket_ >= 0) {
+    close(static_cast<int>(socket_));
+    socket_ = -1;
+  }
+}
+
+HttpResponse HttpConnection::PostJson(const std::string& json_body) {
+  HttpResponse result;
+
+  ParsedUrl parsed;
+  if (!ParseUrl(url_, &parsed)) {
+    result.error = "Failed to parse endpoint URL.";
+    return result;
+  }
+  const std::string request = BuildRequest(parsed, json_body, true);
+
+  // A reused socket may have been closed by the server while idle; retry once on a fresh one.
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    const bool reused = socket_ >= 0;
+    if (!reused) {
+      socket_ = Connect(parsed);
+      if (socket_ < 0) {
+        result.error = "Connect failed.";
+        return result;
+      }
+      ++connects_;
+    }
+
+    result = HttpResponse{};
+    bool keep_alive = true;
+    const int fd = static_cast<int>(socket_);
+    if (SendAll(fd, request) && ReadResponse(fd, &result, &keep_alive)) {
+      if (!keep_alive) Close();
+      return result;
+    }
+    Close();
+    if (!reused) break;
+  }
+  result.ok = false;
+  if (result.error.empty()) result.error = "HTTP request failed.";
+  return result;
+}
+
+}  // namespace mccmod
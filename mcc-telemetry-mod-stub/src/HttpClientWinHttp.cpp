@@ -61,38 +61,22 @@ bool ParseUrl(const std::string& url, ParsedUrl* out) {
   return true;
 }
 
-}  // namespace
+HINTERNET OpenSession() {
+  return WinHttpOpen(L"MccTelemetryMod/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+                     WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+}
 
-HttpResponse HttpPostJson(const std::string& url, const std::string& json_body) {
+// One POST on an open connection. The body is drained so WinHTTP can hand the
+// socket back to its keep-alive pool.
+HttpResponse PostOnConnection(HINTERNET connection, const ParsedUrl& parsed,
+                              const std::string& json_body) {
   HttpResponse result;
 
-  ParsedUrl parsed;
-  if (!ParseUrl(url, &parsed)) {
-    result.error = "Failed to parse endpoint URL.";
-    return result;
-  }
-
-  HINTERNET session = WinHttpOpen(L"MccTelemetryMod/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-                                  WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
-  if (!session) {
-    result.error = "WinHttpOpen failed.";
-    return result;
-  }
-
-  HINTERNET connection = WinHttpConnect(session, parsed.host.c_str(), parsed.port, 0);
-  if (!connection) {
-    WinHttpCloseHandle(session);
-    result.error = "WinHttpConnect failed.";
-    return result;
-  }
-
   DWORD flags = parsed.is_https ? WINHTTP_FLAG_SECURE : 0;
   HINTERNET request = WinHttpOpenRequest(connection, L"POST", parsed.path.c_str(), nullptr,
                                          WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES,
                                          flags);
   if (!request) {
-    WinHttpCloseHandle(connection);
-    WinHttpCloseHandle(session);
     result.error = "WinHttpOpenRequest failed.";
     return result;
   }
@@ -120,12 +104,100 @@ HttpResponse HttpPostJson(const std::string& url, const std::string& json_body)
     } else {
       result.error = "Failed to read HTTP status code.";
     }
+
+    // Read to the end either way, so the connection can be reused.
+    char chunk[1024];
+    DWORD available = 0;
+    while (WinHttpQueryDataAvailable(request, &available) && available > 0) {
+      DWORD read = 0;
+      if (!WinHttpReadData(request, chunk, sizeof(chunk), &read) || read == 0) break;
+      result.body.append(chunk, read);
+    }
   }
 
   WinHttpCloseHandle(request);
+  return result;
+}
+
+}  // namespace
+
+HttpResponse HttpPostJson(const std::string& url, const std::string& json_body) {
+  HttpResponse result;
+
+  ParsedUrl parsed;
+  if (!ParseUrl(url, &parsed)) {
+    result.error = "Failed to parse endpoint URL.";
+    return result;
+  }
+
+  HINTERNET session = OpenSession();
+  if (!session) {
+    result.error = "WinHttpOpen failed.";
+    return result;
+  }
+
+  HINTERNET connection = WinHttpConnect(session, parsed.host.c_str(), parsed.port, 0);
+  if (!connection) {
+    WinHttpCloseHandle(session);
+    result.error = "WinHttpConnect failed.";
+    return result;
+  }
+
+  result = PostOnConnection(connection, parsed, json_body);
+
   WinHttpCloseHandle(connection);
   WinHttpCloseHandle(session);
   return result;
 }
 
+HttpConnection::HttpConnection(const std::string& url) : url_(url) {}
+
+HttpConnection::~HttpConnection() {
+  Close();
+}
+
+void HttpConnection::Close() {
+  if (connection_) WinHttpCloseHandle(static_cast<HINTERNET>(connection_));
+  if (session_) WinHttpCloseHandle(static_cast<HINTERNET>(session_));
+  connection_ = nullptr;
+  session_ = nullptr;
+}
+
+HttpResponse HttpConnection::PostJson(const std::string& json_body) {
+  HttpResponse result;
+
+  ParsedUrl parsed;
+  if (!ParseUrl(url_, &parsed)) {
+    result.error = "Failed to parse endpoint URL.";
+    return result;
+  }
+
+  // WinHTTP pools sockets per session; a stale pooled socket fails the send, so retry once.
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    const bool reused = connection_ != nullptr;
+    if (!reused) {
+      session_ = OpenSession();
+      if (!session_) {
+        result.error = "WinHttpOpen failed.";
+        return result;
+      }
+      connection_ = WinHttpConnect(static_cast<HINTERNET>(session_), parsed.host.c_str(),
+                                   parsed.port, 0);
+      if (!connection_) {
+        Close();
+        result.error = "WinHttpConnect failed.";
+        return result;
+      }
+      ++connects_;
+    }
+
+    result = PostOnConnection(static_cast<HINTERNET>(connection_), parsed, json_body);
+    if (result.status_code != 0) return result;
+    Close();
+    if (!reused) break;
+  }
+  return result;
+}
+
 }  // namespace mccmod
+
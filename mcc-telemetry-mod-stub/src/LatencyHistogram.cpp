@@ -0,0 +1,78 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mccmod {
+namespace {
+
+int HighestBit(uint64_t value) {
+  int bit = 63;
+  while (!(value >> bit)) --bit;
+  return bit;
+}
+
+}  // namespace
+
+size_t LatencyHistogram::BucketFor(uint64_t value) {
+  if (value < kSubBuckets) return static_cast<size_t>(value);
+  const int top = HighestBit(value);
+  const int shift = top - kSubBucketBits;
+  const size_t sub = static_cast<size_t>((value >> shift) & (kSubBuckets - 1));
+  return static_cast<size_t>(shift + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::BucketUpperEdge(size_t bucket) {
+  if (bucket < kSubBuckets) return bucket;
+  const int shift = static_cast<int>(bucket / kSubBuckets) - 1;
+  const uint64_t sub = bucket % kSubBuckets;
+  const uint64_t lower = (kSubBuckets + sub) << shift;
+  return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+  counts_[BucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  uint64_t seen = max_.load(std::memory_order_relaxed);
+  while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& count : counts_) count.store(0, std::memory_order_relaxed);
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::Percentile(double q) const {
+  uint64_t total = 0;
+  for (const auto& count : counts_) total += count.load(std::memory_order_relaxed);
+  if (total == 0) return 0;
+
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+    seen += counts_[bucket].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      // The top bucket's edge can overshoot the largest value actually seen.
+      return std::min(BucketUpperEdge(bucket), max_.load(std::memory_order_relaxed));
+    }
+  }
+  return max_.load(std::memory_order_relaxed);
+}
+
+LatencySummary LatencyHistogram::Summary() const {
+  LatencySummary summary;
+  summary.count = count_.load(std::memory_order_relaxed);
+  if (summary.count == 0) return summary;
+  summary.p50 = Percentile(0.50);
+  summary.p90 = Percentile(0.90);
+  summary.p99 = Percentile(0.99);
+  summary.max = max_.load(std::memory_order_relaxed);
+  summary.mean = static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(summary.count);
+  return summary;
+}
+
+}  // namespace mccmod
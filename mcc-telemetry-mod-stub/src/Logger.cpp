@@ -0,0 +1,419 @@
+#include "Logger.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+namespace mccmod {
+namespace {
+
+constexpr uint64_t kRateWindowMs = 60 * 1000;
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 2;
+  while (result < value) result <<= 1;
+  return result;
+}
+
+void AppendUnsigned(uint64_t value, std::string* out) {
+  char digits[20];
+  size_t count = 0;
+  do {
+    digits[count++] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  while (count > 0) out->push_back(digits[--count]);
+}
+
+void AppendPadded(unsigned value, size_t width, std::string* out) {
+  char digits[8];
+  for (size_t i = width; i > 0; --i) {
+    digits[i - 1] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+  out->append(digits, width);
+}
+
+#if defined(_WIN32)
+class DebugOutputSink : public LogSink {
+ public:
+  void Write(LogLevel, std::string_view line) override {
+    buffer_.assign(line);
+    buffer_.push_back('\n');
+    OutputDebugStringA(buffer_.c_str());
+  }
+
+ private:
+  std::string buffer_;
+};
+#endif
+
+}  // namespace
+
+const char* LogLevelName(LogLevel level) {
+  switch (level) {
+    case LogLevel::kDebug:
+      return "DEBUG";
+    case LogLevel::kInfo:
+      return "INFO";
+    case LogLevel::kWarning:
+      return "WARN";
+    case LogLevel::kError:
+      return "ERROR";
+  }
+  return "?";
+}
+
+void StderrSink::Write(LogLevel, std::string_view line) {
+  std::fwrite(line.data(), 1, line.size(), stderr);
+  std::fputc('\n', stderr);
+}
+
+void StderrSink::Flush() {
+  std::fflush(stderr);
+}
+
+RotatingFileSink::RotatingFileSink(std::string path, uint64_t max_bytes, int max_files)
+    : path_(std::move(path)), max_bytes_(max_bytes), max_files_(std::max(1, max_files)) {}
+
+RotatingFileSink::~RotatingFileSink() {
+  if (file_) std::fclose(file_);
+}
+
+void RotatingFileSink::Open() {
+  file_ = std::fopen(path_.c_str(), "ab");
+  if (!file_) return;
+  std::fseek(file_, 0, SEEK_END);
+  const long size = std::ftell(file_);
+  size_ = size > 0 ? static_cast<uint64_t>(size) : 0;
+}
+
+void RotatingFileSink::Rotate() {
+  if (file_) {
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+  // max_files counts the live file, so the oldest kept is path.(max_files - 1).
+  std::remove((path_ + "." + std::to_string(max_files_ - 1)).c_str());
+  for (int index = max_files_ - 2; index >= 1; --index) {
+    std::rename((path_ + "." + std::to_string(index)).c_str(), (path_ + "." + std::to_string(index + 1)).c_str());
+  }
+  if (max_files_ > 1) {
+    std::rename(path_.c_str(), (path_ + ".1").c_str());
+  } else {
+    std::remove(path_.c_str());
+  }
+  Open();
+}
+
+void RotatingFileSink::Write(LogLevel, std::string_view line) {
+  if (!file_) Open();
+  if (!file_) return;
+  if (size_ > 0 && size_ + line.size() + 1 > max_bytes_) {
+    Rotate();
+    if (!file_) return;
+  }
+  std::fwrite(line.data(), 1, line.size(), file_);
+  std::fputc('\n', file_);
+  size_ += line.size() + 1;
+}
+
+void RotatingFileSink::Flush() {
+  if (file_) std::fflush(file_);
+}
+
+std::unique_ptr<LogSink> MakeDebugOutputSink() {
+#if defined(_WIN32)
+  return std::make_unique<DebugOutputSink>();
+#else
+  return std::make_unique<StderrSink>();
+#endif
+}
+
+Logger::Logger(const LoggerOptions& options, Clock& clock)
+    : clock_(clock), options_(options), min_level_(options.min_level) {
+  const size_t capacity = RoundUpToPowerOfTwo(options_.capacity);
+  cells_ = std::make_unique<Cell[]>(capacity);
+  mask_ = capacity - 1;
+  for (size_t i = 0; i < capacity; ++i) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+Logger::~Logger() {
+  Stop();
+}
+
+void Logger::AddSink(std::unique_ptr<LogSink> sink) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_ || !sink) return;
+  sinks_.push_back(std::move(sink));
+}
+
+void Logger::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_) return;
+  running_ = true;
+  writer_ = std::thread(&Logger::WriterLoop, this);
+}
+
+void Logger::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return;
+    running_ = false;
+  }
+  wake_.notify_one();
+  if (writer_.joinable()) writer_.join();
+  drained_.notify_all();
+}
+
+bool Logger::Admit(LogId id, uint64_t now_ms, uint32_t* suppressed) {
+  *suppressed = 0;
+  const uint32_t limit = GetLogMessageInfo(id).per_minute;
+  if (limit == 0) return true;
+
+  RateState& rate = rates_[static_cast<size_t>(id)];
+  uint64_t start = rate.window_start_ms.load(std::memory_order_relaxed);
+  // The first call claims a fresh window; steady time can start at 0.
+  if (now_ms - start >= kRateWindowMs || rate.used.load(std::memory_order_relaxed) == 0) {
+    if (rate.window_start_ms.compare_exchange_strong(start, now_ms, std::memory_order_relaxed)) {
+      rate.used.store(0, std::memory_order_relaxed);
+    }
+  }
+  // Over the limit, skip the increment so repeats only touch `pending`.
+  if (rate.used.load(std::memory_order_relaxed) < limit &&
+      rate.used.fetch_add(1, std::memory_order_relaxed) < limit) {
+    *suppressed = rate.pending.exchange(0, std::memory_order_relaxed);
+    return true;
+  }
+  rate.pending.fetch_add(1, std::memory_order_relaxed);
+  suppressed_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+bool Logger::Log(LogId id, std::initializer_list<LogArg> args) {
+  const LogMessageInfo& info = GetLogMessageInfo(id);
+  if (info.level < min_level_.load(std::memory_order_relaxed)) return false;
+
+  const uint64_t now_ms = clock_.SteadyMs();
+  uint32_t suppressed = 0;
+  if (!Admit(id, now_ms, &suppressed)) return false;
+
+  // Bounded MPMC queue after Vyukov, used with a single consumer: a cell is
+  // free for position p when its sequence is p, and readable when it is p + 1.
+  uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  Cell* cell = nullptr;
+  while (true) {
+    cell = &cells_[pos & mask_];
+    const uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const int64_t diff = static_cast<int64_t>(sequence - pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      // Full. The suppression count goes back so a later line still reports it.
+      if (suppressed > 0) {
+        rates_[static_cast<size_t>(id)].pending.fetch_add(suppressed, std::memory_order_relaxed);
+      }
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+
+  Record& record = cell->record;
+  record.steady_ms = now_ms;
+  record.suppressed = suppressed;
+  record.id = id;
+  record.arg_count = 0;
+  size_t text_used = 0;
+  for (const LogArg& arg : args) {
+    if (record.arg_count == kMaxLogArgs) break;
+    const uint8_t index = record.arg_count++;
+    record.kinds[index] = arg.kind();
+    record.values[index] = arg.value();
+    record.text_sizes[index] = 0;
+    if (arg.kind() == LogArg::Kind::kText) {
+      const size_t size = std::min(arg.text().size(), kLogTextBytes - text_used);
+      std::memcpy(record.text + text_used, arg.text().data(), size);
+      record.text_sizes[index] = static_cast<uint8_t>(size);
+      text_used += size;
+    }
+  }
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  logged_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool Logger::Pop(Record* record) {
+  Cell& cell = cells_[dequeue_pos_ & mask_];
+  if (cell.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) return false;
+  *record = cell.record;
+  cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+  ++dequeue_pos_;
+  return true;
+}
+
+void Logger::Flush() {
+  const uint64_t target = enqueue_pos_.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!running_) return;
+  wake_requested_ = true;
+  wake_.notify_one();
+  drained_.wait(lock, [&] { return written_pos_ >= target || !running_; });
+}
+
+LoggerStats Logger::GetStats() const {
+  LoggerStats stats;
+  stats.logged = logged_.load(std::memory_order_relaxed);
+  stats.written = written_.load(std::memory_order_relaxed);
+  stats.suppressed = suppressed_.load(std::memory_order_relaxed);
+  stats.dropped = dropped_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void Logger::FormatPrefix(uint64_t steady_ms, LogLevel level, std::string* line) const {
+  // Records carry steady time, the one clock read on the hot path; wall
+  // time is reconstructed from the offset between the two clocks now.
+  const int64_t wall_ms = clock_.WallMs() - static_cast<int64_t>(clock_.SteadyMs() - steady_ms);
+  const std::time_t seconds = static_cast<std::time_t>(wall_ms / 1000);
+  std::tm utc{};
+#if defined(_WIN32)
+  gmtime_s(&utc, &seconds);
+#else
+  gmtime_r(&seconds, &utc);
+#endif
+  line->clear();
+  AppendPadded(static_cast<unsigned>(utc.tm_year + 1900), 4, line);
+  line->push_back('-');
+  AppendPadded(static_cast<unsigned>(utc.tm_mon + 1), 2, line);
+  line->push_back('-');
+  AppendPadded(static_cast<unsigned>(utc.tm_mday), 2, line);
+  line->push_back('T');
+  AppendPadded(static_cast<unsigned>(utc.tm_hour), 2, line);
+  line->push_back(':');
+  AppendPadded(static_cast<unsigned>(utc.tm_min), 2, line);
+  line->push_back(':');
+  AppendPadded(static_cast<unsigned>(utc.tm_sec), 2, line);
+  line->push_back('.');
+  AppendPadded(static_cast<unsigned>(wall_ms % 1000), 3, line);
+  line->append("Z ");
+  line->append(LogLevelName(level));
+  line->append(" [");
+  line->append(options_.tag);
+  line->append("] ");
+}
+
+void Logger::WriteLine(LogLevel level, const std::string& line) {
+  for (const auto& sink : sinks_) sink->Write(level, line);
+  written_.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t Logger::Drain(std::string* line) {
+  size_t count = 0;
+  Record record;
+  while (Pop(&record)) {
+    const LogMessageInfo& info = GetLogMessageInfo(record.id);
+    FormatPrefix(record.steady_ms, info.level, line);
+
+    size_t next_arg = 0;
+    size_t text_offset = 0;
+    for (const char* c = info.format; *c != '\0'; ++c) {
+      if (c[0] != '{' || c[1] != '}') {
+        line->push_back(*c);
+        continue;
+      }
+      ++c;
+      if (next_arg >= record.arg_count) continue;
+      const size_t index = next_arg++;
+      switch (record.kinds[index]) {
+        case LogArg::Kind::kSigned: {
+          const int64_t value = static_cast<int64_t>(record.values[index]);
+          if (value < 0) line->push_back('-');
+          AppendUnsigned(value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value), line);
+          break;
+        }
+        case LogArg::Kind::kUnsigned:
+          AppendUnsigned(record.values[index], line);
+          break;
+        case LogArg::Kind::kText:
+          line->append(record.text + text_offset, record.text_sizes[index]);
+          break;
+      }
+      text_offset += record.text_sizes[index];
+    }
+    if (record.suppressed > 0) {
+      line->append(" (");
+      AppendUnsigned(record.suppressed, line);
+      line->append(" similar suppressed)");
+    }
+    WriteLine(info.level, *line);
+    ++count;
+  }
+  return count;
+}
+
+void Logger::WriteSuppressionSummaries(uint64_t now_ms, bool all, std::string* line) {
+  for (size_t index = 0; index < static_cast<size_t>(LogId::kCount); ++index) {
+    RateState& rate = rates_[index];
+    if (rate.pending.load(std::memory_order_relaxed) == 0) continue;
+    if (!all && now_ms - rate.window_start_ms.load(std::memory_order_relaxed) < kRateWindowMs) continue;
+    const uint32_t count = rate.pending.exchange(0, std::memory_order_relaxed);
+    if (count == 0) continue;
+
+    const LogMessageInfo& info = kLogMessages[index];
+    FormatPrefix(now_ms, info.level, line);
+    line->append("Suppressed ");
+    AppendUnsigned(count, line);
+    line->append(" x \"");
+    line->append(info.format);
+    line->append("\" in the last minute.");
+    WriteLine(info.level, *line);
+  }
+}
+
+void Logger::WriterLoop() {
+  std::string line;
+  line.reserve(256);
+  uint64_t reported_dropped = 0;
+  while (true) {
+    bool stopping = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait_for(lock, std::chrono::milliseconds(options_.drain_interval_ms),
+                     [this] { return wake_requested_ || !running_; });
+      wake_requested_ = false;
+      stopping = !running_;
+    }
+
+    Drain(&line);
+    const uint64_t now_ms = clock_.SteadyMs();
+    WriteSuppressionSummaries(now_ms, stopping, &line);
+    const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped > reported_dropped) {
+      FormatPrefix(now_ms, LogLevel::kWarning, &line);
+      line.append("Dropped ");
+      AppendUnsigned(dropped - reported_dropped, &line);
+      line.append(" line(s) while the log queue was full.");
+      WriteLine(LogLevel::kWarning, line);
+      reported_dropped = dropped;
+    }
+    for (const auto& sink : sinks_) sink->Flush();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      written_pos_ = dequeue_pos_;
+    }
+    drained_.notify_all();
+    if (stopping) break;
+  }
+}
+
+}  // namespace mccmod
@@ -1,39 +1,163 @@
+#if defined(_WIN32)
 #include <Windows.h>
-#include <TlHelp32.h>
+#endif
+
+#include "Clock.h"
+#include "FlightRecorder.h"
+#include "Metrics.h"
+#include "NameClassifier.h"
+#include "PlayerRoster.h"
+#include "ProcessAccess.h"
+#include "ReaderLayout.h"
+#include "RegionCache.h"
+#include "ServiceHost.h"
+#include "SignalFilter.h"
+#include "SnapshotPublisher.h"
+#include "StringFieldCache.h"
+#include "TelemetryContract.h"
+#include "TelemetrySender.h"
+#include "TickScheduler.h"
+#include "TitleCatalog.h"
+#include "TripleBuffer.h"
+#include "WorkerPool.h"
 
 #include <array>
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cerrno>
 #include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <cstdlib>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
+#if defined(MCC_READER_COUNT_ALLOCATIONS)
+// Heap allocations made by the calling thread, from the counting operator new in tools/AllocCounter.cpp. Only
+// the build mcc_alloc_check runs defines MCC_READER_COUNT_ALLOCATIONS and links it; the shipping reader keeps
+// the standard allocator.
+uint64_t ThreadHeapAllocations();
+#endif
+
 namespace {
+using mccmod::ProcessId;
+using mccmod::kMapNameOffset;
+using mccmod::kMccModuleName;
+using mccmod::kMccPlayerCountOffset;
+using mccmod::kModeNameOffsetPrimary;
+using mccmod::kModeNameOffsetSecondary;
+using mccmod::kReachModuleName;
+using mccmod::kReachPlayerCountOffsets;
+using mccmod::kSharedTelemetryBaseOffset;
+
 constexpr int kMaxPlayers = 24;
-constexpr int kMapStabilizeTicks = 3;
-constexpr int kModeStabilizeTicks = 3;
-constexpr int kPlayerStabilizeTicks = 2;
 constexpr bool kUseMapWhitelist = false;
 constexpr int kPollIntervalMs = 200;
-constexpr uintptr_t kSharedTelemetryBaseOffset = 0x4001590;
-constexpr uintptr_t kMapNameOffset = 0x44D;
-constexpr uintptr_t kModeNameOffsetPrimary = 0x3C4;
-constexpr uintptr_t kModeNameOffsetSecondary = 0x8B8;
+constexpr int kReceiverHeartbeatMs = 2000;
+constexpr uint32_t kFlightRecorderTicks = 8192;
+constexpr uint64_t kModuleRescanMs = 2000;
+constexpr uint64_t kProcessScanMs = 1000;
+constexpr size_t kMaxSamplerWorkers = 4;
+constexpr uint64_t kBudgetWindowMs = 10000;
+constexpr unsigned long kOverlayCloseTimeoutMs = 2000;
+constexpr uint64_t kSamplerStopTimeoutMs = 2000;
+constexpr uint64_t kBudgetLogMs = 60000;
+constexpr size_t kMaxReadAttempts = 16;
+// Name fields fail between matches and come back with the next one; a few polls of backoff at most, so a new
+// map is not missed for the region cache's full minute.
+constexpr uint64_t kNameBackoffMaxMs = 3 * kPollIntervalMs;
+
+// Static labels for traced reads; the names only materialize when a debug payload is built.
+enum class ReadLabel : uint8_t {
+    SharedBase,
+    PlayersMcc,
+    PlayersReach0,
+    PlayersReach1,
+    PlayersReach2,
+    Map,
+    ModePrimary,
+    ModeSecondary,
+    Roster,
+    Count
+};
+
+constexpr const char* kReadLabelNames[] = {
+    "shared.base",
+    "players.mcc",
+    "players.reach.0",
+    "players.reach.1",
+    "players.reach.2",
+    "map",
+    "mode.prim",
+    "mode.sec",
+    "roster"
+};
+static_assert(sizeof(kReadLabelNames) / sizeof(kReadLabelNames[0]) == static_cast<size_t>(ReadLabel::Count),
+              "kReadLabelNames must cover every ReadLabel");
+
+constexpr bool IsNameLabel(ReadLabel label) {
+    return label == ReadLabel::Map || label == ReadLabel::ModePrimary || label == ReadLabel::ModeSecondary;
+}
+
+// Hot-path metrics, registered once; sampler threads only touch the references.
+struct ReaderMetrics {
+    mccmod::MetricCounter& samples;
+    mccmod::MetricHistogram& sampleDurationUs;
+    mccmod::MetricCounter& readsOk;
+    mccmod::MetricCounter& readsFailed;
+    mccmod::MetricCounter& readsSkipped;
+    mccmod::MetricCounter& snapshotsEmitted;
+    mccmod::MetricCounter& stringsDecoded;
+    mccmod::MetricCounter& stringsReused;
+    mccmod::MetricCounter& rosterChanges;
+};
+
+inline ReaderMetrics& GetReaderMetrics() {
+    mccmod::MetricsRegistry& registry = mccmod::DefaultMetrics();
+    const char* readsHelp = "Remote memory reads by outcome; skipped ones were turned away by the region cache.";
+    const char* stringsHelp = "Map and mode field reads; reused ones matched the last raw bytes and skipped the decode.";
+    static ReaderMetrics metrics{
+        registry.Counter("mcc_reader_samples_total", "Samples taken across all instances."),
+        registry.Histogram("mcc_reader_sample_duration_us", "Wall time of one sample in microseconds.",
+                           {50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 100000}),
+        registry.Counter("mcc_reader_reads_total", readsHelp, "result=\"ok\""),
+        registry.Counter("mcc_reader_reads_total", readsHelp, "result=\"failed\""),
+        registry.Counter("mcc_reader_reads_total", readsHelp, "result=\"skipped\""),
+        registry.Counter("mcc_reader_snapshots_emitted_total", "Ticks written out by the emitter."),
+        registry.Counter("mcc_reader_string_reads_total", stringsHelp, "result=\"decoded\""),
+        registry.Counter("mcc_reader_string_reads_total", stringsHelp, "result=\"reused\""),
+        registry.Counter("mcc_reader_roster_changes_total", "Player table reads that changed a name, team or slot."),
+    };
+    return metrics;
+}
+
+#if defined(MCC_READER_COUNT_ALLOCATIONS)
+inline mccmod::MetricCounter& SampleAllocations() {
+    static mccmod::MetricCounter& counter = mccmod::DefaultMetrics().Counter(
+        "mcc_reader_sample_allocations_total", "Heap allocations made while taking samples.");
+    return counter;
+}
+#endif
 
 inline bool IsReaderDebugEnabled() {
     const char* value = std::getenv("HMCC_READER_DEBUG");
-    return value && _stricmp(value, "1") == 0;
+    return value && std::strcmp(value, "1") == 0;
 }
 
+#if defined(_WIN32)
 inline std::string FormatWin32ErrorMessage(DWORD error) {
     if (error == 0) {
         return "OK";
@@ -58,949 +182,1740 @@ inline std::string FormatWin32ErrorMessage(DWORD error) {
     }
     return message;
 }
+#endif
 
-enum class ProcessEventType {
-    None,
-    Started,
-    Stopped,
-    Changed
-};
-
-struct ProcessEvent {
-    ProcessEventType type = ProcessEventType::None;
-    DWORD pid = 0;
-};
-
-template<typename T>
-struct ConsensusResult {
-    T value{};
-    int total = 0;
-    int bestCount = 0;
-    bool hasValue = false;
-};
-
-template<typename T>
-ConsensusResult<T> ComputeConsensus(const std::vector<T>& values) {
-    ConsensusResult<T> result;
-    if (values.empty()) {
-        return result;
-    }
-
-    std::map<T, int> frequency;
-    for (const auto& val : values) {
-        frequency[val]++;
-    }
-
-    auto mostFrequent = std::max_element(
-        frequency.begin(),
-        frequency.end(),
-        [](const auto& a, const auto& b) { return a.second < b.second; }
-    );
+// Reader time comes from the default clock so a simulated run can swap in virtual time.
+// Stage timings still use steady_clock directly: they measure real CPU cost.
+inline uint64_t NowSteadyMs() {
+    return mccmod::DefaultClock().SteadyMs();
+}
 
-    result.total = static_cast<int>(values.size());
-    result.bestCount = mostFrequent->second;
-    result.value = mostFrequent->first;
-    result.hasValue = true;
-    return result;
+inline int64_t NowWallMs() {
+    return mccmod::DefaultClock().WallMs();
 }
 
-inline float CalculateConfidence(int bestCount, int total) {
-    if (total <= 0 || bestCount <= 0) {
-        return 0.0f;
-    }
-    return static_cast<float>(bestCount) / static_cast<float>(total);
+inline uint32_t ElapsedUs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
 }
 
-inline uint64_t NowSteadyMs() {
-    const auto now = std::chrono::steady_clock::now();
-    return static_cast<uint64_t>(
-        std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count()
-    );
+// Known names are carried in their catalog spelling, so "sword_base" and "Sword Base"
+// vote as one candidate and the committed value is stable across sources.
+inline void InternCatalogName(const mccmod::CatalogEntry* entry, std::string* name) {
+    if (entry && *name != entry->display_name) {
+        name->assign(entry->display_name);
+    }
 }
 
 inline std::string TrimCopy(const std::string& input) {
-    size_t start = 0;
-    while (start < input.size() && std::isspace(static_cast<unsigned char>(input[start]))) {
-        ++start;
-    }
-    size_t end = input.size();
-    while (end > start && std::isspace(static_cast<unsigned char>(input[end - 1]))) {
-        --end;
-    }
-    return input.substr(start, end - start);
+    const mccmod::TextBounds bounds = mccmod::TrimmedBounds(input);
+    return input.substr(bounds.begin, bounds.end - bounds.begin);
 }
 
 inline std::string TimestampNow() {
-    SYSTEMTIME st = {};
-    GetLocalTime(&st);
+    const int64_t nowMs = NowWallMs();
+    const std::time_t seconds = static_cast<std::time_t>(nowMs / 1000);
+    const int64_t millis = nowMs % 1000;
+    std::tm local = {};
+#if defined(_WIN32)
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
     char buffer[64] = {};
     std::snprintf(
         buffer,
         sizeof(buffer),
-        "%04u-%02u-%02u %02u:%02u:%02u.%03u",
-        static_cast<unsigned>(st.wYear),
-        static_cast<unsigned>(st.wMonth),
-        static_cast<unsigned>(st.wDay),
-        static_cast<unsigned>(st.wHour),
-        static_cast<unsigned>(st.wMinute),
-        static_cast<unsigned>(st.wSecond),
-        static_cast<unsigned>(st.wMilliseconds)
+        "%04d-%02d-%02d %02d:%02d:%02d.%03d",
+        local.tm_year + 1900,
+        local.tm_mon + 1,
+        local.tm_mday,
+        local.tm_hour,
+        local.tm_min,
+        local.tm_sec,
+        static_cast<int>(millis)
     );
     return std::string(buffer);
 }
 
-struct StringSignal {
-    int stabilizeTicks = 3;
-    std::string stableValue;
-    std::string lastCandidate;
-    int streak = 0;
-    float confidence = 0.0f;
-    std::string sourceTag = "none";
-    uint64_t lastStableMs = 0;
-    bool hasStable = false;
-    bool updatedThisTick = false;
-
-    explicit StringSignal(int stabilize)
-        : stabilizeTicks(stabilize) {}
-
-    void Reset() {
-        stableValue.clear();
-        lastCandidate.clear();
-        streak = 0;
-        confidence = 0.0f;
-        sourceTag = "none";
-        lastStableMs = 0;
-        hasStable = false;
-        updatedThisTick = false;
-    }
-
-    std::string Update(const std::vector<std::string>& candidates) {
-        const uint64_t nowMs = NowSteadyMs();
-        updatedThisTick = false;
-        const auto consensus = ComputeConsensus(candidates);
-        confidence = CalculateConfidence(consensus.bestCount, consensus.total);
-        if (consensus.total > 1) {
-            sourceTag = "consensus";
-        } else if (consensus.total == 1) {
-            sourceTag = "single";
-        } else {
-            sourceTag = "none";
-        }
-
-        if (!consensus.hasValue) {
-            return hasStable ? stableValue : "Unknown";
-        }
+using StringSignal = mccmod::StableSignal<std::string>;
+using IntSignal = mccmod::StableSignal<int>;
+using StringCandidates = mccmod::SignalCandidates<std::string>;
+using IntCandidates = mccmod::SignalCandidates<int>;
+
+// Candidate sources. The four player counts are separate fields; the two mode offsets hold one field, so
+// they vote as one source and cannot fast-commit a mode on their own.
+constexpr uint8_t kNameFieldSource = 0;
+
+// Fixed-size trace record so tracing never allocates; the sampler only fills it in debug mode.
+struct ReadAttempt {
+    ReadLabel label = ReadLabel::SharedBase;
+    bool ok = false;
+    bool skipped = false;
+    uint8_t valueLength = 0;
+    uint32_t bytesRead = 0;
+    uintptr_t address = 0;
+    char value[mccmod::kMaxNameTextBytes] = {};
+};
 
-        if (consensus.value == lastCandidate) {
-            streak++;
-        } else {
-            lastCandidate = consensus.value;
-            streak = 1;
-        }
+// Raw bytes of one string field, read once per tick and decoded only when they change. Aligned fields are
+// read at their full UTF-16 size (NameFieldReadBytes), so the decode never reads past them.
+struct StringBytes {
+    std::array<char, mccmod::kNameFieldUtf16Bytes> data{};
+    size_t size = 0;
+};
 
-        if (streak >= stabilizeTicks) {
-            stableValue = consensus.value;
-            lastStableMs = nowMs;
-            hasStable = true;
-            updatedThisTick = true;
-        }
+struct ReadDebug {
+    bool connected = false;
+    ProcessId pid = 0;
+    uintptr_t mccBase = 0;
+    uintptr_t reachBase = 0;
+    std::array<ReadAttempt, kMaxReadAttempts> attempts{};
+    size_t attemptCount = 0;
 
-        return hasStable ? stableValue : "Unknown";
+    void Clear() {
+        connected = false;
+        pid = 0;
+        mccBase = 0;
+        reachBase = 0;
+        attemptCount = 0;
     }
-};
 
-struct IntSignal {
-    int stabilizeTicks = 2;
-    int stableValue = 0;
-    int lastCandidate = 0;
-    int streak = 0;
-    bool hasStable = false;
-    float confidence = 0.0f;
-    std::string sourceTag = "none";
-    uint64_t lastStableMs = 0;
-    bool updatedThisTick = false;
-
-    explicit IntSignal(int stabilize)
-        : stabilizeTicks(stabilize) {}
-
-    void Reset() {
-        stableValue = 0;
-        lastCandidate = 0;
-        streak = 0;
-        hasStable = false;
-        confidence = 0.0f;
-        sourceTag = "none";
-        lastStableMs = 0;
-        updatedThisTick = false;
-    }
-
-    int Update(const std::vector<int>& candidates) {
-        const uint64_t nowMs = NowSteadyMs();
-        updatedThisTick = false;
-        const auto consensus = ComputeConsensus(candidates);
-        confidence = CalculateConfidence(consensus.bestCount, consensus.total);
-        if (consensus.total > 1) {
-            sourceTag = "consensus";
-        } else if (consensus.total == 1) {
-            sourceTag = "single";
-        } else {
-            sourceTag = "none";
+    void Record(
+        ReadLabel label,
+        uintptr_t address,
+        bool ok,
+        bool skipped,
+        size_t bytesRead,
+        const std::string* value = nullptr
+    ) {
+        if (attemptCount >= attempts.size()) {
+            return;
         }
-
-        if (!consensus.hasValue) {
-            return hasStable ? stableValue : 0;
+        ReadAttempt& attempt = attempts[attemptCount++];
+        attempt.label = label;
+        attempt.address = address;
+        attempt.ok = ok;
+        attempt.skipped = skipped;
+        attempt.bytesRead = static_cast<uint32_t>(bytesRead);
+        attempt.valueLength = 0;
+        if (value) {
+            const size_t length = std::min(value->size(), sizeof(attempt.value));
+            std::memcpy(attempt.value, value->data(), length);
+            attempt.valueLength = static_cast<uint8_t>(length);
         }
+    }
+};
 
-        if (consensus.value == lastCandidate) {
-            streak++;
-        } else {
-            lastCandidate = consensus.value;
-            streak = 1;
-        }
+// Everything the emitter needs from one sampler tick. Slots are reused, so
+// strings and vectors keep their capacity between ticks.
+struct TickSnapshot {
+    uint64_t seq = 0;
+    uint64_t captureMs = 0;
+    // The same instant in µs, for the envelope's latency trace, and on the wall clock for readers of the state file.
+    uint64_t captureUs = 0;
+    int64_t captureWallMs = 0;
+    ProcessId pid = 0;
+    bool connected = false;
+    bool handleOk = false;
+    bool inMenus = true;
+    int playerCount = 0;
+    std::string mapName = "Unknown";
+    std::string modeName = "Unknown";
+    // Catalog entries for the committed names; null when unknown.
+    const mccmod::CatalogEntry* mapEntry = nullptr;
+    const mccmod::CatalogEntry* modeEntry = nullptr;
+    // Static strings, so setting them never allocates on the sampler.
+    const char* status = "Disconnected";
+    const char* sourceTag = "none";
+    bool mapUpdatedThisTick = false;
+    bool modeUpdatedThisTick = false;
+    bool playersUpdatedThisTick = false;
+    float mapConfidence = 0.0f;
+    float modeConfidence = 0.0f;
+    float playerConfidence = 0.0f;
+    uint64_t mapLastStableMs = 0;
+    uint64_t modeLastStableMs = 0;
+    ProcessId instancePid = 0;
+    uint64_t overruns = 0;
+    mccmod::RegionCacheStats regionStats;
+    mccmod::StringFieldStats stringStats;
+    // Only set when the player table could be read this tick.
+    bool hasRoster = false;
+    bool rosterUpdatedThisTick = false;
+    uint64_t rosterVersion = 0;
+    mccmod::PlayerRoster roster;
+    mccmod::RosterStats rosterStats;
+    ReadDebug debug;
+};
+}
 
-        if (streak >= stabilizeTicks) {
-            stableValue = consensus.value;
-            hasStable = true;
-            lastStableMs = nowMs;
-            updatedThisTick = true;
-        }
+constexpr size_t kReadLabelCount = static_cast<size_t>(ReadLabel::Count);
+
+// One tick's remote reads, indexed by ReadLabel, so each field is read once and then decoded from here.
+struct TickReads {
+    std::array<mccmod::RemoteRead, kReadLabelCount> reads{};
+    // Turned away by the region cache without a syscall.
+    std::array<bool, kReadLabelCount> skipped{};
+    std::array<bool, kReadLabelCount> traced{};
+    std::array<ReadLabel, kReadLabelCount> queued{};
+    size_t queuedCount = 0;
+    uintptr_t sharedBase = 0;
+    // players.mcc, then players.reach.0-2.
+    std::array<int, 4> players{};
+    // map, mode.prim, mode.sec.
+    std::array<StringBytes, 3> names;
+    std::array<uint8_t, mccmod::kPlayerTableBytes> rosterTable{};
+};
 
-        return hasStable ? stableValue : 0;
-    }
+// Per-instance settings, read from the environment once at startup.
+struct ReaderOptions {
+    mccmod::SignalFilterConfig mapFilter = mccmod::kMapFilterDefaults;
+    mccmod::SignalFilterConfig modeFilter = mccmod::kModeFilterDefaults;
+    mccmod::SignalFilterConfig playerFilter = mccmod::kPlayerFilterDefaults;
+    // Bring the game window forward when the primary instance connects; off in headless mode.
+    bool focusOnConnect = true;
+    // Reuse the last decode of a map or mode field while its raw bytes are unchanged.
+    bool incrementalStrings = true;
+    // Read the player table for the roster section. Off unless HMCC_READER_ROSTER=1: the table layout is
+    // unverified (ReaderLayout.h).
+    bool roster = false;
+    // One process_vm_readv per batch of fields; off, every field is its own read.
+    bool batchReads = true;
 };
-}
 
-class MCCPlayerCountConsole {
+// One MCC process: its handle, module bases, region cache, signal set and flight
+// recorder. Sample() runs on a sampler worker, and an instance is never sampled by
+// two workers at once. The emitter only touches `ticks` and the output state below.
+class ReaderInstance {
 public:
-    MCCPlayerCountConsole()
-        : mapSignal(kMapStabilizeTicks),
-          modeSignal(kModeStabilizeTicks),
-          playerSignal(kPlayerStabilizeTicks) {
+    // instancePid is 0 for the primary instance, which keeps the legacy output names.
+    ReaderInstance(ProcessId instancePid, const ReaderOptions& options, std::function<void()> onTick)
+        : mapSignal(options.mapFilter, "Unknown"),
+          modeSignal(options.modeFilter, "Unknown"),
+          playerSignal(options.playerFilter, 0),
+          instancePid(instancePid),
+          focusOnConnect(options.focusOnConnect),
+          rosterEnabled(options.roster),
+          batchReads(options.batchReads),
+          onTick(std::move(onTick)) {
         InitializeAddresses();
+        const uint32_t verifyEvery = options.incrementalStrings ? mccmod::kStringVerifyEvery : 0;
+        mapField = mccmod::StringFieldCache(verifyEvery);
+        modeFields.fill(mccmod::StringFieldCache(verifyEvery));
     }
 
-    bool Initialize() {
-        LaunchOverlayIfNeeded();
-        UpdateProcessState();
-        std::cout << "MCC Player Count Console running. Press ESC to exit." << std::endl;
-        return true;
+    ~ReaderInstance() {
+        DisconnectProcess();
     }
 
-    void Run() {
-        const bool debugMode = StringEqualsIgnoreCase(GetEnvVar("HMCC_READER_DEBUG"), "1");
-        uint64_t sequence = 0;
-        uint64_t nextTick = NowSteadyMs();
-        while (true) {
-            if (GetAsyncKeyState(VK_ESCAPE) & 0x8000) {
-                break;
-            }
+    ReaderInstance(const ReaderInstance&) = delete;
+    ReaderInstance& operator=(const ReaderInstance&) = delete;
 
-            ProcessEvent evt = UpdateProcessState();
-            if (evt.type == ProcessEventType::Started || evt.type == ProcessEventType::Changed) {
-                FocusGameWindow();
-            }
+    ProcessId InstancePid() const { return instancePid; }
+    bool IsPrimary() const { return instancePid == 0; }
+    ProcessId Target() const { return targetPid.load(); }
+    void SetTarget(ProcessId pid) { targetPid.store(pid); }
 
-            int playerCount = 0;
-            std::string mapName = "Unknown";
-            std::string modeName = "Unknown";
-            bool inMenus = true;
-
-            ReadDebug tickDebug;
-            if (connected) {
-                playerCount = playerSignal.Update(ReadPlayerCandidates(&tickDebug));
-                mapName = mapSignal.Update(ReadMapCandidates(&tickDebug));
-                modeName = modeSignal.Update(ReadModeCandidates(mapName, &tickDebug));
-                inMenus = IsInMenus(playerCount);
-            } else {
-                mapSignal.Reset();
-                modeSignal.Reset();
-                playerSignal.Reset();
-                inMenus = true;
-            }
+    // The next sample disconnects, emits a final disconnected tick and retires the instance.
+    void Retire() {
+        retiring.store(true);
+        targetPid.store(0);
+    }
+    bool IsRetired() const { return retired.load(); }
+    // True while a sample is running, e.g. one still blocked on a hung process at shutdown.
+    bool IsSampling() const { return busy.load(); }
+    // The region cache's avoided-read rate as of the last sample; readable from any thread.
+    uint64_t ReadsAvoidedPerHour() const { return readsAvoidedPerHour.load(); }
+
+    // False while the previous sample is still running, e.g. a read blocked on a hung process.
+    bool TryBeginSample() {
+        if (busy.exchange(true)) {
+            overruns.fetch_add(1);
+            return false;
+        }
+        return true;
+    }
 
-            std::string status = BuildStatus(playerCount, inMenus, connected);
-            WriteTelemetrySnapshot(++sequence, playerCount, mapName, modeName, inMenus, status, tickDebug, debugMode);
+    void OpenFlightRecorder(const std::string& path) {
+        if (!flightRecorder.Open(path, kFlightRecorderTicks) && IsReaderDebugEnabled()) {
+            std::cerr << "\n[reader] flight recorder unavailable: " << path << std::endl;
+        }
+    }
 
-            std::string line = "Players: " + std::to_string(playerCount)
-                               + " | Map: " + mapName
-                               + " | Mode: " + modeName
-                               + " | " + status;
+    void CloseFlightRecorder() {
+        flightRecorder.Close();
+    }
 
-            if (line.size() < lastLineWidth) {
-                line.append(lastLineWidth - line.size(), ' ');
-            } else {
-                lastLineWidth = line.size();
+    void Sample(bool debugMode) {
+#if defined(MCC_READER_COUNT_ALLOCATIONS)
+        const uint64_t allocationsBefore = ThreadHeapAllocations();
+#endif
+        SyncTarget();
+
+        const auto tickStart = std::chrono::steady_clock::now();
+        TickSnapshot& tick = ticks.WriteSlot();
+        tick.debug.Clear();
+        tick.captureUs = mccmod::DefaultClock().SteadyUs();
+        tick.captureMs = tick.captureUs / 1000;
+        tick.captureWallMs = NowWallMs();
+        tick.playerCount = 0;
+        tick.mapName = "Unknown";
+        tick.modeName = "Unknown";
+        tick.mapEntry = nullptr;
+        tick.modeEntry = nullptr;
+        tick.inMenus = true;
+
+        playerCandidates.Clear();
+        mapCandidates.Clear();
+        modeCandidates.Clear();
+        uint32_t readUs = 0;
+        uint32_t filterUs = 0;
+
+        // Reads are only traced when the debug payload will carry them.
+        ReadDebug* trace = debugMode ? &tick.debug : nullptr;
+        if (connected) {
+            // Every field is read up front; mode candidates are screened against the committed map, so their
+            // decode follows the map filter.
+            auto stageStart = std::chrono::steady_clock::now();
+            ReadTickFields(trace);
+            ReadPlayerCandidates(&playerCandidates);
+            ReadMapCandidates(&mapCandidates, trace);
+            auto stageEnd = std::chrono::steady_clock::now();
+            readUs += ElapsedUs(stageStart, stageEnd);
+
+            stageStart = stageEnd;
+            tick.playerCount = playerSignal.Update(playerCandidates, tick.captureMs);
+            tick.mapName = mapSignal.Update(mapCandidates, tick.captureMs);
+            stageEnd = std::chrono::steady_clock::now();
+            filterUs += ElapsedUs(stageStart, stageEnd);
+
+            stageStart = stageEnd;
+            ReadModeCandidates(tick.mapName, &modeCandidates, trace);
+            stageEnd = std::chrono::steady_clock::now();
+            readUs += ElapsedUs(stageStart, stageEnd);
+
+            stageStart = stageEnd;
+            tick.modeName = modeSignal.Update(modeCandidates, tick.captureMs);
+            tick.inMenus = IsInMenus(tick.playerCount);
+            tick.mapEntry = mccmod::FindCatalogMap(tick.mapName);
+            tick.modeEntry = mccmod::FindCatalogGameMode(tick.modeName);
+            stageEnd = std::chrono::steady_clock::now();
+            filterUs += ElapsedUs(stageStart, stageEnd);
+
+            if (rosterEnabled) {
+                stageStart = stageEnd;
+                ReadRoster();
+                readUs += ElapsedUs(stageStart, std::chrono::steady_clock::now());
             }
+        } else {
+            mapSignal.Reset();
+            modeSignal.Reset();
+            playerSignal.Reset();
+        }
+
+        CaptureTickState(++sequence, &tick);
+        readsAvoidedPerHour.store(static_cast<uint64_t>(tick.regionStats.avoided_per_hour));
+        ticks.Publish();
+        if (retiring.load() && !connected) {
+            retired.store(true);
+        }
+        onTick();
+        const uint32_t tickUs = ElapsedUs(tickStart, std::chrono::steady_clock::now());
+        RecordFlight(tick, playerCandidates, mapCandidates, modeCandidates, readUs, filterUs, tickUs);
+        ReaderMetrics& metrics = GetReaderMetrics();
+        metrics.samples.Add();
+        metrics.sampleDurationUs.Observe(tickUs);
+#if defined(MCC_READER_COUNT_ALLOCATIONS)
+        SampleAllocations().Add(ThreadHeapAllocations() - allocationsBefore);
+#endif
+
+        busy.store(false);
+    }
 
-            std::cout << '\r' << line << std::flush;
-
-            const uint64_t nowMs = NowSteadyMs();
-            nextTick += static_cast<uint64_t>(kPollIntervalMs);
-            if (nextTick <= nowMs) {
-                // Drift correction if the loop was stalled.
-                nextTick = nowMs + static_cast<uint64_t>(kPollIntervalMs);
-            }
-            const uint64_t sleepMs = nextTick - nowMs;
-            std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(sleepMs)));
-        }
+    mccmod::TripleBuffer<TickSnapshot> ticks;
 
-        std::cout << std::endl;
-    }
+    // Output state, owned by the emitter thread.
+    std::string telemetryPath;
+    std::string lastPublishedState;
+    std::string lastSubmittedState;
+    uint64_t lastSubmitMs = 0;
+    std::string lastSessionId;
 
 private:
+    StringSignal mapSignal;
+    StringSignal modeSignal;
+    IntSignal playerSignal;
+    // Refilled every tick; kept here so their string slots keep their capacity.
+    IntCandidates playerCandidates;
+    StringCandidates mapCandidates;
+    StringCandidates modeCandidates;
+    std::string nameScratch;
+    const ProcessId instancePid;
+    const bool focusOnConnect;
+    const bool rosterEnabled;
+    const bool batchReads;
+    const std::function<void()> onTick;
+
+    std::atomic<ProcessId> targetPid{0};
+    std::atomic<bool> busy{false};
+    std::atomic<bool> retiring{false};
+    std::atomic<bool> retired{false};
+    std::atomic<uint64_t> overruns{0};
+    std::atomic<uint64_t> readsAvoidedPerHour{0};
+    uint64_t sequence = 0;
+
+#if defined(_WIN32)
     HWND gameWindow = nullptr;
-    HANDLE processHandle = nullptr;
-    DWORD processId = 0;
+#endif
+    mccmod::RemoteProcess process;
+    ProcessId processId = 0;
     bool connected = false;
-    size_t lastLineWidth = 0;
-    std::string telemetryPath;
+    mccmod::FlightRecorder flightRecorder;
 
     std::vector<uintptr_t> candidateAddresses;
     uintptr_t mccBase = 0;
     uintptr_t haloReachBase = 0;
+    uint64_t lastModuleScanMs = 0;
+    mccmod::RegionCache regionCache;
+    TickReads tickReads;
+#if !defined(_WIN32)
+    bool warnedReadDenied = false;
+#endif
+    mccmod::StringFieldCache mapField;
+    std::array<mccmod::StringFieldCache, 2> modeFields;
+    mccmod::RosterTracker rosterTracker;
+    bool rosterValid = false;
+    bool rosterUpdated = false;
+
+    void SyncTarget() {
+        const ProcessId target = targetPid.load();
+        if (target == processId && (connected || target == 0)) {
+            return;
+        }
+        DisconnectProcess();
+        if (target != 0 && ConnectToProcess(target) && IsPrimary() && focusOnConnect) {
+            FocusGameWindow();
+        }
+    }
 
-    StringSignal mapSignal;
-    StringSignal modeSignal;
-    IntSignal playerSignal;
+    void RecordFlight(
+        const TickSnapshot& tick,
+        const IntCandidates& players,
+        const StringCandidates& maps,
+        const StringCandidates& modes,
+        uint32_t readUs,
+        uint32_t filterUs,
+        uint32_t tickUs
+    ) {
+        if (!flightRecorder.IsOpen()) {
+            return;
+        }
 
-    struct ReadAttempt {
-        std::string label;
-        uintptr_t address = 0;
-        bool ok = false;
-        size_t bytesRead = 0;
-        std::string value;
-    };
+        mccmod::FlightRecord record;
+        record.steady_ms = tick.captureMs;
+        record.wall_ms = NowWallMs();
+        record.pid = tick.pid;
+        record.flags = static_cast<uint8_t>(
+            (tick.connected ? mccmod::kFlightConnected : 0) |
+            (tick.inMenus ? mccmod::kFlightInMenus : 0) |
+            (tick.mapUpdatedThisTick ? mccmod::kFlightMapUpdated : 0) |
+            (tick.modeUpdatedThisTick ? mccmod::kFlightModeUpdated : 0) |
+            (tick.playersUpdatedThisTick ? mccmod::kFlightPlayersUpdated : 0));
+
+        const size_t playerSources = std::min(players.count, mccmod::kFlightPlayerSources);
+        for (size_t i = 0; i < playerSources; i++) {
+            record.player_candidates[i] = players.values[i];
+            record.player_source_mask = static_cast<uint8_t>(record.player_source_mask | (1u << players.sources[i]));
+        }
+        record.player_candidate_count = static_cast<uint8_t>(playerSources);
+        if (maps.count > 0) {
+            mccmod::CopyFlightString(record.map_candidate, maps.values[0]);
+            record.map_candidate_count = 1;
+        }
+        const size_t modeSources = std::min(modes.count, mccmod::kFlightModeSources);
+        for (size_t i = 0; i < modeSources; i++) {
+            mccmod::CopyFlightString(record.mode_candidates[i], modes.values[i]);
+        }
+        record.mode_candidate_count = static_cast<uint8_t>(modeSources);
+
+        record.player_count = tick.playerCount;
+        mccmod::CopyFlightString(record.map_name, tick.mapName);
+        mccmod::CopyFlightString(record.mode_name, tick.modeName);
+        record.map_confidence = tick.mapConfidence;
+        record.mode_confidence = tick.modeConfidence;
+        record.player_confidence = tick.playerConfidence;
+        record.read_us = readUs;
+        record.filter_us = filterUs;
+        record.tick_us = tickUs;
+        flightRecorder.Append(record);
+    }
 
-    struct ReadDebug {
-        bool connected = false;
-        DWORD pid = 0;
-        uintptr_t mccBase = 0;
-        uintptr_t reachBase = 0;
-        std::vector<ReadAttempt> attempts;
-        std::string lastError;
-    };
+    void CaptureTickState(uint64_t seq, TickSnapshot* tick) const {
+        tick->seq = seq;
+        tick->pid = processId;
+        tick->connected = connected;
+        tick->handleOk = process.IsOpen();
+        tick->status = BuildStatus(tick->playerCount, tick->inMenus, connected);
+        tick->sourceTag = ComputeSourceTag();
+        tick->mapUpdatedThisTick = mapSignal.UpdatedThisTick();
+        tick->modeUpdatedThisTick = modeSignal.UpdatedThisTick();
+        tick->playersUpdatedThisTick = playerSignal.UpdatedThisTick();
+        tick->mapConfidence = mapSignal.Confidence();
+        tick->modeConfidence = modeSignal.Confidence();
+        tick->playerConfidence = playerSignal.Confidence();
+        tick->mapLastStableMs = mapSignal.LastStableMs();
+        tick->modeLastStableMs = modeSignal.LastStableMs();
+        tick->instancePid = instancePid;
+        tick->overruns = overruns.load();
+        tick->regionStats = regionCache.GetStats(tick->captureMs);
+        // A table that disagrees with the committed player count is not the player table, or not yet; leave
+        // the section out rather than publish names the count does not back.
+        tick->hasRoster = connected && rosterValid && rosterTracker.Roster().count == tick->playerCount;
+        tick->rosterUpdatedThisTick = tick->hasRoster && rosterUpdated;
+        tick->rosterVersion = rosterTracker.Version();
+        tick->roster = rosterTracker.Roster();
+        tick->rosterStats = rosterTracker.Stats();
+        tick->stringStats = mapField.Stats();
+        for (const auto& field : modeFields) {
+            const mccmod::StringFieldStats& stats = field.Stats();
+            tick->stringStats.lookups += stats.lookups;
+            tick->stringStats.reused += stats.reused;
+            tick->stringStats.decoded += stats.decoded;
+            tick->stringStats.verified += stats.verified;
+            tick->stringStats.verify_changed += stats.verify_changed;
+        }
+    }
 
-    static bool StringEqualsIgnoreCase(const std::string& a, const std::string& b) {
-        if (a.size() != b.size()) return false;
-        for (size_t i = 0; i < a.size(); i++) {
-            if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
-                return false;
-            }
+    void InitializeAddresses() {
+        // Legacy absolute addresses are session-specific and produce false positives.
+        // Keep runtime acquisition module-relative only.
+        candidateAddresses.clear();
+
+    }
+
+    bool ConnectToProcess(ProcessId pid) {
+        processId = pid;
+#if defined(_WIN32)
+        gameWindow = FindTopLevelWindowForProcess(pid);
+#endif
+        connected = process.Open(pid);
+        regionCache.Attach(process.NativeHandle(), NowSteadyMs());
+        ResetSessionState();
+        return connected;
+    }
+
+    void DisconnectProcess() {
+        process.Close();
+        connected = false;
+        processId = 0;
+#if defined(_WIN32)
+        gameWindow = nullptr;
+#endif
+        regionCache.Attach(0, NowSteadyMs());
+        ResetSessionState();
+    }
+
+    void ResetSessionState() {
+        mccBase = 0;
+        haloReachBase = 0;
+        lastModuleScanMs = 0;
+        mapSignal.Reset();
+        modeSignal.Reset();
+        playerSignal.Reset();
+        mapField.Reset();
+        for (auto& field : modeFields) {
+            field.Reset();
         }
-        return true;
+        rosterTracker.Reset();
+        rosterValid = false;
+        rosterUpdated = false;
     }
 
-    void LaunchOverlayIfNeeded() {
-        CloseExistingOverlay();
-        if (FindWindowA(nullptr, "Customs on the Ring")) {
+    void FocusGameWindow() {
+#if defined(_WIN32)
+        if (!gameWindow) {
             return;
         }
+        ShowWindow(gameWindow, SW_RESTORE);
+        SetForegroundWindow(gameWindow);
+        BringWindowToTop(gameWindow);
+#endif
+    }
 
-        const std::string overlayExe = GetEnvVar("HMCC_OVERLAY_EXE");
-        if (!overlayExe.empty()) {
-            SpawnProcess(overlayExe, "");
-            return;
+#if defined(_WIN32)
+    struct WindowSearch {
+        DWORD pid = 0;
+        HWND window = nullptr;
+    };
+
+    static BOOL CALLBACK EnumWindowsForProcess(HWND hWnd, LPARAM lParam) {
+        auto* state = reinterpret_cast<WindowSearch*>(lParam);
+        DWORD windowPid = 0;
+        GetWindowThreadProcessId(hWnd, &windowPid);
+        if (windowPid != state->pid) {
+            return TRUE;
         }
 
-        const std::string electronPath = ResolveElectronPath();
-        const std::string appPath = ResolveOverlayAppPath();
-        if (electronPath.empty() || appPath.empty()) {
-            return;
+        if (!IsWindowVisible(hWnd)) {
+            return TRUE;
         }
 
-        const std::string args = "\"" + electronPath + "\" \"" + appPath + "\"";
-        SpawnProcess(electronPath, args, appPath);
+        int length = GetWindowTextLengthA(hWnd);
+        if (length <= 0) {
+            return TRUE;
+        }
+
+        state->window = hWnd;
+        return FALSE;
     }
 
-    void CloseExistingOverlay() {
-        HWND overlay = FindWindowA(nullptr, "Customs on the Ring");
-        if (!overlay) {
+    HWND FindTopLevelWindowForProcess(DWORD pid) {
+        WindowSearch state;
+        state.pid = pid;
+        EnumWindows(EnumWindowsForProcess, reinterpret_cast<LPARAM>(&state));
+        return state.window;
+    }
+#endif
+
+    void EnsureModuleBases() {
+        if (!connected || processId == 0) {
             return;
         }
 
-        DWORD pid = 0;
-        GetWindowThreadProcessId(overlay, &pid);
-        if (pid == 0) {
+        // A title switch unloads haloreach.dll; its old base stops being readable.
+        const uint64_t nowMs = NowSteadyMs();
+        if (haloReachBase != 0 && !regionCache.IsReadable(haloReachBase, nowMs)) {
+            haloReachBase = 0;
+            regionCache.Invalidate();
+        }
+        if (mccBase != 0 && haloReachBase != 0) {
             return;
         }
 
-        PostMessageA(overlay, WM_CLOSE, 0, 0);
-        Sleep(200);
-
-        overlay = FindWindowA(nullptr, "Customs on the Ring");
-        if (!overlay) {
+        // Module snapshots are expensive; look for a missing module at most every kModuleRescanMs.
+        if (lastModuleScanMs != 0 && nowMs - lastModuleScanMs < kModuleRescanMs) {
             return;
         }
+        lastModuleScanMs = nowMs;
 
-        HANDLE proc = OpenProcess(PROCESS_TERMINATE, FALSE, pid);
-        if (proc) {
-            TerminateProcess(proc, 0);
-            CloseHandle(proc);
+        bool loaded = false;
+        if (mccBase == 0) {
+            mccBase = process.FindModuleBase(kMccModuleName);
+            loaded = loaded || mccBase != 0;
+        }
+        if (haloReachBase == 0) {
+            haloReachBase = process.FindModuleBase(kReachModuleName);
+            loaded = loaded || haloReachBase != 0;
+        }
+        if (loaded) {
+            // Regions and failing addresses cached before the load no longer describe the module.
+            regionCache.Invalidate();
         }
     }
 
-    std::string ResolveOverlayAppPath() {
-        const std::string env = GetEnvVar("HMCC_OVERLAY_APP");
-        if (!env.empty()) {
-            return env;
+    // The tick's remote reads in two batches: the player counts and the shared block pointer at fixed module
+    // offsets, then the name fields and the player table behind that pointer. A batch is one process_vm_readv
+    // on Linux, so a tick costs two syscalls rather than one per field, and no field is read twice.
+    void ReadTickFields(ReadDebug* out_debug) {
+        TickReads& t = tickReads;
+        t.reads.fill(mccmod::RemoteRead{});
+        t.skipped.fill(false);
+        t.traced.fill(false);
+        t.queuedCount = 0;
+        t.sharedBase = 0;
+
+        EnsureModuleBases();
+        if (out_debug) {
+            out_debug->connected = connected;
+            out_debug->pid = processId;
+            out_debug->mccBase = mccBase;
+            out_debug->reachBase = haloReachBase;
         }
 
-        const auto root = ResolveRepoRoot();
-        if (root.empty()) {
-            return "";
+        if (mccBase != 0) {
+            QueueRead(ReadLabel::SharedBase, mccBase + kSharedTelemetryBaseOffset, &t.sharedBase, sizeof(t.sharedBase));
+            QueueRead(ReadLabel::PlayersMcc, mccBase + kMccPlayerCountOffset, &t.players[0], sizeof(int));
         }
-        const auto appPath = root / "pc-app";
-        if (std::filesystem::exists(appPath)) {
-            return appPath.string();
+        if (haloReachBase != 0) {
+            QueueRead(ReadLabel::PlayersReach0, haloReachBase + kReachPlayerCountOffsets[0], &t.players[1], sizeof(int));
+            QueueRead(ReadLabel::PlayersReach1, haloReachBase + kReachPlayerCountOffsets[1], &t.players[2], sizeof(int));
+            QueueRead(ReadLabel::PlayersReach2, haloReachBase + kReachPlayerCountOffsets[2], &t.players[3], sizeof(int));
         }
-        return "";
+        ReadQueued(out_debug);
+        if (!HasSharedBlock()) {
+            return;
+        }
+
+        QueueNameRead(ReadLabel::Map, t.sharedBase + kMapNameOffset);
+        QueueNameRead(ReadLabel::ModePrimary, t.sharedBase + kModeNameOffsetPrimary);
+        QueueNameRead(ReadLabel::ModeSecondary, t.sharedBase + kModeNameOffsetSecondary);
+        if (rosterEnabled) {
+            QueueRead(ReadLabel::Roster, t.sharedBase + mccmod::kPlayerTableOffset, t.rosterTable.data(),
+                      t.rosterTable.size());
+        }
+        ReadQueued(out_debug);
     }
 
-    std::string ResolveElectronPath() {
-        const std::string env = GetEnvVar("HMCC_ELECTRON_PATH");
-        if (!env.empty()) {
-            return env;
+    void QueueRead(ReadLabel label, uintptr_t address, void* buffer, size_t size) {
+        mccmod::RemoteRead& read = tickReads.reads[static_cast<size_t>(label)];
+        read.address = address;
+        read.buffer = buffer;
+        read.size = size;
+        tickReads.queued[tickReads.queuedCount++] = label;
+    }
+
+    void QueueNameRead(ReadLabel label, uintptr_t address) {
+        StringBytes& raw = tickReads.names[static_cast<size_t>(label) - static_cast<size_t>(ReadLabel::Map)];
+        QueueRead(label, address, raw.data.data(), mccmod::NameFieldReadBytes(address));
+    }
+
+    // Reads the queued fields that the region cache admits, as one batch unless batching is off. Name fields
+    // are traced by ReadNameField, which has the decoded value.
+    void ReadQueued(ReadDebug* out_debug) {
+        TickReads& t = tickReads;
+        const uint64_t nowMs = NowSteadyMs();
+        ReaderMetrics& metrics = GetReaderMetrics();
+        std::array<mccmod::RemoteRead, kReadLabelCount> batch;
+        std::array<ReadLabel, kReadLabelCount> batchLabels;
+        size_t count = 0;
+        for (size_t i = 0; i < t.queuedCount; i++) {
+            const ReadLabel label = t.queued[i];
+            const mccmod::RemoteRead& read = t.reads[static_cast<size_t>(label)];
+            if (!regionCache.Admit(read.address, read.size, nowMs)) {
+                t.skipped[static_cast<size_t>(label)] = true;
+                metrics.readsSkipped.Add();
+                continue;
+            }
+            batch[count] = read;
+            batchLabels[count++] = label;
         }
+        t.queuedCount = 0;
 
-        const auto root = ResolveRepoRoot();
-        if (root.empty()) {
-            return "";
+        size_t succeeded = 0;
+        if (batchReads) {
+            succeeded = process.ReadBatch(batch.data(), count);
+        } else {
+            // Batches of one: the same syscall per field as a plain read, with the error kept per entry.
+            for (size_t i = 0; i < count; i++) {
+                succeeded += process.ReadBatch(&batch[i], 1);
+            }
         }
-        const auto electronPath =
-            root / "pc-app" / "node_modules" / "electron" / "dist" / "electron.exe";
-        if (std::filesystem::exists(electronPath)) {
-            return electronPath.string();
+#if !defined(_WIN32)
+        if (count > 0 && succeeded == 0 && batch[0].error == EPERM) {
+            WarnReadDenied();
+        }
+#endif
+
+        for (size_t i = 0; i < count; i++) {
+            const ReadLabel label = batchLabels[i];
+            t.reads[static_cast<size_t>(label)] = batch[i];
+            regionCache.RecordResult(batch[i].address, batch[i].ok, nowMs,
+                                     IsNameLabel(label) ? kNameBackoffMaxMs : mccmod::kRegionBackoffMaxMs);
+            (batch[i].ok ? metrics.readsOk : metrics.readsFailed).Add();
+        }
+        if (!out_debug) {
+            return;
+        }
+        for (size_t i = 0; i < kReadLabelCount; i++) {
+            const ReadLabel label = static_cast<ReadLabel>(i);
+            const mccmod::RemoteRead& read = t.reads[i];
+            if (read.size != 0 && !IsNameLabel(label) && !t.traced[i]) {
+                out_debug->Record(label, read.address, read.ok, t.skipped[i], read.bytes_read);
+                t.traced[i] = true;
+            }
         }
-        return "";
     }
 
-    std::filesystem::path ResolveRepoRoot() {
-        char buffer[MAX_PATH] = {};
-        DWORD size = GetModuleFileNameA(nullptr, buffer, MAX_PATH);
-        if (size == 0 || size >= MAX_PATH) {
-            return {};
+#if !defined(_WIN32)
+    // Yama's ptrace_scope=1, the default on many distributions and the Steam Deck, lets a process read only
+    // its descendants' memory, and Proton's game process is not one.
+    void WarnReadDenied() {
+        if (warnedReadDenied) {
+            return;
         }
-        std::filesystem::path exePath(buffer);
-        auto dir = exePath.parent_path();
-        if (dir.empty()) {
-            return {};
+        warnedReadDenied = true;
+        std::cerr << "\n[reader] reading pid " << processId
+                  << " was denied (EPERM); set /proc/sys/kernel/yama/ptrace_scope to 0 or give the reader "
+                     "cap_sys_ptrace"
+                  << std::endl;
+    }
+#endif
+
+    bool TickReadOk(ReadLabel label) const {
+        return tickReads.reads[static_cast<size_t>(label)].ok;
+    }
+
+    bool HasSharedBlock() const {
+        return TickReadOk(ReadLabel::SharedBase) && tickReads.sharedBase != 0;
+    }
+
+    // Each player count is its own source, numbered in ReadLabel order.
+    void ReadPlayerCandidates(IntCandidates* out) const {
+        static constexpr ReadLabel kPlayerLabels[] = {
+            ReadLabel::PlayersMcc, ReadLabel::PlayersReach0, ReadLabel::PlayersReach1, ReadLabel::PlayersReach2};
+        for (size_t i = 0; i < tickReads.players.size(); i++) {
+            const int value = tickReads.players[i];
+            if (TickReadOk(kPlayerLabels[i]) && value >= 0 && value <= kMaxPlayers) {
+                out->Add(value, static_cast<uint8_t>(i));
+            }
         }
-        dir = dir.parent_path();
-        dir = dir.parent_path();
-        dir = dir.parent_path();
-        return dir;
     }
 
-    std::string GetEnvVar(const char* name) {
-        if (!name || !*name) {
-            return "";
+    void ReadMapCandidates(StringCandidates* out, ReadDebug* out_debug) {
+        if (HasSharedBlock() && ReadNameField(ReadLabel::Map, mapField, &nameScratch, out_debug)) {
+            out->Add(nameScratch, kNameFieldSource);
         }
-        char buffer[MAX_PATH] = {};
-        DWORD size = GetEnvironmentVariableA(name, buffer, MAX_PATH);
-        if (size > 0 && size < MAX_PATH) {
-            return std::string(buffer);
+    }
+
+    void ReadModeCandidates(const std::string& mapName, StringCandidates* out, ReadDebug* out_debug) {
+        if (!HasSharedBlock()) {
+            return;
+        }
+        for (size_t field = 0; field < modeFields.size(); field++) {
+            const ReadLabel label = field == 0 ? ReadLabel::ModePrimary : ReadLabel::ModeSecondary;
+            if (!ReadNameField(label, modeFields[field], &nameScratch, out_debug)) {
+                continue;
+            }
+            if (!mapName.empty() && mapName != "Unknown" && nameScratch == mapName) {
+                continue;
+            }
+            // Both offsets are one source: agreeing with each other is not independent confirmation.
+            out->Add(nameScratch, kNameFieldSource);
         }
-        return "";
     }
 
-    void SpawnProcess(const std::string& exePath, const std::string& args, const std::string& workingDir = "") {
-        if (exePath.empty()) {
+    // The whole player table, read in one piece with the tick's second batch. RosterTracker decodes it only
+    // when its bytes move, and flags a change only when a name, team or slot did.
+    void ReadRoster() {
+        rosterValid = false;
+        rosterUpdated = false;
+        if (!TickReadOk(ReadLabel::Roster)) {
             return;
         }
-        STARTUPINFOA si = {};
-        PROCESS_INFORMATION pi = {};
-        si.cb = sizeof(si);
+        rosterValid = true;
+        rosterUpdated = rosterTracker.Update(tickReads.rosterTable.data());
+        if (rosterUpdated) {
+            GetReaderMetrics().rosterChanges.Add();
+        }
+    }
 
-        std::string commandLine = args.empty() ? ("\"" + exePath + "\"") : args;
-        std::vector<char> cmdBuffer(commandLine.begin(), commandLine.end());
-        cmdBuffer.push_back('\0');
+    // Takes one name field from the tick's reads and reports whether it holds a plausible map or mode name,
+    // trimmed and interned. The decode runs only when the raw bytes differ from the last read
+    // (StringFieldCache.h).
+    bool ReadNameField(ReadLabel label, mccmod::StringFieldCache& cache, std::string* out_value,
+                       ReadDebug* out_debug) {
+        const size_t index = static_cast<size_t>(label);
+        const mccmod::RemoteRead& read = tickReads.reads[index];
+        const uintptr_t address = read.address;
+        StringBytes& raw = tickReads.names[index - static_cast<size_t>(ReadLabel::Map)];
+        raw.size = read.bytes_read;
+        if (!read.ok) {
+            cache.Reset();
+            if (out_debug) {
+                out_debug->Record(label, address, false, tickReads.skipped[index], raw.size);
+            }
+            return false;
+        }
 
-        BOOL created = CreateProcessA(
-            nullptr,
-            cmdBuffer.data(),
-            nullptr,
-            nullptr,
-            FALSE,
-            CREATE_NO_WINDOW | DETACHED_PROCESS,
-            nullptr,
-            workingDir.empty() ? nullptr : workingDir.c_str(),
-            &si,
-            &pi
-        );
+        bool accepted = false;
+        if (cache.Lookup(address, raw.data.data(), raw.size, &accepted, out_value)) {
+            GetReaderMetrics().stringsReused.Add();
+            if (out_debug) {
+                out_debug->Record(label, address, true, false, raw.size, out_value);
+            }
+            return accepted;
+        }
 
-        if (created) {
-            CloseHandle(pi.hProcess);
-            CloseHandle(pi.hThread);
+        // UTF-8 unless the bytes look like UTF-16LE and decode to a better name; either way from the bytes
+        // already read.
+        mccmod::DecodeNameField(raw.data.data(), raw.size, address,
+                                label == ReadLabel::Map ? AcceptMapText : AcceptModeText, out_value);
+        if (out_debug) {
+            out_debug->Record(label, address, true, false, raw.size, out_value);
         }
+        mccmod::TrimInPlace(out_value);
+        if (label == ReadLabel::Map) {
+            accepted = AcceptMapText(*out_value);
+            if (accepted) {
+                InternCatalogName(mccmod::FindCatalogMap(*out_value), out_value);
+            }
+        } else {
+            accepted = AcceptModeText(*out_value);
+            if (accepted) {
+                InternCatalogName(mccmod::FindCatalogGameMode(*out_value), out_value);
+            }
+        }
+        cache.Store(accepted, *out_value);
+        GetReaderMetrics().stringsDecoded.Add();
+        return accepted;
     }
 
-    void InitializeAddresses() {
-        // Legacy absolute addresses are session-specific and produce false positives.
-        // Keep runtime acquisition module-relative only.
-        candidateAddresses.clear();
+    // 1-64 bytes of printable ASCII with at least one letter (NameClassifier.h).
+    static bool AcceptMapText(std::string_view name) {
+        if (!mccmod::IsLikelyNameText(name)) {
+            return false;
+        }
+        if (!kUseMapWhitelist) {
+            return true;
+        }
+        return mccmod::FindCatalogMap(name) != nullptr;
+    }
 
+    static bool AcceptModeText(std::string_view mode) {
+        return mccmod::IsLikelyNameText(mode);
     }
 
-    ProcessEvent UpdateProcessState() {
-        DWORD pid = FindMccProcessId();
-        if (pid == 0) {
-            if (connected) {
-                DisconnectProcess();
-                return { ProcessEventType::Stopped, 0 };
-            }
-            return {};
+
+    bool IsInMenus(int playerCount) const {
+        return playerCount <= 0;
+    }
+
+    const char* BuildStatus(int playerCount, bool inMenus, bool isConnected) const {
+        if (!isConnected) {
+            return "Disconnected";
+        }
+        if (inMenus) {
+            return "Lobby in menus";
+        }
+        if (playerCount <= 1) {
+            return "Waiting for players";
+        }
+        return "Game ready";
+    }
+
+    // "consensus" when any signal had more than one distinct source this tick.
+    const char* ComputeSourceTag() const {
+        const int sources = std::max({mapSignal.Sources(), modeSignal.Sources(), playerSignal.Sources()});
+        if (sources > 1) {
+            return "consensus";
+        }
+        return sources == 1 ? "single" : "none";
+    }
+};
+
+class MCCPlayerCountConsole {
+public:
+    // simulateMs > 0 runs that much virtual time on the default clock, which the caller has
+    // pointed at a VirtualClock, and then returns from Run().
+    MCCPlayerCountConsole(bool headless, uint64_t simulateMs)
+        : headless(headless), simulateMs(simulateMs), startMs(NowSteadyMs()) {
+        readerOptions.mapFilter = FilterFromEnv("HMCC_READER_MAP_FILTER", mccmod::kMapFilterDefaults);
+        readerOptions.modeFilter = FilterFromEnv("HMCC_READER_MODE_FILTER", mccmod::kModeFilterDefaults);
+        readerOptions.playerFilter = FilterFromEnv("HMCC_READER_PLAYER_FILTER", mccmod::kPlayerFilterDefaults);
+        if (GetEnvVar("HMCC_READER_FAST_COMMIT") == "0") {
+            readerOptions.mapFilter.fast_commit = false;
+            readerOptions.modeFilter.fast_commit = false;
+            readerOptions.playerFilter.fast_commit = false;
+        }
+        readerOptions.incrementalStrings = GetEnvVar("HMCC_READER_INCREMENTAL_STRINGS") != "0";
+        readerOptions.roster = GetEnvVar("HMCC_READER_ROSTER") == "1";
+        readerOptions.batchReads = GetEnvVar("HMCC_READER_BATCH_READS") != "0";
+        readerOptions.focusOnConnect = !headless;
+    }
+
+    bool Initialize() {
+        if (headless) {
+            // Before any thread starts, so every thread inherits the lower priority.
+            mccmod::LowerProcessPriority();
+        }
+        mccmod::InstallShutdownHandlers();
+#if defined(_WIN32)
+        if (!headless) {
+            // Closing the old overlay and spawning Electron can take seconds; sampling starts without it.
+            overlayThread = std::thread([this] {
+                const uint64_t launchStartMs = NowSteadyMs();
+                LaunchOverlayIfNeeded();
+                overlayLaunchMs.store(static_cast<int64_t>(NowSteadyMs() - launchStartMs));
+            });
+        }
+#endif
+        StartPublisher();
+        StartSender();
+        StartMetrics();
+        ResolveFlightRecorderPath();
+        instances.push_back(CreateInstance(0));
+        UpdateInstances();
+        if (headless) {
+            std::cerr << "MCC telemetry reader running headless." << std::endl;
+        } else {
+            std::cout << "MCC Player Count Console running. Press ESC to exit." << std::endl;
         }
+        return true;
+    }
 
-        if (!connected) {
-            if (ConnectToProcess(pid)) {
-                return { ProcessEventType::Started, pid };
+    void Run() {
+        const bool debugMode = StringEqualsIgnoreCase(GetEnvVar("HMCC_READER_DEBUG"), "1");
+        // Simulated runs sample and emit inline on this thread so virtual time only moves
+        // when the whole tick is done, which keeps them deterministic.
+        std::thread emitter;
+        if (!simulated()) {
+            // Output (file write, pub/sub, receiver, console) runs on its own thread so
+            // slow I/O never delays the next sample.
+            emitterRunning.store(true);
+            emitter = std::thread(&MCCPlayerCountConsole::EmitterLoop, this, debugMode);
+            // Each MCC process is sampled on a worker, so a hung process only stalls its own reads.
+            samplers.Start(SamplerWorkerCount());
+        }
+
+        // Real time waits also watch the shutdown signal so Ctrl+C and --stop take effect at once.
+        if (!simulated()) {
+            scheduler.SetWakeHandle(mccmod::ShutdownWakeHandle());
+        }
+        scheduler.Reset();
+        const uint64_t startTickMs = NowSteadyMs();
+        const uint64_t simulationEndMs = startTickMs + simulateMs;
+        const auto simulationStart = std::chrono::steady_clock::now();
+        uint64_t simulatedTicks = 0;
+        // Process discovery watches real processes, so it keeps real-time pacing; in a simulated
+        // run a /proc scan every simulated second would cost more than the ticks themselves.
+        uint64_t lastProcessScanMs = mccmod::SystemClock().SteadyMs();
+        uint64_t lastBudgetMs = startTickMs;
+        uint64_t lastBudgetLogMs = startTickMs;
+        UpdateBudget(startTickMs);
+        while (!mccmod::IsShutdownRequested() && !(simulated() && NowSteadyMs() >= simulationEndMs)) {
+#if defined(_WIN32)
+            if (!headless && (GetAsyncKeyState(VK_ESCAPE) & 0x8000)) {
+                break;
+            }
+#endif
+            wakeups.fetch_add(1, std::memory_order_relaxed);
+
+            uint64_t nowMs = NowSteadyMs();
+            const uint64_t scanNowMs = mccmod::SystemClock().SteadyMs();
+            if (scanNowMs - lastProcessScanMs >= kProcessScanMs) {
+                lastProcessScanMs = scanNowMs;
+                UpdateInstances();
+            }
+            ScheduleSamples(debugMode);
+            if (simulated()) {
+                EmitPending(debugMode);
+                simulatedTicks++;
+            }
+
+            // The budget measures real resource use; it means nothing in virtual time.
+            if (!simulated() && nowMs - lastBudgetMs >= budgetWindowMs) {
+                lastBudgetMs = nowMs;
+                UpdateBudget(nowMs);
+                if (headless && nowMs - lastBudgetLogMs >= kBudgetLogMs) {
+                    lastBudgetLogMs = nowMs;
+                    std::cerr << "[reader] budget " << BuildBudgetJson() << std::endl;
+                }
+            }
+
+            // Only the headless service stretches its interval; the interactive console keeps full rate.
+            const uint64_t intervalMs = static_cast<uint64_t>(kPollIntervalMs) * (headless ? throttle.load() : 1);
+            scheduler.SetPeriodUs(intervalMs * 1000);
+            if (!scheduler.WaitNextTick()) {
+                // Latches a stop event set from outside the process.
+                mccmod::WaitForShutdown(0);
             }
-            return {};
         }
 
-        if (pid != processId) {
-            DisconnectProcess();
-            if (ConnectToProcess(pid)) {
-                return { ProcessEventType::Changed, pid };
+        if (simulated()) {
+            const double cpuSeconds =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - simulationStart).count();
+            std::cerr << "[reader] simulated " << simulateMs / 1000 << " s in " << std::fixed
+                      << std::setprecision(2) << cpuSeconds << " s (" << simulatedTicks << " ticks)" << std::endl;
+        }
+
+        // A sampler blocked in a read of a hung client must not hold up exit; its worker is left behind.
+        if (!samplers.Stop(kSamplerStopTimeoutMs)) {
+            std::cerr << "\n[reader] a sampler did not return within " << kSamplerStopTimeoutMs
+                      << " ms; leaving it behind" << std::endl;
+        }
+        emitterRunning.store(false);
+        WakeEmitter();
+        if (emitter.joinable()) {
+            emitter.join();
+        }
+        if (overlayThread.joinable()) {
+            overlayThread.join();
+        }
+
+        std::vector<std::shared_ptr<ReaderInstance>> remaining;
+        {
+            std::lock_guard<std::mutex> lock(instancesMutex);
+            remaining.swap(instances);
+        }
+        for (const auto& instance : remaining) {
+            if (!instance->IsSampling()) {
+                instance->CloseFlightRecorder();
             }
         }
 
-        return { ProcessEventType::None, pid };
+        StopMetrics();
+        publisher.Stop();
+        if (senderRunning) {
+            for (const auto& instance : remaining) {
+                sender.Submit(BuildReceiverSnapshot(*instance, TickSnapshot{}), mccmod::DefaultClock().SteadyUs());
+            }
+            sender.Stop();
+        }
+        std::cout << std::endl;
     }
 
-    DWORD FindMccProcessId() {
-        HWND window = FindWindowA(nullptr, "Halo: The Master Chief Collection");
-        if (window) {
-            DWORD pid = 0;
-            GetWindowThreadProcessId(window, &pid);
-            if (pid != 0) {
-                return pid;
+private:
+    const bool headless;
+    const uint64_t simulateMs;
+    const uint64_t startMs;
+    // Startup metrics in ms; -1 until known. firstSnapshotMs is owned by the emitter.
+    int64_t firstSnapshotMs = -1;
+    std::atomic<int64_t> overlayLaunchMs{-1};
+    std::thread overlayThread;
+    size_t lastLineWidth = 0;
+    ReaderOptions readerOptions;
+    std::string flightPath;
+    mccmod::SnapshotPublisher publisher;
+    bool publisherRunning = false;
+    mccmod::TelemetrySender sender;
+    bool senderRunning = false;
+    mccmod::MetricsServer metricsServer;
+    int metricsCollector = 0;
+
+    // instances[0] is the primary reader; the rest follow additional MCC clients.
+    std::vector<std::shared_ptr<ReaderInstance>> instances;
+    std::mutex instancesMutex;
+    std::atomic<size_t> activeInstances{0};
+    mccmod::WorkerPool samplers;
+
+    std::atomic<bool> emitterRunning{false};
+    std::mutex emitterMutex;
+    std::condition_variable emitterWake;
+    bool tickPosted = false;
+
+    // Wakeups of the scheduler, emitter and sampler tasks, measured against the budget.
+    std::atomic<uint64_t> wakeups{0};
+    std::atomic<uint32_t> throttle{1};
+    // Paces Run() on absolute deadlines; a stalled tick skips ahead rather than bunching up.
+    mccmod::TickScheduler scheduler{mccmod::TickSchedulerOptions{
+        static_cast<uint64_t>(kPollIntervalMs) * 1000, mccmod::MissedTickPolicy::kSkip, 0}};
+    mccmod::ResourceBudget budget{BudgetLimitsFromEnv()};
+    mutable std::mutex budgetMutex;
+    const uint64_t budgetWindowMs = BudgetWindowFromEnv();
+
+    static bool StringEqualsIgnoreCase(const std::string& a, const std::string& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) {
+                return false;
             }
         }
+        return true;
+    }
 
-        DWORD pid = FindProcessIdByName("MCC-Win64-Shipping.exe");
-        if (pid == 0) {
-            pid = FindProcessIdByName("MCC-Win64-Shipping");
-        }
-        return pid;
+    void UpdateBudget(uint64_t nowMs) {
+        std::lock_guard<std::mutex> lock(budgetMutex);
+        throttle.store(budget.Update(nowMs, wakeups.load()).throttle);
     }
 
-    bool ConnectToProcess(DWORD pid) {
-        processId = pid;
-        gameWindow = FindTopLevelWindowForProcess(pid);
-        processHandle = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
-        connected = processHandle != nullptr;
-        ResetSessionState();
-        return connected;
+    std::string BuildBudgetJson() const {
+        mccmod::ResourceReport report;
+        mccmod::ResourceLimits limits;
+        {
+            std::lock_guard<std::mutex> lock(budgetMutex);
+            report = budget.Report();
+            limits = budget.Limits();
+        }
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1);
+        out << "{"
+            << "\"workingSetBytes\":" << report.working_set_bytes << ","
+            << "\"cpuMsPerMinute\":" << report.cpu_ms_per_minute << ","
+            << "\"wakeupsPerSecond\":" << report.wakeups_per_second << ","
+            << "\"limits\":{"
+            << "\"workingSetBytes\":" << limits.max_working_set_bytes << ","
+            << "\"cpuMsPerMinute\":" << limits.max_cpu_ms_per_minute << ","
+            << "\"wakeupsPerSecond\":" << limits.max_wakeups_per_second << "},"
+            << "\"overMemory\":" << (report.over_memory ? "true" : "false") << ","
+            << "\"overCpu\":" << (report.over_cpu ? "true" : "false") << ","
+            << "\"overWakeups\":" << (report.over_wakeups ? "true" : "false") << ","
+            << "\"throttle\":" << report.throttle << ","
+            << "\"trims\":" << report.trims
+            << "}";
+        return out.str();
     }
 
-    void DisconnectProcess() {
-        if (processHandle) {
-            CloseHandle(processHandle);
-            processHandle = nullptr;
+#if defined(_WIN32)
+    void LaunchOverlayIfNeeded() {
+        CloseExistingOverlay();
+        if (FindWindowA(nullptr, "Customs on the Ring")) {
+            return;
         }
-        connected = false;
-        processId = 0;
-        gameWindow = nullptr;
-        ResetSessionState();
+
+        const std::string overlayExe = GetEnvVar("HMCC_OVERLAY_EXE");
+        if (!overlayExe.empty()) {
+            SpawnProcess(overlayExe, "");
+            return;
+        }
+
+        const std::string electronPath = ResolveElectronPath();
+        const std::string appPath = ResolveOverlayAppPath();
+        if (electronPath.empty() || appPath.empty()) {
+            return;
+        }
+
+        const std::string args = "\"" + electronPath + "\" \"" + appPath + "\"";
+        SpawnProcess(electronPath, args, appPath);
     }
+#endif
 
-    void ResetSessionState() {
-        mccBase = 0;
-        haloReachBase = 0;
-        mapSignal.Reset();
-        modeSignal.Reset();
-        playerSignal.Reset();
+    void StartPublisher() {
+        // HMCC_READER_PUBSUB: unset/"1" uses the default endpoint, "0" disables, anything else is the endpoint name.
+        const std::string setting = GetEnvVar("HMCC_READER_PUBSUB");
+        if (setting == "0") {
+            return;
+        }
+        const std::string endpoint = (setting.empty() || setting == "1") ? "" : setting;
+        publisherRunning = publisher.Start(endpoint);
+        if (!publisherRunning && IsReaderDebugEnabled()) {
+            std::cerr << "\n[reader] pub/sub endpoint unavailable: "
+                      << (endpoint.empty() ? mccmod::SnapshotPublisher::GetDefaultEndpoint() : endpoint) << std::endl;
+        }
     }
 
-    void FocusGameWindow() {
-        if (!gameWindow) {
+    void StartSender() {
+        // HMCC_READER_ENDPOINT: "1" posts to the local receiver, a URL posts there, unset keeps file output.
+        const std::string setting = GetEnvVar("HMCC_READER_ENDPOINT");
+        if (setting.empty() || setting == "0") {
             return;
         }
-        ShowWindow(gameWindow, SW_RESTORE);
-        SetForegroundWindow(gameWindow);
-        BringWindowToTop(gameWindow);
+        const std::string endpoint = setting == "1" ? "http://127.0.0.1:4760/telemetry" : setting;
+        // Snapshots wait here while the receiver is down and are replayed when it returns.
+        const std::string spoolPath =
+            std::filesystem::path(ResolveTelemetryPath()).replace_filename("reader_spool.log").string();
+        senderRunning = sender.Start(endpoint, spoolPath);
+        if (senderRunning) {
+            std::cout << "Posting telemetry to: " << endpoint << std::endl;
+        }
     }
 
-    DWORD FindProcessIdByName(const char* exeName) {
-        if (!exeName || !*exeName) {
-            return 0;
+    void StartMetrics() {
+        // HMCC_READER_METRICS_PORT: serves Prometheus metrics on 127.0.0.1 at that port; unset or "0" disables.
+        const int port = std::atoi(GetEnvVar("HMCC_READER_METRICS_PORT").c_str());
+        if (port <= 0 || port > 65535) {
+            return;
+        }
+        // Stats kept elsewhere are copied into gauges when a scrape renders.
+        mccmod::MetricsRegistry& registry = mccmod::DefaultMetrics();
+        metricsCollector = registry.AddCollector([this, &registry] {
+            registry.Gauge("mcc_reader_instances", "MCC processes being followed.")
+                .Set(static_cast<int64_t>(activeInstances.load()));
+            registry.Gauge("mcc_reader_throttle", "Poll interval multiplier from the resource budget.")
+                .Set(throttle.load());
+            {
+                std::lock_guard<std::mutex> lock(instancesMutex);
+                uint64_t avoided = 0;
+                for (const auto& instance : instances) {
+                    avoided += instance->ReadsAvoidedPerHour();
+                }
+                registry.Gauge("mcc_reader_region_reads_avoided_per_hour",
+                               "Failing reads the region cache kept from the kernel, extrapolated to one hour.")
+                    .Set(static_cast<int64_t>(avoided));
+            }
+            const mccmod::TickSchedulerStats schedulerStats = scheduler.GetStats();
+            registry.Gauge("mcc_reader_scheduler_ticks", "Scheduler ticks run.")
+                .Set(static_cast<int64_t>(schedulerStats.ticks));
+            registry.Gauge("mcc_reader_scheduler_missed", "Scheduler deadlines skipped.")
+                .Set(static_cast<int64_t>(schedulerStats.missed));
+            registry.Gauge("mcc_reader_scheduler_lateness_p99_us", "99th percentile tick lateness in microseconds.")
+                .Set(static_cast<int64_t>(schedulerStats.lateness_us.p99));
+            {
+                std::lock_guard<std::mutex> lock(budgetMutex);
+                const mccmod::ResourceReport report = budget.Report();
+                registry.Gauge("mcc_reader_working_set_bytes", "Working set at the last budget check.")
+                    .Set(static_cast<int64_t>(report.working_set_bytes));
+                registry.Gauge("mcc_reader_cpu_ms_per_minute", "CPU time per minute over the last budget window.")
+                    .Set(static_cast<int64_t>(report.cpu_ms_per_minute));
+                registry.Gauge("mcc_reader_wakeups_per_second", "Loop wakeups per second over the last budget window.")
+                    .Set(static_cast<int64_t>(report.wakeups_per_second));
+                registry.Gauge("mcc_reader_working_set_trims", "Working set trims the memory budget has made.")
+                    .Set(static_cast<int64_t>(report.trims));
+            }
+            if (senderRunning) {
+                const auto senderStats = sender.GetStats();
+                registry.Gauge("mcc_reader_sender_sent", "Snapshots the receiver acknowledged.")
+                    .Set(static_cast<int64_t>(senderStats.sent));
+                registry.Gauge("mcc_reader_sender_spool_pending", "Snapshots waiting in the spool.")
+                    .Set(static_cast<int64_t>(senderStats.delivery.spool_pending));
+                registry.Gauge("mcc_reader_sender_last_latency_ms", "Capture to acknowledgement of the last post.")
+                    .Set(static_cast<int64_t>(senderStats.last_latency_ms));
+            }
+        });
+        if (metricsServer.Start(static_cast<uint16_t>(port))) {
+            std::cerr << "Serving metrics on http://127.0.0.1:" << metricsServer.Port() << "/metrics" << std::endl;
+        } else {
+            std::cerr << "[reader] metrics port " << port << " unavailable" << std::endl;
         }
+    }
 
-        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-        if (snapshot == INVALID_HANDLE_VALUE) {
-            return 0;
+    void StopMetrics() {
+        metricsServer.Stop();
+        if (metricsCollector != 0) {
+            mccmod::DefaultMetrics().RemoveCollector(metricsCollector);
+            metricsCollector = 0;
         }
+    }
 
-        PROCESSENTRY32 entry = {};
-        entry.dwSize = sizeof(entry);
+    void ResolveFlightRecorderPath() {
+        // HMCC_READER_FLIGHT: unset records next to the telemetry file, "0" disables, anything else is the ring path.
+        const std::string setting = GetEnvVar("HMCC_READER_FLIGHT");
+        if (setting == "0") {
+            return;
+        }
+        flightPath = setting;
+        if (flightPath.empty()) {
+            flightPath = std::filesystem::path(ResolveTelemetryPath()).replace_filename("reader_flight.bin").string();
+        }
+    }
 
-        if (Process32First(snapshot, &entry)) {
-            do {
-                if (_stricmp(entry.szExeFile, exeName) == 0) {
-                    CloseHandle(snapshot);
-                    return entry.th32ProcessID;
-                }
-            } while (Process32Next(snapshot, &entry));
+    // Secondary instances write next to the primary's files with the pid appended to the stem.
+    static std::string InstancePath(const std::string& path, ProcessId instancePid) {
+        if (instancePid == 0) {
+            return path;
         }
+        std::filesystem::path result(path);
+        result.replace_filename(
+            result.stem().string() + "_" + std::to_string(instancePid) + result.extension().string());
+        return result.string();
+    }
 
-        CloseHandle(snapshot);
-        return 0;
+    static size_t SamplerWorkerCount() {
+        const size_t cores = std::thread::hardware_concurrency();
+        return std::min(kMaxSamplerWorkers, std::max<size_t>(2, cores / 2));
     }
 
-    struct WindowSearch {
-        DWORD pid = 0;
-        HWND window = nullptr;
-    };
+    std::shared_ptr<ReaderInstance> CreateInstance(ProcessId instancePid) {
+        auto instance = std::make_shared<ReaderInstance>(instancePid, readerOptions, [this] { WakeEmitter(); });
+        if (!flightPath.empty()) {
+            instance->OpenFlightRecorder(InstancePath(flightPath, instancePid));
+        }
+        return instance;
+    }
 
-    static BOOL CALLBACK EnumWindowsForProcess(HWND hWnd, LPARAM lParam) {
-        auto* state = reinterpret_cast<WindowSearch*>(lParam);
-        DWORD windowPid = 0;
-        GetWindowThreadProcessId(hWnd, &windowPid);
-        if (windowPid != state->pid) {
-            return TRUE;
+    void UpdateInstances() {
+        const std::vector<ProcessId> pids = FindMccProcessIds();
+        auto isLive = [&pids](ProcessId pid) { return std::find(pids.begin(), pids.end(), pid) != pids.end(); };
+
+        std::lock_guard<std::mutex> lock(instancesMutex);
+        // Secondaries leave once their final disconnected tick has been emitted.
+        instances.erase(
+            std::remove_if(instances.begin() + 1, instances.end(), [](const auto& instance) {
+                return instance->IsRetired() && !instance->ticks.HasNew();
+            }),
+            instances.end()
+        );
+
+        for (const auto& instance : instances) {
+            const ProcessId target = instance->Target();
+            if (target == 0 || isLive(target)) {
+                continue;
+            }
+            if (instance->IsPrimary()) {
+                instance->SetTarget(0);
+            } else {
+                instance->Retire();
+            }
         }
 
-        if (!IsWindowVisible(hWnd)) {
-            return TRUE;
+        std::vector<ProcessId> unassigned;
+        for (ProcessId pid : pids) {
+            const bool assigned = std::any_of(instances.begin(), instances.end(), [pid](const auto& instance) {
+                return instance->Target() == pid;
+            });
+            if (!assigned) {
+                unassigned.push_back(pid);
+            }
         }
 
-        int length = GetWindowTextLengthA(hWnd);
-        if (length <= 0) {
-            return TRUE;
+        auto next = unassigned.begin();
+        if (instances.front()->Target() == 0 && next != unassigned.end()) {
+            instances.front()->SetTarget(*next++);
+        }
+        for (; next != unassigned.end(); ++next) {
+            auto instance = CreateInstance(*next);
+            instance->SetTarget(*next);
+            instances.push_back(std::move(instance));
         }
 
-        state->window = hWnd;
-        return FALSE;
+        activeInstances.store(static_cast<size_t>(std::count_if(instances.begin(), instances.end(), [](const auto& instance) {
+            return instance->Target() != 0;
+        })));
     }
 
-    HWND FindTopLevelWindowForProcess(DWORD pid) {
-        WindowSearch state;
-        state.pid = pid;
-        EnumWindows(EnumWindowsForProcess, reinterpret_cast<LPARAM>(&state));
-        return state.window;
+    void ScheduleSamples(bool debugMode) {
+        std::lock_guard<std::mutex> lock(instancesMutex);
+        for (const auto& instance : instances) {
+            if (instance->IsRetired() || !instance->TryBeginSample()) {
+                continue;
+            }
+            if (simulated()) {
+                instance->Sample(debugMode);
+                continue;
+            }
+            samplers.Submit([this, instance, debugMode] {
+                wakeups.fetch_add(1, std::memory_order_relaxed);
+                instance->Sample(debugMode);
+            });
+        }
     }
 
-    void EnsureModuleBases() {
-        if (mccBase != 0 && haloReachBase != 0) {
-            return;
+    bool simulated() const {
+        return simulateMs > 0;
+    }
+
+    void WakeEmitter() {
+        {
+            std::lock_guard<std::mutex> lock(emitterMutex);
+            tickPosted = true;
+        }
+        emitterWake.notify_one();
+    }
+
+    // Emits the newest unconsumed tick of every instance; false if there was none.
+    bool EmitPending(bool debugMode) {
+        std::vector<std::shared_ptr<ReaderInstance>> current;
+        {
+            std::lock_guard<std::mutex> lock(instancesMutex);
+            current = instances;
+        }
+        bool emitted = false;
+        for (const auto& instance : current) {
+            if (instance->ticks.Consume()) {
+                EmitTick(*instance, instance->ticks.ReadSlot(), debugMode);
+                GetReaderMetrics().snapshotsEmitted.Add();
+                emitted = true;
+            }
+        }
+        return emitted;
+    }
+
+    void EmitterLoop(bool debugMode) {
+        while (true) {
+            if (EmitPending(debugMode)) {
+                continue;
+            }
+            if (!emitterRunning.load()) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(emitterMutex);
+            emitterWake.wait_for(lock, std::chrono::milliseconds(kPollIntervalMs), [this] {
+                return tickPosted || !emitterRunning.load();
+            });
+            tickPosted = false;
+            wakeups.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void EmitTick(ReaderInstance& instance, const TickSnapshot& tick, bool debugMode) {
+        if (firstSnapshotMs < 0) {
+            firstSnapshotMs = static_cast<int64_t>(NowSteadyMs() - startMs);
+            if (headless || IsReaderDebugEnabled()) {
+                std::cerr << "\n[reader] first snapshot after " << firstSnapshotMs << " ms" << std::endl;
+            }
         }
-        if (!connected || processId == 0) {
+        const std::string envelope = BuildTelemetryEnvelope(tick, debugMode);
+        const std::string stateKey = BuildStateKey(tick);
+        if (!senderRunning) {
+            // With the receiver fed directly, it owns customs_state.json.
+            WriteTelemetrySnapshot(instance, envelope, debugMode);
+        }
+        // Pub/sub carries the roster section, so a roster change republishes; the receiver contract has no roster.
+        PublishIfChanged(instance, envelope, stateKey + '|' + std::to_string(tick.rosterVersion));
+        SubmitIfDue(instance, tick, stateKey);
+
+        if (headless || !instance.IsPrimary()) {
             return;
         }
-        if (mccBase == 0) {
-            mccBase = GetRemoteModuleBase("mcc-win64-shipping.exe");
+        std::string line = "Players: " + std::to_string(tick.playerCount)
+                           + " | Map: " + tick.mapName
+                           + " | Mode: " + tick.modeName
+                           + " | " + tick.status;
+        const size_t others = activeInstances.load();
+        if (others > 1) {
+            line += " | +" + std::to_string(others - 1) + " more";
         }
-        if (haloReachBase == 0) {
-            haloReachBase = GetRemoteModuleBase("haloreach.dll");
+
+        if (line.size() < lastLineWidth) {
+            line.append(lastLineWidth - line.size(), ' ');
+        } else {
+            lastLineWidth = line.size();
         }
+
+        std::cout << '\r' << line << std::flush;
+    }
+
+    // seq/ts change every tick; this captures only the observable lobby state.
+    static std::string BuildStateKey(const TickSnapshot& tick) {
+        std::string state;
+        state.reserve(tick.mapName.size() + tick.modeName.size() + std::strlen(tick.status) + 32);
+        state += tick.connected ? '1' : '0';
+        state += tick.inMenus ? '1' : '0';
+        state += std::to_string(tick.pid) + '|' + std::to_string(tick.playerCount) + '|';
+        state += tick.mapName + '|' + tick.modeName + '|' + tick.status;
+        return state;
     }
 
-    uintptr_t GetRemoteModuleBase(const char* moduleName) {
-        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, processId);
-        if (snapshot == INVALID_HANDLE_VALUE) {
-            return 0;
+    void PublishIfChanged(ReaderInstance& instance, const std::string& envelope, const std::string& stateKey) {
+        if (!publisherRunning || stateKey == instance.lastPublishedState) {
+            return;
         }
+        instance.lastPublishedState = stateKey;
+        publisher.Publish(envelope);
+    }
 
-        MODULEENTRY32 entry = {};
-        entry.dwSize = sizeof(entry);
+    mccmod::TelemetrySnapshot BuildReceiverSnapshot(ReaderInstance& instance, const TickSnapshot& tick) {
+        const bool hasMap = !tick.mapName.empty() && tick.mapName != "Unknown";
+        const bool hasMode = !tick.modeName.empty() && tick.modeName != "Unknown";
+        if (tick.connected && tick.pid != 0) {
+            instance.lastSessionId = "mcc-" + std::to_string(tick.pid);
+        }
+
+        mccmod::TelemetrySnapshot snapshot;
+        snapshot.is_custom_game = tick.connected && hasMap && !tick.inMenus;
+        snapshot.map_name = hasMap ? tick.mapName : "";
+        snapshot.game_mode = hasMode ? tick.modeName : "";
+        snapshot.player_count = tick.connected ? tick.playerCount : 0;
+        snapshot.max_players = 0;
+        snapshot.timestamp_utc = mccmod::GetIsoUtcNow();
+        snapshot.session_id = instance.lastSessionId;
+        return snapshot;
+    }
 
-        if (Module32First(snapshot, &entry)) {
-            do {
-                if (_stricmp(entry.szModule, moduleName) == 0) {
-                    CloseHandle(snapshot);
-                    return reinterpret_cast<uintptr_t>(entry.modBaseAddr);
-                }
-            } while (Module32Next(snapshot, &entry));
+    void SubmitIfDue(ReaderInstance& instance, const TickSnapshot& tick, const std::string& stateKey) {
+        if (!senderRunning) {
+            return;
+        }
+        const uint64_t nowMs = NowSteadyMs();
+        if (stateKey == instance.lastSubmittedState && nowMs - instance.lastSubmitMs < static_cast<uint64_t>(kReceiverHeartbeatMs)) {
+            return;
         }
+        instance.lastSubmittedState = stateKey;
+        instance.lastSubmitMs = nowMs;
 
-        CloseHandle(snapshot);
-        return 0;
+        std::string validationError;
+        if (!sender.Submit(BuildReceiverSnapshot(instance, tick), tick.captureUs, &validationError) &&
+            IsReaderDebugEnabled()) {
+            std::cerr << "\n[reader] snapshot rejected: " << validationError << std::endl;
+        }
     }
 
-    std::vector<int> ReadPlayerCandidates(ReadDebug* out_debug) {
-        std::vector<int> values;
-        if (!connected) {
-            return values;
+#if defined(_WIN32)
+    // Asks the old overlay to close and waits on its process, so a quick exit is not padded
+    // out to a fixed delay. One that ignores WM_CLOSE is terminated after kOverlayCloseTimeoutMs.
+    void CloseExistingOverlay() {
+        HWND overlay = FindWindowA(nullptr, "Customs on the Ring");
+        if (!overlay) {
+            return;
         }
 
-        EnsureModuleBases();
-        if (out_debug) {
-            out_debug->connected = connected;
-            out_debug->pid = processId;
-            out_debug->mccBase = mccBase;
-            out_debug->reachBase = haloReachBase;
+        DWORD pid = 0;
+        GetWindowThreadProcessId(overlay, &pid);
+        if (pid == 0) {
+            return;
         }
-        values.reserve(4);
 
-        if (mccBase != 0) {
-            int value = 0;
-            if (TryReadMemory("players.mcc", mccBase + 0x3F92E10, &value, out_debug) &&
-                value >= 0 && value <= kMaxPlayers) {
-                values.push_back(value);
-            }
+        // Open before asking it to close so the pid cannot be reused under us.
+        HANDLE proc = OpenProcess(SYNCHRONIZE | PROCESS_TERMINATE, FALSE, pid);
+        PostMessageA(overlay, WM_CLOSE, 0, 0);
+        if (!proc) {
+            return;
         }
 
-        if (haloReachBase != 0) {
-            int value = 0;
-            if (TryReadMemory("players.reach.0", haloReachBase + 0x2B07470, &value, out_debug) &&
-                value >= 0 && value <= kMaxPlayers) {
-                values.push_back(value);
-            }
-            if (TryReadMemory("players.reach.1", haloReachBase + 0x2B08B50, &value, out_debug) &&
-                value >= 0 && value <= kMaxPlayers) {
-                values.push_back(value);
-            }
-            if (TryReadMemory("players.reach.2", haloReachBase + 0x2C996A0, &value, out_debug) &&
-                value >= 0 && value <= kMaxPlayers) {
-                values.push_back(value);
-            }
+        if (WaitForSingleObject(proc, kOverlayCloseTimeoutMs) == WAIT_TIMEOUT) {
+            TerminateProcess(proc, 0);
+            WaitForSingleObject(proc, kOverlayCloseTimeoutMs);
         }
-
-        return values;
+        CloseHandle(proc);
     }
 
-    std::vector<std::string> ReadMapCandidates(ReadDebug* out_debug) {
-        std::vector<std::string> names;
-        if (!connected) {
-            return names;
+    std::string ResolveOverlayAppPath() {
+        const std::string env = GetEnvVar("HMCC_OVERLAY_APP");
+        if (!env.empty()) {
+            return env;
         }
-        names.reserve(1);
 
-        EnsureModuleBases();
-        if (mccBase != 0) {
-            uintptr_t basePtr = 0;
-            if (TryReadMemory("shared.base", mccBase + kSharedTelemetryBaseOffset, &basePtr, out_debug) &&
-                basePtr != 0) {
-                std::string name;
-                if (TryReadString("map", basePtr + kMapNameOffset, &name, 64, out_debug)) {
-                    name = TrimCopy(name);
-                    if (IsLikelyMapName(name)) {
-                        names.push_back(name);
-                    }
-                }
-            }
+        const auto root = ResolveRepoRoot();
+        if (root.empty()) {
+            return "";
         }
-
-        return names;
+        const auto appPath = root / "pc-app";
+        if (std::filesystem::exists(appPath)) {
+            return appPath.string();
+        }
+        return "";
     }
 
-    std::vector<std::string> ReadModeCandidates(const std::string& mapName, ReadDebug* out_debug) {
-        std::vector<std::string> modes;
-        if (!connected) {
-            return modes;
+    std::string ResolveElectronPath() {
+        const std::string env = GetEnvVar("HMCC_ELECTRON_PATH");
+        if (!env.empty()) {
+            return env;
         }
-        modes.reserve(2);
 
-        EnsureModuleBases();
-        if (mccBase != 0) {
-            uintptr_t basePtr = 0;
-            if (TryReadMemory("shared.base", mccBase + kSharedTelemetryBaseOffset, &basePtr, out_debug) &&
-                basePtr != 0) {
-                for (uintptr_t offset : {kModeNameOffsetPrimary, kModeNameOffsetSecondary}) {
-                    std::string mode;
-                    const char* label = offset == kModeNameOffsetPrimary ? "mode.prim" : "mode.sec";
-                    if (!TryReadString(label, basePtr + offset, &mode, 64, out_debug)) {
-                        continue;
-                    }
-                    mode = TrimCopy(mode);
-                    if (!IsLikelyGameMode(mode)) {
-                        continue;
-                    }
-                    if (!mapName.empty() && mapName != "Unknown" && mode == mapName) {
-                        continue;
-                    }
-                    if (std::find(modes.begin(), modes.end(), mode) == modes.end()) {
-                        modes.push_back(mode);
-                    }
-                }
-            }
+        const auto root = ResolveRepoRoot();
+        if (root.empty()) {
+            return "";
         }
-
-        return modes;
+        const auto electronPath =
+            root / "pc-app" / "node_modules" / "electron" / "dist" / "electron.exe";
+        if (std::filesystem::exists(electronPath)) {
+            return electronPath.string();
+        }
+        return "";
     }
 
-    template<typename T>
-    bool TryReadMemory(const char* label, uintptr_t address, T* out_value, ReadDebug* out_debug) {
-        if (!processHandle || !out_value) {
-            return false;
-        }
-        SIZE_T bytesRead = 0;
-        if (ReadProcessMemory(processHandle, reinterpret_cast<LPCVOID>(address), out_value, sizeof(T), &bytesRead)) {
-            const bool ok = bytesRead == sizeof(T);
-            if (out_debug) {
-                ReadAttempt attempt;
-                attempt.label = label ? label : "mem";
-                attempt.address = address;
-                attempt.ok = ok;
-                attempt.bytesRead = bytesRead;
-                out_debug->attempts.push_back(std::move(attempt));
-            }
-            return ok;
+    std::filesystem::path ResolveRepoRoot() {
+        char buffer[MAX_PATH] = {};
+        DWORD size = GetModuleFileNameA(nullptr, buffer, MAX_PATH);
+        if (size == 0 || size >= MAX_PATH) {
+            return {};
         }
-        if (out_debug) {
-            ReadAttempt attempt;
-            attempt.label = label ? label : "mem";
-            attempt.address = address;
-            attempt.ok = false;
-            attempt.bytesRead = bytesRead;
-            out_debug->attempts.push_back(std::move(attempt));
+        std::filesystem::path exePath(buffer);
+        auto dir = exePath.parent_path();
+        if (dir.empty()) {
+            return {};
         }
-        return false;
+        dir = dir.parent_path();
+        dir = dir.parent_path();
+        dir = dir.parent_path();
+        return dir;
     }
 
-    bool TryReadStringUtf8(uintptr_t address, std::string* out_value, size_t maxLength, size_t* out_bytes_read) {
-        if (!processHandle || !out_value || maxLength == 0) {
-            return false;
+    void SpawnProcess(const std::string& exePath, const std::string& args, const std::string& workingDir = "") {
+        if (exePath.empty()) {
+            return;
         }
+        STARTUPINFOA si = {};
+        PROCESS_INFORMATION pi = {};
+        si.cb = sizeof(si);
 
-        std::vector<char> buffer(maxLength + 1, 0);
-        SIZE_T bytesRead = 0;
-        if (!ReadProcessMemory(processHandle, reinterpret_cast<LPCVOID>(address), buffer.data(), maxLength, &bytesRead)) {
-            return false;
-        }
+        std::string commandLine = args.empty() ? ("\"" + exePath + "\"") : args;
+        std::vector<char> cmdBuffer(commandLine.begin(), commandLine.end());
+        cmdBuffer.push_back('\0');
 
-        if (out_bytes_read) *out_bytes_read = static_cast<size_t>(bytesRead);
-        buffer[maxLength] = '\0';
-        size_t length = strnlen_s(buffer.data(), maxLength);
-        if (length == 0) {
-            out_value->clear();
-            return true;
-        }
+        BOOL created = CreateProcessA(
+            nullptr,
+            cmdBuffer.data(),
+            nullptr,
+            nullptr,
+            FALSE,
+            CREATE_NO_WINDOW | DETACHED_PROCESS,
+            nullptr,
+            workingDir.empty() ? nullptr : workingDir.c_str(),
+            &si,
+            &pi
+        );
 
-        out_value->assign(buffer.data(), length);
-        return true;
+        if (created) {
+            CloseHandle(pi.hProcess);
+            CloseHandle(pi.hThread);
+        }
     }
+#endif
 
-    bool TryReadStringUtf16(uintptr_t address, std::string* out_value, size_t maxChars, size_t* out_bytes_read) {
-        if (!processHandle || !out_value || maxChars == 0) {
-            return false;
+    std::string GetEnvVar(const char* name) {
+        if (!name || !*name) {
+            return "";
         }
+        const char* value = std::getenv(name);
+        return value ? std::string(value) : "";
+    }
 
-        std::vector<wchar_t> buffer(maxChars + 1, 0);
-        SIZE_T bytesRead = 0;
-        const size_t bytesToRead = maxChars * sizeof(wchar_t);
-        if (!ReadProcessMemory(processHandle, reinterpret_cast<LPCVOID>(address), buffer.data(), bytesToRead, &bytesRead)) {
-            return false;
+    // HMCC_READER_{MAP,MODE,PLAYER}_FILTER, e.g. "streak=3,conflict=4,sources=2,confidence=1.0,fast=1"; keys left
+    // out keep their default. A spec that does not parse is reported and ignored.
+    mccmod::SignalFilterConfig FilterFromEnv(const char* name, mccmod::SignalFilterConfig config) {
+        const std::string spec = GetEnvVar(name);
+        if (!spec.empty() && !mccmod::ParseSignalFilterConfig(spec, &config)) {
+            std::cerr << "[reader] ignoring " << name << "=" << spec << std::endl;
         }
+        return config;
+    }
 
-        if (out_bytes_read) *out_bytes_read = static_cast<size_t>(bytesRead);
-        buffer[maxChars] = L'\0';
-        size_t length = 0;
-        while (length < maxChars && buffer[length] != L'\0') {
-            length++;
-        }
-        if (length == 0) {
-            out_value->clear();
-            return true;
+    // HMCC_READER_MAX_WAKEUPS overrides the wakeups-per-second limit, and HMCC_READER_BUDGET_WINDOW_MS how
+    // often usage is measured against the budget; mcc_headless_check sets both to see the throttle move.
+    mccmod::ResourceLimits BudgetLimitsFromEnv() {
+        mccmod::ResourceLimits limits;
+        const double maxWakeups = std::atof(GetEnvVar("HMCC_READER_MAX_WAKEUPS").c_str());
+        if (maxWakeups > 0) {
+            limits.max_wakeups_per_second = maxWakeups;
         }
+        return limits;
+    }
 
-        int needed = WideCharToMultiByte(CP_UTF8, 0, buffer.data(), static_cast<int>(length), nullptr, 0, nullptr, nullptr);
-        if (needed <= 0) {
-            return false;
-        }
-        std::string utf8;
-        utf8.resize(static_cast<size_t>(needed));
-        WideCharToMultiByte(CP_UTF8, 0, buffer.data(), static_cast<int>(length), utf8.data(), needed, nullptr, nullptr);
-        *out_value = utf8;
-        return true;
+    uint64_t BudgetWindowFromEnv() {
+        const uint64_t windowMs = std::strtoull(GetEnvVar("HMCC_READER_BUDGET_WINDOW_MS").c_str(), nullptr, 10);
+        return windowMs > 0 ? windowMs : kBudgetWindowMs;
     }
 
-    bool TryReadString(const char* label, uintptr_t address, std::string* out_value, size_t maxLength, ReadDebug* out_debug) {
-        if (!processHandle || !out_value || maxLength == 0) {
-            return false;
+    // All MCC clients on this host. The client owning the game window comes first so a
+    // single-client host keeps following the same process as before.
+    std::vector<ProcessId> FindMccProcessIds() {
+        std::vector<ProcessId> pids;
+#if defined(_WIN32)
+        HWND window = FindWindowA(nullptr, "Halo: The Master Chief Collection");
+        if (window) {
+            DWORD pid = 0;
+            GetWindowThreadProcessId(window, &pid);
+            if (pid != 0) {
+                pids.push_back(pid);
+            }
         }
+#endif
 
-        size_t bytesRead = 0;
-        std::string value;
-
-        bool ok = TryReadStringUtf8(address, &value, maxLength, &bytesRead);
-        if (ok) {
-            const bool labelIsMap = label && std::strncmp(label, "map", 3) == 0;
-            const bool labelIsMode = label && std::strncmp(label, "mode", 4) == 0;
-            const bool utf8LooksValid =
-                (labelIsMap && IsLikelyMapName(value)) ||
-                (labelIsMode && IsLikelyGameMode(value));
-
-            // Heuristic: if the underlying bytes look like UTF-16LE (lots of zeros at odd indices), try UTF-16.
-            // Important: do NOT scan past value.size(); bytesRead may be > value.size() for short strings.
-            // Also, UTF-16 strings should be 2-byte aligned; skip the heuristic on odd addresses (e.g. mapName at base+0x44D).
-            if (!utf8LooksValid && (address % 2) == 0) {
-                std::array<unsigned char, 32> probe{};
-                SIZE_T probeRead = 0;
-                if (ReadProcessMemory(processHandle, reinterpret_cast<LPCVOID>(address), probe.data(), probe.size(), &probeRead) &&
-                    probeRead > 0) {
-                    const size_t n = std::min(static_cast<size_t>(probeRead), probe.size());
-
-                    // Only treat it as UTF-16 if the *early* bytes follow the pattern: <printable> 00 <printable> 00 ...
-                    // This avoids false positives for short ASCII strings with lots of trailing NUL padding.
-                    const size_t pairs = std::min(n / 2, static_cast<size_t>(8));
-                    int oddZero = 0;
-                    int evenPrintable = 0;
-                    for (size_t i = 0; i < pairs; i++) {
-                        const unsigned char even = probe[i * 2];
-                        const unsigned char odd = probe[i * 2 + 1];
-                        if (odd == 0) oddZero++;
-                        if (even >= 32 && even <= 126) evenPrintable++;
-                    }
-
-                    if (pairs >= 2 && oddZero >= static_cast<int>(pairs - 1) && evenPrintable >= 2) {
-                        std::string utf16;
-                        size_t bytesRead16 = 0;
-                        if (TryReadStringUtf16(address, &utf16, maxLength, &bytesRead16) && !utf16.empty()) {
-                            const bool utf16LooksValid =
-                                (labelIsMap && IsLikelyMapName(utf16)) ||
-                                (labelIsMode && IsLikelyGameMode(utf16)) ||
-                                (!labelIsMap && !labelIsMode);
-                            if (!utf16LooksValid) {
-                                // Keep UTF-8 if UTF-16 decode produced garbage for a known field type.
-                                *out_value = value;
-                                if (out_debug) {
-                                    ReadAttempt attempt;
-                                    attempt.label = label ? label : "str";
-                                    attempt.address = address;
-                                    attempt.ok = ok;
-                                    attempt.bytesRead = bytesRead;
-                                    attempt.value = ok ? value : "";
-                                    out_debug->attempts.push_back(std::move(attempt));
-                                }
-                                return ok;
-                            }
-                            value = utf16;
-                            bytesRead = bytesRead16;
-                        }
-                    }
-                }
+        for (ProcessId pid : mccmod::FindProcessesByName(TargetProcessNames())) {
+            if (std::find(pids.begin(), pids.end(), pid) == pids.end()) {
+                pids.push_back(pid);
             }
-            *out_value = value;
         }
+        return pids;
+    }
 
-        if (out_debug) {
-            ReadAttempt attempt;
-            attempt.label = label ? label : "str";
-            attempt.address = address;
-            attempt.ok = ok;
-            attempt.bytesRead = bytesRead;
-            attempt.value = ok ? value : "";
-            out_debug->attempts.push_back(std::move(attempt));
+    // HMCC_READER_TARGET: comma-separated executable names to follow instead of MCC.
+    std::vector<std::string> TargetProcessNames() {
+        std::vector<std::string> names;
+        std::stringstream setting(GetEnvVar("HMCC_READER_TARGET"));
+        std::string name;
+        while (std::getline(setting, name, ',')) {
+            name = TrimCopy(name);
+            if (!name.empty()) {
+                names.push_back(name);
+            }
         }
-
-        return ok;
+        if (names.empty()) {
+            names = {"MCC-Win64-Shipping.exe", "MCC-Win64-Shipping"};
+        }
+        return names;
     }
 
     std::string ResolveTelemetryPath() {
-        char buffer[MAX_PATH] = {};
-        DWORD size = GetEnvironmentVariableA("MCC_TELEMETRY_OUT", buffer, MAX_PATH);
-        if (size > 0 && size < MAX_PATH) {
-            return std::string(buffer);
+        const std::string configured = GetEnvVar("MCC_TELEMETRY_OUT");
+        if (!configured.empty()) {
+            return configured;
         }
 
-        size = GetEnvironmentVariableA("APPDATA", buffer, MAX_PATH);
-        if (size > 0 && size < MAX_PATH) {
-            std::string dir = std::string(buffer) + "\\MCC";
+#if defined(_WIN32)
+        const std::string appData = GetEnvVar("APPDATA");
+        if (!appData.empty()) {
+            std::string dir = appData + "\\MCC";
             CreateDirectoryA(dir.c_str(), nullptr);
             return dir + "\\customs_state.json";
         }
+#else
+        std::filesystem::path stateDir;
+        const std::string xdgState = GetEnvVar("XDG_STATE_HOME");
+        const std::string home = GetEnvVar("HOME");
+        if (!xdgState.empty()) {
+            stateDir = xdgState;
+        } else if (!home.empty()) {
+            stateDir = std::filesystem::path(home) / ".local" / "state";
+        }
+        if (!stateDir.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(stateDir / "MCC", ec);
+            if (!ec) {
+                return (stateDir / "MCC" / "customs_state.json").string();
+            }
+        }
+#endif
 
         return "customs_state.json";
     }
@@ -1031,215 +1946,163 @@ private:
         }
         return out.str();
     }
-
-    bool IsLikelyMapName(const std::string& name) const {
-        if (name.empty() || name.size() > 64) {
-            return false;
-        }
-
-        bool hasAlpha = false;
-        for (char c : name) {
-            unsigned char uc = static_cast<unsigned char>(c);
-            if (std::isalnum(uc)) {
-                if (std::isalpha(uc)) {
-                    hasAlpha = true;
-                }
-                continue;
-            }
-            if (c == '_' || c == '-' || c == ' ') {
-                continue;
-            }
-            if (uc >= 32 && uc <= 126) {
-                continue;
-            }
-            return false;
-        }
-
-        if (!hasAlpha) {
-            return false;
-        }
-        if (!kUseMapWhitelist) {
-            return true;
-        }
-        return IsReachMapName(name);
-    }
-
-    bool IsLikelyGameMode(const std::string& mode) const {
-        if (mode.empty() || mode.size() > 64) {
-            return false;
-        }
-
-        bool hasAlpha = false;
-        for (char c : mode) {
-            unsigned char uc = static_cast<unsigned char>(c);
-            if (std::isalnum(uc)) {
-                if (std::isalpha(uc)) {
-                    hasAlpha = true;
-                }
-                continue;
-            }
-            if (c == '_' || c == '-' || c == ' ') {
-                continue;
-            }
-            if (uc >= 32 && uc <= 126) {
-                continue;
-            }
-            return false;
-        }
-
-        return hasAlpha;
-    }
-
-    static std::string NormalizeMapName(const std::string& name) {
-        std::string out;
-        out.reserve(name.size());
-        for (char c : name) {
-            if (std::isalnum(static_cast<unsigned char>(c))) {
-                out.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
-            }
-        }
-        return out;
-    }
-
-    static bool IsReachMapName(const std::string& name) {
-        static const std::vector<std::string> kReachMaps = {
-            "Boardwalk",
-            "Boneyard",
-            "Countdown",
-            "Powerhouse",
-            "Reflection",
-            "Spire",
-            "Sword Base",
-            "Zealot",
-            "Forge World",
-            "Asylum",
-            "Hemorrhage",
-            "Paradiso",
-            "Pinnacle",
-            "The Cage",
-            "Anchor 9",
-            "Breakpoint",
-            "Tempest",
-            "Condemned",
-            "Highlands",
-            "Battle Canyon",
-            "Breakneck",
-            "High Noon",
-            "Penance",
-            "Ridgeline",
-            "Solitary"
-        };
-
-        const std::string normalized = NormalizeMapName(name);
-        for (const auto& entry : kReachMaps) {
-            if (NormalizeMapName(entry) == normalized) {
-                return true;
-            }
-        }
-        return false;
-    }
-
-    bool IsInMenus(int playerCount) const {
-        return playerCount <= 0;
-    }
-
-    std::string BuildStatus(int playerCount, bool inMenus, bool isConnected) const {
-        if (!isConnected) {
-            return "Disconnected";
-        }
-        if (inMenus) {
-            return "Lobby in menus";
-        }
-        if (playerCount <= 1) {
-            return "Waiting for players";
-        }
-        return "Game ready";
-    }
-
-    std::string ComputeSourceTag() const {
-        if (mapSignal.sourceTag == "consensus" || modeSignal.sourceTag == "consensus" || playerSignal.sourceTag == "consensus") {
-            return "consensus";
-        }
-        if (mapSignal.sourceTag == "single" || modeSignal.sourceTag == "single" || playerSignal.sourceTag == "single") {
-            return "single";
-        }
-        return "none";
-    }
-
-    void WriteTelemetrySnapshot(
-        uint64_t seq,
-        int playerCount,
-        const std::string& mapName,
-        const std::string& modeName,
-        bool inMenus,
-        const std::string& status,
-        const ReadDebug& debug,
-        bool debugMode
-    ) {
-        if (telemetryPath.empty()) {
-            telemetryPath = ResolveTelemetryPath();
-            std::cout << "\nWriting telemetry to: " << telemetryPath << std::endl;
-        }
-
-        const bool hasMap = !mapName.empty() && mapName != "Unknown";
-        const bool hasMode = !modeName.empty() && modeName != "Unknown";
-        const bool isCustomGame = connected && hasMap && !inMenus;
-        const auto now = std::chrono::system_clock::now();
-        const auto epochMs =
-            std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+    std::string BuildTelemetryEnvelope(const TickSnapshot& tick, bool debugMode) {
+        const ReadDebug& debug = tick.debug;
+        const bool hasMap = !tick.mapName.empty() && tick.mapName != "Unknown";
+        const int64_t epochMs = NowWallMs();
+
+        // The lobby fields shared with the DLL's envelope come from the schema serializer,
+        // so both documents carry the same keys. Values are the raw tick's, not the receiver's.
+        mccmod::TelemetrySnapshot lobby;
+        lobby.is_custom_game = tick.connected && hasMap && !tick.inMenus;
+        lobby.map_name = tick.mapName;
+        lobby.game_mode = tick.modeName;
+        lobby.player_count = tick.playerCount;
+        lobby.timestamp_utc = mccmod::GetIsoUtcNow();
+        std::string lobbyFields;
+        mccmod::AppendTelemetryFieldsJson(lobby, &lobbyFields);
 
         std::ostringstream payload;
         payload << "{";
-        payload << "\"seq\":" << seq << ",";
+        payload << "\"seq\":" << tick.seq << ",";
         payload << "\"ts\":" << epochMs << ",";
-        payload << "\"pid\":" << processId << ",";
-        payload << "\"sessionId\":\"\",";
-        payload << "\"connected\":" << (connected ? "true" : "false") << ",";
-        payload << "\"inMenus\":" << (inMenus ? "true" : "false") << ",";
-        payload << "\"mapName\":\"" << EscapeJson(mapName) << "\",";
-        payload << "\"modeName\":\"" << EscapeJson(modeName) << "\",";
-        payload << "\"playerCount\":" << playerCount << ",";
-        payload << "\"mapUpdatedThisTick\":" << (mapSignal.updatedThisTick ? "true" : "false") << ",";
-        payload << "\"modeUpdatedThisTick\":" << (modeSignal.updatedThisTick ? "true" : "false") << ",";
-        payload << "\"playersUpdatedThisTick\":" << (playerSignal.updatedThisTick ? "true" : "false") << ",";
+        // When the values were read; ts minus captureTs is the reader's own share of their age.
+        payload << "\"captureTs\":" << tick.captureWallMs << ",";
+        payload << "\"pid\":" << tick.pid << ",";
+        payload << "\"instance\":" << tick.instancePid << ",";
+        payload << "\"connected\":" << (tick.connected ? "true" : "false") << ",";
+        payload << "\"inMenus\":" << (tick.inMenus ? "true" : "false") << ",";
+        payload << "\"modeName\":\"" << EscapeJson(tick.modeName) << "\",";
+        payload << "\"mapUpdatedThisTick\":" << (tick.mapUpdatedThisTick ? "true" : "false") << ",";
+        payload << "\"modeUpdatedThisTick\":" << (tick.modeUpdatedThisTick ? "true" : "false") << ",";
+        payload << "\"playersUpdatedThisTick\":" << (tick.playersUpdatedThisTick ? "true" : "false") << ",";
         payload << "\"confidence\":{"
-                << "\"map\":" << std::fixed << std::setprecision(2) << mapSignal.confidence << ","
-                << "\"mode\":" << std::fixed << std::setprecision(2) << modeSignal.confidence << ","
-                << "\"players\":" << std::fixed << std::setprecision(2) << playerSignal.confidence
+                << "\"map\":" << std::fixed << std::setprecision(2) << tick.mapConfidence << ","
+                << "\"mode\":" << std::fixed << std::setprecision(2) << tick.modeConfidence << ","
+                << "\"players\":" << std::fixed << std::setprecision(2) << tick.playerConfidence
                 << "},";
-        payload << "\"status\":\"" << EscapeJson(status) << "\",";
-        payload << "\"sourceTag\":\"" << EscapeJson(ComputeSourceTag()) << "\",";
-        payload << "\"isCustomGame\":" << (isCustomGame ? "true" : "false") << ",";
-        payload << "\"gameMode\":\"" << EscapeJson(modeName) << "\"";
+        payload << "\"status\":\"" << tick.status << "\",";
+        payload << "\"sourceTag\":\"" << tick.sourceTag << "\",";
+        // Stable catalog IDs (0 when the name is not in the catalog) and the map's title.
+        payload << "\"mccTitle\":\"" << (tick.mapEntry ? mccmod::TitleTag(tick.mapEntry->Title()) : "") << "\",";
+        payload << "\"mapId\":" << (tick.mapEntry ? tick.mapEntry->id : 0) << ",";
+        payload << "\"modeId\":" << (tick.modeEntry ? tick.modeEntry->id : 0) << ",";
+        payload << lobbyFields;
+        if (tick.hasRoster) {
+            // Optional: only with HMCC_READER_ROSTER=1, and left out while the player table cannot be read or
+            // its active entries disagree with playerCount.
+            std::string players;
+            mccmod::AppendRosterJson(tick.roster, &players);
+            payload << ",\"roster\":{"
+                    << "\"version\":" << tick.rosterVersion << ","
+                    << "\"updatedThisTick\":" << (tick.rosterUpdatedThisTick ? "true" : "false") << ","
+                    << "\"players\":" << players
+                    << "}";
+        }
 
         if (debugMode) {
             payload << ",";
             payload << "\"debug\":{";
             payload << "\"tick\":\"" << EscapeJson(TimestampNow()) << "\",";
             payload << "\"pollMs\":" << kPollIntervalMs << ",";
-            payload << "\"handleOk\":" << (processHandle ? "true" : "false") << ",";
+            payload << "\"handleOk\":" << (tick.handleOk ? "true" : "false") << ",";
             payload << "\"mapAgeMs\":"
-                    << (mapSignal.lastStableMs == 0 ? -1LL : static_cast<long long>(NowSteadyMs() - mapSignal.lastStableMs))
+                    << (tick.mapLastStableMs == 0 ? -1LL : static_cast<long long>(tick.captureMs - tick.mapLastStableMs))
                     << ",";
             payload << "\"modeAgeMs\":"
-                    << (modeSignal.lastStableMs == 0 ? -1LL : static_cast<long long>(NowSteadyMs() - modeSignal.lastStableMs))
+                    << (tick.modeLastStableMs == 0 ? -1LL : static_cast<long long>(tick.captureMs - tick.modeLastStableMs))
                     << ",";
-            payload << "\"mapUpdatedThisTick\":" << (mapSignal.updatedThisTick ? "true" : "false") << ",";
-            payload << "\"modeUpdatedThisTick\":" << (modeSignal.updatedThisTick ? "true" : "false") << ",";
-            payload << "\"playersUpdatedThisTick\":" << (playerSignal.updatedThisTick ? "true" : "false") << ",";
+            payload << "\"emitLagMs\":" << (NowSteadyMs() - tick.captureMs) << ",";
+            payload << "\"mapUpdatedThisTick\":" << (tick.mapUpdatedThisTick ? "true" : "false") << ",";
+            payload << "\"modeUpdatedThisTick\":" << (tick.modeUpdatedThisTick ? "true" : "false") << ",";
+            payload << "\"playersUpdatedThisTick\":" << (tick.playersUpdatedThisTick ? "true" : "false") << ",";
             payload << "\"mccBase\":" << static_cast<unsigned long long>(debug.mccBase) << ",";
             payload << "\"reachBase\":" << static_cast<unsigned long long>(debug.reachBase) << ",";
+            if (senderRunning) {
+                const auto senderStats = sender.GetStats();
+                payload << "\"sender\":{"
+                        << "\"sent\":" << senderStats.sent << ","
+                        << "\"failed\":" << senderStats.failed << ","
+                        << "\"coalesced\":" << senderStats.coalesced << ","
+                        << "\"rejected\":" << senderStats.rejected << ","
+                        << "\"lastLatencyMs\":" << senderStats.last_latency_ms << ","
+                        << "\"circuit\":\"" << mccmod::CircuitStateName(senderStats.delivery.circuit) << "\","
+                        << "\"circuitOpens\":" << senderStats.delivery.circuit_opens << ","
+                        << "\"spooled\":" << senderStats.delivery.spooled << ","
+                        << "\"spoolPending\":" << senderStats.delivery.spool_pending << ","
+                        << "\"replayed\":" << senderStats.delivery.replayed << ","
+                        << "\"compacted\":" << senderStats.delivery.compacted << ","
+                        << "\"dropped\":" << senderStats.delivery.dropped << ","
+                        << "\"latencyUs\":{";
+                // Per hop of the envelope's trip, over every traced post so far.
+                const auto latency = mccmod::GetDeliveryLatency();
+                for (size_t i = 0; i < latency.size(); i++) {
+                    payload << (i ? "," : "") << "\""
+                            << mccmod::DeliveryHopName(static_cast<mccmod::DeliveryHop>(i)) << "\":{"
+                            << "\"count\":" << latency[i].count << ","
+                            << "\"p50\":" << latency[i].p50 << ","
+                            << "\"p99\":" << latency[i].p99 << ","
+                            << "\"max\":" << latency[i].max << "}";
+                }
+                payload << "}},";
+            }
+            payload << "\"startup\":{"
+                    << "\"firstSnapshotMs\":" << firstSnapshotMs << ","
+                    << "\"overlayLaunchMs\":" << overlayLaunchMs.load()
+                    << "},";
+            payload << "\"budget\":" << BuildBudgetJson() << ",";
+            payload << "\"sampler\":{"
+                    << "\"workers\":" << samplers.Size() << ","
+                    << "\"instances\":" << activeInstances.load() << ","
+                    << "\"overruns\":" << tick.overruns
+                    << "},";
+            const mccmod::TickSchedulerStats schedulerStats = scheduler.GetStats();
+            payload << "\"scheduler\":{"
+                    << "\"ticks\":" << schedulerStats.ticks << ","
+                    << "\"missed\":" << schedulerStats.missed << ","
+                    << "\"highResolution\":" << (schedulerStats.high_resolution ? "true" : "false") << ","
+                    << "\"latenessUs\":{"
+                    << "\"p50\":" << schedulerStats.lateness_us.p50 << ","
+                    << "\"p99\":" << schedulerStats.lateness_us.p99 << ","
+                    << "\"max\":" << schedulerStats.lateness_us.max
+                    << "}},";
+            const auto& region = tick.regionStats;
+            payload << "\"regionCache\":{"
+                    << "\"queries\":" << region.region_queries << ","
+                    << "\"rejectedUnmapped\":" << region.rejected_unmapped << ","
+                    << "\"rejectedBackoff\":" << region.rejected_backoff << ","
+                    << "\"readFailures\":" << region.read_failures << ","
+                    << "\"backoffAddresses\":" << region.backoff_addresses << ","
+                    << "\"avoidedPerHour\":" << std::fixed << std::setprecision(0) << region.avoided_per_hour
+                    << "},";
+            const auto& rosterStats = tick.rosterStats;
+            payload << "\"roster\":{"
+                    << "\"updates\":" << rosterStats.updates << ","
+                    << "\"decodes\":" << rosterStats.decodes << ","
+                    << "\"changes\":" << rosterStats.changes
+                    << "},";
+            const auto& strings = tick.stringStats;
+            payload << "\"strings\":{"
+                    << "\"lookups\":" << strings.lookups << ","
+                    << "\"reused\":" << strings.reused << ","
+                    << "\"decoded\":" << strings.decoded << ","
+                    << "\"verified\":" << strings.verified << ","
+                    << "\"verifyChanged\":" << strings.verify_changed
+                    << "},";
             payload << "\"attempts\":[";
-            for (size_t i = 0; i < debug.attempts.size(); i++) {
+            for (size_t i = 0; i < debug.attemptCount; i++) {
                 const auto& a = debug.attempts[i];
                 if (i > 0) payload << ",";
                 payload << "{";
-                payload << "\"label\":\"" << EscapeJson(a.label) << "\",";
+                payload << "\"label\":\"" << kReadLabelNames[static_cast<size_t>(a.label)] << "\",";
                 payload << "\"addr\":" << static_cast<unsigned long long>(a.address) << ",";
                 payload << "\"ok\":" << (a.ok ? "true" : "false") << ",";
+                if (a.skipped) {
+                    payload << "\"skipped\":true,";
+                }
                 payload << "\"bytes\":" << static_cast<unsigned long long>(a.bytesRead);
-                if (!a.value.empty()) {
-                    payload << ",\"value\":\"" << EscapeJson(a.value) << "\"";
+                if (a.valueLength > 0) {
+                    payload << ",\"value\":\"" << EscapeJson(std::string(a.value, a.valueLength)) << "\"";
                 }
                 payload << "}";
             }
@@ -1248,8 +2111,16 @@ private:
         }
         payload << "}";
 
+        return "{\"version\":\"1.0\",\"data\":" + payload.str() + "}";
+    }
+    void WriteTelemetrySnapshot(ReaderInstance& instance, const std::string& envelope, bool debugMode) {
+        if (instance.telemetryPath.empty()) {
+            instance.telemetryPath = InstancePath(ResolveTelemetryPath(), instance.InstancePid());
+            std::cout << "\nWriting telemetry to: " << instance.telemetryPath << std::endl;
+        }
+
         const bool readerDebug = debugMode || IsReaderDebugEnabled();
-        std::filesystem::path targetPath(telemetryPath);
+        std::filesystem::path targetPath(instance.telemetryPath);
         std::filesystem::path tmpPath = targetPath;
         tmpPath += ".tmp";
 
@@ -1263,7 +2134,7 @@ private:
                 return;
             }
 
-            out << "{\"version\":\"1.0\",\"data\":" << payload.str() << "}";
+            out << envelope;
             out.flush();
             if (!out.good()) {
                 if (readerDebug) {
@@ -1275,6 +2146,7 @@ private:
         }
 
         // Atomically replace the target file to avoid torn reads/zero-byte windows.
+#if defined(_WIN32)
         const std::wstring tmpW = tmpPath.wstring();
         const std::wstring targetW = targetPath.wstring();
         if (!MoveFileExW(
@@ -1293,16 +2165,74 @@ private:
             std::error_code ec;
             std::filesystem::remove(tmpPath, ec);
         }
+#else
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, targetPath, ec);
+        if (ec) {
+            if (readerDebug) {
+                std::cerr << "\n[reader] telemetry write failed: rename("
+                          << tmpPath.string() << " -> " << targetPath.string()
+                          << ") msg=" << ec.message() << std::endl;
+            }
+            std::filesystem::remove(tmpPath, ec);
+        }
+#endif
+    }};
+
+// `--simulate <seconds>` runs the reader on a VirtualClock for that long and exits.
+uint64_t ParseSimulateMs(const std::string& args) {
+    const std::string flag = "--simulate";
+    const size_t at = args.find(flag);
+    if (at == std::string::npos) {
+        return 0;
     }
-};
+    return std::strtoull(args.c_str() + at + flag.size(), nullptr, 10) * 1000;
+}
 
-int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
-    MCCPlayerCountConsole console;
+int RunReader(bool headless, uint64_t simulateMs) {
+    mccmod::VirtualClock virtualClock;
+    if (simulateMs > 0) {
+        mccmod::SetDefaultClock(&virtualClock);
+        // Run() is the only loop that sleeps on the clock; other threads never do.
+        virtualClock.AddParticipant();
+    }
 
-    if (!console.Initialize()) {
-        return 1;
+    int result = 1;
+    {
+        MCCPlayerCountConsole console(headless, simulateMs);
+        if (console.Initialize()) {
+            console.Run();
+            result = 0;
+        }
     }
+    if (simulateMs > 0) {
+        virtualClock.RemoveParticipant();
+    }
+    mccmod::SetDefaultClock(nullptr);
+    return result;
+}
 
-    console.Run();
-    return 0;
+#if defined(_WIN32)
+// `--headless` (or HMCC_READER_HEADLESS=1) runs without the overlay, console line or
+// window focus; `--stop` asks a running headless reader to exit.
+int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR cmdLine, int) {
+    const std::string args = cmdLine ? cmdLine : "";
+    if (args.find("--stop") != std::string::npos) {
+        return mccmod::SignalRunningService() ? 0 : 1;
+    }
+    const uint64_t simulateMs = ParseSimulateMs(args);
+    const char* headlessEnv = std::getenv("HMCC_READER_HEADLESS");
+    const bool headless = simulateMs > 0 || args.find("--headless") != std::string::npos ||
+                          (headlessEnv && std::strcmp(headlessEnv, "1") == 0);
+    return RunReader(headless, simulateMs);
+}
+#else
+// Outside Windows there is no overlay or game window to drive, so the reader always runs headless.
+int main(int argc, char** argv) {
+    std::string args;
+    for (int i = 1; i < argc; i++) {
+        args += std::string(argv[i]) + " ";
+    }
+    return RunReader(true, ParseSimulateMs(args));
 }
+#endif
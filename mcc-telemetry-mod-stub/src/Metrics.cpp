@@ -0,0 +1,184 @@
+#include "Metrics.h"
+
+#include <algorithm>
+
+namespace mccmod {
+namespace {
+
+const char* TypeName(bool counter, bool gauge) {
+  if (counter) return "counter";
+  if (gauge) return "gauge";
+  return "histogram";
+}
+
+// Help text escapes backslashes and newlines; label values are written by
+// the callers, which only use fixed strings.
+void AppendHelp(std::string_view help, std::string* out) {
+  for (const char c : help) {
+    if (c == '\\') {
+      out->append("\\\\");
+    } else if (c == '\n') {
+      out->append("\\n");
+    } else {
+      out->push_back(c);
+    }
+  }
+}
+
+void AppendSample(const std::string& name, std::string_view suffix, const std::string& labels,
+                  std::string_view extra_label, const std::string& value, std::string* out) {
+  out->append(name);
+  out->append(suffix);
+  if (!labels.empty() || !extra_label.empty()) {
+    out->push_back('{');
+    out->append(labels);
+    if (!labels.empty() && !extra_label.empty()) out->push_back(',');
+    out->append(extra_label);
+    out->push_back('}');
+  }
+  out->push_back(' ');
+  out->append(value);
+  out->push_back('\n');
+}
+
+}  // namespace
+
+MetricHistogram::MetricHistogram(std::vector<uint64_t> bounds)
+    : bounds_(std::move(bounds)), buckets_(new std::atomic<uint64_t>[bounds_.size() + 1]) {
+  for (size_t i = 0; i <= bounds_.size(); ++i) buckets_[i].store(0, std::memory_order_relaxed);
+}
+
+void MetricHistogram::Observe(uint64_t value) {
+  // A dozen bounds at most; a linear scan beats a binary search here.
+  size_t bucket = 0;
+  while (bucket < bounds_.size() && value > bounds_[bucket]) ++bucket;
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t MetricHistogram::Count() const {
+  uint64_t count = 0;
+  for (size_t i = 0; i <= bounds_.size(); ++i) count += buckets_[i].load(std::memory_order_relaxed);
+  return count;
+}
+
+std::vector<uint64_t> MetricHistogram::BucketCounts() const {
+  std::vector<uint64_t> counts(bounds_.size() + 1);
+  for (size_t i = 0; i < counts.size(); ++i) counts[i] = buckets_[i].load(std::memory_order_relaxed);
+  return counts;
+}
+
+MetricsRegistry::Series& MetricsRegistry::FindOrAddLocked(std::string_view name, std::string_view help, Type type,
+                                                          std::string_view labels) {
+  auto family_it = std::find_if(families_.begin(), families_.end(),
+                                [&](const std::unique_ptr<Family>& family) { return family->name == name; });
+  if (family_it == families_.end()) {
+    auto family = std::make_unique<Family>();
+    family->name = std::string(name);
+    family->help = std::string(help);
+    family->type = type;
+    families_.push_back(std::move(family));
+    family_it = families_.end() - 1;
+  }
+  Family& family = **family_it;
+  for (auto& series : family.series) {
+    if (series->labels == labels) return *series;
+  }
+  auto series = std::make_unique<Series>();
+  series->labels = std::string(labels);
+  family.series.push_back(std::move(series));
+  return *family.series.back();
+}
+
+MetricCounter& MetricsRegistry::Counter(std::string_view name, std::string_view help, std::string_view labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Series& series = FindOrAddLocked(name, help, Type::kCounter, labels);
+  if (!series.counter) series.counter = std::make_unique<MetricCounter>();
+  return *series.counter;
+}
+
+MetricGauge& MetricsRegistry::Gauge(std::string_view name, std::string_view help, std::string_view labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Series& series = FindOrAddLocked(name, help, Type::kGauge, labels);
+  if (!series.gauge) series.gauge = std::make_unique<MetricGauge>();
+  return *series.gauge;
+}
+
+MetricHistogram& MetricsRegistry::Histogram(std::string_view name, std::string_view help,
+                                            std::vector<uint64_t> bounds, std::string_view labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Series& series = FindOrAddLocked(name, help, Type::kHistogram, labels);
+  if (!series.histogram) series.histogram = std::make_unique<MetricHistogram>(std::move(bounds));
+  return *series.histogram;
+}
+
+int MetricsRegistry::AddCollector(std::function<void()> collector) {
+  std::lock_guard<std::mutex> lock(collectors_mutex_);
+  const int handle = next_collector_++;
+  collectors_.emplace_back(handle, std::move(collector));
+  return handle;
+}
+
+void MetricsRegistry::RemoveCollector(int handle) {
+  std::lock_guard<std::mutex> lock(collectors_mutex_);
+  collectors_.erase(std::remove_if(collectors_.begin(), collectors_.end(),
+                                   [handle](const auto& entry) { return entry.first == handle; }),
+                    collectors_.end());
+}
+
+std::string MetricsRegistry::Render() {
+  {
+    std::lock_guard<std::mutex> lock(collectors_mutex_);
+    for (const auto& entry : collectors_) entry.second();
+  }
+
+  std::string out;
+  out.reserve(4096);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& family : families_) {
+    out.append("# HELP ");
+    out.append(family->name);
+    out.push_back(' ');
+    AppendHelp(family->help, &out);
+    out.append("\n# TYPE ");
+    out.append(family->name);
+    out.push_back(' ');
+    out.append(TypeName(family->type == Type::kCounter, family->type == Type::kGauge));
+    out.push_back('\n');
+
+    for (const auto& series : family->series) {
+      switch (family->type) {
+        case Type::kCounter:
+          AppendSample(family->name, "", series->labels, {}, std::to_string(series->counter->Value()), &out);
+          break;
+        case Type::kGauge:
+          AppendSample(family->name, "", series->labels, {}, std::to_string(series->gauge->Value()), &out);
+          break;
+        case Type::kHistogram: {
+          const MetricHistogram& histogram = *series->histogram;
+          const std::vector<uint64_t> counts = histogram.BucketCounts();
+          uint64_t cumulative = 0;
+          for (size_t i = 0; i < counts.size(); ++i) {
+            cumulative += counts[i];
+            const std::string le =
+                i < histogram.Bounds().size() ? std::to_string(histogram.Bounds()[i]) : std::string("+Inf");
+            AppendSample(family->name, "_bucket", series->labels, "le=\"" + le + "\"", std::to_string(cumulative),
+                         &out);
+          }
+          AppendSample(family->name, "_sum", series->labels, {}, std::to_string(histogram.Sum()), &out);
+          // From the buckets, so _count always equals the +Inf bucket within one scrape.
+          AppendSample(family->name, "_count", series->labels, {}, std::to_string(cumulative), &out);
+          break;
+        }
+      }
+    }
+  }
+  return out;
+}
+
+MetricsRegistry& DefaultMetrics() {
+  static MetricsRegistry* registry = new MetricsRegistry();
+  return *registry;
+}
+
+}  // namespace mccmod
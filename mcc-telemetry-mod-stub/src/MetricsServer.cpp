@@ -0,0 +1,206 @@
+#include "Metrics.h"
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <string>
+
+namespace mccmod {
+namespace {
+
+// How often the accept loop looks at running_; bounds how long Stop() waits.
+constexpr int kAcceptPollMs = 250;
+// A scrape request is one short GET; anything longer is not a scraper.
+constexpr size_t kMaxRequestBytes = 4096;
+constexpr int kReceiveTimeoutMs = 1000;
+
+#if defined(_WIN32)
+using NativeSocket = SOCKET;
+constexpr NativeSocket kNoSocket = INVALID_SOCKET;
+
+void CloseSocket(NativeSocket socket) { closesocket(socket); }
+
+int PollOne(NativeSocket socket, int timeout_ms) {
+  WSAPOLLFD entry{};
+  entry.fd = socket;
+  entry.events = POLLRDNORM;
+  const int ready = WSAPoll(&entry, 1, timeout_ms);
+  return ready > 0 && (entry.revents & POLLRDNORM) ? 1 : ready < 0 ? -1 : 0;
+}
+
+void SetReceiveTimeout(NativeSocket socket, int timeout_ms) {
+  const DWORD value = static_cast<DWORD>(timeout_ms);
+  setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&value), sizeof(value));
+}
+#else
+using NativeSocket = int;
+constexpr NativeSocket kNoSocket = -1;
+
+void CloseSocket(NativeSocket socket) { close(socket); }
+
+int PollOne(NativeSocket socket, int timeout_ms) {
+  pollfd entry{};
+  entry.fd = socket;
+  entry.events = POLLIN;
+  const int ready = poll(&entry, 1, timeout_ms);
+  return ready > 0 && (entry.revents & POLLIN) ? 1 : ready < 0 ? -1 : 0;
+}
+
+void SetReceiveTimeout(NativeSocket socket, int timeout_ms) {
+  timeval value{};
+  value.tv_sec = timeout_ms / 1000;
+  value.tv_usec = (timeout_ms % 1000) * 1000;
+  setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &value, sizeof(value));
+}
+#endif
+
+bool SendAll(NativeSocket socket, const std::string& data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+#if defined(_WIN32)
+    const int n = send(socket, data.data() + sent, static_cast<int>(data.size() - sent), 0);
+#else
+    const ssize_t n = send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+#endif
+    if (n <= 0) return false;
+    sent += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+std::string Response(const char* status, const char* content_type, const std::string& body) {
+  std::string out = "HTTP/1.1 ";
+  out.append(status);
+  out.append("\r\nContent-Type: ");
+  out.append(content_type);
+  out.append("\r\nContent-Length: ");
+  out.append(std::to_string(body.size()));
+  out.append("\r\nConnection: close\r\n\r\n");
+  out.append(body);
+  return out;
+}
+
+}  // namespace
+
+MetricsServer::~MetricsServer() { Stop(); }
+
+bool MetricsServer::Start(uint16_t port, MetricsRegistry& registry) {
+  if (running_.load()) return true;
+  registry_ = &registry;
+
+#if defined(_WIN32)
+  WSADATA wsa{};
+  if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+
+  const NativeSocket fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (fd == kNoSocket) {
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+    return false;
+  }
+  const int reuse = 1;
+#if defined(_WIN32)
+  // On Windows SO_REUSEADDR lets another process bind the same port and
+  // take over the scrapes; exclusive use refuses that instead.
+  setsockopt(fd, SOL_SOCKET, SO_EXCLUSIVEADDRUSE, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+#else
+  // Rebinding right after a restart, while old connections sit in TIME_WAIT.
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+#endif
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  socklen_t length = sizeof(address);
+  if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 16) != 0 ||
+      getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+    CloseSocket(fd);
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+    return false;
+  }
+  port_ = ntohs(address.sin_port);
+  listener_ = static_cast<intptr_t>(fd);
+
+  running_.store(true);
+  acceptor_ = std::thread(&MetricsServer::AcceptLoop, this);
+  return true;
+}
+
+void MetricsServer::Stop() {
+  if (!running_.exchange(false)) return;
+  if (acceptor_.joinable()) {
+    acceptor_.join();
+  }
+  CloseSocket(static_cast<NativeSocket>(listener_));
+  listener_ = -1;
+  port_ = 0;
+#if defined(_WIN32)
+  WSACleanup();
+#endif
+}
+
+void MetricsServer::AcceptLoop() {
+  const NativeSocket listener = static_cast<NativeSocket>(listener_);
+  while (running_.load()) {
+    if (PollOne(listener, kAcceptPollMs) <= 0) continue;
+    const NativeSocket client = accept(listener, nullptr, nullptr);
+    if (client == kNoSocket) continue;
+    Serve(static_cast<intptr_t>(client));
+    CloseSocket(client);
+  }
+}
+
+void MetricsServer::Serve(intptr_t client_handle) {
+  const NativeSocket client = static_cast<NativeSocket>(client_handle);
+  SetReceiveTimeout(client, kReceiveTimeoutMs);
+
+  std::string request;
+  char buffer[1024];
+  while (request.find("\r\n\r\n") == std::string::npos && request.size() < kMaxRequestBytes) {
+    const auto n = recv(client, buffer, sizeof(buffer), 0);
+    if (n <= 0) break;
+    request.append(buffer, static_cast<size_t>(n));
+  }
+  if (request.empty()) return;
+
+  // Only the request line matters: METHOD SP TARGET SP VERSION.
+  const size_t line_end = request.find("\r\n");
+  const std::string line = request.substr(0, line_end);
+  const size_t method_end = line.find(' ');
+  const size_t target_end = method_end == std::string::npos ? std::string::npos : line.find(' ', method_end + 1);
+  if (target_end == std::string::npos) {
+    SendAll(client, Response("400 Bad Request", "text/plain", "bad request\n"));
+    return;
+  }
+  const std::string method = line.substr(0, method_end);
+  std::string target = line.substr(method_end + 1, target_end - method_end - 1);
+  target = target.substr(0, target.find('?'));
+
+  if (target != "/metrics") {
+    SendAll(client, Response("404 Not Found", "text/plain", "not found\n"));
+    return;
+  }
+  if (method != "GET") {
+    SendAll(client, Response("405 Method Not Allowed", "text/plain", "method not allowed\n"));
+    return;
+  }
+  scrapes_.fetch_add(1, std::memory_order_relaxed);
+  SendAll(client, Response("200 OK", "text/plain; version=0.0.4", registry_->Render()));
+}
+
+}  // namespace mccmod
@@ -0,0 +1,558 @@
+#include "ModScanner.h"
+
+#include "Clock.h"
+#include "Hash64.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace mccmod {
+namespace {
+
+namespace fs = std::filesystem;
+
+// Bumped whenever the hash input changes (e.g. kChunkBytes).
+constexpr char kCacheHeader[] = "MCCMODCACHE1";
+// Below this a plain read is cheaper than setting up and tearing down a mapping.
+constexpr uint64_t kMapThresholdBytes = 64 * 1024;
+
+struct DirTask {
+  fs::path dir;
+  uint32_t mod = 0;
+  // Relative to the mod directory, '/'-separated; empty for the mod itself.
+  std::string relative;
+};
+
+struct FileEntry {
+  fs::path path;
+  // Absolute UTF-8 path; the cache key.
+  std::string key;
+  std::string relative;
+  uint32_t mod = 0;
+  uint64_t size = 0;
+  int64_t mtime = 0;
+  uint64_t hash = 0;
+  // Slots in the chunk hash table; only used for files hashed this scan.
+  size_t first_chunk = 0;
+  uint32_t chunks = 0;
+};
+
+struct ChunkTask {
+  uint32_t file = 0;
+  uint32_t chunk = 0;
+};
+
+bool Cancelled(const std::atomic<bool>* cancel) {
+  return cancel && cancel->load(std::memory_order_relaxed);
+}
+
+void AppendU64(uint64_t value, std::string* out) {
+  char bytes[sizeof(value)];
+  std::memcpy(bytes, &value, sizeof(value));
+  out->append(bytes, sizeof(bytes));
+}
+
+// Lists one directory. Symlinks and special files are skipped: a link could
+// leave the mod folder or loop back into it.
+uint64_t ListDirectory(const DirTask& task, std::vector<DirTask>* subdirs,
+                       std::vector<FileEntry>* files) {
+  uint64_t errors = 0;
+  std::error_code ec;
+  fs::directory_iterator it(task.dir, ec);
+  if (ec) return 1;
+
+  for (const fs::directory_iterator end; !ec && it != end; it.increment(ec)) {
+    const fs::directory_entry& entry = *it;
+    std::error_code entry_ec;
+    const fs::file_status status = entry.symlink_status(entry_ec);
+    if (entry_ec) {
+      ++errors;
+      continue;
+    }
+    const bool is_dir = fs::is_directory(status);
+    if (!is_dir && !fs::is_regular_file(status)) continue;
+
+    std::string name = entry.path().filename().u8string();
+    std::string relative = task.relative.empty() ? std::move(name) : task.relative + '/' + name;
+    if (is_dir) {
+      subdirs->push_back(DirTask{entry.path(), task.mod, std::move(relative)});
+      continue;
+    }
+
+    FileEntry file;
+    file.size = entry.file_size(entry_ec);
+    if (!entry_ec) file.mtime = entry.last_write_time(entry_ec).time_since_epoch().count();
+    if (entry_ec) {
+      ++errors;
+      continue;
+    }
+    file.path = entry.path();
+    file.key = file.path.u8string();
+    file.relative = std::move(relative);
+    file.mod = task.mod;
+    files->push_back(std::move(file));
+  }
+  if (ec) ++errors;
+  return errors;
+}
+
+// Hashes [offset, offset + length) of a file. Large ranges are mapped rather
+// than copied through a buffer.
+bool HashRange(const fs::path& path, uint64_t offset, uint64_t length, uint64_t* hash) {
+  if (length == 0) {
+    *hash = Hash64(nullptr, 0);
+    return true;
+  }
+  thread_local std::vector<char> buffer;
+  bool ok = false;
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return false;
+
+  if (length < kMapThresholdBytes) {
+    buffer.resize(static_cast<size_t>(length));
+    OVERLAPPED at{};
+    at.Offset = static_cast<DWORD>(offset);
+    at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD read = 0;
+    if (ReadFile(file, buffer.data(), static_cast<DWORD>(length), &read, &at) && read == length) {
+      *hash = Hash64(buffer.data(), buffer.size());
+      ok = true;
+    }
+  } else {
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) {
+      // Chunk offsets are multiples of kChunkBytes, so they satisfy the
+      // allocation-granularity alignment MapViewOfFile requires.
+      const void* view = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(offset >> 32),
+                                       static_cast<DWORD>(offset), static_cast<SIZE_T>(length));
+      if (view) {
+        *hash = Hash64(view, static_cast<size_t>(length));
+        UnmapViewOfFile(view);
+        ok = true;
+      }
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+#else
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+
+  // Touching a mapping past end-of-file raises SIGBUS, so re-check the size
+  // in case the file was truncated since the walk stat'ed it.
+  struct stat info {};
+  if (fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < offset + length) {
+    close(fd);
+    return false;
+  }
+
+  if (length < kMapThresholdBytes) {
+    buffer.resize(static_cast<size_t>(length));
+    size_t done = 0;
+    while (done < length) {
+      const ssize_t got = pread(fd, buffer.data() + done, length - done, static_cast<off_t>(offset + done));
+      if (got < 0 && errno == EINTR) continue;
+      if (got <= 0) break;
+      done += static_cast<size_t>(got);
+    }
+    if (done == length) {
+      *hash = Hash64(buffer.data(), buffer.size());
+      ok = true;
+    }
+  } else {
+    void* view = mmap(nullptr, static_cast<size_t>(length), PROT_READ, MAP_PRIVATE, fd,
+                      static_cast<off_t>(offset));
+    if (view != MAP_FAILED) {
+      madvise(view, static_cast<size_t>(length), MADV_SEQUENTIAL | MADV_WILLNEED);
+      *hash = Hash64(view, static_cast<size_t>(length));
+      munmap(view, static_cast<size_t>(length));
+      ok = true;
+    }
+  }
+  close(fd);
+#endif
+
+  return ok;
+}
+
+std::vector<std::string> SplitRoots(const std::string& list) {
+  std::vector<std::string> roots;
+  std::string current;
+  for (const char c : list) {
+#if defined(_WIN32)
+    const bool separator = c == ';';
+#else
+    const bool separator = c == ';' || c == ':';
+#endif
+    if (!separator) {
+      current.push_back(c);
+      continue;
+    }
+    if (!current.empty()) roots.push_back(std::move(current));
+    current.clear();
+  }
+  if (!current.empty()) roots.push_back(std::move(current));
+  return roots;
+}
+
+}  // namespace
+
+std::string FormatModFingerprint(uint64_t fingerprint) {
+  if (fingerprint == 0) return {};
+  char buffer[17];
+  std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(fingerprint));
+  return buffer;
+}
+
+void ApplyModScan(const ModScanResult& result, TelemetrySnapshot* snapshot) {
+  const TelemetryFieldInfo& field = kTelemetryFields[kTelemetryField_mods];
+  snapshot->mods.clear();
+  size_t total = 0;
+  for (const ModInfo& mod : result.mods) {
+    // The same folder name under both roots is one mod to the user.
+    if (!snapshot->mods.empty() && snapshot->mods.back() == mod.name) continue;
+    if (mod.name.size() > kTelemetryItemMaxBytes) continue;
+    if (snapshot->mods.size() >= static_cast<size_t>(field.max) ||
+        total + mod.name.size() > kTelemetryListMaxBytes) {
+      break;
+    }
+    total += mod.name.size();
+    snapshot->mods.push_back(mod.name);
+  }
+  snapshot->mods_fingerprint = FormatModFingerprint(result.fingerprint);
+}
+
+std::vector<std::string> DefaultModRoots() {
+  if (const char* paths = std::getenv("MCC_MOD_PATHS")) {
+    return SplitRoots(paths);
+  }
+
+  std::vector<std::string> roots;
+#if defined(_WIN32)
+  const char* program_files_x86 = std::getenv("ProgramFiles(x86)");
+  const char* program_files = std::getenv("ProgramFiles");
+  const std::string steam_base = program_files_x86  ? program_files_x86
+                                 : program_files    ? program_files
+                                                    : "C:\\Program Files (x86)";
+  roots.push_back(steam_base + "\\Steam\\steamapps\\common\\Halo The Master Chief Collection\\Mods");
+  if (const char* user_profile = std::getenv("USERPROFILE")) {
+    roots.push_back(std::string(user_profile) + "\\Documents\\Halo MCC\\Mods");
+  }
+#endif
+  return roots;
+}
+
+ModScanner::ModScanner(size_t threads)
+    : threads_(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+  pool_.Start(threads_);
+}
+
+ModScanner::~ModScanner() {
+  pool_.Stop();
+}
+
+template <typename Body>
+void ModScanner::RunOnAllWorkers(const Body& body) {
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t remaining = threads_;
+  for (size_t worker = 0; worker < threads_; ++worker) {
+    const bool submitted = pool_.Submit([&, worker] {
+      body(worker);
+      std::lock_guard<std::mutex> lock(mutex);
+      --remaining;
+      // Notified under the lock: the waiter owns `done` and returns as soon as it sees 0.
+      done.notify_one();
+    });
+    if (!submitted) {
+      body(worker);
+      std::lock_guard<std::mutex> lock(mutex);
+      --remaining;
+    }
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [&] { return remaining == 0; });
+}
+
+ModScanResult ModScanner::Scan(const std::vector<std::string>& roots,
+                               const std::atomic<bool>* cancel) {
+  ModScanResult result;
+  ModScanStats& stats = result.stats;
+  Clock& clock = SystemClock();
+  const uint64_t walk_start = clock.SteadyMs();
+
+  // Mods are the top-level directories of each root, sorted up front so the
+  // walk can tag files with their final mod index.
+  struct ModDir {
+    ModInfo info;
+    fs::path path;
+  };
+  std::vector<ModDir> mod_dirs;
+  for (const std::string& root : roots) {
+    std::error_code ec;
+    const fs::path root_path = fs::absolute(fs::u8path(root), ec);
+    if (ec || !fs::is_directory(root_path, ec)) continue;
+    fs::directory_iterator it(root_path, ec);
+    for (const fs::directory_iterator end; !ec && it != end; it.increment(ec)) {
+      std::error_code entry_ec;
+      if (!fs::is_directory(it->symlink_status(entry_ec))) continue;
+      ModDir mod;
+      mod.info.name = it->path().filename().u8string();
+      mod.info.root = root;
+      mod.path = it->path();
+      mod_dirs.push_back(std::move(mod));
+    }
+    if (ec) ++stats.errors;
+  }
+  std::sort(mod_dirs.begin(), mod_dirs.end(), [](const ModDir& a, const ModDir& b) {
+    return a.info.name != b.info.name ? a.info.name < b.info.name : a.info.root < b.info.root;
+  });
+
+  // Parallel walk: workers share a queue of directories and stop once it is
+  // empty with no directory still being listed.
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::deque<DirTask> queue;
+  size_t listing = 0;
+  std::vector<FileEntry> files;
+  for (size_t i = 0; i < mod_dirs.size(); ++i) {
+    queue.push_back(DirTask{mod_dirs[i].path, static_cast<uint32_t>(i), std::string()});
+    result.mods.push_back(mod_dirs[i].info);
+  }
+
+  RunOnAllWorkers([&](size_t) {
+    std::vector<DirTask> subdirs;
+    std::vector<FileEntry> found;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      wake.wait(lock, [&] { return !queue.empty() || listing == 0 || Cancelled(cancel); });
+      if (queue.empty() || Cancelled(cancel)) break;
+      const DirTask task = std::move(queue.front());
+      queue.pop_front();
+      ++listing;
+      lock.unlock();
+
+      const uint64_t errors = ListDirectory(task, &subdirs, &found);
+
+      lock.lock();
+      --listing;
+      ++stats.directories;
+      stats.errors += errors;
+      for (DirTask& subdir : subdirs) queue.push_back(std::move(subdir));
+      for (FileEntry& file : found) files.push_back(std::move(file));
+      subdirs.clear();
+      found.clear();
+      wake.notify_all();
+    }
+    wake.notify_all();
+  });
+
+  const uint64_t hash_start = clock.SteadyMs();
+  stats.walk_ms = hash_start - walk_start;
+  if (Cancelled(cancel)) {
+    result.cancelled = true;
+    return result;
+  }
+
+  // Cache lookups, then one task per chunk of every file that missed.
+  // Biggest files go first so a large pack does not finish the scan alone.
+  std::vector<uint32_t> misses;
+  for (size_t i = 0; i < files.size(); ++i) {
+    FileEntry& file = files[i];
+    stats.bytes += file.size;
+    const auto cached = cache_.find(file.key);
+    if (cached != cache_.end() && cached->second.size == file.size &&
+        cached->second.mtime == file.mtime) {
+      file.hash = cached->second.hash;
+      ++stats.cache_hits;
+      continue;
+    }
+    misses.push_back(static_cast<uint32_t>(i));
+  }
+  stats.files = files.size();
+  std::sort(misses.begin(), misses.end(),
+            [&](uint32_t a, uint32_t b) { return files[a].size > files[b].size; });
+
+  std::vector<ChunkTask> chunks;
+  for (const uint32_t index : misses) {
+    FileEntry& file = files[index];
+    file.first_chunk = chunks.size();
+    file.chunks = static_cast<uint32_t>(std::max<uint64_t>(1, (file.size + kChunkBytes - 1) / kChunkBytes));
+    for (uint32_t chunk = 0; chunk < file.chunks; ++chunk) {
+      chunks.push_back(ChunkTask{index, chunk});
+    }
+  }
+
+  std::vector<uint64_t> chunk_hashes(chunks.size());
+  std::vector<uint8_t> chunk_ok(chunks.size());
+  std::atomic<size_t> next_chunk{0};
+  std::atomic<uint64_t> bytes_hashed{0};
+  RunOnAllWorkers([&](size_t) {
+    while (!Cancelled(cancel)) {
+      const size_t slot = next_chunk.fetch_add(1, std::memory_order_relaxed);
+      if (slot >= chunks.size()) break;
+      const FileEntry& file = files[chunks[slot].file];
+      const uint64_t offset = static_cast<uint64_t>(chunks[slot].chunk) * kChunkBytes;
+      const uint64_t length = std::min(kChunkBytes, file.size - offset);
+      if (HashRange(file.path, offset, length, &chunk_hashes[slot])) {
+        chunk_ok[slot] = 1;
+        bytes_hashed.fetch_add(length, std::memory_order_relaxed);
+      }
+    }
+  });
+  stats.bytes_hashed = bytes_hashed.load();
+  stats.hash_ms = clock.SteadyMs() - hash_start;
+  if (Cancelled(cancel)) {
+    result.cancelled = true;
+    return result;
+  }
+
+  // Files that could not be read hash as 0 and stay out of the cache, so the
+  // next scan tries them again.
+  std::unordered_set<uint32_t> unreadable;
+  for (const uint32_t index : misses) {
+    FileEntry& file = files[index];
+    const auto first = chunk_ok.begin() + static_cast<std::ptrdiff_t>(file.first_chunk);
+    if (!std::all_of(first, first + file.chunks, [](uint8_t ok) { return ok != 0; })) {
+      file.hash = 0;
+      unreadable.insert(index);
+      ++stats.errors;
+      continue;
+    }
+    const uint64_t* hashes = chunk_hashes.data() + file.first_chunk;
+    file.hash = file.chunks == 1 ? hashes[0] : Hash64(hashes, file.chunks * sizeof(uint64_t));
+    ++stats.files_hashed;
+  }
+
+  // Keep only files seen this scan; mods that were removed drop out.
+  std::unordered_map<std::string, CacheEntry> next_cache;
+  next_cache.reserve(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (unreadable.count(static_cast<uint32_t>(i))) continue;
+    const FileEntry& file = files[i];
+    next_cache[file.key] = CacheEntry{file.size, file.mtime, file.hash};
+  }
+  if (stats.files_hashed > 0 || next_cache.size() != cache_.size()) cache_dirty_ = true;
+  cache_ = std::move(next_cache);
+
+  // Fingerprints: per mod over its files in path order, then over the mods.
+  std::sort(files.begin(), files.end(), [](const FileEntry& a, const FileEntry& b) {
+    return a.mod != b.mod ? a.mod < b.mod : a.relative < b.relative;
+  });
+  std::string buffer;
+  size_t cursor = 0;
+  for (uint32_t mod = 0; mod < result.mods.size(); ++mod) {
+    ModInfo& info = result.mods[mod];
+    buffer.clear();
+    for (; cursor < files.size() && files[cursor].mod == mod; ++cursor) {
+      const FileEntry& file = files[cursor];
+      buffer.append(file.relative);
+      buffer.push_back('\0');
+      AppendU64(file.size, &buffer);
+      AppendU64(file.hash, &buffer);
+      ++info.files;
+      info.bytes += file.size;
+    }
+    info.fingerprint = Hash64(buffer);
+  }
+
+  buffer.clear();
+  for (const ModInfo& info : result.mods) {
+    buffer.append(info.name);
+    buffer.push_back('\0');
+    AppendU64(info.fingerprint, &buffer);
+  }
+  result.fingerprint = result.mods.empty() ? 0 : Hash64(buffer);
+  return result;
+}
+
+bool ModScanner::LoadCache(const std::string& path) {
+  cache_.clear();
+  cache_dirty_ = false;
+  std::ifstream in(fs::u8path(path), std::ios::binary);
+  if (!in) return false;
+
+  std::string line;
+  if (!std::getline(in, line) || line != kCacheHeader) return false;
+  while (std::getline(in, line)) {
+    // path \t size \t mtime \t hash; the path is the only field that could hold a tab.
+    const size_t hash_tab = line.rfind('\t');
+    if (hash_tab == std::string::npos || hash_tab == 0) continue;
+    const size_t mtime_tab = line.rfind('\t', hash_tab - 1);
+    if (mtime_tab == std::string::npos || mtime_tab == 0) continue;
+    const size_t size_tab = line.rfind('\t', mtime_tab - 1);
+    if (size_tab == std::string::npos) continue;
+
+    CacheEntry entry;
+    char* end = nullptr;
+    entry.size = std::strtoull(line.c_str() + size_tab + 1, &end, 10);
+    if (*end != '\t') continue;
+    entry.mtime = std::strtoll(line.c_str() + mtime_tab + 1, &end, 10);
+    if (*end != '\t') continue;
+    entry.hash = std::strtoull(line.c_str() + hash_tab + 1, &end, 16);
+    if (*end != '\0' && *end != '\r') continue;
+    cache_[line.substr(0, size_tab)] = entry;
+  }
+  return true;
+}
+
+bool ModScanner::SaveCache(const std::string& path) {
+  if (!cache_dirty_) return true;
+
+  const fs::path target = fs::u8path(path);
+  fs::path temp = target;
+  temp += ".tmp";
+  {
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out << kCacheHeader << '\n';
+    char numbers[64];
+    for (const auto& [key, entry] : cache_) {
+      if (key.find('\n') != std::string::npos) continue;
+      std::snprintf(numbers, sizeof(numbers), "\t%llu\t%lld\t%016llx\n",
+                    static_cast<unsigned long long>(entry.size), static_cast<long long>(entry.mtime),
+                    static_cast<unsigned long long>(entry.hash));
+      out << key << numbers;
+    }
+    if (!out.flush()) return false;
+  }
+
+  std::error_code ec;
+  fs::rename(temp, target, ec);
+  if (ec) {
+    fs::remove(temp, ec);
+    return false;
+  }
+  cache_dirty_ = false;
+  return true;
+}
+
+void ModScanner::ClearCache() {
+  cache_dirty_ = !cache_.empty();
+  cache_.clear();
+}
+
+}  // namespace mccmod
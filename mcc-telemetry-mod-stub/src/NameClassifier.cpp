@@ -0,0 +1,187 @@
+#include "NameClassifier.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MCC_NAME_AVX2 1
+#endif
+// x64 always has SSE2; MSVC does not define __SSE2__ for it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MCC_NAME_SSE2 1
+#endif
+
+namespace mccmod {
+namespace {
+
+#if defined(MCC_NAME_SSE2)
+// False if any of the 16 bytes at `p` is outside 0x20-0x7E; sets *has_alpha
+// if any is a letter. Signed compares do the range checks, so bytes >= 0x80
+// (negative) fail both. Letters are found by folding to lowercase with | 0x20.
+inline bool CheckChunk16(const char* p, bool* has_alpha) {
+  const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  const __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x1F)),
+                                          _mm_cmplt_epi8(v, _mm_set1_epi8(0x7F)));
+  if (_mm_movemask_epi8(printable) != 0xFFFF) return false;
+  const __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+  const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)),
+                                      _mm_cmplt_epi8(folded, _mm_set1_epi8('z' + 1)));
+  *has_alpha |= _mm_movemask_epi8(alpha) != 0;
+  return true;
+}
+#endif
+
+#if defined(MCC_NAME_AVX2)
+inline bool CheckChunk32(const char* p, bool* has_alpha) {
+  const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  const __m256i printable = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(0x1F)),
+                                             _mm256_cmpgt_epi8(_mm256_set1_epi8(0x7F), v));
+  if (_mm256_movemask_epi8(printable) != -1) return false;
+  const __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+  const __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(folded, _mm256_set1_epi8('a' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), folded));
+  *has_alpha |= _mm256_movemask_epi8(alpha) != 0;
+  return true;
+}
+#endif
+
+}  // namespace
+
+TextBounds TrimmedBounds(std::string_view text) {
+  TextBounds bounds{0, text.size()};
+  while (bounds.begin < bounds.end &&
+         (kNameCharClass[static_cast<unsigned char>(text[bounds.begin])] & kNameCharSpace)) {
+    ++bounds.begin;
+  }
+  while (bounds.end > bounds.begin &&
+         (kNameCharClass[static_cast<unsigned char>(text[bounds.end - 1])] & kNameCharSpace)) {
+    --bounds.end;
+  }
+  return bounds;
+}
+
+void TrimInPlace(std::string* text) {
+  const TextBounds bounds = TrimmedBounds(*text);
+  text->erase(bounds.end);
+  text->erase(0, bounds.begin);
+}
+
+bool IsLikelyNameTextScalar(std::string_view text) {
+  if (text.empty() || text.size() > kMaxNameTextBytes) return false;
+  uint8_t all = 0xFF;
+  uint8_t any = 0;
+  for (const char c : text) {
+    const uint8_t bits = kNameCharClass[static_cast<unsigned char>(c)];
+    all &= bits;
+    any |= bits;
+  }
+  return (all & kNameCharPrintable) && (any & kNameCharAlpha);
+}
+
+bool IsLikelyNameText(std::string_view text) {
+  const size_t size = text.size();
+  if (size == 0 || size > kMaxNameTextBytes) return false;
+  const char* data = text.data();
+  bool has_alpha = false;
+
+  // Whole chunks, then one chunk ending at the last byte. It overlaps the
+  // previous one, which is harmless for an all/any check and never reads
+  // outside the string.
+#if defined(MCC_NAME_AVX2)
+  if (size >= 32) {
+    size_t offset = 0;
+    for (; offset + 32 <= size; offset += 32) {
+      if (!CheckChunk32(data + offset, &has_alpha)) return false;
+    }
+    if (offset < size && !CheckChunk32(data + size - 32, &has_alpha)) return false;
+    return has_alpha;
+  }
+#endif
+#if defined(MCC_NAME_SSE2)
+  if (size >= 16) {
+    size_t offset = 0;
+    for (; offset + 16 <= size; offset += 16) {
+      if (!CheckChunk16(data + offset, &has_alpha)) return false;
+    }
+    if (offset < size && !CheckChunk16(data + size - 16, &has_alpha)) return false;
+    return has_alpha;
+  }
+#endif
+  return IsLikelyNameTextScalar(text);
+}
+
+void Utf16LeToUtf8(const char* bytes, size_t units, std::string* out) {
+  const auto unit = [bytes](size_t i) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(bytes[i * 2])) |
+           static_cast<uint32_t>(static_cast<unsigned char>(bytes[i * 2 + 1])) << 8;
+  };
+  out->clear();
+  out->reserve(units);
+  for (size_t i = 0; i < units; ++i) {
+    uint32_t cp = unit(i);
+    if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < units && unit(i + 1) >= 0xDC00 && unit(i + 1) <= 0xDFFF) {
+      cp = 0x10000 + ((cp - 0xD800) << 10) + (unit(i + 1) - 0xDC00);
+      ++i;
+    } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+      cp = 0xFFFD;
+    }
+
+    if (cp < 0x80) {
+      out->push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+      out->push_back(static_cast<char>(0xC0 | (cp >> 6)));
+      out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+      out->push_back(static_cast<char>(0xE0 | (cp >> 12)));
+      out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+      out->push_back(static_cast<char>(0xF0 | (cp >> 18)));
+      out->push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+      out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+  }
+}
+
+bool DecodeNameField(const char* raw, size_t size, uintptr_t address, bool (*accept)(std::string_view),
+                     std::string* out) {
+  out->assign(raw, strnlen(raw, std::min(size, kMaxNameTextBytes)));
+  if (accept(*out) || address % 2 != 0 || size == 0) return false;
+
+  // Only the early bytes decide: <printable> 00 <printable> 00 ... A short
+  // ASCII name followed by NUL padding must not pass for UTF-16.
+  const size_t pairs = std::min(size / 2, static_cast<size_t>(8));
+  size_t odd_zero = 0;
+  size_t even_printable = 0;
+  for (size_t i = 0; i < pairs; ++i) {
+    const unsigned char even = static_cast<unsigned char>(raw[i * 2]);
+    if (raw[i * 2 + 1] == 0) ++odd_zero;
+    if (even >= 32 && even <= 126) ++even_printable;
+  }
+  if (pairs < 2 || odd_zero + 1 < pairs || even_printable < 2) return false;
+
+  const size_t max_units = std::min(size, kNameFieldUtf16Bytes) / 2;
+  size_t units = 0;
+  while (units < max_units && (raw[units * 2] != 0 || raw[units * 2 + 1] != 0)) ++units;
+  std::string utf16;
+  Utf16LeToUtf8(raw, units, &utf16);
+  // Keep the UTF-8 reading when the UTF-16 one is no better.
+  if (utf16.empty() || !accept(utf16)) return false;
+  out->swap(utf16);
+  return true;
+}
+
+const char* NameClassifierIsa() {
+#if defined(MCC_NAME_AVX2)
+  return "avx2";
+#elif defined(MCC_NAME_SSE2)
+  return "sse2";
+#else
+  return "none";
+#endif
+}
+
+}  // namespace mccmod
@@ -0,0 +1,119 @@
+#include "PlayerRoster.h"
+
+#include "Hash64.h"
+#include "TelemetryContract.h"
+
+#include <cstring>
+#include <type_traits>
+
+namespace mccmod {
+namespace {
+
+static_assert(std::is_trivially_copyable_v<PlayerRoster> && sizeof(PlayerRoster) ==
+                  1 + kPlayerTableEntries * (3 + kRosterNameBytes),
+              "PlayerRoster is compared and hashed as bytes; it must not have padding");
+
+// UTF-16LE to UTF-8 into a fixed slot; unpaired surrogates become U+FFFD.
+// Returns the bytes written, or 0 if the name is empty or holds a control
+// character.
+size_t DecodeGamertag(const uint8_t* entry, char (&out)[kRosterNameBytes]) {
+  size_t written = 0;
+  bool visible = false;
+  for (size_t i = 0; i < kPlayerEntryNameChars; ++i) {
+    uint32_t cp = entry[i * 2] | (static_cast<uint32_t>(entry[i * 2 + 1]) << 8);
+    if (cp == 0) break;
+    if (cp < 0x20 || cp == 0x7F) return 0;
+    if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < kPlayerEntryNameChars) {
+      const uint32_t low = entry[i * 2 + 2] | (static_cast<uint32_t>(entry[i * 2 + 3]) << 8);
+      if (low >= 0xDC00 && low <= 0xDFFF) {
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        ++i;
+      } else {
+        cp = 0xFFFD;
+      }
+    } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+      cp = 0xFFFD;
+    }
+    if (cp != ' ') visible = true;
+
+    if (cp < 0x80) {
+      out[written++] = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+      out[written++] = static_cast<char>(0xC0 | (cp >> 6));
+      out[written++] = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+      out[written++] = static_cast<char>(0xE0 | (cp >> 12));
+      out[written++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      out[written++] = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+      out[written++] = static_cast<char>(0xF0 | (cp >> 18));
+      out[written++] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+      out[written++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      out[written++] = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+  }
+  return visible ? written : 0;
+}
+
+}  // namespace
+
+void DecodePlayerTable(const uint8_t* table, PlayerRoster* out) {
+  *out = PlayerRoster{};
+  for (size_t slot = 0; slot < kPlayerTableEntries; ++slot) {
+    const uint8_t* entry = table + slot * kPlayerEntryStride;
+    if (!(entry[kPlayerEntryFlagsOffset] & kPlayerEntryActive)) continue;
+    const size_t row = out->count;
+    const size_t length = DecodeGamertag(entry, out->names[row]);
+    if (length == 0) {
+      std::memset(out->names[row], 0, kRosterNameBytes);
+      continue;
+    }
+    out->name_lengths[row] = static_cast<uint8_t>(length);
+    out->teams[row] = entry[kPlayerEntryTeamOffset];
+    out->slots[row] = static_cast<uint8_t>(slot);
+    ++out->count;
+  }
+}
+
+bool SameRoster(const PlayerRoster& a, const PlayerRoster& b) {
+  return std::memcmp(&a, &b, sizeof(PlayerRoster)) == 0;
+}
+
+void AppendRosterJson(const PlayerRoster& roster, std::string* out) {
+  out->push_back('[');
+  for (size_t i = 0; i < roster.count; ++i) {
+    if (i > 0) out->push_back(',');
+    out->append("{\"name\":\"");
+    AppendEscapedJson(std::string(roster.names[i], roster.name_lengths[i]), out);
+    out->append("\",\"team\":");
+    out->append(roster.teams[i] == kPlayerNoTeam ? std::string("-1") : std::to_string(roster.teams[i]));
+    out->append(",\"slot\":");
+    out->append(std::to_string(roster.slots[i]));
+    out->push_back('}');
+  }
+  out->push_back(']');
+}
+
+bool RosterTracker::Update(const uint8_t* table) {
+  ++stats_.updates;
+  const uint64_t hash = Hash64(table, kPlayerTableBytes);
+  if (primed_ && hash == table_hash_) return false;
+  table_hash_ = hash;
+  ++stats_.decodes;
+
+  DecodePlayerTable(table, &scratch_);
+  // The first table always counts, so an empty lobby is still reported once.
+  if (primed_ && SameRoster(scratch_, roster_)) return false;
+  primed_ = true;
+  roster_ = scratch_;
+  ++version_;
+  ++stats_.changes;
+  return true;
+}
+
+void RosterTracker::Reset() {
+  primed_ = false;
+  roster_ = PlayerRoster{};
+}
+
+}  // namespace mccmod
@@ -0,0 +1,311 @@
+#include "ProcessAccess.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#include <TlHelp32.h>
+#else
+#include <dirent.h>
+#include <signal.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace mccmod {
+namespace {
+
+#if !defined(_WIN32)
+
+// Last component of a path, accepting both separators so Wine's
+// "Z:\...\MCC-Win64-Shipping.exe" argv[0] matches too.
+std::string BaseName(const std::string& path) {
+  const size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+std::string ReadProcFile(ProcessId pid, const char* name) {
+  std::ifstream file("/proc/" + std::to_string(pid) + "/" + name, std::ios::binary);
+  std::string content;
+  std::getline(file, content, '\0');
+  while (!content.empty() && (content.back() == '\n' || content.back() == '\0')) {
+    content.pop_back();
+  }
+  return content;
+}
+
+// The kernel keeps at most 15 characters of comm (TASK_COMM_LEN - 1).
+constexpr size_t kCommChars = 15;
+
+// Wine sets comm to the Windows executable's name; a long one is cut short.
+bool MatchesTruncatedComm(const std::string& comm, const std::vector<std::string>& names) {
+  if (comm.size() != kCommChars) return false;
+  for (const auto& name : names) {
+    if (name.size() > kCommChars && EqualsIgnoreCase(comm, name.substr(0, kCommChars))) return true;
+  }
+  return false;
+}
+
+// Remote iovecs per process_vm_readv call; well under IOV_MAX.
+constexpr size_t kBatchIovecs = 64;
+
+#endif
+
+bool MatchesAny(const std::string& candidate, const std::vector<std::string>& names) {
+  for (const auto& name : names) {
+    if (EqualsIgnoreCase(candidate, name)) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+bool EqualsIgnoreCase(const std::string& a, const std::string& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (std::tolower(static_cast<unsigned char>(a[i])) !=
+        std::tolower(static_cast<unsigned char>(b[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<ProcessId> FindProcessesByName(const std::vector<std::string>& names) {
+  std::vector<ProcessId> pids;
+#if defined(_WIN32)
+  HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+  if (snapshot == INVALID_HANDLE_VALUE) return pids;
+
+  PROCESSENTRY32 entry = {};
+  entry.dwSize = sizeof(entry);
+  if (Process32First(snapshot, &entry)) {
+    do {
+      if (MatchesAny(entry.szExeFile, names)) {
+        pids.push_back(entry.th32ProcessID);
+      }
+    } while (Process32Next(snapshot, &entry));
+  }
+  CloseHandle(snapshot);
+#else
+  DIR* proc = opendir("/proc");
+  if (!proc) return pids;
+  while (const dirent* entry = readdir(proc)) {
+    char* end = nullptr;
+    const unsigned long pid = std::strtoul(entry->d_name, &end, 10);
+    if (pid == 0 || *end != '\0') continue;
+    const ProcessId process = static_cast<ProcessId>(pid);
+    if (MatchesAny(BaseName(ReadProcFile(process, "cmdline")), names)) {
+      pids.push_back(process);
+      continue;
+    }
+    const std::string comm = ReadProcFile(process, "comm");
+    if (MatchesAny(comm, names) || (MatchesTruncatedComm(comm, names) && IsWineHosted(process))) {
+      pids.push_back(process);
+    }
+  }
+  closedir(proc);
+#endif
+  return pids;
+}
+
+bool IsWineHosted(ProcessId pid) {
+#if defined(_WIN32)
+  (void)pid;
+  return false;
+#else
+  // wine, wine64, wine-preloader or wine64-preloader, from a distro or a
+  // Proton build.
+  char target[4096];
+  const std::string link = "/proc/" + std::to_string(pid) + "/exe";
+  const ssize_t length = readlink(link.c_str(), target, sizeof(target) - 1);
+  if (length <= 0) return false;
+  const std::string exe = BaseName(std::string(target, static_cast<size_t>(length)));
+  return exe.size() >= 4 && EqualsIgnoreCase(exe.substr(0, 4), "wine");
+#endif
+}
+
+RemoteProcess::~RemoteProcess() {
+  Close();
+}
+
+bool RemoteProcess::Open(ProcessId pid) {
+  Close();
+  if (pid == 0) return false;
+#if defined(_WIN32)
+  HANDLE handle = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
+  if (!handle) return false;
+  handle_ = reinterpret_cast<intptr_t>(handle);
+#else
+  // No handle to hold on Linux; just make sure the process exists and is ours to signal.
+  if (kill(static_cast<pid_t>(pid), 0) != 0 && errno != EPERM) return false;
+  handle_ = static_cast<intptr_t>(pid);
+#endif
+  pid_ = pid;
+  return true;
+}
+
+void RemoteProcess::Close() {
+#if defined(_WIN32)
+  if (handle_) {
+    CloseHandle(reinterpret_cast<HANDLE>(handle_));
+  }
+#endif
+  handle_ = 0;
+  pid_ = 0;
+}
+
+bool RemoteProcess::Read(uintptr_t address, void* buffer, size_t size, size_t* bytes_read) const {
+  *bytes_read = 0;
+  if (!pid_) return false;
+#if defined(_WIN32)
+  SIZE_T read = 0;
+  const bool ok = ReadProcessMemory(reinterpret_cast<HANDLE>(handle_),
+                                    reinterpret_cast<LPCVOID>(address), buffer, size,
+                                    &read) != FALSE;
+  *bytes_read = static_cast<size_t>(read);
+  return ok;
+#else
+  iovec local{buffer, size};
+  iovec remote{reinterpret_cast<void*>(address), size};
+  const ssize_t read = process_vm_readv(static_cast<pid_t>(pid_), &local, 1, &remote, 1, 0);
+  if (read < 0) return false;
+  *bytes_read = static_cast<size_t>(read);
+  // Match ReadProcessMemory: a partial read is a failed read.
+  return static_cast<size_t>(read) == size;
+#endif
+}
+
+size_t RemoteProcess::ReadBatch(RemoteRead* reads, size_t count) const {
+  for (size_t i = 0; i < count; ++i) {
+    reads[i].bytes_read = 0;
+    reads[i].ok = false;
+    reads[i].error = 0;
+  }
+  if (!pid_) return 0;
+  size_t succeeded = 0;
+#if defined(_WIN32)
+  for (size_t i = 0; i < count; ++i) {
+    reads[i].ok = Read(reads[i].address, reads[i].buffer, reads[i].size, &reads[i].bytes_read);
+    if (reads[i].ok) {
+      ++succeeded;
+    } else {
+      reads[i].error = static_cast<int>(GetLastError());
+    }
+  }
+#else
+  iovec local[kBatchIovecs];
+  iovec remote[kBatchIovecs];
+  size_t next = 0;
+  while (next < count) {
+    const size_t chunk = std::min(count - next, kBatchIovecs);
+    for (size_t i = 0; i < chunk; ++i) {
+      const RemoteRead& read = reads[next + i];
+      local[i] = iovec{read.buffer, read.size};
+      remote[i] = iovec{reinterpret_cast<void*>(read.address), read.size};
+    }
+    const ssize_t transferred =
+        process_vm_readv(static_cast<pid_t>(pid_), local, chunk, remote, chunk, 0);
+    if (transferred < 0) {
+      // EFAULT: the first entry faulted before any byte moved; skip it.
+      // Anything else (ESRCH, EPERM) fails the rest of the batch too.
+      const int error = errno;
+      if (error != EFAULT) {
+        for (size_t i = next; i < count; ++i) reads[i].error = error;
+        break;
+      }
+      reads[next].error = EFAULT;
+      ++next;
+      continue;
+    }
+    // The kernel stops at the first remote entry that faults, so the bytes
+    // fill the entries in order. The entry they end in failed.
+    size_t left = static_cast<size_t>(transferred);
+    size_t done = 0;
+    for (; done < chunk && left >= reads[next + done].size; ++done) {
+      RemoteRead& read = reads[next + done];
+      read.bytes_read = read.size;
+      read.ok = true;
+      left -= read.size;
+      ++succeeded;
+    }
+    if (done < chunk) {
+      reads[next + done].bytes_read = left;
+      reads[next + done].error = EFAULT;
+      ++done;
+    }
+    next += done;
+  }
+#endif
+  return succeeded;
+}
+
+bool RemoteProcess::HasPeHeader(uintptr_t address) const {
+  uint8_t dos[0x40];
+  size_t bytes_read = 0;
+  if (!Read(address, dos, sizeof(dos), &bytes_read) || dos[0] != 'M' || dos[1] != 'Z') return false;
+  uint32_t pe_offset = 0;
+  std::memcpy(&pe_offset, dos + 0x3C, sizeof(pe_offset));
+  if (pe_offset < sizeof(dos) || pe_offset > 0x1000) return false;
+  char signature[4];
+  return Read(address + pe_offset, signature, sizeof(signature), &bytes_read) &&
+         std::memcmp(signature, "PE\0\0", 4) == 0;
+}
+
+uintptr_t RemoteProcess::FindModuleBase(const std::string& module_name) const {
+  if (!pid_) return 0;
+#if defined(_WIN32)
+  HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, pid_);
+  if (snapshot == INVALID_HANDLE_VALUE) return 0;
+
+  uintptr_t base = 0;
+  MODULEENTRY32 entry = {};
+  entry.dwSize = sizeof(entry);
+  if (Module32First(snapshot, &entry)) {
+    do {
+      if (EqualsIgnoreCase(entry.szModule, module_name)) {
+        base = reinterpret_cast<uintptr_t>(entry.modBaseAddr);
+        break;
+      }
+    } while (Module32Next(snapshot, &entry));
+  }
+  CloseHandle(snapshot);
+  return base;
+#else
+  // Wine maps a PE image's headers from file offset 0 at the image base and
+  // each section after it; the same file can also be mapped as plain data
+  // elsewhere, so prefer an offset-0 mapping that holds a PE header.
+  std::ifstream maps("/proc/" + std::to_string(pid_) + "/maps");
+  std::string line;
+  uintptr_t lowest = 0;
+  uintptr_t base = 0;
+  while (std::getline(maps, line)) {
+    unsigned long long start = 0;
+    unsigned long long offset = 0;
+    int path_offset = -1;
+    if (std::sscanf(line.c_str(), "%llx-%*x %*s %llx %*s %*s %n", &start, &offset, &path_offset) < 2 ||
+        path_offset < 0 || static_cast<size_t>(path_offset) >= line.size()) {
+      continue;
+    }
+    std::string path = line.substr(static_cast<size_t>(path_offset));
+    const std::string deleted = " (deleted)";
+    if (path.size() > deleted.size() && path.compare(path.size() - deleted.size(), deleted.size(), deleted) == 0) {
+      path.resize(path.size() - deleted.size());
+    }
+    if (!EqualsIgnoreCase(BaseName(path), module_name)) continue;
+    const uintptr_t address = static_cast<uintptr_t>(start);
+    if (lowest == 0 || address < lowest) lowest = address;
+    if (offset == 0 && (base == 0 || address < base) && HasPeHeader(address)) base = address;
+  }
+  return base ? base : lowest;
+#endif
+}
+
+}  // namespace mccmod
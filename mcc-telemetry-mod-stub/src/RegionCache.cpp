@@ -0,0 +1,234 @@
+#include "RegionCache.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+
+namespace mccmod {
+namespace {
+
+constexpr uint64_t kRegionTtlMs = 5000;
+constexpr uint64_t kBackoffBaseMs = 400;
+constexpr uint32_t kBackoffMaxShift = 16;
+constexpr size_t kMaxBackoffAddresses = 256;
+
+#if defined(_WIN32)
+
+bool IsReadableProtection(DWORD protect) {
+  if (protect & (PAGE_GUARD | PAGE_NOACCESS)) return false;
+  return (protect & (PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READ |
+                     PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)) != 0;
+}
+
+#else
+
+// Adds the region of one /proc/<pid>/maps line ("start-end perms ..."), and
+// the unmapped gap before it.
+void AddMapsLine(const char* line, uintptr_t* cursor, std::vector<MemoryRegion>* out) {
+  unsigned long long start = 0;
+  unsigned long long end = 0;
+  char perms[5] = {};
+  if (std::sscanf(line, "%llx-%llx %4s", &start, &end, perms) != 3 || end <= start) return;
+  if (start > *cursor) {
+    out->push_back({*cursor, static_cast<uintptr_t>(start), false});
+  }
+  out->push_back({static_cast<uintptr_t>(start), static_cast<uintptr_t>(end), perms[0] == 'r'});
+  *cursor = static_cast<uintptr_t>(end);
+}
+
+#endif
+
+bool IsWholeMap(const std::vector<MemoryRegion>& regions) {
+  return !regions.empty() && regions.front().base == 0 &&
+         regions.back().end == std::numeric_limits<uintptr_t>::max();
+}
+
+}  // namespace
+
+bool QueryMemoryRegions(intptr_t process, uintptr_t address, std::vector<MemoryRegion>* out) {
+  out->clear();
+#if defined(_WIN32)
+  MEMORY_BASIC_INFORMATION info{};
+  if (VirtualQueryEx(reinterpret_cast<HANDLE>(process), reinterpret_cast<LPCVOID>(address), &info,
+                     sizeof(info)) != sizeof(info)) {
+    return false;
+  }
+  MemoryRegion region;
+  region.base = reinterpret_cast<uintptr_t>(info.BaseAddress);
+  region.end = region.base + info.RegionSize;
+  region.readable = info.State == MEM_COMMIT && IsReadableProtection(info.Protect);
+  out->push_back(region);
+  return true;
+#else
+  (void)address;
+  char path[64];
+  std::snprintf(path, sizeof(path), "/proc/%lld/maps", static_cast<long long>(process));
+  const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+
+  // Only the head of each line matters; the rest (a path, maybe longer than
+  // any buffer) is skipped. Stack buffers, so a refresh does not allocate.
+  char buffer[4096];
+  char head[64];
+  size_t head_length = 0;
+  uintptr_t cursor = 0;
+  while (true) {
+    const ssize_t n = read(fd, buffer, sizeof(buffer));
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) {
+      close(fd);
+      out->clear();
+      return false;
+    }
+    if (n == 0) break;
+    for (ssize_t i = 0; i < n; ++i) {
+      if (buffer[i] == '\n') {
+        head[head_length] = '\0';
+        AddMapsLine(head, &cursor, out);
+        head_length = 0;
+      } else if (head_length + 1 < sizeof(head)) {
+        head[head_length++] = buffer[i];
+      }
+    }
+  }
+  close(fd);
+  out->push_back({cursor, std::numeric_limits<uintptr_t>::max(), false});
+  return true;
+#endif
+}
+
+void RegionCache::Attach(intptr_t process, uint64_t now_ms) {
+  process_ = process;
+  attached_ms_ = now_ms;
+  stats_ = RegionCacheStats{};
+  Invalidate();
+}
+
+void RegionCache::Invalidate() {
+  regions_.clear();
+  backoff_.clear();
+}
+
+bool RegionCache::Admit(uintptr_t address, size_t size, uint64_t now_ms) {
+  if (!process_) return true;
+
+  const auto backoff = backoff_.find(address);
+  if (backoff != backoff_.end() && now_ms < backoff->second.retry_at_ms) {
+    ++stats_.rejected_backoff;
+    return false;
+  }
+
+  if (size > std::numeric_limits<uintptr_t>::max() - address) {
+    ++stats_.rejected_unmapped;
+    return false;
+  }
+
+  // A read may span neighbouring regions with different protections; all must be readable.
+  const uintptr_t last = address + size;
+  for (uintptr_t cursor = address; cursor < last;) {
+    const Region* region = Lookup(cursor, now_ms);
+    if (!region) return true;  // Unknown: let the read decide.
+    if (!region->readable) {
+      ++stats_.rejected_unmapped;
+      return false;
+    }
+    cursor = region->end;
+  }
+  return true;
+}
+
+void RegionCache::RecordResult(uintptr_t address, bool ok, uint64_t now_ms, uint64_t max_backoff_ms) {
+  if (!process_) return;
+
+  if (ok) {
+    backoff_.erase(address);
+    return;
+  }
+
+  ++stats_.read_failures;
+  if (backoff_.size() >= kMaxBackoffAddresses && backoff_.find(address) == backoff_.end()) {
+    backoff_.clear();
+  }
+  Backoff& entry = backoff_[address];
+  ++entry.failures;
+  const uint32_t shift = std::min(entry.failures - 1, kBackoffMaxShift);
+  entry.retry_at_ms = now_ms + std::min(kBackoffBaseMs << shift, max_backoff_ms);
+
+  // The cached map said this was readable; refetch the region next time.
+  const auto it = Containing(address);
+  if (it != regions_.end()) regions_.erase(it);
+}
+
+bool RegionCache::IsReadable(uintptr_t address, uint64_t now_ms) {
+  if (!process_) return true;
+  const Region* region = Lookup(address, now_ms);
+  return !region || region->readable;
+}
+
+RegionCacheStats RegionCache::GetStats(uint64_t now_ms) const {
+  RegionCacheStats stats = stats_;
+  stats.backoff_addresses = backoff_.size();
+  const uint64_t elapsed_ms = now_ms > attached_ms_ ? now_ms - attached_ms_ : 0;
+  if (elapsed_ms > 0) {
+    const double avoided = static_cast<double>(stats.rejected_unmapped + stats.rejected_backoff);
+    stats.avoided_per_hour = avoided * 3600000.0 / static_cast<double>(elapsed_ms);
+  }
+  return stats;
+}
+
+const RegionCache::Region* RegionCache::Lookup(uintptr_t address, uint64_t now_ms) {
+  auto find = [this, address, now_ms]() -> const Region* {
+    const auto it = Containing(address);
+    if (it == regions_.end() || now_ms - it->fetched_ms > kRegionTtlMs) return nullptr;
+    return &*it;
+  };
+
+  if (const Region* cached = find()) return cached;
+
+  ++stats_.region_queries;
+  if (!QueryMemoryRegions(process_, address, &fetched_)) return nullptr;
+  if (IsWholeMap(fetched_)) {
+    // Linux answers with the whole map, sorted and gap-filled; it replaces the cache outright.
+    regions_.clear();
+    for (const auto& region : fetched_) {
+      if (region.end > region.base) regions_.push_back({region.base, region.end, region.readable, now_ms});
+    }
+  } else {
+    for (const auto& region : fetched_) {
+      Insert(region, now_ms);
+    }
+  }
+  return find();
+}
+
+void RegionCache::Insert(const MemoryRegion& region, uint64_t now_ms) {
+  if (region.end <= region.base) return;
+
+  // Drop anything the new region overlaps, including an entry that starts below it.
+  auto first = std::lower_bound(regions_.begin(), regions_.end(), region.base,
+                                [](const Region& entry, uintptr_t base) { return entry.base < base; });
+  if (first != regions_.begin() && std::prev(first)->end > region.base) --first;
+  auto last = first;
+  while (last != regions_.end() && last->base < region.end) ++last;
+  first = regions_.erase(first, last);
+  regions_.insert(first, Region{region.base, region.end, region.readable, now_ms});
+}
+
+std::vector<RegionCache::Region>::iterator RegionCache::Containing(uintptr_t address) {
+  auto it = std::upper_bound(regions_.begin(), regions_.end(), address,
+                             [](uintptr_t value, const Region& entry) { return value < entry.base; });
+  if (it == regions_.begin()) return regions_.end();
+  --it;
+  return address < it->end ? it : regions_.end();
+}
+
+}  // namespace mccmod
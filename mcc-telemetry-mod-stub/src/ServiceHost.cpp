@@ -0,0 +1,220 @@
+#include "ServiceHost.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+
+namespace mccmod {
+namespace {
+
+std::atomic<bool> g_shutdown{false};
+
+#if defined(_WIN32)
+
+constexpr char kStopEventName[] = "Local\\hmcc-reader-stop";
+HANDLE g_stop_event = nullptr;
+
+uint64_t FileTimeToMs(const FILETIME& time) {
+  const uint64_t ticks = (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+  return ticks / 10000;
+}
+
+BOOL WINAPI OnConsoleControl(DWORD) {
+  RequestShutdown();
+  return TRUE;
+}
+
+#else
+
+// Self-pipe so the signal handler can wake WaitForShutdown with only async-signal-safe calls.
+int g_wake_pipe[2] = {-1, -1};
+
+void OnSignal(int) {
+  g_shutdown.store(true);
+  if (g_wake_pipe[1] >= 0) {
+    const char byte = 1;
+    const ssize_t ignored = write(g_wake_pipe[1], &byte, 1);
+    (void)ignored;
+  }
+}
+
+#endif
+
+}  // namespace
+
+bool GetProcessResourceUsage(ResourceUsage* out) {
+#if defined(_WIN32)
+  FILETIME created{}, exited{}, kernel{}, user{};
+  PROCESS_MEMORY_COUNTERS memory{};
+  memory.cb = sizeof(memory);
+  HANDLE self = GetCurrentProcess();
+  if (!GetProcessTimes(self, &created, &exited, &kernel, &user) ||
+      !GetProcessMemoryInfo(self, &memory, sizeof(memory))) {
+    return false;
+  }
+  out->cpu_ms = FileTimeToMs(kernel) + FileTimeToMs(user);
+  out->working_set_bytes = memory.WorkingSetSize;
+  return true;
+#else
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return false;
+  out->cpu_ms = static_cast<uint64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 +
+                static_cast<uint64_t>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+
+  unsigned long long size_pages = 0;
+  unsigned long long resident_pages = 0;
+  FILE* statm = std::fopen("/proc/self/statm", "r");
+  if (!statm) return false;
+  const bool parsed = std::fscanf(statm, "%llu %llu", &size_pages, &resident_pages) == 2;
+  std::fclose(statm);
+  if (!parsed) return false;
+  out->working_set_bytes = resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  return true;
+#endif
+}
+
+bool LowerProcessPriority() {
+#if defined(_WIN32)
+  return SetPriorityClass(GetCurrentProcess(), BELOW_NORMAL_PRIORITY_CLASS) != FALSE;
+#else
+  return setpriority(PRIO_PROCESS, 0, 10) == 0;
+#endif
+}
+
+void TrimWorkingSet() {
+#if defined(_WIN32)
+  SetProcessWorkingSetSize(GetCurrentProcess(), static_cast<SIZE_T>(-1), static_cast<SIZE_T>(-1));
+#elif defined(__GLIBC__)
+  malloc_trim(0);
+#endif
+}
+
+void InstallShutdownHandlers() {
+#if defined(_WIN32)
+  if (!g_stop_event) {
+    g_stop_event = CreateEventA(nullptr, TRUE, FALSE, kStopEventName);
+  }
+  SetConsoleCtrlHandler(OnConsoleControl, TRUE);
+#else
+  if (g_wake_pipe[0] < 0 && pipe(g_wake_pipe) == 0) {
+    for (int fd : g_wake_pipe) {
+      fcntl(fd, F_SETFD, FD_CLOEXEC);
+      fcntl(fd, F_SETFL, O_NONBLOCK);
+    }
+  }
+  struct sigaction action {};
+  action.sa_handler = OnSignal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+#endif
+}
+
+void RequestShutdown() {
+  g_shutdown.store(true);
+#if defined(_WIN32)
+  if (g_stop_event) SetEvent(g_stop_event);
+#else
+  OnSignal(0);
+#endif
+}
+
+bool IsShutdownRequested() {
+  return g_shutdown.load();
+}
+
+bool WaitForShutdown(uint64_t timeout_ms) {
+  if (g_shutdown.load()) return true;
+#if defined(_WIN32)
+  if (g_stop_event) {
+    if (WaitForSingleObject(g_stop_event, static_cast<DWORD>(timeout_ms)) == WAIT_OBJECT_0) {
+      g_shutdown.store(true);
+    }
+  } else {
+    Sleep(static_cast<DWORD>(timeout_ms));
+  }
+#else
+  pollfd entry{};
+  entry.fd = g_wake_pipe[0];
+  entry.events = POLLIN;
+  poll(entry.fd >= 0 ? &entry : nullptr, entry.fd >= 0 ? 1 : 0, static_cast<int>(timeout_ms));
+#endif
+  return g_shutdown.load();
+}
+
+intptr_t ShutdownWakeHandle() {
+#if defined(_WIN32)
+  return g_stop_event ? reinterpret_cast<intptr_t>(g_stop_event) : -1;
+#else
+  return g_wake_pipe[0];
+#endif
+}
+
+bool SignalRunningService() {
+#if defined(_WIN32)
+  HANDLE event = OpenEventA(EVENT_MODIFY_STATE, FALSE, kStopEventName);
+  if (!event) return false;
+  const bool ok = SetEvent(event) != FALSE;
+  CloseHandle(event);
+  return ok;
+#else
+  return false;
+#endif
+}
+
+const ResourceReport& ResourceBudget::Update(uint64_t now_ms, uint64_t wakeups) {
+  ResourceUsage usage;
+  if (!GetProcessResourceUsage(&usage)) return report_;
+  return Update(now_ms, wakeups, usage);
+}
+
+const ResourceReport& ResourceBudget::Update(uint64_t now_ms, uint64_t wakeups, const ResourceUsage& usage) {
+  report_.working_set_bytes = usage.working_set_bytes;
+  if (!has_baseline_ || now_ms <= last_ms_) {
+    has_baseline_ = true;
+    last_ms_ = now_ms;
+    last_cpu_ms_ = usage.cpu_ms;
+    last_wakeups_ = wakeups;
+    return report_;
+  }
+
+  const double elapsed_ms = static_cast<double>(now_ms - last_ms_);
+  report_.cpu_ms_per_minute = static_cast<double>(usage.cpu_ms - last_cpu_ms_) * 60000.0 / elapsed_ms;
+  report_.wakeups_per_second = static_cast<double>(wakeups - last_wakeups_) * 1000.0 / elapsed_ms;
+  last_ms_ = now_ms;
+  last_cpu_ms_ = usage.cpu_ms;
+  last_wakeups_ = wakeups;
+
+  report_.over_memory = report_.working_set_bytes > limits_.max_working_set_bytes;
+  report_.over_cpu = report_.cpu_ms_per_minute > limits_.max_cpu_ms_per_minute;
+  report_.over_wakeups = report_.wakeups_per_second > limits_.max_wakeups_per_second;
+
+  if (report_.over_memory) {
+    TrimWorkingSet();
+    ++report_.trims;
+  }
+  if (report_.over_cpu || report_.over_wakeups) {
+    report_.throttle = std::min(report_.throttle * 2, kMaxThrottle);
+  } else if (report_.throttle > 1 &&
+             report_.cpu_ms_per_minute < limits_.max_cpu_ms_per_minute / 2 &&
+             report_.wakeups_per_second < limits_.max_wakeups_per_second / 2) {
+    report_.throttle /= 2;
+  }
+  return report_;
+}
+
+}  // namespace mccmod
@@ -105,6 +105,24 @@ std::string GetDefaultSettingsPath() {
   return app_data + "\\MCC\\telemetry_mod_settings.json";
 }
 
+std::string GetDefaultSpoolPath() {
+  const std::string app_data = GetEnvVar("APPDATA");
+  if (app_data.empty()) return "telemetry_spool.log";
+  return app_data + "\\MCC\\telemetry_spool.log";
+}
+
+std::string GetDefaultModCachePath() {
+  const std::string app_data = GetEnvVar("APPDATA");
+  if (app_data.empty()) return "mod_scan_cache.tsv";
+  return app_data + "\\MCC\\mod_scan_cache.tsv";
+}
+
+std::string GetDefaultLogPath() {
+  const std::string app_data = GetEnvVar("APPDATA");
+  if (app_data.empty()) return "telemetry_mod.log";
+  return app_data + "\\MCC\\telemetry_mod.log";
+}
+
 ModSettings LoadSettings() {
   ModSettings settings;
 
@@ -127,9 +145,15 @@ ModSettings LoadSettings() {
   if (FindJsonBool(json, "debugMode", &bool_value)) {
     settings.debug_mode = bool_value;
   }
+  if (FindJsonBool(json, "scanMods", &bool_value)) {
+    settings.scan_mods = bool_value;
+  }
   if (FindJsonInt(json, "updateInterval", &int_value)) {
     settings.update_interval_ms = ClampInt(int_value, 500, 10000);
   }
+  if (FindJsonInt(json, "metricsPort", &int_value)) {
+    settings.metrics_port = ClampInt(int_value, 0, 65535);
+  }
   if (FindJsonString(json, "endpoint", &str_value) && !str_value.empty()) {
     settings.endpoint = str_value;
   }
@@ -0,0 +1,67 @@
+#include "SignalFilter.h"
+
+#include <cstdlib>
+#include <sstream>
+
+namespace mccmod {
+namespace {
+
+bool ParseInt(const std::string& text, int min, int max, int* out) {
+  if (text.empty()) return false;
+  char* end = nullptr;
+  const long value = std::strtol(text.c_str(), &end, 10);
+  if (*end != '\0' || value < min || value > max) return false;
+  *out = static_cast<int>(value);
+  return true;
+}
+
+bool ParseFraction(const std::string& text, float* out) {
+  if (text.empty()) return false;
+  char* end = nullptr;
+  const double value = std::strtod(text.c_str(), &end);
+  if (*end != '\0' || !(value >= 0.0 && value <= 1.0)) return false;
+  *out = static_cast<float>(value);
+  return true;
+}
+
+}  // namespace
+
+bool ParseSignalFilterConfig(const std::string& spec, SignalFilterConfig* config) {
+  SignalFilterConfig parsed = *config;
+  std::istringstream in(spec);
+  std::string item;
+  while (std::getline(in, item, ',')) {
+    if (item.empty()) continue;
+    const size_t equals = item.find('=');
+    if (equals == std::string::npos) return false;
+    const std::string key = item.substr(0, equals);
+    const std::string value = item.substr(equals + 1);
+    int fast = 0;
+    bool ok = false;
+    if (key == "streak") {
+      ok = ParseInt(value, 1, 1000, &parsed.streak_ticks);
+    } else if (key == "conflict") {
+      ok = ParseInt(value, 1, 1000, &parsed.conflict_ticks);
+    } else if (key == "sources") {
+      ok = ParseInt(value, 1, kMaxSignalSources, &parsed.fast_min_sources);
+    } else if (key == "confidence") {
+      ok = ParseFraction(value, &parsed.fast_confidence);
+    } else if (key == "fast") {
+      ok = ParseInt(value, 0, 1, &fast);
+      parsed.fast_commit = fast != 0;
+    }
+    if (!ok) return false;
+  }
+  *config = parsed;
+  return true;
+}
+
+std::string FormatSignalFilterConfig(const SignalFilterConfig& config) {
+  std::ostringstream out;
+  out << "streak=" << config.streak_ticks << ",conflict=" << config.conflict_ticks
+      << ",sources=" << config.fast_min_sources << ",confidence=" << config.fast_confidence
+      << ",fast=" << (config.fast_commit ? 1 : 0);
+  return out.str();
+}
+
+}  // namespace mccmod
@@ -0,0 +1,356 @@
+#include "SnapshotPublisher.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace mccmod {
+namespace {
+
+#if defined(_WIN32)
+
+constexpr DWORD kPipeBufferBytes = 64 * 1024;
+constexpr DWORD kAcceptWaitMs = 1000;
+
+HANDLE ToHandle(intptr_t value) {
+  return reinterpret_cast<HANDLE>(value);
+}
+
+bool WriteAll(intptr_t handle, const char* data, size_t size, intptr_t stop_event) {
+  HANDLE pipe = ToHandle(handle);
+  OVERLAPPED overlapped{};
+  overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+  if (!overlapped.hEvent) return false;
+
+  bool ok = true;
+  while (ok && size > 0) {
+    DWORD written = 0;
+    ResetEvent(overlapped.hEvent);
+    if (!WriteFile(pipe, data, static_cast<DWORD>(size), &written, &overlapped)) {
+      if (GetLastError() != ERROR_IO_PENDING) {
+        ok = false;
+        break;
+      }
+      const HANDLE waits[2] = {overlapped.hEvent, ToHandle(stop_event)};
+      const DWORD signaled = WaitForMultipleObjects(2, waits, FALSE, INFINITE);
+      if (signaled != WAIT_OBJECT_0) {
+        CancelIoEx(pipe, &overlapped);
+        GetOverlappedResult(pipe, &overlapped, &written, TRUE);
+        ok = false;
+        break;
+      }
+      if (!GetOverlappedResult(pipe, &overlapped, &written, FALSE)) {
+        ok = false;
+        break;
+      }
+    }
+    data += written;
+    size -= written;
+  }
+
+  CloseHandle(overlapped.hEvent);
+  return ok;
+}
+
+void InterruptNative(intptr_t handle) {
+  CancelIoEx(ToHandle(handle), nullptr);
+}
+
+void CloseNative(intptr_t handle) {
+  HANDLE pipe = ToHandle(handle);
+  DisconnectNamedPipe(pipe);
+  CloseHandle(pipe);
+}
+
+#else
+
+constexpr int kAcceptPollMs = 250;
+
+bool WriteAll(intptr_t handle, const char* data, size_t size, intptr_t) {
+  const int fd = static_cast<int>(handle);
+  while (size > 0) {
+    const ssize_t written = send(fd, data, size, MSG_NOSIGNAL);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+void InterruptNative(intptr_t handle) {
+  shutdown(static_cast<int>(handle), SHUT_RDWR);
+}
+
+void CloseNative(intptr_t handle) {
+  close(static_cast<int>(handle));
+}
+
+// A reader that crashed leaves its socket file behind, but so does one that
+// is still running. Only a socket nobody answers on is removed; anything else
+// (a live listener, a full backlog, a non-socket file) keeps the path.
+bool ClearStaleSocket(const sockaddr_un& address) {
+  struct stat info{};
+  if (lstat(address.sun_path, &info) != 0) return errno == ENOENT;
+  if (!S_ISSOCK(info.st_mode)) return false;
+
+  const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (probe < 0) return false;
+  const bool refused =
+      connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 && errno == ECONNREFUSED;
+  close(probe);
+  return refused && unlink(address.sun_path) == 0;
+}
+
+#endif
+
+}  // namespace
+
+struct SnapshotPublisher::Client {
+  intptr_t handle = -1;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::deque<Message> queue;
+  bool closing = false;
+  std::atomic<bool> done{false};
+  std::thread thread;
+};
+
+SnapshotPublisher::SnapshotPublisher() = default;
+
+SnapshotPublisher::~SnapshotPublisher() {
+  Stop();
+}
+
+std::string SnapshotPublisher::GetDefaultEndpoint() {
+#if defined(_WIN32)
+  return "\\\\.\\pipe\\hmcc-telemetry";
+#else
+  const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+  const std::string dir = runtime_dir && *runtime_dir ? runtime_dir : "/tmp";
+  return dir + "/hmcc-telemetry.sock";
+#endif
+}
+
+bool SnapshotPublisher::Start(const std::string& endpoint, size_t client_queue_depth) {
+  if (running_.load()) return true;
+  endpoint_ = endpoint.empty() ? GetDefaultEndpoint() : endpoint;
+  client_queue_depth_ = client_queue_depth == 0 ? 1 : client_queue_depth;
+
+#if defined(_WIN32)
+  HANDLE stop_event = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+  if (!stop_event) return false;
+  stop_event_ = reinterpret_cast<intptr_t>(stop_event);
+#else
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (endpoint_.size() >= sizeof(address.sun_path)) return false;
+  std::memcpy(address.sun_path, endpoint_.c_str(), endpoint_.size() + 1);
+
+  if (!ClearStaleSocket(address)) return false;
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return false;
+  if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+      listen(fd, 64) != 0) {
+    close(fd);
+    return false;
+  }
+  chmod(endpoint_.c_str(), 0600);
+  listener_ = fd;
+#endif
+
+  running_.store(true);
+  acceptor_ = std::thread(&SnapshotPublisher::AcceptLoop, this);
+  return true;
+}
+
+void SnapshotPublisher::Stop() {
+  if (!running_.exchange(false)) return;
+
+#if defined(_WIN32)
+  SetEvent(ToHandle(stop_event_));
+#endif
+  if (acceptor_.joinable()) {
+    acceptor_.join();
+  }
+  ReapClients(true);
+
+#if defined(_WIN32)
+  CloseHandle(ToHandle(stop_event_));
+  stop_event_ = 0;
+#else
+  close(static_cast<int>(listener_));
+  listener_ = -1;
+  unlink(endpoint_.c_str());
+#endif
+}
+
+void SnapshotPublisher::Publish(const std::string& snapshot_json) {
+  auto message = std::make_shared<const std::string>(snapshot_json + "\n");
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  latest_ = message;
+  ++published_;
+  for (auto& client : clients_) {
+    std::lock_guard<std::mutex> client_lock(client->mutex);
+    if (client->queue.size() >= client_queue_depth_) {
+      // Drop-to-latest: a subscriber that fell behind only needs the newest state.
+      dropped_ += client->queue.size();
+      client->queue.clear();
+    }
+    client->queue.push_back(message);
+    client->wake.notify_one();
+  }
+}
+
+PublisherStats SnapshotPublisher::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PublisherStats stats;
+  stats.published = published_;
+  stats.dropped = dropped_;
+  stats.subscribers = clients_.size();
+  return stats;
+}
+
+void SnapshotPublisher::AcceptLoop() {
+#if defined(_WIN32)
+  HANDLE connect_event = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+  if (!connect_event) return;
+
+  while (running_.load()) {
+    HANDLE pipe = CreateNamedPipeA(
+        endpoint_.c_str(), PIPE_ACCESS_OUTBOUND | FILE_FLAG_OVERLAPPED,
+        PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, PIPE_UNLIMITED_INSTANCES,
+        kPipeBufferBytes, 0, 0, nullptr);
+    if (pipe == INVALID_HANDLE_VALUE) {
+      if (WaitForSingleObject(ToHandle(stop_event_), kAcceptWaitMs) == WAIT_OBJECT_0) break;
+      continue;
+    }
+
+    OVERLAPPED overlapped{};
+    overlapped.hEvent = connect_event;
+    ResetEvent(connect_event);
+
+    bool connected = ConnectNamedPipe(pipe, &overlapped) != FALSE;
+    if (!connected) {
+      const DWORD error = GetLastError();
+      if (error == ERROR_PIPE_CONNECTED) {
+        connected = true;
+      } else if (error == ERROR_IO_PENDING) {
+        const HANDLE waits[2] = {connect_event, ToHandle(stop_event_)};
+        while (running_.load()) {
+          const DWORD signaled = WaitForMultipleObjects(2, waits, FALSE, kAcceptWaitMs);
+          if (signaled == WAIT_OBJECT_0) {
+            DWORD unused = 0;
+            connected = GetOverlappedResult(pipe, &overlapped, &unused, FALSE) != FALSE;
+            break;
+          }
+          if (signaled != WAIT_TIMEOUT) break;
+          ReapClients(false);
+        }
+        if (!connected) {
+          CancelIoEx(pipe, &overlapped);
+          DWORD unused = 0;
+          GetOverlappedResult(pipe, &overlapped, &unused, TRUE);
+        }
+      }
+    }
+
+    if (connected && running_.load()) {
+      AddClient(reinterpret_cast<intptr_t>(pipe));
+    } else {
+      CloseHandle(pipe);
+    }
+    ReapClients(false);
+  }
+
+  CloseHandle(connect_event);
+#else
+  const int listener = static_cast<int>(listener_);
+  while (running_.load()) {
+    pollfd entry{};
+    entry.fd = listener;
+    entry.events = POLLIN;
+    const int ready = poll(&entry, 1, kAcceptPollMs);
+    if (ready > 0 && (entry.revents & POLLIN)) {
+      const int fd = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+      if (fd >= 0) {
+        AddClient(fd);
+      }
+    }
+    ReapClients(false);
+  }
+#endif
+}
+
+void SnapshotPublisher::AddClient(intptr_t native_handle) {
+  auto client = std::make_unique<Client>();
+  client->handle = native_handle;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (latest_) {
+    client->queue.push_back(latest_);
+  }
+  client->thread = std::thread(&SnapshotPublisher::ClientLoop, this, client.get());
+  clients_.push_back(std::move(client));
+}
+
+void SnapshotPublisher::ClientLoop(Client* client) {
+  while (true) {
+    Message message;
+    {
+      std::unique_lock<std::mutex> lock(client->mutex);
+      client->wake.wait(lock, [client] { return client->closing || !client->queue.empty(); });
+      if (client->closing) break;
+      message = std::move(client->queue.front());
+      client->queue.pop_front();
+    }
+    if (!WriteAll(client->handle, message->data(), message->size(), stop_event_)) {
+      break;
+    }
+  }
+  client->done.store(true);
+}
+
+void SnapshotPublisher::ReapClients(bool all) {
+  std::vector<std::unique_ptr<Client>> finished;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = clients_.begin(); it != clients_.end();) {
+      if (all || (*it)->done.load()) {
+        finished.push_back(std::move(*it));
+        it = clients_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  for (auto& client : finished) {
+    {
+      std::lock_guard<std::mutex> lock(client->mutex);
+      client->closing = true;
+    }
+    client->wake.notify_one();
+    InterruptNative(client->handle);
+    if (client->thread.joinable()) {
+      client->thread.join();
+    }
+    CloseNative(client->handle);
+  }
+}
+
+}  // namespace mccmod
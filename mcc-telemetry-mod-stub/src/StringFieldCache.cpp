@@ -0,0 +1,42 @@
+#include "StringFieldCache.h"
+
+#include "Hash64.h"
+
+namespace mccmod {
+
+bool StringFieldCache::Lookup(uintptr_t address, const void* raw, size_t size, bool* accepted, std::string* value) {
+  ++stats_.lookups;
+  pending_fingerprint_ = Hash64(raw, size, static_cast<uint64_t>(address));
+  verifying_ = false;
+  if (primed_ && pending_fingerprint_ == fingerprint_ && verify_every_ > 0) {
+    if (reuses_ < verify_every_) {
+      ++reuses_;
+      ++stats_.reused;
+      *accepted = accepted_;
+      value->assign(value_);
+      return true;
+    }
+    verifying_ = true;
+    ++stats_.verified;
+  }
+  ++stats_.decoded;
+  return false;
+}
+
+void StringFieldCache::Store(bool accepted, const std::string& value) {
+  if (verifying_ && (accepted != accepted_ || value != value_)) ++stats_.verify_changed;
+  verifying_ = false;
+  primed_ = true;
+  reuses_ = 0;
+  fingerprint_ = pending_fingerprint_;
+  accepted_ = accepted;
+  value_.assign(value);
+}
+
+void StringFieldCache::Reset() {
+  primed_ = false;
+  verifying_ = false;
+  reuses_ = 0;
+}
+
+}  // namespace mccmod
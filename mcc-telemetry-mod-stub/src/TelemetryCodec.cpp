@@ -0,0 +1,415 @@
+#include "TelemetryContract.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace mccmod {
+namespace {
+
+// ---- JSON -------------------------------------------------------------------
+
+// Just enough JSON for telemetry envelopes: objects, arrays, strings with
+// escapes, numbers, booleans and null. Values of unknown keys are skipped.
+class JsonCursor {
+ public:
+  explicit JsonCursor(const std::string& text) : text_(text) {}
+
+  bool AtEnd() {
+    SkipSpace();
+    return pos_ == text_.size();
+  }
+
+  bool Consume(char expected) {
+    SkipSpace();
+    if (pos_ < text_.size() && text_[pos_] == expected) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  bool Peek(char expected) {
+    SkipSpace();
+    return pos_ < text_.size() && text_[pos_] == expected;
+  }
+
+  bool ReadString(std::string* out) {
+    if (!Consume('"')) return false;
+    out->clear();
+    while (pos_ < text_.size()) {
+      const char c = text_[pos_++];
+      if (c == '"') return true;
+      if (static_cast<unsigned char>(c) < 0x20) return false;
+      if (c != '\\') {
+        out->push_back(c);
+        continue;
+      }
+      if (pos_ >= text_.size()) return false;
+      switch (text_[pos_++]) {
+        case '"':
+          out->push_back('"');
+          break;
+        case '\\':
+          out->push_back('\\');
+          break;
+        case '/':
+          out->push_back('/');
+          break;
+        case 'b':
+          out->push_back('\b');
+          break;
+        case 'f':
+          out->push_back('\f');
+          break;
+        case 'n':
+          out->push_back('\n');
+          break;
+        case 'r':
+          out->push_back('\r');
+          break;
+        case 't':
+          out->push_back('\t');
+          break;
+        case 'u':
+          if (!ReadUnicodeEscape(out)) return false;
+          break;
+        default:
+          return false;
+      }
+    }
+    return false;
+  }
+
+  bool ReadNumber(double* out) {
+    SkipSpace();
+    const char* start = text_.c_str() + pos_;
+    char* end = nullptr;
+    *out = std::strtod(start, &end);
+    if (end == start) return false;
+    pos_ += static_cast<size_t>(end - start);
+    return std::isfinite(*out);
+  }
+
+  bool ReadBool(bool* out) {
+    SkipSpace();
+    if (text_.compare(pos_, 4, "true") == 0) {
+      pos_ += 4;
+      *out = true;
+      return true;
+    }
+    if (text_.compare(pos_, 5, "false") == 0) {
+      pos_ += 5;
+      *out = false;
+      return true;
+    }
+    return false;
+  }
+
+  bool SkipValue(int depth = 0) {
+    if (depth > 32) return false;
+    SkipSpace();
+    if (pos_ >= text_.size()) return false;
+    const char c = text_[pos_];
+    if (c == '"') {
+      std::string ignored;
+      return ReadString(&ignored);
+    }
+    if (c == '{' || c == '[') {
+      const char close = c == '{' ? '}' : ']';
+      ++pos_;
+      if (Consume(close)) return true;
+      do {
+        if (c == '{') {
+          std::string ignored;
+          if (!ReadString(&ignored) || !Consume(':')) return false;
+        }
+        if (!SkipValue(depth + 1)) return false;
+      } while (Consume(','));
+      return Consume(close);
+    }
+    if (text_.compare(pos_, 4, "null") == 0) {
+      pos_ += 4;
+      return true;
+    }
+    bool ignored_bool = false;
+    if (ReadBool(&ignored_bool)) return true;
+    double ignored_number = 0.0;
+    return ReadNumber(&ignored_number);
+  }
+
+ private:
+  void SkipSpace() {
+    while (pos_ < text_.size() &&
+           (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+      ++pos_;
+    }
+  }
+
+  bool ReadHex4(uint32_t* out) {
+    if (pos_ + 4 > text_.size()) return false;
+    *out = 0;
+    for (int i = 0; i < 4; ++i) {
+      const char c = text_[pos_++];
+      *out <<= 4;
+      if (c >= '0' && c <= '9') {
+        *out |= static_cast<uint32_t>(c - '0');
+      } else if (c >= 'a' && c <= 'f') {
+        *out |= static_cast<uint32_t>(c - 'a' + 10);
+      } else if (c >= 'A' && c <= 'F') {
+        *out |= static_cast<uint32_t>(c - 'A' + 10);
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool ReadUnicodeEscape(std::string* out) {
+    uint32_t code = 0;
+    if (!ReadHex4(&code)) return false;
+    if (code >= 0xD800 && code <= 0xDBFF) {
+      uint32_t low = 0;
+      if (text_.compare(pos_, 2, "\\u") != 0) return false;
+      pos_ += 2;
+      if (!ReadHex4(&low) || low < 0xDC00 || low > 0xDFFF) return false;
+      code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+    }
+    if (code < 0x80) {
+      out->push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+      out->push_back(static_cast<char>(0xC0 | (code >> 6)));
+      out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+      out->push_back(static_cast<char>(0xE0 | (code >> 12)));
+      out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+      out->push_back(static_cast<char>(0xF0 | (code >> 18)));
+      out->push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+      out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      out->push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+    return true;
+  }
+
+  const std::string& text_;
+  size_t pos_ = 0;
+};
+
+bool ReadJsonField(JsonCursor& cursor, bool* out) {
+  return cursor.ReadBool(out);
+}
+
+bool ReadJsonField(JsonCursor& cursor, int* out) {
+  double value = 0.0;
+  if (!cursor.ReadNumber(&value) || value != std::floor(value) ||
+      value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+    return false;
+  }
+  *out = static_cast<int>(value);
+  return true;
+}
+
+bool ReadJsonField(JsonCursor& cursor, std::string* out) {
+  return cursor.ReadString(out);
+}
+
+bool ReadJsonField(JsonCursor& cursor, std::vector<std::string>* out) {
+  out->clear();
+  if (!cursor.Consume('[')) return false;
+  if (cursor.Consume(']')) return true;
+  do {
+    out->emplace_back();
+    if (!cursor.ReadString(&out->back())) return false;
+  } while (cursor.Consume(','));
+  return cursor.Consume(']');
+}
+
+bool ParseError(const std::string& message, std::string* error) {
+  if (error) *error = message;
+  return false;
+}
+
+// Reads one object. At the top level (`delivery` set) it also accepts the
+// envelope keys; a "data" object found there replaces any bare fields.
+bool ParseObject(JsonCursor& cursor, TelemetrySnapshot* snapshot, DeliveryId* delivery,
+                 bool top_level, std::string* error) {
+  if (!cursor.Consume('{')) return ParseError("Expected a JSON object.", error);
+  if (cursor.Consume('}')) return true;
+
+  std::string name;
+  do {
+    if (!cursor.ReadString(&name) || !cursor.Consume(':')) {
+      return ParseError("Malformed object key.", error);
+    }
+#define MCC_SCHEMA_PARSE(type, member, key, min, max, flags)      \
+  if (name == key) {                                              \
+    if (!ReadJsonField(cursor, &snapshot->member)) {              \
+      return ParseError(key " has the wrong type.", error);       \
+    }                                                             \
+    continue;                                                     \
+  }
+    MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_PARSE)
+#undef MCC_SCHEMA_PARSE
+
+    if (top_level && name == "data" && cursor.Peek('{')) {
+      *snapshot = TelemetrySnapshot{};
+      if (!ParseObject(cursor, snapshot, delivery, false, error)) return false;
+      continue;
+    }
+    if (top_level && name == "version") {
+      std::string version;
+      if (!cursor.ReadString(&version)) return ParseError("version has the wrong type.", error);
+      if (version != "1.0") return ParseError("Unsupported envelope version " + version + ".", error);
+      continue;
+    }
+    if (top_level && delivery && name == "producer") {
+      if (!cursor.ReadString(&delivery->producer)) return ParseError("producer has the wrong type.", error);
+      continue;
+    }
+    if (top_level && delivery && name == "seq") {
+      double seq = 0.0;
+      if (!cursor.ReadNumber(&seq) || seq < 0 || seq != std::floor(seq)) {
+        return ParseError("seq has the wrong type.", error);
+      }
+      delivery->seq = static_cast<uint64_t>(seq);
+      continue;
+    }
+    if (!cursor.SkipValue()) return ParseError("Malformed value for " + name + ".", error);
+  } while (cursor.Consume(','));
+
+  if (!cursor.Consume('}')) return ParseError("Expected '}'.", error);
+  return true;
+}
+
+// ---- Binary -----------------------------------------------------------------
+
+void PutVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void PutU32(uint32_t value, std::string* out) {
+  for (int i = 0; i < 4; ++i) {
+    out->push_back(static_cast<char>(value >> (i * 8)));
+  }
+}
+
+void PutField(bool value, std::string* out) {
+  out->push_back(value ? 1 : 0);
+}
+
+void PutField(int value, std::string* out) {
+  PutU32(static_cast<uint32_t>(value), out);
+}
+
+void PutField(const std::string& value, std::string* out) {
+  PutVarint(value.size(), out);
+  out->append(value);
+}
+
+void PutField(const std::vector<std::string>& value, std::string* out) {
+  PutVarint(value.size(), out);
+  for (const std::string& item : value) PutField(item, out);
+}
+
+class ByteReader {
+ public:
+  ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  size_t Position() const { return pos_; }
+
+  bool U32(uint32_t* out) {
+    if (size_ - pos_ < 4) return false;
+    *out = 0;
+    for (int i = 0; i < 4; ++i) {
+      *out |= static_cast<uint32_t>(data_[pos_ + i]) << (i * 8);
+    }
+    pos_ += 4;
+    return true;
+  }
+
+  bool Varint(uint64_t* out) {
+    *out = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (pos_ >= size_) return false;
+      const uint8_t byte = data_[pos_++];
+      *out |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+  }
+
+  bool Field(bool* out) {
+    if (pos_ >= size_ || data_[pos_] > 1) return false;
+    *out = data_[pos_++] != 0;
+    return true;
+  }
+
+  bool Field(int* out) {
+    uint32_t raw = 0;
+    if (!U32(&raw)) return false;
+    *out = static_cast<int>(raw);
+    return true;
+  }
+
+  bool Field(std::string* out) {
+    uint64_t length = 0;
+    if (!Varint(&length) || length > size_ - pos_) return false;
+    out->assign(reinterpret_cast<const char*>(data_ + pos_), static_cast<size_t>(length));
+    pos_ += static_cast<size_t>(length);
+    return true;
+  }
+
+  bool Field(std::vector<std::string>* out) {
+    uint64_t count = 0;
+    // Every item takes at least one byte, which bounds a hostile count.
+    if (!Varint(&count) || count > size_ - pos_) return false;
+    out->assign(static_cast<size_t>(count), std::string());
+    for (std::string& item : *out) {
+      if (!Field(&item)) return false;
+    }
+    return true;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t pos_ = 0;
+};
+
+}  // namespace
+
+bool ParseTelemetryEnvelopeJson(const std::string& json, TelemetrySnapshot* snapshot,
+                                DeliveryId* delivery, std::string* error) {
+  *snapshot = TelemetrySnapshot{};
+  JsonCursor cursor(json);
+  if (!ParseObject(cursor, snapshot, delivery, true, error)) return false;
+  if (!cursor.AtEnd()) return ParseError("Trailing data after the envelope.", error);
+  return true;
+}
+
+void EncodeTelemetrySnapshot(const TelemetrySnapshot& snapshot, std::string* out) {
+  PutU32(kTelemetrySchemaFingerprint, out);
+#define MCC_SCHEMA_ENCODE(type, member, key, min, max, flags) PutField(snapshot.member, out);
+  MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_ENCODE)
+#undef MCC_SCHEMA_ENCODE
+}
+
+size_t DecodeTelemetrySnapshot(const void* data, size_t size, TelemetrySnapshot* snapshot) {
+  ByteReader reader(static_cast<const uint8_t*>(data), size);
+  uint32_t fingerprint = 0;
+  if (!reader.U32(&fingerprint) || fingerprint != kTelemetrySchemaFingerprint) return 0;
+#define MCC_SCHEMA_DECODE(type, member, key, min, max, flags) \
+  if (!reader.Field(&snapshot->member)) return 0;
+  MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_DECODE)
+#undef MCC_SCHEMA_DECODE
+  return reader.Position();
+}
+
+}  // namespace mccmod
@@ -1,52 +1,152 @@
 #include "TelemetryContract.h"
 
-#include <chrono>
+#include "Clock.h"
+
+#include <charconv>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
+#include <system_error>
+#include <unordered_set>
 
 namespace mccmod {
 namespace {
 
+// Validation messages are spelled out at compile time from the schema.
+#define MCC_SCHEMA_BOUNDS_MESSAGE_Bool(key, min, max) ""
+#define MCC_SCHEMA_BOUNDS_MESSAGE_Int(key, min, max) key " out of range (" #min "-" #max ")."
+#define MCC_SCHEMA_BOUNDS_MESSAGE_String(key, min, max) key " longer than " #max " bytes."
+#define MCC_SCHEMA_BOUNDS_MESSAGE_StringList(key, min, max) key " has more than " #max " items."
+
+static_assert(kTelemetryItemMaxBytes == 128 && kTelemetryListMaxBytes == 512,
+              "Update the list messages below.");
+
+struct FieldMessages {
+  const char* bounds;
+  const char* required;
+  const char* item;
+  const char* total;
+  const char* duplicate;
+};
+
+bool Fail(const char* message, std::string* error) {
+  if (error) *error = message;
+  return false;
+}
+
+bool CheckField(bool, int64_t, int64_t, uint32_t, bool, const FieldMessages&, std::string*) {
+  return true;
+}
+
+bool CheckField(int value, int64_t min, int64_t max, uint32_t, bool, const FieldMessages& messages,
+                std::string* error) {
+  if (value < min || value > max) return Fail(messages.bounds, error);
+  return true;
+}
+
+bool CheckField(const std::string& value, int64_t, int64_t max, uint32_t flags, bool custom_game,
+                const FieldMessages& messages, std::string* error) {
+  if (value.size() > static_cast<size_t>(max)) return Fail(messages.bounds, error);
+  if ((flags & kFieldRequiredInCustomGame) && custom_game && value.empty()) {
+    return Fail(messages.required, error);
+  }
+  return true;
+}
+
+bool CheckField(const std::vector<std::string>& value, int64_t, int64_t max, uint32_t flags, bool,
+                const FieldMessages& messages, std::string* error) {
+  if (value.size() > static_cast<size_t>(max)) return Fail(messages.bounds, error);
+  size_t total = 0;
+  for (const std::string& item : value) {
+    if (item.size() > kTelemetryItemMaxBytes) return Fail(messages.item, error);
+    total += item.size();
+  }
+  if (total > kTelemetryListMaxBytes) return Fail(messages.total, error);
+  if ((flags & kFieldUniqueItems) && value.size() > 1) {
+    std::unordered_set<std::string> seen;
+    for (const std::string& item : value) {
+      if (!seen.insert(item).second) return Fail(messages.duplicate, error);
+    }
+  }
+  return true;
+}
+
+void AppendJsonValue(bool value, std::string* out) {
+  out->append(value ? "true" : "false");
+}
+
+void AppendJsonValue(int value, std::string* out) {
+  char buffer[16];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out->append(buffer, result.ptr);
+}
+
+void AppendJsonValue(const std::string& value, std::string* out) {
+  out->push_back('"');
+  AppendEscapedJson(value, out);
+  out->push_back('"');
+}
+
+void AppendJsonValue(const std::vector<std::string>& value, std::string* out) {
+  out->push_back('[');
+  for (size_t i = 0; i < value.size(); ++i) {
+    if (i > 0) out->push_back(',');
+    AppendJsonValue(value[i], out);
+  }
+  out->push_back(']');
+}
+
+}  // namespace
+
 std::string EscapeJson(const std::string& input) {
-  std::ostringstream out;
-  for (char c : input) {
+  std::string out;
+  AppendEscapedJson(input, &out);
+  return out;
+}
+
+void AppendEscapedJson(const std::string& input, std::string* out) {
+  static const char kHex[] = "0123456789abcdef";
+  size_t clean_from = 0;
+  for (size_t i = 0; i < input.size(); ++i) {
+    const unsigned char c = static_cast<unsigned char>(input[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') continue;
+    // Copy the run that needed no escaping in one go.
+    out->append(input, clean_from, i - clean_from);
+    clean_from = i + 1;
     switch (c) {
       case '"':
-        out << "\\\"";
+        out->append("\\\"");
         break;
       case '\\':
-        out << "\\\\";
+        out->append("\\\\");
         break;
       case '\b':
-        out << "\\b";
+        out->append("\\b");
         break;
       case '\f':
-        out << "\\f";
+        out->append("\\f");
         break;
       case '\n':
-        out << "\\n";
+        out->append("\\n");
         break;
       case '\r':
-        out << "\\r";
+        out->append("\\r");
         break;
       case '\t':
-        out << "\\t";
+        out->append("\\t");
         break;
       default:
-        out << c;
+        out->append("\\u00");
+        out->push_back(kHex[c >> 4]);
+        out->push_back(kHex[c & 0xF]);
         break;
     }
   }
-  return out.str();
+  out->append(input, clean_from, std::string::npos);
 }
 
-}  // namespace
-
 std::string GetIsoUtcNow() {
-  using clock = std::chrono::system_clock;
-  const auto now = clock::now();
-  const std::time_t raw_time = clock::to_time_t(now);
+  const std::time_t raw_time = static_cast<std::time_t>(DefaultClock().WallMs() / 1000);
 
   std::tm utc{};
 #if defined(_WIN32)
@@ -61,57 +161,127 @@ std::string GetIsoUtcNow() {
 }
 
 bool ValidateSnapshot(const TelemetrySnapshot& snapshot, std::string* error) {
-  if (snapshot.player_count < 0 || snapshot.player_count > 32) {
-    if (error) *error = "playerCount out of range (0-32).";
-    return false;
-  }
-  if (snapshot.max_players < 0 || snapshot.max_players > 32) {
-    if (error) *error = "maxPlayers out of range (0-32).";
-    return false;
+#define MCC_SCHEMA_CHECK(type, member, key, min, max, flags)                                   \
+  if (!CheckField(snapshot.member, min, max, flags, snapshot.is_custom_game,                   \
+                  FieldMessages{MCC_SCHEMA_BOUNDS_MESSAGE_##type(key, min, max),               \
+                                "Missing " key " while in custom game.",                      \
+                                key " item longer than 128 bytes.",                            \
+                                key " longer than 512 bytes in total.",                        \
+                                key " contains duplicate items."},                             \
+                  error)) {                                                                     \
+    return false;                                                                               \
   }
+  MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_CHECK)
+#undef MCC_SCHEMA_CHECK
+
+  // The one rule that spans fields.
   if (snapshot.max_players > 0 && snapshot.player_count > snapshot.max_players) {
     if (error) *error = "playerCount exceeds maxPlayers.";
     return false;
   }
-  if (snapshot.is_custom_game) {
-    if (snapshot.map_name.empty()) {
-      if (error) *error = "Missing mapName while in custom game.";
-      return false;
-    }
-    if (snapshot.game_mode.empty()) {
-      if (error) *error = "Missing gameMode while in custom game.";
-      return false;
-    }
-  }
   return true;
 }
 
-std::string BuildTelemetryEnvelopeJson(const TelemetrySnapshot& snapshot) {
-  std::ostringstream mods;
-  mods << "[";
-  for (size_t i = 0; i < snapshot.mods.size(); ++i) {
-    if (i > 0) mods << ",";
-    mods << '"' << EscapeJson(snapshot.mods[i]) << '"';
+void AppendTelemetryFieldsJson(const TelemetrySnapshot& snapshot, std::string* out) {
+  // Straight-line: one pre-escaped key literal and one typed append per field.
+  // Every value is followed by a comma and the last one is dropped.
+  const size_t start = out->size();
+#define MCC_SCHEMA_APPEND_JSON(type, member, key, min, max, flags) \
+  out->append("\"" key "\":");                                     \
+  AppendJsonValue(snapshot.member, out);                           \
+  out->push_back(',');
+  MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_APPEND_JSON)
+#undef MCC_SCHEMA_APPEND_JSON
+  if (out->size() > start) out->pop_back();
+}
+
+std::string BuildTelemetryEnvelopeJson(const TelemetrySnapshot& snapshot,
+                                       const DeliveryId* delivery) {
+  std::string out;
+  out.reserve(256 + snapshot.map_name.size() + snapshot.game_mode.size() + snapshot.host_name.size());
+  out.append("{\"version\":\"1.0\",");
+  if (delivery) {
+    out.append("\"producer\":\"");
+    AppendEscapedJson(delivery->producer, &out);
+    out.append("\",\"seq\":");
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), delivery->seq);
+    out.append(buffer, result.ptr);
+    out.push_back(',');
   }
-  mods << "]";
+  out.append("\"data\":{");
+  AppendTelemetryFieldsJson(snapshot, &out);
+  out.append("}}");
+  return out;
+}
 
-  std::ostringstream out;
-  out << "{";
-  out << "\"version\":\"1.0\",";
-  out << "\"data\":{";
-  out << "\"isCustomGame\":" << (snapshot.is_custom_game ? "true" : "false") << ",";
-  out << "\"mapName\":\"" << EscapeJson(snapshot.map_name) << "\",";
-  out << "\"gameMode\":\"" << EscapeJson(snapshot.game_mode) << "\",";
-  out << "\"playerCount\":" << snapshot.player_count << ",";
-  out << "\"maxPlayers\":" << snapshot.max_players << ",";
-  out << "\"hostName\":\"" << EscapeJson(snapshot.host_name) << "\",";
-  out << "\"mods\":" << mods.str() << ",";
-  out << "\"timestamp\":\"" << EscapeJson(snapshot.timestamp_utc) << "\",";
-  out << "\"sessionID\":\"" << EscapeJson(snapshot.session_id) << "\"";
-  out << "}";
-  out << "}";
+void AppendEnvelopeTrace(const DeliveryTrace& trace, std::string* envelope) {
+  if (envelope->empty() || envelope->back() != '}') return;
+  envelope->pop_back();
+  envelope->append(",\"trace\":{");
+  bool first = true;
+  const auto field = [&](const char* key, auto value) {
+    if (value == 0) return;
+    if (!first) envelope->push_back(',');
+    first = false;
+    envelope->push_back('"');
+    envelope->append(key);
+    envelope->append("\":");
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    envelope->append(buffer, result.ptr);
+  };
+  field("captureUs", trace.capture_us);
+  field("serializedUs", trace.serialized_us);
+  field("sentUs", trace.sent_us);
+  field("sentWallUs", trace.sent_wall_us);
+  envelope->append("}}");
+}
 
-  return out.str();
+bool StampEnvelopeSent(uint64_t sent_us, int64_t sent_wall_us, std::string* envelope) {
+  // The trace is the last member, so its closing brace is the second to last byte.
+  const size_t trace = envelope->rfind(",\"trace\":{");
+  if (trace == std::string::npos || envelope->size() < 2 || envelope->compare(envelope->size() - 2, 2, "}}") != 0 ||
+      envelope->find('}', trace) != envelope->size() - 2) {
+    return false;
+  }
+  std::string stamps;
+  stamps.reserve(64);
+  if ((*envelope)[envelope->size() - 3] != '{') stamps.push_back(',');
+  stamps.append("\"sentUs\":");
+  stamps.append(std::to_string(sent_us));
+  stamps.append(",\"sentWallUs\":");
+  stamps.append(std::to_string(sent_wall_us));
+  envelope->insert(envelope->size() - 2, stamps);
+  return true;
+}
+
+bool ParseEnvelopeTrace(const std::string& envelope, DeliveryTrace* trace) {
+  const size_t at = envelope.rfind(",\"trace\":{");
+  if (at == std::string::npos) return false;
+  *trace = DeliveryTrace{};
+  const std::string_view tail = std::string_view(envelope).substr(at);
+  const auto field = [&tail](std::string_view key, auto* value) {
+    const size_t key_at = tail.find(key);
+    if (key_at == std::string_view::npos) return;
+    const char* begin = tail.data() + key_at + key.size();
+    std::from_chars(begin, tail.data() + tail.size(), *value);
+  };
+  field("\"captureUs\":", &trace->capture_us);
+  field("\"serializedUs\":", &trace->serialized_us);
+  field("\"sentUs\":", &trace->sent_us);
+  field("\"sentWallUs\":", &trace->sent_wall_us);
+  return true;
+}
+
+bool ParseReceivedWallUs(const std::string& ack_json, int64_t* received_wall_us) {
+  static constexpr char kKey[] = "\"receivedWallUs\":";
+  const size_t at = ack_json.find(kKey);
+  if (at == std::string::npos) return false;
+  const char* begin = ack_json.data() + at + sizeof(kKey) - 1;
+  while (*begin == ' ') ++begin;
+  const auto result = std::from_chars(begin, ack_json.data() + ack_json.size(), *received_wall_us);
+  return result.ec == std::errc() && *received_wall_us > 0;
 }
 
 }  // namespace mccmod
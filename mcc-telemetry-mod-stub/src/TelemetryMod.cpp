@@ -1,23 +1,23 @@
 #include "TelemetryMod.h"
 
-#include "HttpClientWinHttp.h"
+#include "ModScanner.h"
 #include "OfficialApiAdapter.h"
 #include "Settings.h"
 #include "TelemetryContract.h"
+#include "TelemetryOutbox.h"
+#include "TickScheduler.h"
 
-#include <Windows.h>
-
-#include <chrono>
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <thread>
 
 namespace mccmod {
 namespace {
 
-void LogLine(const std::string& line, bool always = false, bool debug_mode = false) {
-  if (!always && !debug_mode) return;
-  OutputDebugStringA(("[MccTelemetryMod] " + line + "\n").c_str());
-}
+// Warm rescans only stat files, so this mostly bounds how late a newly
+// installed mod shows up.
+constexpr uint64_t kModRescanIntervalMs = 60 * 1000;
 
 TelemetrySnapshot BuildInactiveSnapshot(const std::string& session_id) {
   TelemetrySnapshot snapshot;
@@ -27,21 +27,81 @@ TelemetrySnapshot BuildInactiveSnapshot(const std::string& session_id) {
   return snapshot;
 }
 
+// Registered once; the worker only touches the references.
+struct ModMetrics {
+  MetricCounter& ticks;
+  MetricCounter& gated_disabled;
+  MetricCounter& gated_api_unavailable;
+  MetricCounter& gated_offline_only;
+  MetricCounter& gated_anti_cheat;
+  MetricCounter& delivered;
+  MetricCounter& spooled;
+  MetricCounter& validation_rejections;
+};
+
+ModMetrics& Metrics() {
+  MetricsRegistry& registry = DefaultMetrics();
+  const char* gated_help = "Worker ticks that emitted nothing, by the gate that stopped them.";
+  const char* snapshots_help = "Validated snapshots handed to the outbox, by outcome.";
+  static ModMetrics metrics{
+      registry.Counter("mcc_mod_ticks_total", "Worker loop iterations."),
+      registry.Counter("mcc_mod_ticks_gated_total", gated_help, "gate=\"disabled\""),
+      registry.Counter("mcc_mod_ticks_gated_total", gated_help, "gate=\"api_unavailable\""),
+      registry.Counter("mcc_mod_ticks_gated_total", gated_help, "gate=\"offline_only\""),
+      registry.Counter("mcc_mod_ticks_gated_total", gated_help, "gate=\"anti_cheat\""),
+      registry.Counter("mcc_mod_snapshots_total", snapshots_help, "result=\"delivered\""),
+      registry.Counter("mcc_mod_snapshots_total", snapshots_help, "result=\"spooled\""),
+      registry.Counter("mcc_mod_validation_rejections_total", "Snapshots dropped by ValidateSnapshot()."),
+  };
+  return metrics;
+}
+
 }  // namespace
 
 void TelemetryMod::Initialize() {
   if (initialized_) return;
   initialized_ = true;
   running_.store(true);
+  stopping_.store(false);
+  emit_allowed_.store(false);
+  LoggerOptions log_options;
+  log_options.tag = "MccTelemetryMod";
+  logger_ = std::make_unique<Logger>(log_options, clock_);
+  logger_->AddSink(MakeDebugOutputSink());
+  logger_->AddSink(std::make_unique<RotatingFileSink>(GetDefaultLogPath()));
+  logger_->Start();
+  const int metrics_port = LoadSettings().metrics_port;
+  if (metrics_port > 0) {
+    metrics_server_ = std::make_unique<MetricsServer>();
+    if (!metrics_server_->Start(static_cast<uint16_t>(metrics_port))) {
+      logger_->Log(LogId::kMetricsUnavailable, {metrics_port});
+      metrics_server_.reset();
+    }
+  }
+  // Both loops sleep on clock_; registered before either starts so a virtual
+  // clock cannot move on while the other is still running its first pass.
+  clock_.AddParticipant();
+  clock_.AddParticipant();
   worker_ = std::thread(&TelemetryMod::WorkerLoop, this);
+  mod_scanner_ = std::thread(&TelemetryMod::ModScanLoop, this);
 }
 
 void TelemetryMod::Shutdown() {
   if (!initialized_) return;
   running_.store(false);
+  stopping_.store(true);
   if (worker_.joinable()) {
     worker_.join();
   }
+  if (mod_scanner_.joinable()) {
+    mod_scanner_.join();
+  }
+  if (metrics_server_) {
+    metrics_server_->Stop();
+    metrics_server_.reset();
+  }
+  logger_->Stop();
+  logger_.reset();
   initialized_ = false;
 }
 
@@ -50,73 +110,147 @@ void TelemetryMod::WorkerLoop() {
   bool had_active_snapshot = false;
   bool api_unavailable_logged = false;
   std::string last_session_id;
+  std::unique_ptr<TelemetryOutbox> outbox;
+  CircuitState last_circuit = CircuitState::kClosed;
+  // Absolute deadlines keep the update cadence steady however long a read or
+  // delivery takes; a stalled iteration skips the deadlines it overran.
+  TickScheduler scheduler(TickSchedulerOptions{}, clock_);
+  const auto wait_next_tick = [&scheduler](uint64_t period_ms) {
+    scheduler.SetPeriodUs(period_ms * 1000);
+    scheduler.WaitNextTick();
+  };
 
+  ModMetrics& metrics = Metrics();
+  logger_->Log(LogId::kWorkerStarted);
   while (running_.load()) {
+    metrics.ticks.Add();
     const ModSettings settings = LoadSettings();
+    logger_->SetMinLevel(settings.debug_mode ? LogLevel::kDebug : LogLevel::kInfo);
+    if (!outbox || outbox->Endpoint() != settings.endpoint) {
+      outbox = std::make_unique<TelemetryOutbox>(settings.endpoint, GetDefaultSpoolPath(), clock_);
+    }
+    // Log circuit transitions only; an open circuit stays quiet while it spools.
+    const TelemetryOutboxStats delivery = outbox->GetStats();
+    if (delivery.circuit != last_circuit) {
+      logger_->Log(LogId::kCircuitChanged, {CircuitStateName(delivery.circuit), delivery.spool_pending});
+      last_circuit = delivery.circuit;
+    }
 
     if (!settings.enabled) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+      metrics.gated_disabled.Add();
+      emit_allowed_.store(false);
+      wait_next_tick(1000);
       continue;
     }
 
     if (!adapter.IsApiAvailable()) {
+      metrics.gated_api_unavailable.Add();
+      emit_allowed_.store(false);
       if (!api_unavailable_logged) {
-        LogLine("Official API unavailable. Adapter not wired yet.", true, settings.debug_mode);
+        logger_->Log(LogId::kApiUnavailable);
         api_unavailable_logged = true;
       }
-      std::this_thread::sleep_for(std::chrono::milliseconds(settings.update_interval_ms));
+      wait_next_tick(static_cast<uint64_t>(settings.update_interval_ms));
       continue;
     }
     api_unavailable_logged = false;
 
     bool can_emit = true;
     if (settings.offline_only && !adapter.IsOfflineCustomContext()) {
+      metrics.gated_offline_only.Add();
       can_emit = false;
-    }
-
-    if (!settings.allow_when_anti_cheat_active && adapter.IsAntiCheatActive()) {
+    } else if (!settings.allow_when_anti_cheat_active && adapter.IsAntiCheatActive()) {
+      metrics.gated_anti_cheat.Add();
       can_emit = false;
     }
+    emit_allowed_.store(can_emit);
 
     if (!can_emit) {
       if (had_active_snapshot) {
         TelemetrySnapshot inactive = BuildInactiveSnapshot(last_session_id);
-        const HttpResponse response =
-            HttpPostJson(settings.endpoint, BuildTelemetryEnvelopeJson(inactive));
-        LogLine(response.ok ? "Sent inactive snapshot due to safety gate."
-                            : "Failed to send inactive snapshot due to safety gate.",
-                true, settings.debug_mode);
+        logger_->Log(outbox->Deliver(inactive) ? LogId::kInactiveSent : LogId::kInactiveSpooled);
         had_active_snapshot = false;
+      } else {
+        outbox->Flush();
       }
-      std::this_thread::sleep_for(std::chrono::milliseconds(settings.update_interval_ms));
+      wait_next_tick(static_cast<uint64_t>(settings.update_interval_ms));
       continue;
     }
 
     TelemetrySnapshot snapshot;
     if (adapter.TryReadSnapshot(&snapshot)) {
+      const uint64_t captured_us = clock_.SteadyUs();
       snapshot.timestamp_utc = GetIsoUtcNow();
+      if (settings.scan_mods) ApplyLatestModScan(&snapshot);
       std::string validation_error;
       if (ValidateSnapshot(snapshot, &validation_error)) {
-        const HttpResponse response =
-            HttpPostJson(settings.endpoint, BuildTelemetryEnvelopeJson(snapshot));
-        if (!response.ok) {
-          LogLine("Failed to post telemetry snapshot.", true, settings.debug_mode);
+        // A spooled snapshot still counts: replay delivers it, or the newer state it was compacted into.
+        if (outbox->Deliver(snapshot, captured_us)) {
+          metrics.delivered.Add();
         } else {
-          had_active_snapshot = snapshot.is_custom_game;
-          last_session_id = snapshot.session_id;
+          metrics.spooled.Add();
+          logger_->Log(LogId::kSnapshotSpooled);
         }
+        had_active_snapshot = snapshot.is_custom_game;
+        last_session_id = snapshot.session_id;
       } else {
-        LogLine("Snapshot validation failed: " + validation_error, true, settings.debug_mode);
+        metrics.validation_rejections.Add();
+        logger_->Log(LogId::kValidationFailed, {validation_error});
       }
     }
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(settings.update_interval_ms));
+    wait_next_tick(static_cast<uint64_t>(settings.update_interval_ms));
   }
 
   const ModSettings settings = LoadSettings();
-  if (settings.enabled && !last_session_id.empty()) {
-    TelemetrySnapshot inactive = BuildInactiveSnapshot(last_session_id);
-    HttpPostJson(settings.endpoint, BuildTelemetryEnvelopeJson(inactive));
+  if (outbox && settings.enabled && !last_session_id.empty()) {
+    // Spooled if the receiver is down, so the next run closes the session out.
+    outbox->Deliver(BuildInactiveSnapshot(last_session_id));
+  }
+  logger_->Log(LogId::kWorkerStopped);
+  clock_.RemoveParticipant();
+}
+
+void TelemetryMod::ModScanLoop() {
+  // A game is running alongside; leave it most of the cores.
+  ModScanner scanner(std::max(1u, std::thread::hardware_concurrency() / 4));
+  const std::string cache_path = GetDefaultModCachePath();
+  scanner.LoadCache(cache_path);
+
+  while (running_.load()) {
+    const ModSettings settings = LoadSettings();
+    // Scan only while the worker may emit: with a gate closed (offline-only
+    // outside an offline custom, anti-cheat active) nothing would use the
+    // result, and walking the mod folders is I/O the game should not share.
+    if (!settings.enabled || !settings.scan_mods || !emit_allowed_.load()) {
+      clock_.SleepFor(1000);
+      continue;
+    }
+    ModScanResult result = scanner.Scan(DefaultModRoots(), &stopping_);
+    if (!result.cancelled) {
+      logger_->Log(LogId::kModScanDone, {result.mods.size(), result.stats.bytes_hashed,
+                                         result.stats.walk_ms + result.stats.hash_ms});
+      scanner.SaveCache(cache_path);
+      std::lock_guard<std::mutex> lock(mods_mutex_);
+      mod_scan_ = std::move(result);
+      have_mod_scan_ = true;
+    }
+    // Short sleeps so Shutdown() is not held up by the rescan interval.
+    for (uint64_t slept = 0; slept < kModRescanIntervalMs && running_.load(); slept += 1000) {
+      clock_.SleepFor(1000);
+    }
+  }
+  clock_.RemoveParticipant();
+}
+
+void TelemetryMod::ApplyLatestModScan(TelemetrySnapshot* snapshot) {
+  std::lock_guard<std::mutex> lock(mods_mutex_);
+  if (!have_mod_scan_) return;
+  if (snapshot->mods.empty()) {
+    ApplyModScan(mod_scan_, snapshot);
+  } else {
+    // The adapter knows what the lobby loaded; the fingerprint still pins down the installed content.
+    snapshot->mods_fingerprint = FormatModFingerprint(mod_scan_.fingerprint);
   }
 }
 
@@ -0,0 +1,209 @@
+#include "TelemetryOutbox.h"
+
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace mccmod {
+namespace {
+
+// Random per outbox, so sequence numbers restarting with the process never
+// collide with ones the receiver has already seen.
+std::string MakeProducerId(Clock& clock) {
+  std::random_device device;
+  const uint64_t bits = (static_cast<uint64_t>(device()) << 32) ^ device() ^
+                        static_cast<uint64_t>(clock.WallMs());
+  char buffer[17] = {};
+  std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(bits));
+  return buffer;
+}
+
+std::string StateKey(const TelemetrySnapshot& snapshot) {
+  if (!snapshot.is_custom_game) return "idle";
+  return "custom|" + snapshot.map_name + "|" + snapshot.game_mode;
+}
+
+constexpr const char* kDeliveryHopNames[kDeliveryHopCount] = {
+    "capture_to_serialize", "serialize_to_send", "send_to_receipt",
+    "send_to_ack",          "capture_to_receipt", "capture_to_ack",
+};
+
+LatencyHistogram* DeliveryLatency() {
+  static LatencyHistogram hops[kDeliveryHopCount];
+  return hops;
+}
+
+void RecordHop(DeliveryHop hop, uint64_t from_us, uint64_t to_us) {
+  DeliveryLatency()[static_cast<size_t>(hop)].Record(to_us > from_us ? to_us - from_us : 0);
+}
+
+struct OutboxMetrics {
+  MetricCounter& posted_ok;
+  MetricCounter& posted_failed;
+  MetricCounter& posted_refused;
+  MetricHistogram& post_duration_ms;
+  MetricCounter& spooled;
+};
+
+OutboxMetrics& Metrics() {
+  static OutboxMetrics metrics{
+      DefaultMetrics().Counter("mcc_telemetry_posts_total", "Telemetry POSTs by outcome.", "result=\"ok\""),
+      DefaultMetrics().Counter("mcc_telemetry_posts_total", "Telemetry POSTs by outcome.", "result=\"failed\""),
+      DefaultMetrics().Counter("mcc_telemetry_posts_total", "Telemetry POSTs by outcome.", "result=\"refused\""),
+      DefaultMetrics().Histogram("mcc_telemetry_post_duration_ms", "Telemetry POST round trip in milliseconds.",
+                                 {5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000}),
+      DefaultMetrics().Counter("mcc_telemetry_spooled_total", "Snapshots written to the offline spool."),
+  };
+  static const int collector = DefaultMetrics().AddCollector([] {
+    const std::array<LatencySummary, kDeliveryHopCount> latency = GetDeliveryLatency();
+    for (size_t i = 0; i < kDeliveryHopCount; ++i) {
+      const std::string labels = std::string("hop=\"") + kDeliveryHopNames[i] + "\"";
+      DefaultMetrics()
+          .Gauge("mcc_telemetry_hop_latency_p50_us", "Median per-hop delivery latency in microseconds.", labels)
+          .Set(static_cast<int64_t>(latency[i].p50));
+      DefaultMetrics()
+          .Gauge("mcc_telemetry_hop_latency_p99_us", "99th percentile per-hop delivery latency in microseconds.",
+                 labels)
+          .Set(static_cast<int64_t>(latency[i].p99));
+    }
+  });
+  (void)collector;
+  return metrics;
+}
+
+}  // namespace
+
+const char* DeliveryHopName(DeliveryHop hop) {
+  const size_t index = static_cast<size_t>(hop);
+  return index < kDeliveryHopCount ? kDeliveryHopNames[index] : "unknown";
+}
+
+std::array<LatencySummary, kDeliveryHopCount> GetDeliveryLatency() {
+  std::array<LatencySummary, kDeliveryHopCount> summaries;
+  for (size_t i = 0; i < kDeliveryHopCount; ++i) summaries[i] = DeliveryLatency()[i].Summary();
+  return summaries;
+}
+
+TelemetryOutbox::TelemetryOutbox(const std::string& endpoint, const std::string& spool_path,
+                                 Clock& clock, const CircuitBreakerOptions& breaker,
+                                 uint64_t spool_max_bytes)
+    : endpoint_(endpoint),
+      clock_(clock),
+      connection_(endpoint),
+      breaker_(breaker),
+      spool_(spool_path, spool_max_bytes),
+      producer_(MakeProducerId(clock)) {
+  spool_.Open();
+}
+
+bool TelemetryOutbox::Deliver(const TelemetrySnapshot& snapshot, uint64_t captured_us) {
+  const DeliveryId id{producer_, next_seq_++};
+  DeliveryTrace trace;
+  trace.capture_us = captured_us != 0 ? captured_us : clock_.SteadyUs();
+  SpoolRecord record{0, snapshot.session_id, StateKey(snapshot), BuildTelemetryEnvelopeJson(snapshot, &id)};
+  trace.serialized_us = clock_.SteadyUs();
+  // Capture and serialization stamps are spooled with the envelope, so a
+  // replay still reports how stale it was when it finally went out.
+  AppendEnvelopeTrace(trace, &record.json);
+
+  if (spool_.Pending() > 0) {
+    // Keep delivery order: the new record waits behind the older ones.
+    Spool(std::move(record));
+    return Flush();
+  }
+  if (breaker_.Allow(clock_.SteadyMs()) && Post(record.json)) {
+    return true;
+  }
+  Spool(std::move(record));
+  return false;
+}
+
+bool TelemetryOutbox::Flush() {
+  if (spool_.Pending() == 0) return true;
+
+  const std::vector<SpoolRecord> replay = spool_.Compacted();
+  uint64_t skipped = spool_.Pending() - replay.size();
+  for (const SpoolRecord& record : replay) {
+    if (!breaker_.Allow(clock_.SteadyMs()) || !Post(record.json)) {
+      return false;
+    }
+    // Acking by sequence also retires the compacted-away records before this one.
+    spool_.Ack(record.seq);
+    ++stats_.replayed;
+    stats_.compacted += skipped;
+    skipped = 0;
+  }
+  return spool_.Pending() == 0;
+}
+
+TelemetryOutboxStats TelemetryOutbox::GetStats() const {
+  TelemetryOutboxStats stats = stats_;
+  stats.compacted += spool_.CompactedAway();
+  stats.dropped = spool_.Dropped();
+  stats.spool_pending = spool_.Pending();
+  stats.circuit_opens = breaker_.Opens();
+  stats.circuit = breaker_.State();
+  return stats;
+}
+
+bool TelemetryOutbox::Post(const std::string& json) {
+  OutboxMetrics& metrics = Metrics();
+  DeliveryTrace trace;
+  const bool traced = ParseEnvelopeTrace(json, &trace);
+  std::string stamped;
+  trace.sent_us = clock_.SteadyUs();
+  if (traced) {
+    trace.sent_wall_us = clock_.WallUs();
+    stamped = json;
+    StampEnvelopeSent(trace.sent_us, trace.sent_wall_us, &stamped);
+  }
+  const HttpResponse response = connection_.PostJson(traced ? stamped : json);
+  const uint64_t acked_us = clock_.SteadyUs();
+  metrics.post_duration_ms.Observe((acked_us - trace.sent_us) / 1000);
+  if (response.ok) {
+    breaker_.RecordSuccess();
+    ++stats_.posted;
+    metrics.posted_ok.Add();
+    if (traced) RecordTrace(trace, acked_us, response.body);
+    return true;
+  }
+  const unsigned long status = response.status_code;
+  if (status >= 400 && status < 500 && status != 408 && status != 429) {
+    breaker_.RecordSuccess();
+    ++stats_.refused;
+    metrics.posted_refused.Add();
+    return true;
+  }
+  breaker_.RecordFailure(clock_.SteadyMs());
+  ++stats_.failed;
+  metrics.posted_failed.Add();
+  return false;
+}
+
+void TelemetryOutbox::RecordTrace(const DeliveryTrace& trace, uint64_t acked_us, const std::string& ack) {
+  RecordHop(DeliveryHop::kCaptureToSerialize, trace.capture_us, trace.serialized_us);
+  RecordHop(DeliveryHop::kSerializeToSend, trace.serialized_us, trace.sent_us);
+  RecordHop(DeliveryHop::kSendToAck, trace.sent_us, acked_us);
+  RecordHop(DeliveryHop::kCaptureToAck, trace.capture_us, acked_us);
+  int64_t received_wall_us = 0;
+  if (ParseReceivedWallUs(ack, &received_wall_us)) {
+    // The receiver's wall clock, moved onto this process's steady timeline.
+    const int64_t send_to_receipt = std::max<int64_t>(0, received_wall_us - trace.sent_wall_us);
+    const uint64_t received_us = trace.sent_us + static_cast<uint64_t>(send_to_receipt);
+    RecordHop(DeliveryHop::kSendToReceipt, trace.sent_us, received_us);
+    RecordHop(DeliveryHop::kCaptureToReceipt, trace.capture_us, received_us);
+  }
+}
+
+void TelemetryOutbox::Spool(SpoolRecord record) {
+  if (spool_.Append(&record)) {
+    ++stats_.spooled;
+    Metrics().spooled.Add();
+  }
+}
+
+}  // namespace mccmod
@@ -0,0 +1,128 @@
+#include "TelemetrySender.h"
+
+#include "Clock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace mccmod {
+namespace {
+
+// How often a spool left behind by a dead receiver is retried when no new
+// snapshots arrive to drive it. The circuit still decides whether to connect.
+constexpr auto kSpoolRetryInterval = std::chrono::seconds(1);
+
+}  // namespace
+
+TelemetrySender::~TelemetrySender() {
+  Stop();
+}
+
+bool TelemetrySender::Start(const std::string& endpoint, const std::string& spool_path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_) return true;
+  if (endpoint.empty()) return false;
+  outbox_ = std::make_unique<TelemetryOutbox>(endpoint, spool_path);
+  stats_.delivery = outbox_->GetStats();
+  running_ = true;
+  worker_ = std::thread(&TelemetrySender::WorkerLoop, this);
+  return true;
+}
+
+void TelemetrySender::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return;
+    running_ = false;
+  }
+  wake_.notify_one();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+bool TelemetrySender::Submit(const TelemetrySnapshot& snapshot, uint64_t captured_us,
+                             std::string* validation_error) {
+  std::string error;
+  if (!ValidateSnapshot(snapshot, &error)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.rejected;
+    if (validation_error) *validation_error = error;
+    return false;
+  }
+
+  // Validated snapshots are within the schema bounds and always fit.
+  Pending entry;
+  ToFixedSnapshot(snapshot, &entry.snapshot);
+  entry.captured_us = captured_us;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) return false;
+    ++stats_.submitted;
+    auto it = std::find_if(pending_.begin(), pending_.end(), [&snapshot](const Pending& queued) {
+      return queued.snapshot.session_id.View() == snapshot.session_id;
+    });
+    if (it != pending_.end()) {
+      ++stats_.coalesced;
+      *it = entry;
+    } else {
+      pending_.push_back(entry);
+    }
+  }
+  wake_.notify_one();
+  return true;
+}
+
+TelemetrySenderStats TelemetrySender::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void TelemetrySender::WorkerLoop() {
+  Pending next;
+
+  while (true) {
+    bool have_next = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      auto ready = [this] { return !pending_.empty() || !running_; };
+      if (stats_.delivery.spool_pending > 0) {
+        wake_.wait_for(lock, kSpoolRetryInterval, ready);
+      } else {
+        wake_.wait(lock, ready);
+      }
+      if (pending_.empty() && !running_) break;
+      if (!pending_.empty()) {
+        // Oldest session first, so every session gets its turn.
+        next = std::move(pending_.front());
+        pending_.erase(pending_.begin());
+        have_next = true;
+      }
+    }
+
+    if (!have_next) {
+      outbox_->Flush();
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_.delivery = outbox_->GetStats();
+      continue;
+    }
+
+    const uint64_t captured_us = next.captured_us;
+    TelemetrySnapshot snapshot;
+    FromFixedSnapshot(next.snapshot, &snapshot);
+    const bool delivered = outbox_->Deliver(snapshot, captured_us);
+    const uint64_t acked_us = DefaultClock().SteadyUs();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (delivered) {
+      ++stats_.sent;
+      stats_.last_latency_ms = acked_us >= captured_us ? (acked_us - captured_us) / 1000 : 0;
+    } else {
+      ++stats_.failed;
+    }
+    stats_.delivery = outbox_->GetStats();
+  }
+}
+
+}  // namespace mccmod
@@ -0,0 +1,178 @@
+#include "TelemetrySpool.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <unordered_map>
+#include <utility>
+
+namespace mccmod {
+namespace {
+
+// Fields are tab-separated and records newline-terminated, so neither may
+// appear inside the id fields; envelopes never carry a raw newline.
+std::string SanitizeField(std::string value, bool allow_tab) {
+  for (char& c : value) {
+    if (c == '\n' || c == '\r' || (!allow_tab && c == '\t')) c = ' ';
+  }
+  return value;
+}
+
+bool ParseSeq(const std::string& text, uint64_t* seq) {
+  if (text.empty()) return false;
+  char* end = nullptr;
+  *seq = std::strtoull(text.c_str(), &end, 10);
+  return end && *end == '\0' && *seq > 0;
+}
+
+// Splits off the first `fields` tab-separated fields; the remainder is the last element.
+bool SplitLine(const std::string& line, size_t fields, std::vector<std::string>* out) {
+  out->clear();
+  size_t start = 0;
+  for (size_t i = 0; i < fields; ++i) {
+    const size_t tab = line.find('\t', start);
+    if (tab == std::string::npos) return false;
+    out->push_back(line.substr(start, tab - start));
+    start = tab + 1;
+  }
+  out->push_back(line.substr(start));
+  return true;
+}
+
+std::vector<SpoolRecord> CompactRecords(const std::deque<SpoolRecord>& records) {
+  std::unordered_map<std::string, size_t> last_index;
+  for (size_t i = 0; i < records.size(); ++i) {
+    last_index[records[i].session_id] = i;
+  }
+
+  std::unordered_map<std::string, const std::string*> previous_key;
+  std::vector<SpoolRecord> kept;
+  for (size_t i = 0; i < records.size(); ++i) {
+    const SpoolRecord& record = records[i];
+    auto previous = previous_key.find(record.session_id);
+    const bool transition = previous == previous_key.end() || *previous->second != record.state_key;
+    previous_key[record.session_id] = &record.state_key;
+    if (transition || last_index[record.session_id] == i) {
+      kept.push_back(record);
+    }
+  }
+  return kept;
+}
+
+}  // namespace
+
+TelemetrySpool::TelemetrySpool(const std::string& path, uint64_t max_bytes)
+    : path_(path), max_bytes_(max_bytes) {}
+
+bool TelemetrySpool::Open() {
+  if (path_.empty()) return true;
+
+  std::ifstream in(path_, std::ios::in | std::ios::binary);
+  if (in) {
+    std::string line;
+    std::vector<std::string> fields;
+    while (std::getline(in, line)) {
+      // getline() also returns a final line with no newline; that one was torn.
+      if (in.eof()) break;
+      uint64_t seq = 0;
+      if (line.rfind("R\t", 0) == 0 && SplitLine(line, 4, &fields) && ParseSeq(fields[1], &seq)) {
+        pending_.push_back(SpoolRecord{seq, fields[2], fields[3], fields[4]});
+        if (seq >= next_seq_) next_seq_ = seq + 1;
+      } else if (line.rfind("A\t", 0) == 0 && SplitLine(line, 1, &fields) &&
+                 ParseSeq(fields[1], &seq)) {
+        while (!pending_.empty() && pending_.front().seq <= seq) pending_.pop_front();
+      } else {
+        break;
+      }
+    }
+  }
+
+  // Start from a clean file holding only what is still pending.
+  Rewrite();
+  return out_.is_open();
+}
+
+bool TelemetrySpool::Append(SpoolRecord* record) {
+  record->session_id = SanitizeField(record->session_id, false);
+  record->state_key = SanitizeField(record->state_key, false);
+  record->json = SanitizeField(record->json, true);
+  record->seq = next_seq_;
+
+  const uint64_t needed = FormatRecord(*record).size();
+  if (needed > max_bytes_) return false;
+  ++next_seq_;
+
+  if (bytes_ + needed > max_bytes_) {
+    MakeRoom(needed);
+  }
+  WriteLine(FormatRecord(*record));
+  pending_.push_back(*record);
+  return true;
+}
+
+std::vector<SpoolRecord> TelemetrySpool::Compacted() const {
+  return CompactRecords(pending_);
+}
+
+void TelemetrySpool::Ack(uint64_t seq) {
+  const size_t before = pending_.size();
+  while (!pending_.empty() && pending_.front().seq <= seq) pending_.pop_front();
+  if (pending_.size() == before) return;
+
+  if (pending_.empty()) {
+    Rewrite();
+  } else {
+    WriteLine("A\t" + std::to_string(seq) + "\n");
+  }
+}
+
+std::string TelemetrySpool::FormatRecord(const SpoolRecord& record) {
+  return "R\t" + std::to_string(record.seq) + "\t" + record.session_id + "\t" + record.state_key +
+         "\t" + record.json + "\n";
+}
+
+void TelemetrySpool::WriteLine(const std::string& line) {
+  bytes_ += line.size();
+  if (!out_.is_open()) return;
+  out_.write(line.data(), static_cast<std::streamsize>(line.size()));
+  out_.flush();
+}
+
+void TelemetrySpool::Rewrite() {
+  bytes_ = 0;
+  for (const SpoolRecord& record : pending_) {
+    bytes_ += FormatRecord(record).size();
+  }
+  if (path_.empty()) return;
+
+  out_.close();
+  const std::string tmp_path = path_ + ".tmp";
+  {
+    std::ofstream tmp(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    for (const SpoolRecord& record : pending_) {
+      tmp << FormatRecord(record);
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, path_, ec);
+  out_.open(path_, std::ios::out | std::ios::binary | std::ios::app);
+}
+
+void TelemetrySpool::MakeRoom(uint64_t needed) {
+  const size_t before = pending_.size();
+  std::vector<SpoolRecord> kept = CompactRecords(pending_);
+  pending_.assign(std::make_move_iterator(kept.begin()), std::make_move_iterator(kept.end()));
+  compacted_away_ += before - pending_.size();
+
+  uint64_t live_bytes = 0;
+  for (const SpoolRecord& record : pending_) {
+    live_bytes += FormatRecord(record).size();
+  }
+  while (!pending_.empty() && live_bytes + needed > max_bytes_) {
+    live_bytes -= FormatRecord(pending_.front()).size();
+    pending_.pop_front();
+    ++dropped_;
+  }
+  Rewrite();
+}
+
+}  // namespace mccmod
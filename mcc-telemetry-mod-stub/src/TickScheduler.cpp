@@ -0,0 +1,218 @@
+#include "TickScheduler.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+#include <chrono>
+
+// Windows 10 1803+; older SDKs lack the name.
+#if defined(_WIN32) && !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace mccmod {
+namespace {
+
+#if !defined(_WIN32)
+timespec ToTimespec(uint64_t us) {
+  timespec ts{};
+  ts.tv_sec = static_cast<time_t>(us / 1000000);
+  ts.tv_nsec = static_cast<long>((us % 1000000) * 1000);
+  return ts;
+}
+#endif
+
+}  // namespace
+
+const char* MissedTickPolicyName(MissedTickPolicy policy) {
+  switch (policy) {
+    case MissedTickPolicy::kSkip:
+      return "skip";
+    case MissedTickPolicy::kCatchUp:
+      return "catch-up";
+  }
+  return "unknown";
+}
+
+TickScheduler::TickScheduler(const TickSchedulerOptions& options, Clock& clock)
+    : clock_(clock), options_(options) {
+#if defined(_WIN32)
+  HANDLE timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                        TIMER_ALL_ACCESS);
+  high_resolution_ = timer != nullptr;
+  if (!timer) {
+    // Pre-1803 Windows: an ordinary timer, as coarse as the system tick.
+    timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+  }
+  timer_ = timer ? reinterpret_cast<intptr_t>(timer) : -1;
+#else
+  high_resolution_ = true;
+#endif
+  Reset();
+}
+
+TickScheduler::~TickScheduler() {
+#if defined(_WIN32)
+  if (timer_ != -1) CloseHandle(reinterpret_cast<HANDLE>(timer_));
+#else
+  if (timer_ >= 0) close(static_cast<int>(timer_));
+#endif
+}
+
+void TickScheduler::SetPeriodUs(uint64_t period_us) {
+  options_.period_us = period_us;
+}
+
+void TickScheduler::SetWakeHandle(intptr_t handle) {
+  wake_handle_ = handle;
+#if !defined(_WIN32)
+  // clock_nanosleep cannot also watch an fd, so waits move to an absolute timerfd.
+  if (wake_handle_ >= 0 && timer_ < 0) {
+    timer_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+  }
+#endif
+}
+
+void TickScheduler::Reset() {
+  deadline_us_ = NowUs();
+  catch_up_run_ = 0;
+}
+
+uint64_t TickScheduler::NowUs() const {
+  if (clock_.IsVirtual()) return clock_.SteadyMs() * 1000;
+#if defined(_WIN32)
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+#else
+  // The clock clock_nanosleep and timerfd measure deadlines against.
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000 + static_cast<uint64_t>(ts.tv_nsec) / 1000;
+#endif
+}
+
+bool TickScheduler::SleepUntilUs(uint64_t deadline_us) {
+  if (clock_.IsVirtual()) {
+    clock_.SleepUntil((deadline_us + 999) / 1000);
+    return true;
+  }
+
+#if defined(_WIN32)
+  const uint64_t now_us = NowUs();
+  if (deadline_us <= now_us) return true;
+  HANDLE wake = wake_handle_ != -1 ? reinterpret_cast<HANDLE>(wake_handle_) : nullptr;
+  if (timer_ == -1) {
+    const DWORD timeout_ms = static_cast<DWORD>((deadline_us - now_us + 999) / 1000);
+    if (!wake) {
+      Sleep(timeout_ms);
+      return true;
+    }
+    return WaitForSingleObject(wake, timeout_ms) != WAIT_OBJECT_0;
+  }
+
+  // High-resolution timers take relative due times, in 100 ns units; the
+  // deadline itself stays absolute because it is recomputed from "now".
+  HANDLE timer = reinterpret_cast<HANDLE>(timer_);
+  LARGE_INTEGER due{};
+  due.QuadPart = -static_cast<LONGLONG>((deadline_us - now_us) * 10);
+  if (!SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE)) return true;
+  const HANDLE handles[2] = {timer, wake};
+  const DWORD result = WaitForMultipleObjects(wake ? 2 : 1, handles, FALSE, INFINITE);
+  if (result == WAIT_OBJECT_0 + 1) {
+    CancelWaitableTimer(timer);
+    return false;
+  }
+  return true;
+#else
+  const timespec deadline = ToTimespec(deadline_us);
+  if (wake_handle_ < 0 || timer_ < 0) {
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+    return true;
+  }
+
+  itimerspec spec{};
+  spec.it_value = deadline;
+  if (deadline.tv_sec == 0 && deadline.tv_nsec == 0) return true;  // would disarm the timer
+  if (timerfd_settime(static_cast<int>(timer_), TFD_TIMER_ABSTIME, &spec, nullptr) != 0) return true;
+
+  pollfd fds[2] = {};
+  fds[0].fd = static_cast<int>(timer_);
+  fds[0].events = POLLIN;
+  fds[1].fd = static_cast<int>(wake_handle_);
+  fds[1].events = POLLIN;
+  while (true) {
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      return true;
+    }
+    if (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) return false;
+    if (fds[0].revents & POLLIN) {
+      uint64_t expirations = 0;
+      const ssize_t ignored = read(static_cast<int>(timer_), &expirations, sizeof(expirations));
+      (void)ignored;
+      return true;
+    }
+  }
+#endif
+}
+
+bool TickScheduler::WaitNextTick() {
+  const uint64_t period = options_.period_us;
+  const uint64_t previous = deadline_us_;
+  uint64_t next = previous + period;
+  uint64_t now = NowUs();
+
+  if (period > 0 && now >= next) {
+    // Deadlines after `next` that have also passed.
+    const uint64_t behind = (now - next) / period;
+    if (behind > 0) {
+      if (options_.missed == MissedTickPolicy::kCatchUp && catch_up_run_ < options_.max_catch_up) {
+        // Run `next` now; the later ones follow on the next calls.
+        ++catch_up_run_;
+        caught_up_.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        next += behind * period;
+        missed_.fetch_add(behind, std::memory_order_relaxed);
+        catch_up_run_ = 0;
+      }
+    }
+  }
+
+  if (now < next) {
+    catch_up_run_ = 0;
+    if (!SleepUntilUs(next)) {
+      deadline_us_ = previous;
+      interrupted_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    now = NowUs();
+  }
+
+  deadline_us_ = next;
+  lateness_us_.Record(now > next ? now - next : 0);
+  ticks_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+TickSchedulerStats TickScheduler::GetStats() const {
+  TickSchedulerStats stats;
+  stats.ticks = ticks_.load(std::memory_order_relaxed);
+  stats.missed = missed_.load(std::memory_order_relaxed);
+  stats.caught_up = caught_up_.load(std::memory_order_relaxed);
+  stats.interrupted = interrupted_.load(std::memory_order_relaxed);
+  stats.lateness_us = lateness_us_.Summary();
+  stats.high_resolution = high_resolution_;
+  return stats;
+}
+
+}  // namespace mccmod
@@ -0,0 +1,204 @@
+#include "TitleCatalog.h"
+
+#include <cstring>
+
+namespace mccmod {
+namespace {
+
+// Longest normalized name the catalog can hold; longer input cannot match.
+constexpr size_t kMaxKeyBytes = 24;
+
+// Matches std::isalnum/std::tolower in the "C" locale, which is what the
+// reader's old NormalizeMapName used; bytes above 0x7F are dropped.
+constexpr bool IsKeyChar(char c) {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+constexpr char LowerAscii(char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Seeded FNV-1a with a final mix; the table builder searches for the seed.
+constexpr uint64_t HashStart(uint64_t seed) {
+  return 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull);
+}
+
+constexpr uint64_t HashStep(uint64_t hash, char c) {
+  return (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+}
+
+constexpr uint64_t HashFinish(uint64_t hash) {
+  hash ^= hash >> 29;
+  hash *= 0xBF58476D1CE4E5B9ull;
+  return hash ^ (hash >> 32);
+}
+
+struct CatalogKey {
+  char text[kMaxKeyBytes] = {};
+  uint8_t size = 0;
+  bool fits = true;
+};
+
+constexpr CatalogKey MakeKey(const char* name) {
+  CatalogKey key;
+  for (const char* c = name; *c; ++c) {
+    if (!IsKeyChar(*c)) continue;
+    if (key.size == kMaxKeyBytes) {
+      key.fits = false;
+      break;
+    }
+    key.text[key.size++] = LowerAscii(*c);
+  }
+  return key;
+}
+
+constexpr uint64_t KeyHash(const CatalogKey& key, uint64_t seed) {
+  uint64_t hash = HashStart(seed);
+  for (size_t i = 0; i < key.size; ++i) hash = HashStep(hash, key.text[i]);
+  return HashFinish(hash);
+}
+
+template <size_t kEntries>
+struct CatalogKeys {
+  CatalogKey keys[kEntries];
+  bool all_fit = true;
+};
+
+template <size_t kEntries>
+constexpr CatalogKeys<kEntries> MakeKeys(const CatalogEntry (&entries)[kEntries]) {
+  CatalogKeys<kEntries> out{};
+  for (size_t i = 0; i < kEntries; ++i) {
+    out.keys[i] = MakeKey(entries[i].display_name);
+    out.all_fit = out.all_fit && out.keys[i].fits && out.keys[i].size > 0;
+  }
+  return out;
+}
+
+// Single-level perfect hash: a seed under which every key lands in its own
+// slot. With the table at least 8x the key count a seed turns up within a
+// few dozen tries, and lookups cost one hash and one compare.
+template <size_t kEntries, size_t kSlots>
+struct PerfectHashTable {
+  static_assert((kSlots & (kSlots - 1)) == 0, "slot count must be a power of two");
+  static_assert(kEntries < 255, "slots hold an 8-bit entry index");
+
+  uint64_t seed = 0;
+  // Entry index + 1; 0 marks an empty slot.
+  uint8_t slots[kSlots] = {};
+};
+
+constexpr uint64_t kMaxSeedTries = 4096;
+
+template <size_t kSlots, size_t kEntries>
+constexpr PerfectHashTable<kEntries, kSlots> BuildPerfectHash(const CatalogKeys<kEntries>& keys) {
+  PerfectHashTable<kEntries, kSlots> table;
+  // Last seed that claimed each slot, so the table need not be cleared per try.
+  uint64_t claimed[kSlots] = {};
+  for (uint64_t seed = 1; seed <= kMaxSeedTries; ++seed) {
+    bool collision = false;
+    for (size_t i = 0; i < kEntries && !collision; ++i) {
+      const size_t slot = static_cast<size_t>(KeyHash(keys.keys[i], seed) & (kSlots - 1));
+      collision = claimed[slot] == seed;
+      claimed[slot] = seed;
+    }
+    if (collision) continue;
+    table.seed = seed;
+    for (size_t i = 0; i < kEntries; ++i) {
+      table.slots[KeyHash(keys.keys[i], seed) & (kSlots - 1)] = static_cast<uint8_t>(i + 1);
+    }
+    return table;
+  }
+  return table;
+}
+
+constexpr size_t SlotsFor(size_t entries) {
+  size_t slots = 1;
+  while (slots < entries * 8) slots <<= 1;
+  return slots;
+}
+
+template <size_t kEntries>
+constexpr bool IdsUnique(const CatalogEntry (&entries)[kEntries]) {
+  for (size_t i = 0; i < kEntries; ++i) {
+    for (size_t j = i + 1; j < kEntries; ++j) {
+      if (entries[i].id == entries[j].id) return false;
+    }
+  }
+  return true;
+}
+
+constexpr size_t kMapCount = sizeof(kCatalogMaps) / sizeof(kCatalogMaps[0]);
+constexpr size_t kGameModeCount = sizeof(kCatalogGameModes) / sizeof(kCatalogGameModes[0]);
+
+constexpr CatalogKeys<kMapCount> kMapKeys = MakeKeys(kCatalogMaps);
+constexpr CatalogKeys<kGameModeCount> kGameModeKeys = MakeKeys(kCatalogGameModes);
+static_assert(kMapKeys.all_fit && kGameModeKeys.all_fit,
+              "catalog names must normalize to 1..kMaxKeyBytes characters");
+static_assert(IdsUnique(kCatalogMaps) && IdsUnique(kCatalogGameModes) &&
+                  kCatalogMaps[kMapCount - 1].id < kCatalogGameModes[0].id,
+              "catalog IDs must be unique");
+
+constexpr auto kMapTable = BuildPerfectHash<SlotsFor(kMapCount)>(kMapKeys);
+constexpr auto kGameModeTable = BuildPerfectHash<SlotsFor(kGameModeCount)>(kGameModeKeys);
+// Two names that normalize alike can never be separated, so this also catches duplicates.
+static_assert(kMapTable.seed != 0, "no perfect hash for the map catalog; duplicate name?");
+static_assert(kGameModeTable.seed != 0, "no perfect hash for the gametype catalog; duplicate name?");
+
+template <size_t kEntries, size_t kSlots>
+const CatalogEntry* Lookup(const PerfectHashTable<kEntries, kSlots>& table, const CatalogKeys<kEntries>& keys,
+                           const CatalogEntry (&entries)[kEntries], std::string_view name) {
+  // Normalize and hash in one pass over the input.
+  char normalized[kMaxKeyBytes];
+  size_t size = 0;
+  uint64_t hash = HashStart(table.seed);
+  for (const char c : name) {
+    if (!IsKeyChar(c)) continue;
+    if (size == kMaxKeyBytes) return nullptr;
+    normalized[size] = LowerAscii(c);
+    hash = HashStep(hash, normalized[size]);
+    ++size;
+  }
+  const uint8_t slot = table.slots[HashFinish(hash) & (kSlots - 1)];
+  if (slot == 0) return nullptr;
+  const CatalogKey& key = keys.keys[slot - 1];
+  if (key.size != size || std::memcmp(key.text, normalized, size) != 0) return nullptr;
+  return &entries[slot - 1];
+}
+
+constexpr const char* kTitleTags[] = {"halo1", "halo2", "halo3", "halo3odst", "haloreach", "halo4"};
+constexpr const char* kTitleNames[] = {"Halo: Combat Evolved", "Halo 2", "Halo 3",
+                                       "Halo 3: ODST", "Halo: Reach", "Halo 4"};
+static_assert(sizeof(kTitleTags) / sizeof(kTitleTags[0]) == static_cast<size_t>(MccTitle::kCount) &&
+                  sizeof(kTitleNames) / sizeof(kTitleNames[0]) == static_cast<size_t>(MccTitle::kCount),
+              "every MccTitle needs a tag and a name");
+
+}  // namespace
+
+const char* TitleTag(MccTitle title) {
+  return title < MccTitle::kCount ? kTitleTags[static_cast<size_t>(title)] : "";
+}
+
+const char* TitleDisplayName(MccTitle title) {
+  return title < MccTitle::kCount ? kTitleNames[static_cast<size_t>(title)] : "";
+}
+
+const CatalogEntry* FindCatalogMap(std::string_view name) {
+  return Lookup(kMapTable, kMapKeys, kCatalogMaps, name);
+}
+
+const CatalogEntry* FindCatalogGameMode(std::string_view name) {
+  return Lookup(kGameModeTable, kGameModeKeys, kCatalogGameModes, name);
+}
+
+const CatalogEntry* FindCatalogId(uint16_t id) {
+  // Linear; IDs are for decoding stored records, not for the per-tick path.
+  for (const CatalogEntry& entry : kCatalogMaps) {
+    if (entry.id == id) return &entry;
+  }
+  for (const CatalogEntry& entry : kCatalogGameModes) {
+    if (entry.id == id) return &entry;
+  }
+  return nullptr;
+}
+
+}  // namespace mccmod
@@ -0,0 +1,98 @@
+#include "WorkerPool.h"
+
+#include <chrono>
+#include <utility>
+
+namespace mccmod {
+
+WorkerPool::~WorkerPool() {
+  Stop();
+}
+
+bool WorkerPool::Start(size_t threads) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  if (state_->running) return true;
+  if (threads == 0 || state_->live_workers > 0) return false;
+  state_->running = true;
+  state_->live_workers = threads;
+  workers_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    workers_.emplace_back(&WorkerPool::WorkerLoop, state_);
+  }
+  return true;
+}
+
+void WorkerPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (!state_->running) return;
+    state_->running = false;
+    state_->tasks.clear();
+  }
+  state_->wake.notify_all();
+  for (auto& worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  workers_.clear();
+}
+
+bool WorkerPool::Stop(uint64_t timeout_ms) {
+  bool stopped = true;
+  {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    if (!state_->running) return true;
+    state_->running = false;
+    state_->tasks.clear();
+    state_->wake.notify_all();
+    stopped = state_->exited.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                                      [this] { return state_->live_workers == 0; });
+  }
+  for (auto& worker : workers_) {
+    if (!worker.joinable()) continue;
+    if (stopped) {
+      worker.join();
+    } else {
+      worker.detach();
+    }
+  }
+  workers_.clear();
+  // Detached workers keep the old state; a restarted pool gets its own.
+  if (!stopped) state_ = std::make_shared<State>();
+  return stopped;
+}
+
+bool WorkerPool::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (!state_->running) return false;
+    state_->tasks.push_back(std::move(task));
+  }
+  state_->wake.notify_one();
+  return true;
+}
+
+size_t WorkerPool::QueueDepth() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->tasks.size();
+}
+
+void WorkerPool::WorkerLoop(std::shared_ptr<State> state) {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(state->mutex);
+      state->wake.wait(lock, [&state] { return !state->running || !state->tasks.empty(); });
+      if (!state->running) break;
+      task = std::move(state->tasks.front());
+      state->tasks.pop_front();
+    }
+    task();
+  }
+  std::lock_guard<std::mutex> lock(state->mutex);
+  --state->live_workers;
+  state->exited.notify_all();
+}
+
+}  // namespace mccmod
@@ -0,0 +1,197 @@
+// Counts the reader's heap allocations per sample: runs
+// mcc_player_overlay_alloc --headless against mcc_dummy_target, with and
+// without HMCC_READER_DEBUG, and scrapes mcc_reader_sample_allocations_total
+// from its /metrics endpoint. Prints JSON; exits 1 if a check fails.
+//
+//   mcc_alloc_check [--reader PATH] [--dummy PATH] [--warmup-ms N] [--window-ms N]
+//
+// That build of the reader links tools/AllocCounter.cpp, which counts
+// allocations per thread in a replacement operator new, so the figure holds
+// only the sampler's work, not the emitter's or the metrics server's. After
+// --warmup-ms the counters are read, then the dummy gains a player every
+// 400 ms for --window-ms, and the counters are read again. The default window
+// outlasts the region cache's 5 s expiry, so it holds a refresh. Outside
+// debug mode the samples in that window must not allocate.
+#include "ChildProcess.h"
+#include "MetricsScrape.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr auto kStartTimeout = std::chrono::seconds(10);
+constexpr auto kChangeInterval = std::chrono::milliseconds(400);
+
+struct Options {
+  std::string reader;
+  std::string dummy;
+  int warmup_ms = 2000;
+  int window_ms = 5500;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--reader" && has_value) {
+      options->reader = argv[++i];
+    } else if (arg == "--dummy" && has_value) {
+      options->dummy = argv[++i];
+    } else if (arg == "--warmup-ms" && has_value) {
+      options->warmup_ms = std::atoi(argv[++i]);
+    } else if (arg == "--window-ms" && has_value) {
+      options->window_ms = std::atoi(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  if (options->reader.empty()) options->reader = mcctools::SiblingPath("mcc_player_overlay_alloc");
+  if (options->dummy.empty()) options->dummy = mcctools::SiblingPath("mcc_dummy_target");
+  return !options->reader.empty() && !options->dummy.empty() && options->warmup_ms >= 0 && options->window_ms > 0;
+}
+
+struct Counters {
+  int64_t samples = -1;
+  int64_t allocations = -1;
+};
+
+Counters ReadCounters(uint16_t port) {
+  const std::string text = mcctools::ScrapeMetrics(port);
+  Counters counters;
+  counters.samples = mcctools::MetricValue(text, "mcc_reader_samples_total");
+  counters.allocations = mcctools::MetricValue(text, "mcc_reader_sample_allocations_total");
+  return counters;
+}
+
+struct RunResult {
+  bool started = false;
+  bool exited_cleanly = false;
+  int64_t warmup_samples = 0;
+  int64_t warmup_allocations = 0;
+  int64_t samples = 0;
+  int64_t allocations = 0;
+};
+
+RunResult RunReader(const Options& options, const std::string& dir, const std::string& target, pid_t dummy_pid,
+                    bool debug) {
+  RunResult result;
+  const uint16_t port = mcctools::FreePort();
+  const pid_t reader_pid = mcctools::Spawn(
+      options.reader, {"--headless"},
+      {"HMCC_READER_TARGET=" + target, "HMCC_READER_METRICS_PORT=" + std::to_string(port), "HMCC_READER_PUBSUB=0",
+       "HMCC_READER_ENDPOINT=", "HMCC_READER_DEBUG=" + std::string(debug ? "1" : "0"),
+       "HMCC_READER_FLIGHT=" + dir + "/flight.bin", "MCC_TELEMETRY_OUT=" + dir + "/state.json"});
+  if (reader_pid <= 0 || port == 0) return result;
+
+  // Warm-up ends once the reader is connected and sampling, plus --warmup-ms.
+  const auto deadline = SteadyClock::now() + kStartTimeout;
+  Counters first;
+  while ((first = ReadCounters(port)).samples <= 0 && SteadyClock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  result.started = first.samples > 0;
+  if (result.started) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(options.warmup_ms));
+    const Counters before = ReadCounters(port);
+    const auto window_end = SteadyClock::now() + std::chrono::milliseconds(options.window_ms);
+    while (SteadyClock::now() < window_end) {
+      kill(dummy_pid, SIGUSR2);
+      std::this_thread::sleep_for(kChangeInterval);
+    }
+    const Counters after = ReadCounters(port);
+    result.warmup_samples = before.samples;
+    result.warmup_allocations = before.allocations;
+    result.samples = after.samples - before.samples;
+    result.allocations = after.allocations - before.allocations;
+  }
+  const int status = mcctools::Terminate(reader_pid);
+  result.exited_cleanly = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  return result;
+}
+
+std::string RunJson(const RunResult& result) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3) << "{\"warmupSamples\":" << result.warmup_samples
+      << ",\"warmupAllocations\":" << result.warmup_allocations << ",\"samples\":" << result.samples
+      << ",\"allocations\":" << result.allocations << ",\"allocationsPerSample\":"
+      << (result.samples > 0 ? static_cast<double>(result.allocations) / static_cast<double>(result.samples) : 0.0)
+      << "}";
+  return out.str();
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_alloc_check [--reader PATH] [--dummy PATH] [--warmup-ms N] [--window-ms N]" << std::endl;
+    return 2;
+  }
+
+  char dir_template[] = "/tmp/mcc-alloc-check-XXXXXX";
+  if (!mkdtemp(dir_template)) {
+    std::perror("mcc_alloc_check: mkdtemp");
+    return 2;
+  }
+  const std::string dir = dir_template;
+  const std::string target = "alloc" + std::to_string(getpid());
+  const std::string dummy = dir + "/" + target;
+  if (!mcctools::CopyExecutable(options.dummy, dummy)) {
+    std::cerr << "mcc_alloc_check: cannot set up " << dir << std::endl;
+    std::filesystem::remove_all(dir);
+    return 2;
+  }
+  const pid_t dummy_pid = mcctools::Spawn(dummy, {"4", "Sword Base", "Team Slayer"});
+
+  Checks checks;
+  checks.Expect(dummy_pid > 0, "dummy started");
+  RunResult plain;
+  RunResult debug;
+  if (dummy_pid > 0) {
+    plain = RunReader(options, dir, target, dummy_pid, false);
+    debug = RunReader(options, dir, target, dummy_pid, true);
+  }
+  mcctools::Terminate(dummy_pid);
+  std::filesystem::remove_all(dir);
+
+  checks.Expect(plain.started && debug.started, "reader serving metrics");
+  checks.Expect(plain.exited_cleanly && debug.exited_cleanly, "reader exited cleanly");
+  // The first samples size their buffers; a count of zero there means the counter is not wired up.
+  checks.Expect(plain.warmup_allocations > 0 && debug.warmup_allocations > 0, "warm-up allocations counted");
+  checks.Expect(plain.samples > 0 && plain.allocations >= 0, "samples taken in the window");
+  checks.Expect(plain.allocations == 0, "no allocations per sample outside debug mode");
+
+  std::cout << "{\"windowMs\":" << options.window_ms << ",\"plain\":" << RunJson(plain)
+            << ",\"debug\":" << RunJson(debug) << ",\"checks\":{\"passed\":" << checks.passed << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
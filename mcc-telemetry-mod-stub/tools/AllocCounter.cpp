@@ -0,0 +1,71 @@
+// Counting replacement for the global allocator, linked only into
+// mcc_player_overlay_alloc, the reader build mcc_alloc_check runs. Every form
+// of operator new counts one allocation for the calling thread; plain, array,
+// nothrow and aligned forms all come from malloc or posix_memalign, and every
+// form of operator delete frees, so the families stay matched.
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local uint64_t thread_allocations = 0;
+
+// nullptr only when the size cannot be met and no new_handler is installed.
+void* Allocate(std::size_t size, std::size_t alignment) {
+  ++thread_allocations;
+  if (size == 0) size = 1;
+  while (true) {
+    void* block = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+      block = std::malloc(size);
+    } else if (posix_memalign(&block, alignment, size) != 0) {
+      block = nullptr;
+    }
+    if (block) return block;
+    const std::new_handler handler = std::get_new_handler();
+    if (!handler) return nullptr;
+    handler();
+  }
+}
+
+void* AllocateOrThrow(std::size_t size, std::size_t alignment) {
+  if (void* block = Allocate(size, alignment)) return block;
+  throw std::bad_alloc();
+}
+
+}  // namespace
+
+// Declared by the reader under MCC_READER_COUNT_ALLOCATIONS.
+uint64_t ThreadHeapAllocations() { return thread_allocations; }
+
+void* operator new(std::size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new[](std::size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return AllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return AllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return Allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { std::free(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { std::free(block); }
+void operator delete(void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept { std::free(block); }
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept { std::free(block); }
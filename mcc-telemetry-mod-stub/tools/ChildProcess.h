@@ -0,0 +1,95 @@
+#pragma once
+
+// Starting and stopping the reader and mcc_dummy_target from the Linux check
+// tools that drive them as child processes.
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char** environ;
+
+namespace mcctools {
+
+// `name` in the directory of the running executable; empty if that is unknown.
+inline std::string SiblingPath(const std::string& name) {
+  char self[4096];
+  const ssize_t length = readlink("/proc/self/exe", self, sizeof(self) - 1);
+  if (length <= 0) return std::string();
+  const std::string path(self, static_cast<size_t>(length));
+  return path.substr(0, path.find_last_of('/') + 1) + name;
+}
+
+// Copies an executable, so a child can run under a name of the tool's choosing.
+inline bool CopyExecutable(const std::string& from, const std::string& to) {
+  std::ifstream in(from, std::ios::binary);
+  std::ofstream out(to, std::ios::binary | std::ios::trunc);
+  if (!in || !out) return false;
+  out << in.rdbuf();
+  out.close();
+  return out.good() && chmod(to.c_str(), 0700) == 0;
+}
+
+// Starts `path` with `args` after argv[0], in this process's environment with
+// the "KEY=value" entries of `env` added or replacing theirs. The child's
+// stdout goes to /dev/null, and its stderr to `stderr_path` when that is set.
+// Returns the pid, or -1.
+inline pid_t Spawn(const std::string& path, const std::vector<std::string>& args,
+                   const std::vector<std::string>& env = {}, const std::string& stderr_path = std::string()) {
+  std::vector<std::string> environment;
+  for (char** entry = environ; *entry; ++entry) {
+    const std::string current = *entry;
+    const std::string key = current.substr(0, current.find('=') + 1);
+    bool replaced = false;
+    for (const std::string& added : env) replaced = replaced || added.compare(0, key.size(), key) == 0;
+    if (!replaced) environment.push_back(current);
+  }
+  environment.insert(environment.end(), env.begin(), env.end());
+
+  std::vector<char*> child_argv = {const_cast<char*>(path.c_str())};
+  for (const std::string& arg : args) child_argv.push_back(const_cast<char*>(arg.c_str()));
+  child_argv.push_back(nullptr);
+  std::vector<char*> child_env;
+  for (const std::string& entry : environment) child_env.push_back(const_cast<char*>(entry.c_str()));
+  child_env.push_back(nullptr);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+  if (!stderr_path.empty()) {
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, stderr_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  }
+  pid_t child = -1;
+  const int spawned = posix_spawn(&child, path.c_str(), &actions, nullptr, child_argv.data(), child_env.data());
+  posix_spawn_file_actions_destroy(&actions);
+  return spawned == 0 ? child : -1;
+}
+
+// SIGTERM, then SIGKILL if the child has not exited within `grace`; reaps it.
+// Returns the wait status.
+inline int Terminate(pid_t child, std::chrono::milliseconds grace = std::chrono::milliseconds(3000)) {
+  int status = 0;
+  if (child <= 0) return status;
+  kill(child, SIGTERM);
+  const auto deadline = std::chrono::steady_clock::now() + grace;
+  while (waitpid(child, &status, WNOHANG) == 0) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      kill(child, SIGKILL);
+      waitpid(child, &status, 0);
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return status;
+}
+
+}  // namespace mcctools
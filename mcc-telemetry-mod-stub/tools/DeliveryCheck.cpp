@@ -0,0 +1,391 @@
+// Checks the delivery path's pieces one at a time: CircuitBreaker on a
+// scripted clock, TelemetrySpool against files written and torn on disk, and
+// TelemetryOutbox::Flush against loadgen's stand-in receiver coming up after
+// an outage. Prints JSON; exits 1 if a check fails.
+//
+//   mcc_delivery_check [--dir PATH]
+//
+// The outbox check spools a scripted run of two sessions while nothing
+// listens on the receiver's port, then starts the stand-in there and flushes.
+// The receiver must see every lobby transition and each session's latest
+// state, in delivery order, and nothing compaction should have dropped.
+#include "CircuitBreaker.h"
+#include "StandInReceiver.h"
+#include "TelemetryOutbox.h"
+#include "TelemetrySpool.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr auto kFlushTimeout = std::chrono::seconds(3);
+
+struct Options {
+  std::string dir;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--dir" && has_value) {
+      options->dir = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+void CheckCircuitBreaker(Checks* checks) {
+  mccmod::CircuitBreakerOptions options;
+  options.failure_threshold = 3;
+  options.base_backoff_ms = 100;
+  options.max_backoff_ms = 700;
+  mccmod::CircuitBreaker breaker(options);
+
+  uint64_t now = 1000;
+  breaker.RecordFailure(now);
+  breaker.RecordFailure(now);
+  breaker.RecordSuccess();
+  breaker.RecordFailure(now);
+  breaker.RecordFailure(now);
+  checks->Expect(breaker.State() == mccmod::CircuitState::kClosed && breaker.Allow(now),
+                 "breaker: a success resets the failure run");
+  breaker.RecordFailure(now);
+  checks->Expect(breaker.State() == mccmod::CircuitState::kOpen && breaker.RetryAtMs() == now + 100,
+                 "breaker: threshold failures open with the base backoff");
+  checks->Expect(!breaker.Allow(now + 99) && breaker.Rejected() == 1, "breaker: open rejects until the backoff ends");
+
+  // Half-open admits one probe; a second caller waits for its answer.
+  checks->Expect(breaker.Allow(now + 100) && breaker.State() == mccmod::CircuitState::kHalfOpen,
+                 "breaker: backoff expiry admits a half-open probe");
+  checks->Expect(!breaker.Allow(now + 100), "breaker: only one probe in flight");
+
+  // Failed probes double the backoff up to the cap: 200, 400, then 700 twice.
+  const uint64_t expected[] = {200, 400, 700, 700};
+  bool doubled = true;
+  now += 100;
+  for (const uint64_t backoff : expected) {
+    breaker.RecordFailure(now);
+    doubled = doubled && breaker.State() == mccmod::CircuitState::kOpen && breaker.RetryAtMs() == now + backoff;
+    now = breaker.RetryAtMs();
+    doubled = doubled && breaker.Allow(now);
+  }
+  checks->Expect(doubled, "breaker: failed probes double the backoff up to its cap");
+
+  breaker.RecordSuccess();
+  checks->Expect(breaker.State() == mccmod::CircuitState::kClosed && breaker.Allow(now),
+                 "breaker: a successful probe closes the circuit");
+  breaker.RecordFailure(now);
+  breaker.RecordFailure(now);
+  breaker.RecordFailure(now);
+  checks->Expect(breaker.RetryAtMs() == now + 100, "breaker: reopening after a close starts from the base backoff");
+}
+
+mccmod::SpoolRecord Record(const std::string& session, const std::string& key, const std::string& json) {
+  return mccmod::SpoolRecord{0, session, key, json};
+}
+
+uint64_t FileSize(const std::string& path) {
+  std::error_code error;
+  const uint64_t size = std::filesystem::file_size(path, error);
+  return error ? 0 : size;
+}
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::ostringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+void CheckSpool(const std::string& dir, Checks* checks) {
+  const std::string path = dir + "/spool_check.log";
+  std::filesystem::remove(path);
+
+  // Torn tail: a crash mid-append leaves a final line with no newline.
+  {
+    mccmod::TelemetrySpool spool(path);
+    spool.Open();
+    for (int i = 0; i < 3; ++i) {
+      mccmod::SpoolRecord record = Record("a", "idle", "{\"n\":" + std::to_string(i) + "}");
+      spool.Append(&record);
+    }
+  }
+  {
+    std::ofstream torn(path, std::ios::binary | std::ios::app);
+    torn << "R\t4\ta\tidle\t{\"n\":";
+  }
+  {
+    mccmod::TelemetrySpool spool(path);
+    spool.Open();
+    checks->Expect(spool.Pending() == 3, "spool: torn final line dropped on open");
+    checks->Expect(FileSize(path) == spool.Bytes() && ReadFile(path).back() == '\n',
+                   "spool: open rewrites the file without the torn line");
+    mccmod::SpoolRecord next = Record("a", "idle", "{\"n\":3}");
+    spool.Append(&next);
+    checks->Expect(next.seq == 4, "spool: sequence continues after the last whole record");
+
+    // Acks add a line; records up to the acked seq are gone after a reopen.
+    spool.Ack(2);
+    checks->Expect(spool.Pending() == 2 && ReadFile(path).find("A\t2\n") != std::string::npos,
+                   "spool: ack appends an ack line");
+    spool.Ack(1);
+    checks->Expect(spool.Pending() == 2 && ReadFile(path).find("A\t1\n") == std::string::npos,
+                   "spool: ack below the oldest pending record writes nothing");
+  }
+  {
+    mccmod::TelemetrySpool spool(path);
+    spool.Open();
+    const std::vector<mccmod::SpoolRecord> pending = spool.Compacted();
+    checks->Expect(spool.Pending() == 2 && !pending.empty() && pending.back().seq == 4,
+                   "spool: acked records stay delivered across a reopen");
+    spool.Ack(4);
+    checks->Expect(spool.Pending() == 0 && spool.Bytes() == 0 && FileSize(path) == 0,
+                   "spool: acking everything truncates the file");
+  }
+
+  // Compaction: one session's updates within a state collapse to the latest,
+  // keeping each record that starts a new state.
+  {
+    std::filesystem::remove(path);
+    mccmod::TelemetrySpool spool(path);
+    spool.Open();
+    const char* keys[] = {"idle", "idle", "custom|Sword Base", "custom|Sword Base", "custom|Sword Base", "idle"};
+    for (const char* key : keys) {
+      mccmod::SpoolRecord record = Record("a", key, "{}");
+      spool.Append(&record);
+    }
+    mccmod::SpoolRecord other = Record("b", "idle", "{}");
+    spool.Append(&other);
+    std::vector<uint64_t> seqs;
+    for (const auto& record : spool.Compacted()) seqs.push_back(record.seq);
+    checks->Expect(seqs == std::vector<uint64_t>({1, 3, 6, 7}),
+                   "spool: compacted keeps transitions and each session's latest, in order");
+  }
+
+  // MakeRoom compacts first: same-state updates make room without dropping
+  // anything compaction would keep.
+  {
+    std::filesystem::remove(path);
+    const std::string json(100, 'x');
+    const uint64_t line = ("R\t10\ta\tidle\t" + json + "\n").size();
+    mccmod::TelemetrySpool spool(path, line * 8);
+    spool.Open();
+    for (int i = 0; i < 20; ++i) {
+      mccmod::SpoolRecord record = Record("a", "idle", json);
+      spool.Append(&record);
+    }
+    checks->Expect(spool.CompactedAway() > 0 && spool.Dropped() == 0 && spool.Bytes() <= line * 8,
+                   "spool: a full file is compacted before anything is dropped");
+    checks->Expect(FileSize(path) == spool.Bytes(), "spool: compaction rewrites the file");
+    const std::vector<mccmod::SpoolRecord> pending = spool.Compacted();
+    checks->Expect(pending.size() == 2 && pending.front().seq == 1 && pending.back().seq == 20,
+                   "spool: compaction kept the state's first record and the latest");
+  }
+
+  // When every record is a transition, compaction frees nothing and the
+  // oldest are trimmed.
+  {
+    std::filesystem::remove(path);
+    const std::string json(100, 'x');
+    const uint64_t line = ("R\t10\ta\tkey10\t" + json + "\n").size();
+    mccmod::TelemetrySpool spool(path, line * 8);
+    spool.Open();
+    for (int i = 10; i < 30; ++i) {
+      mccmod::SpoolRecord record = Record("a", "key" + std::to_string(i), json);
+      spool.Append(&record);
+    }
+    const std::vector<mccmod::SpoolRecord> pending = spool.Compacted();
+    checks->Expect(spool.Dropped() > 0 && spool.Bytes() <= line * 8 && FileSize(path) == spool.Bytes(),
+                   "spool: the oldest records are trimmed when compaction is not enough");
+    checks->Expect(!pending.empty() && pending.back().seq == 20 && pending.front().seq == spool.Dropped() + 1,
+                   "spool: trimming keeps the newest records");
+
+    mccmod::SpoolRecord huge = Record("a", "idle", std::string(line * 8, 'x'));
+    checks->Expect(!spool.Append(&huge), "spool: a record larger than the file is refused");
+  }
+  std::filesystem::remove(path);
+}
+
+mccmod::TelemetrySnapshot Snapshot(const std::string& session, const std::string& map, const std::string& mode,
+                                   int players) {
+  mccmod::TelemetrySnapshot snapshot;
+  snapshot.session_id = session;
+  snapshot.is_custom_game = !map.empty();
+  snapshot.map_name = map;
+  snapshot.game_mode = mode;
+  snapshot.player_count = players;
+  snapshot.max_players = 16;
+  return snapshot;
+}
+
+std::string Describe(const mccmod::TelemetrySnapshot& snapshot) {
+  return snapshot.session_id + "/" + (snapshot.is_custom_game ? snapshot.map_name + "|" + snapshot.game_mode : "idle") +
+         "/" + std::to_string(snapshot.player_count);
+}
+
+struct OutboxResult {
+  uint64_t delivered_while_down = 0;
+  bool drained = false;
+  std::vector<std::string> expected;
+  std::vector<std::string> applied;
+  bool in_order = true;
+  bool live_after_drain = false;
+  mccmod::TelemetryOutboxStats stats;
+};
+
+OutboxResult RunOutbox(const std::string& dir) {
+  OutboxResult result;
+  uint16_t port = 0;
+  {
+    mcctools::StandInReceiver probe;
+    if (probe.Start()) port = probe.Port();
+  }
+  if (port == 0) return result;
+
+  const std::string spool_path = dir + "/outbox_check.log";
+  std::filesystem::remove(spool_path);
+  mccmod::CircuitBreakerOptions breaker;
+  breaker.failure_threshold = 1;
+  breaker.base_backoff_ms = 20;
+  breaker.max_backoff_ms = 80;
+  mccmod::TelemetryOutbox outbox("http://127.0.0.1:" + std::to_string(port) + "/telemetry", spool_path,
+                                 mccmod::DefaultClock(), breaker);
+
+  // Player counts are unique, so each applied envelope names its source.
+  const std::vector<mccmod::TelemetrySnapshot> script = {
+      Snapshot("a", "", "", 0),
+      Snapshot("a", "", "", 1),
+      Snapshot("a", "Sword Base", "Slayer", 2),
+      Snapshot("a", "Sword Base", "Slayer", 3),
+      Snapshot("a", "Sword Base", "Slayer", 4),
+      Snapshot("b", "Zealot", "CTF", 5),
+      Snapshot("a", "Zealot", "Slayer", 6),
+      Snapshot("b", "Zealot", "CTF", 7),
+      Snapshot("a", "", "", 8),
+      Snapshot("b", "Zealot", "CTF", 9),
+  };
+  // What compaction keeps: per session, each new state and the last record.
+  for (size_t i = 0; i < script.size(); ++i) {
+    auto key = [](const mccmod::TelemetrySnapshot& s) { return s.is_custom_game ? s.map_name + s.game_mode : ""; };
+    bool first = true;
+    bool last = true;
+    for (size_t j = 0; j < script.size(); ++j) {
+      if (script[j].session_id != script[i].session_id) continue;
+      if (j < i) first = key(script[j]) != key(script[i]);
+      if (j > i) last = false;
+    }
+    if (first || last) result.expected.push_back(Describe(script[i]));
+  }
+
+  for (const auto& snapshot : script) {
+    if (outbox.Deliver(snapshot)) ++result.delivered_while_down;
+  }
+
+  mcctools::StandInReceiver receiver(port);
+  receiver.KeepAppliedLog();
+  if (receiver.Start()) {
+    const auto deadline = SteadyClock::now() + kFlushTimeout;
+    while (!(result.drained = outbox.Flush()) && SteadyClock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  result.stats = outbox.GetStats();
+  result.live_after_drain = result.drained && outbox.Deliver(Snapshot("b", "", "", 10));
+
+  uint64_t last_seq = 0;
+  for (const auto& applied : receiver.AppliedLog()) {
+    result.applied.push_back(Describe(applied.snapshot));
+    result.in_order = result.in_order && applied.delivery.seq > last_seq;
+    last_seq = applied.delivery.seq;
+  }
+  receiver.Stop();
+  std::filesystem::remove(spool_path);
+  return result;
+}
+
+std::string JoinJson(const std::vector<std::string>& items) {
+  std::string out = "[";
+  for (size_t i = 0; i < items.size(); ++i) out += (i ? ",\"" : "\"") + items[i] + "\"";
+  return out + "]";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_delivery_check [--dir PATH]" << std::endl;
+    return 2;
+  }
+  const bool own_dir = options.dir.empty();
+  const std::filesystem::path dir =
+      own_dir ? std::filesystem::temp_directory_path() /
+                    ("mcc_delivery_check." + std::to_string(SteadyClock::now().time_since_epoch().count()))
+              : std::filesystem::path(options.dir);
+  std::error_code error;
+  std::filesystem::create_directories(dir, error);
+  if (!std::filesystem::is_directory(dir)) {
+    std::cerr << "mcc_delivery_check: cannot use " << dir.string() << std::endl;
+    return 2;
+  }
+
+  Checks checks;
+  CheckCircuitBreaker(&checks);
+  CheckSpool(dir.string(), &checks);
+  const OutboxResult outbox = RunOutbox(dir.string());
+  if (own_dir) std::filesystem::remove_all(dir, error);
+
+  std::vector<std::string> expected_then_live = outbox.expected;
+  expected_then_live.push_back("b/idle/10");
+  checks.Expect(outbox.delivered_while_down == 0 && outbox.stats.spooled == 10,
+                "outbox: everything spooled while the receiver was down");
+  checks.Expect(outbox.stats.circuit_opens > 0, "outbox: failures opened the circuit");
+  checks.Expect(outbox.drained, "outbox: flush drained the spool once the receiver was up");
+  checks.Expect(outbox.in_order, "outbox: replay kept delivery order");
+  checks.Expect(outbox.applied == expected_then_live,
+                "outbox: receiver saw every transition and each session's latest state");
+  checks.Expect(outbox.stats.replayed == outbox.expected.size() &&
+                    outbox.stats.compacted == outbox.stats.spooled - outbox.stats.replayed &&
+                    outbox.stats.spool_pending == 0,
+                "outbox: replayed and compacted add up to what was spooled");
+  checks.Expect(outbox.live_after_drain && outbox.stats.circuit == mccmod::CircuitState::kClosed,
+                "outbox: delivers directly after the drain");
+
+  std::cout << "{\"outbox\":{\"spooled\":" << outbox.stats.spooled << ",\"replayed\":" << outbox.stats.replayed
+            << ",\"compacted\":" << outbox.stats.compacted << ",\"circuitOpens\":" << outbox.stats.circuit_opens
+            << ",\"applied\":" << JoinJson(outbox.applied) << "},\"checks\":{\"passed\":" << checks.passed
+            << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+// Stand-in MCC process for running the reader on Linux. Maps sparse files
+// named like the MCC and Halo: Reach modules the way Wine maps a PE image, so
+// the reader finds them in /proc/<pid>/maps, then lays out the fields the
+// reader samples at the offsets in ReaderLayout.h.
+//
+//   mcc_dummy_target [--wine] [players] [map] [mode]
+//   HMCC_READER_TARGET=mcc_dummy_target mcc_player_overlay
+//
+// Each module file starts with a PE header and is mapped twice: the image
+// from offset 0, then a view from a later page, which lands lower in memory
+// as Wine's section mappings can. --wine sets comm to the 15-character cut of
+// the MCC executable name, as Wine does; run from a copy named
+// wine64-preloader, the process then passes for MCC under Proton.
+//
+// The player table holds "Player 1".."Player N" on alternating teams. Kills
+// tick up every second, which must not count as a roster change; SIGUSR1
+// moves the last player to the other team, which must. SIGUSR2 lets one more
+// player join, back down to one after a full lobby of 16.
+#include "ReaderLayout.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+
+volatile sig_atomic_t g_stop = 0;
+volatile sig_atomic_t g_swap_team = 0;
+volatile sig_atomic_t g_player_joined = 0;
+
+void OnSignal(int) {
+  g_stop = 1;
+}
+
+void OnSwapTeam(int) {
+  g_swap_team = 1;
+}
+
+void OnPlayerJoined(int) {
+  g_player_joined = 1;
+}
+
+struct SharedTelemetryBlock {
+  char bytes[0x1000];
+};
+
+void WriteString(SharedTelemetryBlock* block, uintptr_t offset, const std::string& value) {
+  const size_t length = std::min(value.size(), size_t{63});
+  std::memcpy(block->bytes + offset, value.data(), length);
+  block->bytes[offset + length] = '\0';
+}
+
+char* PlayerEntry(SharedTelemetryBlock* block, size_t slot) {
+  return block->bytes + mccmod::kPlayerTableOffset + slot * mccmod::kPlayerEntryStride;
+}
+
+void WritePlayer(SharedTelemetryBlock* block, size_t slot, const std::string& name, uint8_t team) {
+  char* entry = PlayerEntry(block, slot);
+  const size_t length = std::min(name.size(), mccmod::kPlayerEntryNameChars - 1);
+  for (size_t i = 0; i < length; ++i) {
+    entry[i * 2] = name[i];
+    entry[i * 2 + 1] = 0;
+  }
+  entry[mccmod::kPlayerEntryFlagsOffset] = static_cast<char>(mccmod::kPlayerEntryActive);
+  entry[mccmod::kPlayerEntryTeamOffset] = static_cast<char>(team);
+}
+
+// Fills the first `players` slots of the table and clears the rest.
+size_t WriteRoster(SharedTelemetryBlock* block, int players) {
+  const size_t roster = std::min(static_cast<size_t>(std::max(players, 0)), mccmod::kPlayerTableEntries);
+  for (size_t slot = 0; slot < mccmod::kPlayerTableEntries; ++slot) {
+    if (slot < roster) {
+      WritePlayer(block, slot, "Player " + std::to_string(slot + 1), static_cast<uint8_t>(slot % 2));
+    } else {
+      std::memset(PlayerEntry(block, slot), 0, mccmod::kPlayerEntryStride);
+    }
+  }
+  return roster;
+}
+
+// A sparse module file mapped as an image, plus a second view of it from
+// the next page on.
+struct Module {
+  std::string path;
+  size_t bytes = 0;
+  int fd = -1;
+  char* image = nullptr;
+  char* section_view = nullptr;
+};
+
+bool MapModule(const std::string& path, uintptr_t last_offset, Module* module) {
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  module->path = path;
+  module->bytes = (last_offset + sizeof(uintptr_t) + page - 1) / page * page;
+  module->fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (module->fd < 0 || ftruncate(module->fd, static_cast<off_t>(module->bytes)) != 0) {
+    std::perror("mcc_dummy_target: module file");
+    return false;
+  }
+  void* image = mmap(nullptr, module->bytes, PROT_READ | PROT_WRITE, MAP_SHARED, module->fd, 0);
+  if (image == MAP_FAILED) {
+    std::perror("mcc_dummy_target: mmap");
+    return false;
+  }
+  module->image = static_cast<char*>(image);
+  // "MZ", e_lfanew, and the PE signature it points at.
+  const uint32_t pe_offset = 0x80;
+  module->image[0] = 'M';
+  module->image[1] = 'Z';
+  std::memcpy(module->image + 0x3C, &pe_offset, sizeof(pe_offset));
+  std::memcpy(module->image + pe_offset, "PE\0\0", 4);
+
+  // Below the image, where a lowest-mapping search would take it for the base.
+  void* view = mmap(module->image - 16 * page, page, PROT_READ, MAP_SHARED, module->fd, static_cast<off_t>(page));
+  module->section_view = view == MAP_FAILED ? nullptr : static_cast<char*>(view);
+  return true;
+}
+
+void UnmapModule(Module* module) {
+  if (module->section_view) munmap(module->section_view, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+  if (module->image) munmap(module->image, module->bytes);
+  if (module->fd >= 0) close(module->fd);
+  unlink(module->path.c_str());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int arg = 1;
+  const bool wine = argc > 1 && std::strcmp(argv[1], "--wine") == 0;
+  if (wine) ++arg;
+  const int players = argc > arg ? std::atoi(argv[arg]) : 8;
+  const std::string map = argc > arg + 1 ? argv[arg + 1] : "Powerhouse";
+  const std::string mode = argc > arg + 2 ? argv[arg + 2] : "Slayer";
+
+  const std::string dir = "/tmp/mcc-dummy-" + std::to_string(getpid());
+  if (mkdir(dir.c_str(), 0700) != 0) {
+    std::perror("mcc_dummy_target: mkdir");
+    return 1;
+  }
+  Module mcc;
+  Module reach;
+  if (!MapModule(dir + "/" + mccmod::kMccModuleName, mccmod::kSharedTelemetryBaseOffset, &mcc) ||
+      !MapModule(dir + "/" + mccmod::kReachModuleName, mccmod::kReachPlayerCountOffsets[2], &reach)) {
+    return 1;
+  }
+
+  auto* block = new SharedTelemetryBlock{};
+  WriteString(block, mccmod::kMapNameOffset, map);
+  WriteString(block, mccmod::kModeNameOffsetPrimary, mode);
+  WriteString(block, mccmod::kModeNameOffsetSecondary, mode);
+  size_t roster = WriteRoster(block, players);
+
+  int32_t player_count = players;
+  const auto write_count = [&] {
+    std::memcpy(mcc.image + mccmod::kMccPlayerCountOffset, &player_count, sizeof(player_count));
+    for (const uintptr_t offset : mccmod::kReachPlayerCountOffsets) {
+      std::memcpy(reach.image + offset, &player_count, sizeof(player_count));
+    }
+  };
+  write_count();
+  const uintptr_t block_address = reinterpret_cast<uintptr_t>(block);
+  std::memcpy(mcc.image + mccmod::kSharedTelemetryBaseOffset, &block_address, sizeof(block_address));
+
+  if (wine) {
+    const std::string comm = std::string(mccmod::kMccModuleName).substr(0, 15);
+    prctl(PR_SET_NAME, comm.c_str(), 0, 0, 0);
+  }
+
+  // Yama ptrace_scope=1 only lets ancestors read us; the reader is usually a sibling.
+#if defined(PR_SET_PTRACER)
+  prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);
+#endif
+
+  signal(SIGINT, OnSignal);
+  signal(SIGTERM, OnSignal);
+  signal(SIGUSR1, OnSwapTeam);
+  signal(SIGUSR2, OnPlayerJoined);
+  std::cout << "mcc_dummy_target pid " << getpid() << ": " << players << " players, " << map
+            << " / " << mode << std::endl;
+  uint16_t kills = 0;
+  while (!g_stop) {
+    sleep(1);
+    if (g_player_joined) {
+      g_player_joined = 0;
+      player_count = player_count % 16 + 1;
+      roster = WriteRoster(block, player_count);
+      write_count();
+    }
+    ++kills;
+    for (size_t slot = 0; slot < roster; ++slot) {
+      std::memcpy(PlayerEntry(block, slot) + mccmod::kPlayerEntryKillsOffset, &kills, sizeof(kills));
+    }
+    if (g_swap_team && roster > 0) {
+      g_swap_team = 0;
+      char* team = PlayerEntry(block, roster - 1) + mccmod::kPlayerEntryTeamOffset;
+      *team = static_cast<char>(*team ^ 1);
+    }
+  }
+
+  UnmapModule(&reach);
+  UnmapModule(&mcc);
+  rmdir(dir.c_str());
+  delete block;
+  return 0;
+}
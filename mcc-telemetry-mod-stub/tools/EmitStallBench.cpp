@@ -0,0 +1,303 @@
+// Stalls the snapshot emitter and measures how far the sampler's ticks
+// stray from their schedule, with output inline on the sampler thread (the
+// reader before the split) and on its own emitter thread fed by a
+// TripleBuffer (the reader now). Prints JSON; exits 1 if a check fails.
+//
+//   mcc_emit_stall_bench [--period-ms N] [--ticks N] [--work-us N] [--stall-ms N] [--stall-every N] [--dir PATH]
+//
+// Each tick busy-works for --work-us like a sample, then hands a snapshot to
+// the emitter. An emit writes the snapshot to a file and renames it into
+// place, like the state file, and every --stall-every-th emit also blocks
+// for --stall-ms, like a slow disk or a blocked console. Jitter is how far
+// each interval between tick starts is off the period; skipped deadlines are
+// counted as missed. The emitter checks that it sees sequence numbers in
+// order and never a torn snapshot.
+#include "LatencyHistogram.h"
+#include "TickScheduler.h"
+#include "TripleBuffer.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+struct Options {
+  uint64_t period_ms = 20;
+  uint64_t ticks = 250;
+  uint64_t work_us = 500;
+  uint64_t stall_ms = 150;
+  uint64_t stall_every = 10;
+  std::string dir;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--period-ms" && has_value) {
+      options->period_ms = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--ticks" && has_value) {
+      options->ticks = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--work-us" && has_value) {
+      options->work_us = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--stall-ms" && has_value) {
+      options->stall_ms = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--stall-every" && has_value) {
+      options->stall_every = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--dir" && has_value) {
+      options->dir = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  return options->period_ms > 0 && options->ticks > 1 && options->stall_every > 0;
+}
+
+uint64_t NowUs() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now().time_since_epoch()).count());
+}
+
+void BusyWork(uint64_t work_us) {
+  const auto until = SteadyClock::now() + std::chrono::microseconds(work_us);
+  while (SteadyClock::now() < until) {
+  }
+}
+
+// Stands in for TickSnapshot: every word of the payload carries the sequence
+// number, so a snapshot read while it was being written shows up as torn.
+struct BenchSnapshot {
+  uint64_t seq = 0;
+  uint64_t capture_us = 0;
+  std::array<uint64_t, 32> payload{};
+};
+
+class Emitter {
+ public:
+  Emitter(const Options& options, const std::filesystem::path& dir)
+      : options_(options), path_(dir / "state.json"), temp_path_(dir / "state.json.tmp") {}
+
+  void Emit(const BenchSnapshot& snapshot) {
+    for (const uint64_t word : snapshot.payload) {
+      if (word != snapshot.seq) ++torn_;
+    }
+    if (snapshot.seq <= last_seq_) ++out_of_order_;
+    last_seq_ = snapshot.seq;
+
+    std::ostringstream json;
+    json << "{\"seq\":" << snapshot.seq << ",\"captureUs\":" << snapshot.capture_us << ",\"payload\":[";
+    for (size_t i = 0; i < snapshot.payload.size(); ++i) json << (i ? "," : "") << snapshot.payload[i];
+    json << "]}\n";
+    {
+      std::ofstream out(temp_path_, std::ios::binary | std::ios::trunc);
+      out << json.str();
+      out.flush();
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path_, path_, error);
+    if (++emitted_ % options_.stall_every == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(options_.stall_ms));
+    }
+    lag_us_.Record(NowUs() - snapshot.capture_us);
+  }
+
+  uint64_t Emitted() const { return emitted_; }
+  uint64_t LastSeq() const { return last_seq_; }
+  uint64_t Torn() const { return torn_; }
+  uint64_t OutOfOrder() const { return out_of_order_; }
+  mccmod::LatencySummary Lag() const { return lag_us_.Summary(); }
+
+ private:
+  const Options& options_;
+  std::filesystem::path path_;
+  std::filesystem::path temp_path_;
+  uint64_t emitted_ = 0;
+  uint64_t last_seq_ = 0;
+  uint64_t torn_ = 0;
+  uint64_t out_of_order_ = 0;
+  mccmod::LatencyHistogram lag_us_;
+};
+
+struct RunResult {
+  mccmod::LatencySummary jitter_us;
+  mccmod::TickSchedulerStats scheduler;
+  mccmod::LatencySummary emit_lag_us;
+  uint64_t emitted = 0;
+  uint64_t last_emitted = 0;
+  uint64_t torn = 0;
+  uint64_t out_of_order = 0;
+};
+
+void FillSnapshot(uint64_t seq, BenchSnapshot* snapshot) {
+  snapshot->seq = seq;
+  snapshot->capture_us = NowUs();
+  snapshot->payload.fill(seq);
+}
+
+RunResult Run(const Options& options, const std::filesystem::path& dir, bool split) {
+  const uint64_t period_us = options.period_ms * 1000;
+  Emitter emitter(options, dir);
+  mccmod::TripleBuffer<BenchSnapshot> ticks;
+  std::atomic<bool> running{true};
+  std::mutex mutex;
+  std::condition_variable wake;
+  bool posted = false;
+
+  // Same shape as the reader's EmitterLoop: drain the newest tick, else wait.
+  std::thread emitter_thread;
+  if (split) {
+    emitter_thread = std::thread([&] {
+      while (true) {
+        if (ticks.Consume()) {
+          emitter.Emit(ticks.ReadSlot());
+          continue;
+        }
+        if (!running.load()) break;
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait_for(lock, std::chrono::milliseconds(options.period_ms), [&] { return posted || !running.load(); });
+        posted = false;
+      }
+    });
+  }
+
+  mccmod::LatencyHistogram jitter_us;
+  mccmod::TickSchedulerOptions scheduler_options;
+  scheduler_options.period_us = period_us;
+  mccmod::TickScheduler scheduler(scheduler_options);
+  BenchSnapshot inline_snapshot;
+  uint64_t previous_start = 0;
+  for (uint64_t seq = 1; seq <= options.ticks; ++seq) {
+    scheduler.WaitNextTick();
+    const uint64_t start = NowUs();
+    if (previous_start != 0) {
+      const uint64_t interval = start - previous_start;
+      jitter_us.Record(interval > period_us ? interval - period_us : period_us - interval);
+    }
+    previous_start = start;
+    BusyWork(options.work_us);
+    if (split) {
+      FillSnapshot(seq, &ticks.WriteSlot());
+      ticks.Publish();
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        posted = true;
+      }
+      wake.notify_one();
+    } else {
+      FillSnapshot(seq, &inline_snapshot);
+      emitter.Emit(inline_snapshot);
+    }
+  }
+  if (split) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      running.store(false);
+    }
+    wake.notify_one();
+    emitter_thread.join();
+  }
+
+  RunResult result;
+  result.jitter_us = jitter_us.Summary();
+  result.scheduler = scheduler.GetStats();
+  result.emit_lag_us = emitter.Lag();
+  result.emitted = emitter.Emitted();
+  result.last_emitted = emitter.LastSeq();
+  result.torn = emitter.Torn();
+  result.out_of_order = emitter.OutOfOrder();
+  return result;
+}
+
+std::string SummaryJson(const mccmod::LatencySummary& summary) {
+  return "{\"p50\":" + std::to_string(summary.p50) + ",\"p99\":" + std::to_string(summary.p99) +
+         ",\"max\":" + std::to_string(summary.max) + "}";
+}
+
+std::string RunJson(const RunResult& result) {
+  return "{\"jitterUs\":" + SummaryJson(result.jitter_us) + ",\"latenessUs\":" +
+         SummaryJson(result.scheduler.lateness_us) + ",\"missed\":" + std::to_string(result.scheduler.missed) +
+         ",\"emitted\":" + std::to_string(result.emitted) + ",\"emitLagUs\":" + SummaryJson(result.emit_lag_us) +
+         ",\"torn\":" + std::to_string(result.torn) + ",\"outOfOrder\":" + std::to_string(result.out_of_order) + "}";
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_emit_stall_bench [--period-ms N] [--ticks N] [--work-us N] [--stall-ms N]"
+                 " [--stall-every N] [--dir PATH]"
+              << std::endl;
+    return 2;
+  }
+  const bool own_dir = options.dir.empty();
+  const std::filesystem::path dir =
+      own_dir ? std::filesystem::temp_directory_path() /
+                    ("mcc_emit_stall_bench." + std::to_string(SteadyClock::now().time_since_epoch().count()))
+              : std::filesystem::path(options.dir);
+  std::error_code error;
+  std::filesystem::create_directories(dir, error);
+  if (!std::filesystem::is_directory(dir)) {
+    std::cerr << "mcc_emit_stall_bench: cannot use " << dir.string() << std::endl;
+    return 2;
+  }
+
+  const RunResult inline_run = Run(options, dir, false);
+  const RunResult split_run = Run(options, dir, true);
+  if (own_dir) std::filesystem::remove_all(dir, error);
+
+  // The stalls are longer than a period, so inline output must cost ticks;
+  // if it does not, the bench is not stalling anything. A stall that reaches
+  // the sampler shows up as a whole period or more of jitter, while a busy
+  // host's late wakeups cost a few milliseconds and the odd tick, so the
+  // split run is held to a period of jitter and a tenth of inline's misses.
+  const uint64_t period_us = options.period_ms * 1000;
+  const bool stalls_cost_ticks = options.stall_ms > options.period_ms;
+  Checks checks;
+  if (stalls_cost_ticks) {
+    checks.Expect(inline_run.scheduler.missed > 0, "inline: stalls cost sampler ticks");
+    checks.Expect(split_run.scheduler.missed * 10 <= inline_run.scheduler.missed,
+                  "split: at most a tenth of inline's missed ticks");
+  }
+  checks.Expect(split_run.jitter_us.p99 < period_us, "split: tick jitter p99 under a period");
+  checks.Expect(split_run.torn == 0 && split_run.out_of_order == 0, "split: snapshots whole and in order");
+  checks.Expect(split_run.last_emitted == options.ticks, "split: newest snapshot emitted at the end");
+  if (stalls_cost_ticks) checks.Expect(split_run.emitted < options.ticks, "split: stalled emits coalesce to the newest");
+
+  std::cout << "{\"periodMs\":" << options.period_ms << ",\"ticks\":" << options.ticks
+            << ",\"workUs\":" << options.work_us << ",\"stallMs\":" << options.stall_ms
+            << ",\"stallEvery\":" << options.stall_every << ",\"inline\":" << RunJson(inline_run)
+            << ",\"split\":" << RunJson(split_run) << ",\"checks\":{\"passed\":" << checks.passed << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
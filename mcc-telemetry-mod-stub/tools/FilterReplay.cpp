@@ -0,0 +1,456 @@
+// Replays reader ticks from a flight recorder ring through the signal filter
+// and reports detection latency and false commits per filter setting.
+// Prints JSON; exits 1 if a check fails.
+//
+//   mcc_filter_replay [--flight PATH] [--ticks N] [--seed S] [--settle-ticks N]
+//                     [--map-filter SPEC] [--mode-filter SPEC] [--player-filter SPEC]
+//
+// Without --flight a synthetic trace of noisy sources is written through
+// FlightRecorder first and replayed from that file, so both paths decode
+// the same records. Ground truth is the trace's own settled value: the
+// per-tick winner among distinct sources, once it holds for --settle-ticks
+// ticks. Committing anything else is a false commit; latency runs from the
+// first tick of a settled value to the tick the filter commits it.
+//
+// Each signal runs three filters: "streak" (fast commit off), "configured"
+// (the reader's defaults, or SPEC in the HMCC_READER_*_FILTER format) and
+// "perReading" (configured, but every reading counted as its own source, as
+// the reader did before both mode offsets became one source).
+#include "FlightRecorder.h"
+#include "SignalFilter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+using IntCandidates = mccmod::SignalCandidates<int>;
+using StringCandidates = mccmod::SignalCandidates<std::string>;
+
+constexpr uint64_t kTickMs = 200;
+
+struct Options {
+  std::string flight_path;
+  size_t ticks = 30000;
+  uint64_t seed = 1;
+  size_t settle_ticks = 5;
+  mccmod::SignalFilterConfig map_filter = mccmod::kMapFilterDefaults;
+  mccmod::SignalFilterConfig mode_filter = mccmod::kModeFilterDefaults;
+  mccmod::SignalFilterConfig player_filter = mccmod::kPlayerFilterDefaults;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--flight" && has_value) {
+      options->flight_path = argv[++i];
+    } else if (arg == "--ticks" && has_value) {
+      options->ticks = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--seed" && has_value) {
+      options->seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--settle-ticks" && has_value) {
+      options->settle_ticks = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--map-filter" && has_value) {
+      if (!mccmod::ParseSignalFilterConfig(argv[++i], &options->map_filter)) return false;
+    } else if (arg == "--mode-filter" && has_value) {
+      if (!mccmod::ParseSignalFilterConfig(argv[++i], &options->mode_filter)) return false;
+    } else if (arg == "--player-filter" && has_value) {
+      if (!mccmod::ParseSignalFilterConfig(argv[++i], &options->player_filter)) return false;
+    } else {
+      return false;
+    }
+  }
+  return options->ticks > 0 && options->settle_ticks > 0;
+}
+
+// One reader tick's candidates, rebuilt from a flight record.
+struct TickInput {
+  uint64_t steady_ms = 0;
+  bool connected = false;
+  IntCandidates players;
+  StringCandidates map;
+  StringCandidates mode;
+};
+
+std::string FlightText(const char (&text)[mccmod::kFlightNameBytes]) {
+  return std::string(text, strnlen(text, mccmod::kFlightNameBytes));
+}
+
+TickInput FromRecord(const mccmod::FlightRecord& record) {
+  TickInput tick;
+  tick.steady_ms = record.steady_ms;
+  tick.connected = (record.flags & mccmod::kFlightConnected) != 0;
+  // Without a source mask (version 1 files) each candidate is taken as its own source.
+  uint8_t source = 0;
+  for (uint8_t i = 0; i < record.player_candidate_count && i < mccmod::kFlightPlayerSources; ++i) {
+    if (record.player_source_mask != 0) {
+      while (source < mccmod::kFlightPlayerSources && !(record.player_source_mask & (1u << source))) ++source;
+    }
+    tick.players.Add(record.player_candidates[i], record.player_source_mask != 0 ? source++ : i);
+  }
+  if (record.map_candidate_count > 0) tick.map.Add(FlightText(record.map_candidate), 0);
+  for (uint8_t i = 0; i < record.mode_candidate_count && i < mccmod::kFlightModeSources; ++i) {
+    tick.mode.Add(FlightText(record.mode_candidates[i]), 0);
+  }
+  return tick;
+}
+
+// A lobby drifting through player counts, maps and modes, read through
+// sources with the faults the reader sees: failed reads, garbage, the Reach
+// counts lagging a tick, and torn updates that several sources read alike.
+// The two mode offsets are one field, so they fail and glitch together.
+bool WriteSyntheticTrace(const Options& options, const std::string& path) {
+  static const char* const kMaps[] = {"Sword Base", "Powerhouse", "Countdown", "Boardwalk",
+                                      "Zealot",     "Reflection", "Spire",     "Forge World"};
+  static const char* const kModes[] = {"Slayer",  "Team Slayer",      "Infection",
+                                       "Oddball", "Capture the Flag", "King of the Hill"};
+  constexpr size_t kMapCount = sizeof(kMaps) / sizeof(kMaps[0]);
+  constexpr size_t kModeCount = sizeof(kModes) / sizeof(kModes[0]);
+  constexpr size_t kReachLag[3] = {0, 0, 1};
+  constexpr size_t kMinHoldTicks = 10;  // lobbies do not change count faster than every 2 s
+
+  mccmod::FlightRecorder recorder;
+  if (!recorder.Open(path, static_cast<uint32_t>(options.ticks))) return false;
+  std::mt19937_64 rng(options.seed);
+  std::uniform_real_distribution<double> roll(0.0, 1.0);
+  auto chance = [&](double p) { return roll(rng) < p; };
+
+  std::vector<int> players_history;
+  int players = 0;
+  size_t held = 0;
+  size_t map = 0;
+  size_t mode = 0;
+  for (size_t t = 0; t < options.ticks; ++t) {
+    if (++held >= kMinHoldTicks && chance(1.0 / 30)) {
+      players = std::clamp(players + static_cast<int>(rng() % 6) - 2, 0, 16);
+      held = 0;
+    }
+    if (chance(1.0 / 1500)) {
+      map = (map + 1 + rng() % (kMapCount - 1)) % kMapCount;
+      if (chance(0.5)) mode = (mode + 1 + rng() % (kModeCount - 1)) % kModeCount;
+    } else if (chance(1.0 / 1500)) {
+      mode = (mode + 1 + rng() % (kModeCount - 1)) % kModeCount;
+    }
+    players_history.push_back(players);
+
+    mccmod::FlightRecord record;
+    record.steady_ms = 1000 + t * kTickMs;
+    record.wall_ms = static_cast<int64_t>(record.steady_ms);
+    record.flags = mccmod::kFlightConnected;
+    const bool torn_count = chance(0.001);
+    for (uint8_t source = 0; source < 4; ++source) {
+      const size_t lag = source == 0 ? 0 : kReachLag[source - 1];
+      int value = players_history[t >= lag ? t - lag : 0];
+      if (source > 0 && torn_count) value += 1;
+      if (chance(source == 0 ? 0.02 : 0.05)) continue;
+      if (chance(0.005)) value = static_cast<int>(rng() % 25);
+      record.player_candidates[record.player_candidate_count++] = value;
+      record.player_source_mask = static_cast<uint8_t>(record.player_source_mask | (1u << source));
+    }
+
+    if (!chance(0.02)) {
+      const std::string name = kMaps[map];
+      mccmod::CopyFlightString(record.map_candidate, chance(0.003) ? name.substr(0, name.size() / 2) : name);
+      record.map_candidate_count = 1;
+    }
+    const std::string shown = chance(0.004) ? kModes[(mode + 1) % kModeCount] : kModes[mode];
+    if (!chance(0.02)) {
+      mccmod::CopyFlightString(record.mode_candidates[record.mode_candidate_count++], shown);
+      if (!chance(0.01)) mccmod::CopyFlightString(record.mode_candidates[record.mode_candidate_count++], shown);
+    }
+    recorder.Append(record);
+  }
+  recorder.Close();
+  return true;
+}
+
+template <typename T>
+using CandidatesOf = std::function<const mccmod::SignalCandidates<T>&(const TickInput&)>;
+
+// The per-tick winner among distinct sources, and where each run of it that
+// lasted settle_ticks began.
+template <typename T>
+struct Truth {
+  std::vector<bool> settled;  // a settled value applies at this tick
+  std::vector<T> value;
+  std::vector<size_t> starts;
+};
+
+template <typename T>
+Truth<T> SettledTruth(const std::vector<TickInput>& ticks, const CandidatesOf<T>& candidates, size_t settle) {
+  const size_t n = ticks.size();
+  std::vector<bool> has(n, false);
+  std::vector<T> winner(n);
+  for (size_t t = 0; t < n; ++t) {
+    if (!ticks[t].connected) continue;
+    const auto consensus = mccmod::ComputeConsensus(candidates(ticks[t]));
+    if (consensus.value) {
+      has[t] = true;
+      winner[t] = *consensus.value;
+    } else if (t > 0 && has[t - 1]) {
+      // A tick without readings does not break a run, as it does not break the filter's streak.
+      has[t] = true;
+      winner[t] = winner[t - 1];
+    }
+  }
+
+  Truth<T> truth;
+  truth.settled.assign(n, false);
+  truth.value.resize(n);
+  bool current = false;
+  T value{};
+  for (size_t t = 0; t < n;) {
+    size_t end = t + 1;
+    while (end < n && has[t] && has[end] && ticks[end].connected && winner[end] == winner[t]) ++end;
+    if (!ticks[t].connected) {
+      current = false;
+    } else if (has[t] && end - t >= settle) {
+      if (!current || winner[t] != value) truth.starts.push_back(t);
+      current = true;
+      value = winner[t];
+    }
+    for (size_t i = t; i < end; ++i) {
+      truth.settled[i] = current;
+      truth.value[i] = value;
+    }
+    t = end;
+  }
+  return truth;
+}
+
+struct FilterResult {
+  uint64_t commits = 0;
+  uint64_t false_commits = 0;
+  uint64_t settled = 0;
+  uint64_t missed = 0;
+  std::vector<uint64_t> latency_ticks;
+  std::vector<uint64_t> latency_ms;
+  double ns_per_tick = 0.0;
+};
+
+template <typename T>
+FilterResult RunFilter(const std::vector<TickInput>& ticks, const CandidatesOf<T>& candidates, const Truth<T>& truth,
+                       const mccmod::SignalFilterConfig& config, bool per_reading) {
+  const size_t n = ticks.size();
+  std::vector<bool> has(n, false);
+  std::vector<T> committed(n);
+  mccmod::StableSignal<T> signal(config, T{});
+  mccmod::SignalCandidates<T> renumbered;
+  const auto start = SteadyClock::now();
+  for (size_t t = 0; t < n; ++t) {
+    if (!ticks[t].connected) {
+      signal.Reset();
+      continue;
+    }
+    const mccmod::SignalCandidates<T>* input = &candidates(ticks[t]);
+    if (per_reading) {
+      renumbered = *input;
+      for (size_t i = 0; i < renumbered.count; ++i) renumbered.sources[i] = static_cast<uint8_t>(i);
+      input = &renumbered;
+    }
+    committed[t] = signal.Update(*input, ticks[t].steady_ms);
+    has[t] = signal.HasStable();
+  }
+  FilterResult result;
+  result.ns_per_tick = std::chrono::duration<double, std::nano>(SteadyClock::now() - start).count() /
+                       static_cast<double>(std::max<size_t>(n, 1));
+
+  for (size_t t = 0; t < n; ++t) {
+    if (!has[t] || (t > 0 && has[t - 1] && committed[t] == committed[t - 1])) continue;
+    ++result.commits;
+    if (!truth.settled[t] || committed[t] != truth.value[t]) ++result.false_commits;
+  }
+  for (size_t k = 0; k < truth.starts.size(); ++k) {
+    const size_t begin = truth.starts[k];
+    const size_t end = k + 1 < truth.starts.size() ? truth.starts[k + 1] : n;
+    ++result.settled;
+    size_t t = begin;
+    while (t < end && !(has[t] && committed[t] == truth.value[begin])) ++t;
+    if (t == end) {
+      ++result.missed;
+      continue;
+    }
+    result.latency_ticks.push_back(t - begin);
+    result.latency_ms.push_back(ticks[t].steady_ms - ticks[begin].steady_ms);
+  }
+  return result;
+}
+
+uint64_t Percentile(std::vector<uint64_t> samples, double q) {
+  if (samples.empty()) return 0;
+  std::sort(samples.begin(), samples.end());
+  return samples[static_cast<size_t>(q * static_cast<double>(samples.size() - 1) + 0.5)];
+}
+
+std::string ResultJson(const FilterResult& result) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(4) << "{\"commits\":" << result.commits
+      << ",\"falseCommits\":" << result.false_commits << ",\"falseCommitRate\":"
+      << (result.commits ? static_cast<double>(result.false_commits) / static_cast<double>(result.commits) : 0.0)
+      << ",\"settled\":" << result.settled << ",\"missed\":" << result.missed << ",\"latencyTicks\":{\"p50\":"
+      << Percentile(result.latency_ticks, 0.5) << ",\"p90\":" << Percentile(result.latency_ticks, 0.9)
+      << ",\"max\":" << Percentile(result.latency_ticks, 1.0) << "},\"latencyMs\":{\"p50\":"
+      << Percentile(result.latency_ms, 0.5) << ",\"p90\":" << Percentile(result.latency_ms, 0.9)
+      << "}" << std::setprecision(1) << ",\"nsPerTick\":" << result.ns_per_tick << "}";
+  return out.str();
+}
+
+struct SignalResults {
+  FilterResult streak;
+  FilterResult configured;
+  FilterResult per_reading;
+};
+
+template <typename T>
+SignalResults ReplaySignal(const std::vector<TickInput>& ticks, const CandidatesOf<T>& candidates,
+                           const mccmod::SignalFilterConfig& config, size_t settle) {
+  const Truth<T> truth = SettledTruth(ticks, candidates, settle);
+  mccmod::SignalFilterConfig streak = config;
+  streak.fast_commit = false;
+  SignalResults results;
+  results.streak = RunFilter(ticks, candidates, truth, streak, false);
+  results.configured = RunFilter(ticks, candidates, truth, config, false);
+  results.per_reading = RunFilter(ticks, candidates, truth, config, true);
+  return results;
+}
+
+std::string SignalJson(const SignalResults& results, const mccmod::SignalFilterConfig& config) {
+  return "{\"config\":\"" + mccmod::FormatSignalFilterConfig(config) + "\",\"streak\":" +
+         ResultJson(results.streak) + ",\"configured\":" + ResultJson(results.configured) +
+         ",\"perReading\":" + ResultJson(results.per_reading) + "}";
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+bool SameConfig(const mccmod::SignalFilterConfig& a, const mccmod::SignalFilterConfig& b) {
+  return a.streak_ticks == b.streak_ticks && a.conflict_ticks == b.conflict_ticks &&
+         a.fast_min_sources == b.fast_min_sources && a.fast_confidence == b.fast_confidence &&
+         a.fast_commit == b.fast_commit;
+}
+
+// The filter pieces the replay numbers rest on.
+void CheckFilter(Checks* checks) {
+  mccmod::SignalFilterConfig config;
+  checks->Expect(mccmod::ParseSignalFilterConfig(mccmod::FormatSignalFilterConfig(mccmod::kPlayerFilterDefaults),
+                                                 &config) &&
+                     SameConfig(config, mccmod::kPlayerFilterDefaults),
+                 "filter spec round trip");
+  checks->Expect(mccmod::ParseSignalFilterConfig("streak=5", &config) && config.streak_ticks == 5 &&
+                     config.fast_min_sources == mccmod::kPlayerFilterDefaults.fast_min_sources,
+                 "partial spec keeps the other keys");
+  checks->Expect(!mccmod::ParseSignalFilterConfig("streak=0", &config) &&
+                     !mccmod::ParseSignalFilterConfig("confidence=1.5", &config) &&
+                     !mccmod::ParseSignalFilterConfig("speed=1", &config) && config.streak_ticks == 5,
+                 "bad specs rejected");
+
+  StringCandidates one_source;
+  one_source.Add("Slayer", 0);
+  one_source.Add("Slayer", 0);
+  StringCandidates two_sources;
+  two_sources.Add("Slayer", 0);
+  two_sources.Add("Slayer", 1);
+  auto ticks_to_commit = [](const StringCandidates& candidates) {
+    mccmod::StableSignal<std::string> mode(mccmod::kModeFilterDefaults, "Unknown");
+    int ticks = 0;
+    while (!mode.HasStable() && ticks < 100) mode.Update(candidates, static_cast<uint64_t>(++ticks));
+    return ticks;
+  };
+  checks->Expect(ticks_to_commit(one_source) == mccmod::kModeFilterDefaults.streak_ticks,
+                 "two readings of one source need a streak");
+  checks->Expect(ticks_to_commit(two_sources) == 1, "two agreeing sources fast-commit");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_filter_replay [--flight PATH] [--ticks N] [--seed S] [--settle-ticks N]\n"
+                 "                         [--map-filter SPEC] [--mode-filter SPEC] [--player-filter SPEC]"
+              << std::endl;
+    return 2;
+  }
+
+  const bool synthetic = options.flight_path.empty();
+  const std::string path =
+      synthetic ? (std::filesystem::temp_directory_path() /
+                   ("mcc_filter_replay." + std::to_string(SteadyClock::now().time_since_epoch().count()) + ".bin"))
+                      .string()
+                : options.flight_path;
+  if (synthetic && !WriteSyntheticTrace(options, path)) {
+    std::cerr << "mcc_filter_replay: cannot write " << path << std::endl;
+    return 1;
+  }
+  std::vector<mccmod::FlightRecord> records;
+  std::string error;
+  const bool read = mccmod::ReadFlightRecords(path, &records, &error);
+  if (synthetic) std::filesystem::remove(path);
+  if (!read) {
+    std::cerr << "mcc_filter_replay: " << error << std::endl;
+    return 1;
+  }
+
+  std::vector<TickInput> ticks;
+  ticks.reserve(records.size());
+  for (const auto& record : records) ticks.push_back(FromRecord(record));
+
+  const SignalResults players = ReplaySignal<int>(
+      ticks, [](const TickInput& tick) -> const IntCandidates& { return tick.players; }, options.player_filter,
+      options.settle_ticks);
+  const SignalResults map = ReplaySignal<std::string>(
+      ticks, [](const TickInput& tick) -> const StringCandidates& { return tick.map; }, options.map_filter,
+      options.settle_ticks);
+  const SignalResults mode = ReplaySignal<std::string>(
+      ticks, [](const TickInput& tick) -> const StringCandidates& { return tick.mode; }, options.mode_filter,
+      options.settle_ticks);
+
+  Checks checks;
+  CheckFilter(&checks);
+  if (synthetic) {
+    checks.Expect(ticks.size() == options.ticks, "synthetic trace read back whole");
+    checks.Expect(players.configured.missed == 0 && map.configured.missed == 0 && mode.configured.missed == 0,
+                  "configured filter detects every settled value");
+    checks.Expect(Percentile(players.configured.latency_ticks, 0.5) < Percentile(players.streak.latency_ticks, 0.5),
+                  "fast commit detects player changes sooner");
+    checks.Expect(mode.configured.false_commits <= mode.streak.false_commits,
+                  "mode glitch on both offsets not fast-committed");
+    checks.Expect(mode.per_reading.false_commits > mode.configured.false_commits,
+                  "counting readings as sources commits mode glitches");
+  }
+
+  std::cout << "{\"source\":\"" << (synthetic ? "synthetic" : "flight") << "\",\"ticks\":" << ticks.size()
+            << ",\"settleTicks\":" << options.settle_ticks << ",\"signals\":{\"players\":"
+            << SignalJson(players, options.player_filter) << ",\"map\":" << SignalJson(map, options.map_filter)
+            << ",\"mode\":" << SignalJson(mode, options.mode_filter) << "},\"checks\":{\"passed\":" << checks.passed
+            << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+// Round-trips snapshots through FixedTelemetrySnapshot: random snapshots
+// that pass ValidateSnapshot must come back byte for byte after a memcpy,
+// and oversized fields must be cut at a UTF-8 boundary and flagged. Prints
+// JSON; exits 1 if a check fails.
+//
+//   mcc_fixed_snapshot_check [--snapshots N] [--seed N]
+#include "FixedTelemetrySnapshot.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using mccmod::FixedTelemetrySnapshot;
+using mccmod::TelemetrySnapshot;
+
+struct Options {
+  int snapshots = 2000;
+  uint32_t seed = 1;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--snapshots" && has_value) {
+      options->snapshots = std::atoi(argv[++i]);
+    } else if (arg == "--seed" && has_value) {
+      options->seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else {
+      return false;
+    }
+  }
+  return options->snapshots > 0;
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+// One UTF-8 character of 1 to 4 bytes, never a NUL.
+std::string RandomCharacter(std::mt19937& rng) {
+  static const char* const kCharacters[] = {"a", "Z", "7", " ", "\"", "\\", "\x01", "\xc3\xa9",
+                                            "\xe2\x9c\x93", "\xf0\x9f\x98\x80"};
+  return kCharacters[rng() % (sizeof(kCharacters) / sizeof(kCharacters[0]))];
+}
+
+// Up to `max_bytes` of whole characters.
+std::string RandomText(std::mt19937& rng, size_t max_bytes) {
+  const size_t target = rng() % (max_bytes + 1);
+  std::string text;
+  while (true) {
+    const std::string next = RandomCharacter(rng);
+    if (text.size() + next.size() > target) break;
+    text += next;
+  }
+  return text;
+}
+
+// Random but valid: every string and list within its schema bounds.
+TelemetrySnapshot RandomSnapshot(std::mt19937& rng) {
+  TelemetrySnapshot snapshot;
+  snapshot.is_custom_game = rng() % 2 == 0;
+  snapshot.map_name = "m" + RandomText(rng, 63);
+  snapshot.game_mode = "g" + RandomText(rng, 63);
+  snapshot.playlist = RandomText(rng, 64);
+  snapshot.max_players = static_cast<int>(rng() % 33);
+  snapshot.player_count = snapshot.max_players > 0 ? static_cast<int>(rng() % (snapshot.max_players + 1)) : 0;
+  snapshot.host_name = RandomText(rng, 64);
+  const size_t mods = rng() % 33;
+  size_t total = 0;
+  for (size_t i = 0; i < mods; ++i) {
+    // The index and a ':' no random character produces keep the items distinct.
+    const std::string item = std::to_string(i) + ":" + RandomText(rng, 40);
+    if (total + item.size() > mccmod::kTelemetryListMaxBytes) break;
+    total += item.size();
+    snapshot.mods.push_back(item);
+  }
+  snapshot.mods_fingerprint = RandomText(rng, 16);
+  snapshot.timestamp_utc = RandomText(rng, 32);
+  snapshot.session_id = RandomText(rng, 128);
+  return snapshot;
+}
+
+bool SameSnapshot(const TelemetrySnapshot& a, const TelemetrySnapshot& b) {
+  return mccmod::BuildTelemetryEnvelopeJson(a) == mccmod::BuildTelemetryEnvelopeJson(b);
+}
+
+// Through raw bytes, as a trace file or shared memory would carry it.
+FixedTelemetrySnapshot CopyThroughBytes(const FixedTelemetrySnapshot& fixed) {
+  unsigned char bytes[sizeof(FixedTelemetrySnapshot)];
+  std::memcpy(bytes, &fixed, sizeof(bytes));
+  FixedTelemetrySnapshot copy;
+  std::memcpy(&copy, bytes, sizeof(bytes));
+  return copy;
+}
+
+bool IsWholeUtf8(const std::string& text) {
+  size_t i = 0;
+  while (i < text.size()) {
+    const unsigned char lead = static_cast<unsigned char>(text[i]);
+    const size_t length = lead < 0x80 ? 1 : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+    if (length == 0 || i + length > text.size()) return false;
+    i += length;
+  }
+  return true;
+}
+
+void CheckRandomRoundTrips(const Options& options, Checks* checks) {
+  std::mt19937 rng(options.seed);
+  int invalid = 0;
+  int flagged = 0;
+  int mismatched = 0;
+  for (int i = 0; i < options.snapshots; ++i) {
+    const TelemetrySnapshot snapshot = RandomSnapshot(rng);
+    std::string error;
+    if (!mccmod::ValidateSnapshot(snapshot, &error)) {
+      ++invalid;
+      continue;
+    }
+    FixedTelemetrySnapshot fixed;
+    if (!mccmod::ToFixedSnapshot(snapshot, &fixed) || fixed.truncated != 0) ++flagged;
+    TelemetrySnapshot back;
+    mccmod::FromFixedSnapshot(CopyThroughBytes(fixed), &back);
+    if (!SameSnapshot(snapshot, back)) ++mismatched;
+  }
+  checks->Expect(invalid == 0, "random snapshots pass ValidateSnapshot");
+  checks->Expect(flagged == 0, "valid snapshots convert without truncation");
+  checks->Expect(mismatched == 0, "valid snapshots round-trip exactly through memcpy");
+}
+
+void CheckAtBounds(Checks* checks) {
+  TelemetrySnapshot snapshot;
+  snapshot.is_custom_game = true;
+  snapshot.map_name = std::string(62, 'a') + "\xc3\xa9";
+  snapshot.game_mode = std::string(64, 'g');
+  snapshot.session_id = std::string(128, 's');
+  snapshot.mods = {std::string(128, 'w'), std::string(128, 'x'), std::string(128, 'y'), std::string(128, 'z')};
+  std::string error;
+  FixedTelemetrySnapshot fixed;
+  TelemetrySnapshot back;
+  const bool converted = mccmod::ValidateSnapshot(snapshot, &error) && mccmod::ToFixedSnapshot(snapshot, &fixed);
+  mccmod::FromFixedSnapshot(CopyThroughBytes(fixed), &back);
+  checks->Expect(converted && SameSnapshot(snapshot, back), "fields at their bounds round-trip");
+
+  // 32 one-byte mods: the most items, with room left in the blob.
+  snapshot.mods.clear();
+  for (char c = 'A'; c < 'A' + 32; ++c) snapshot.mods.push_back(std::string(1, c));
+  const bool most = mccmod::ValidateSnapshot(snapshot, &error) && mccmod::ToFixedSnapshot(snapshot, &fixed);
+  mccmod::FromFixedSnapshot(fixed, &back);
+  checks->Expect(most && back.mods == snapshot.mods, "most mods round-trip");
+}
+
+void CheckTruncation(Checks* checks) {
+  TelemetrySnapshot snapshot;
+  snapshot.is_custom_game = true;
+  // The 64-byte cut lands inside the two-byte character, which must go whole.
+  snapshot.map_name = std::string(63, 'a') + "\xc3\xa9";
+  snapshot.game_mode = "Slayer";
+  FixedTelemetrySnapshot fixed;
+  const bool whole = mccmod::ToFixedSnapshot(snapshot, &fixed);
+  checks->Expect(!whole && fixed.IsTruncated(mccmod::kTelemetryField_map_name) &&
+                     !fixed.IsTruncated(mccmod::kTelemetryField_game_mode),
+                 "oversized string flagged, others not");
+  checks->Expect(fixed.map_name.View() == std::string(63, 'a'), "string cut before a split character");
+
+  std::mt19937 rng(7);
+  bool prefixes = true;
+  for (int i = 0; i < 500; ++i) {
+    std::string text;
+    while (text.size() <= 64) text += RandomCharacter(rng);
+    mccmod::FixedString<64> cut;
+    const bool fits = cut.Assign(text);
+    const std::string kept(cut.View());
+    prefixes = prefixes && !fits && text.compare(0, kept.size(), kept) == 0 && IsWholeUtf8(kept) &&
+               kept.size() > 64 - 4;
+  }
+  checks->Expect(prefixes, "random oversized strings cut to a whole-character prefix");
+
+  snapshot.map_name = "Zealot";
+  snapshot.mods.clear();
+  for (int i = 0; i < 40; ++i) snapshot.mods.push_back("mod" + std::to_string(i));
+  mccmod::ToFixedSnapshot(snapshot, &fixed);
+  TelemetrySnapshot back;
+  mccmod::FromFixedSnapshot(fixed, &back);
+  checks->Expect(fixed.IsTruncated(mccmod::kTelemetryField_mods) && back.mods.size() == 32 &&
+                     back.mods.front() == "mod0" && back.mods.back() == "mod31",
+                 "mods over the item bound keep the first 32 and are flagged");
+
+  mccmod::FixedStringList<4, 16> list;
+  const bool refused_long = !list.Append(std::string(256, 'x'));
+  list.Append("0123456789");
+  const bool refused_full = !list.Append("abcdef");
+  checks->Expect(refused_long && refused_full && list.count == 1 && list.used == 11,
+                 "list refuses an item that does not fit and stays unchanged");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_fixed_snapshot_check [--snapshots N] [--seed N]" << std::endl;
+    return 2;
+  }
+
+  Checks checks;
+  CheckRandomRoundTrips(options, &checks);
+  CheckAtBounds(&checks);
+  CheckTruncation(&checks);
+
+  std::cout << "{\"snapshots\":" << options.snapshots << ",\"seed\":" << options.seed
+            << ",\"sizeBytes\":" << sizeof(FixedTelemetrySnapshot) << ",\"checks\":{\"passed\":" << checks.passed
+            << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
@@ -0,0 +1,25 @@
+// Decodes a reader flight recorder ring file to JSONL, oldest tick first.
+#include "FlightRecorder.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "usage: mcc_flight_dump <reader_flight.bin>" << std::endl;
+    return 2;
+  }
+
+  std::vector<mccmod::FlightRecord> records;
+  std::string error;
+  if (!mccmod::ReadFlightRecords(argv[1], &records, &error)) {
+    std::cerr << "mcc_flight_dump: " << error << std::endl;
+    return 1;
+  }
+
+  for (const auto& record : records) {
+    std::cout << mccmod::FlightRecordToJson(record) << '\n';
+  }
+  return 0;
+}
@@ -0,0 +1,359 @@
+// Drives FlightRecorder with a synthetic producer and checks what a reader
+// of the ring sees: record order and field round trip, torn records dropped,
+// and a producer SIGKILLed mid-append leaving a consistent, contiguous tail
+// that a reopened recorder continues. Prints JSON; exits 1 if a check fails.
+//
+//   mcc_flight_check [--capacity N] [--records N] [--kills N] [--dir PATH]
+//
+// Every record's fields are derived from its seq, so any record read back
+// can be checked whole against the one that was written. Torn records are
+// made by hand in the file, the way a crash leaves them: a slot whose
+// payload is half the new record and half the old one, and a slot with the
+// new payload whose commit_seq was never written.
+#include "FlightRecorder.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+  uint32_t capacity = 64;
+  uint64_t records = 150;
+  int kills = 100;
+  std::string dir;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--capacity" && has_value) {
+      options->capacity = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--records" && has_value) {
+      options->records = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--kills" && has_value) {
+      options->kills = std::atoi(argv[++i]);
+    } else if (arg == "--dir" && has_value) {
+      options->dir = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  // The torn-record checks need the ring to have wrapped.
+  return options->capacity > 1 && options->records > options->capacity && options->kills >= 0;
+}
+
+// The record the producer writes for `seq`; seq and commit_seq are Append's.
+mccmod::FlightRecord MakeRecord(uint64_t seq) {
+  mccmod::FlightRecord record;
+  record.steady_ms = 1000 + seq * 200;
+  record.wall_ms = 1700000000000 + static_cast<int64_t>(seq) * 200;
+  record.pid = 4242;
+  record.flags = static_cast<uint8_t>(seq & 0x1F);
+  record.player_candidate_count = static_cast<uint8_t>(seq % (mccmod::kFlightPlayerSources + 1));
+  for (size_t i = 0; i < mccmod::kFlightPlayerSources; ++i) {
+    record.player_candidates[i] = static_cast<int32_t>((seq + i) % 17);
+  }
+  record.player_source_mask = static_cast<uint8_t>((1u << record.player_candidate_count) - 1);
+  record.player_count = static_cast<int32_t>(seq % 17);
+  record.map_confidence = static_cast<float>(seq % 100) / 100.0f;
+  record.mode_confidence = static_cast<float>((seq + 1) % 100) / 100.0f;
+  record.player_confidence = static_cast<float>((seq + 2) % 100) / 100.0f;
+  record.read_us = static_cast<uint32_t>(seq % 1000);
+  record.filter_us = static_cast<uint32_t>(seq % 500);
+  record.tick_us = static_cast<uint32_t>(seq % 2000);
+  record.map_candidate_count = 1;
+  record.mode_candidate_count = 2;
+  mccmod::CopyFlightString(record.map_candidate, "Map " + std::to_string(seq));
+  mccmod::CopyFlightString(record.mode_candidates[0], "Mode " + std::to_string(seq));
+  mccmod::CopyFlightString(record.mode_candidates[1], "Mode " + std::to_string(seq + 1));
+  mccmod::CopyFlightString(record.map_name, "Committed map " + std::to_string(seq / 10));
+  mccmod::CopyFlightString(record.mode_name, "Committed mode " + std::to_string(seq / 10));
+  return record;
+}
+
+bool SameText(const char (&a)[mccmod::kFlightNameBytes], const char (&b)[mccmod::kFlightNameBytes]) {
+  return std::strncmp(a, b, mccmod::kFlightNameBytes) == 0;
+}
+
+// True if `record` is exactly what the producer wrote for its seq.
+bool MatchesWritten(const mccmod::FlightRecord& record) {
+  const mccmod::FlightRecord expected = MakeRecord(record.seq);
+  bool same = record.commit_seq == record.seq && record.steady_ms == expected.steady_ms &&
+              record.wall_ms == expected.wall_ms && record.pid == expected.pid && record.flags == expected.flags &&
+              record.player_candidate_count == expected.player_candidate_count &&
+              record.player_source_mask == expected.player_source_mask &&
+              record.player_count == expected.player_count && record.map_confidence == expected.map_confidence &&
+              record.mode_confidence == expected.mode_confidence &&
+              record.player_confidence == expected.player_confidence && record.read_us == expected.read_us &&
+              record.filter_us == expected.filter_us && record.tick_us == expected.tick_us &&
+              record.map_candidate_count == expected.map_candidate_count &&
+              record.mode_candidate_count == expected.mode_candidate_count &&
+              SameText(record.map_candidate, expected.map_candidate) &&
+              SameText(record.mode_candidates[0], expected.mode_candidates[0]) &&
+              SameText(record.mode_candidates[1], expected.mode_candidates[1]) &&
+              SameText(record.map_name, expected.map_name) && SameText(record.mode_name, expected.mode_name);
+  for (size_t i = 0; i < mccmod::kFlightPlayerSources; ++i) {
+    same = same && record.player_candidates[i] == expected.player_candidates[i];
+  }
+  return same;
+}
+
+// What a reader of the ring got: records whole, seqs contiguous, and the range.
+struct RingView {
+  bool read = false;
+  size_t count = 0;
+  uint64_t first = 0;
+  uint64_t last = 0;
+  bool whole = true;
+  bool contiguous = true;
+};
+
+RingView ReadRing(const std::string& path) {
+  RingView view;
+  std::vector<mccmod::FlightRecord> records;
+  std::string error;
+  view.read = mccmod::ReadFlightRecords(path, &records, &error);
+  view.count = records.size();
+  for (size_t i = 0; i < records.size(); ++i) {
+    view.whole = view.whole && MatchesWritten(records[i]);
+    if (i > 0) view.contiguous = view.contiguous && records[i].seq == records[i - 1].seq + 1;
+  }
+  if (!records.empty()) {
+    view.first = records.front().seq;
+    view.last = records.back().seq;
+  }
+  return view;
+}
+
+mccmod::FlightFileHeader ReadHeader(const std::string& path) {
+  mccmod::FlightFileHeader header;
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd >= 0) {
+    if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) header = {};
+    close(fd);
+  }
+  return header;
+}
+
+off_t SlotOffset(uint64_t seq, uint32_t capacity) {
+  return static_cast<off_t>(sizeof(mccmod::FlightFileHeader) + ((seq - 1) % capacity) * sizeof(mccmod::FlightRecord));
+}
+
+// Writes `length` bytes of `record` over the slot `seq` maps to, as a crashed
+// Append would have left them; the header's next_seq is not advanced.
+bool WriteSlot(const std::string& path, uint32_t capacity, const mccmod::FlightRecord& record, size_t length) {
+  const int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  const bool ok = pwrite(fd, &record, length, SlotOffset(record.seq, capacity)) == static_cast<ssize_t>(length);
+  close(fd);
+  return ok;
+}
+
+// Slots holding a record whose commit_seq does not match: torn by a crash.
+size_t CountTornSlots(const std::string& path, uint32_t capacity) {
+  size_t torn = 0;
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return torn;
+  mccmod::FlightRecord record;
+  for (uint32_t i = 0; i < capacity; ++i) {
+    const off_t offset = static_cast<off_t>(sizeof(mccmod::FlightFileHeader) + i * sizeof(record));
+    if (pread(fd, &record, sizeof(record), offset) != static_cast<ssize_t>(sizeof(record))) break;
+    if (record.seq != 0 && record.commit_seq != record.seq) ++torn;
+  }
+  close(fd);
+  return torn;
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+void CheckRoundTrip(const Options& options, const std::string& path, Checks* checks) {
+  std::filesystem::remove(path);
+  mccmod::FlightRecorder recorder;
+  checks->Expect(recorder.Open(path, options.capacity), "round trip: ring opened");
+  for (uint64_t seq = 1; seq <= options.records; ++seq) recorder.Append(MakeRecord(seq));
+  recorder.Close();
+
+  const RingView view = ReadRing(path);
+  checks->Expect(view.read && view.count == options.capacity, "round trip: a full ring of records");
+  checks->Expect(view.first == options.records - options.capacity + 1 && view.last == options.records,
+                 "round trip: the newest records kept");
+  checks->Expect(view.whole, "round trip: every field read back as written");
+  checks->Expect(view.contiguous, "round trip: records in seq order");
+}
+
+// Continues the ring from CheckRoundTrip.
+void CheckTornRecords(const Options& options, const std::string& path, Checks* checks) {
+  const uint64_t next = options.records + 1;
+
+  // Half the new record over the oldest one: the new seq, the old commit_seq.
+  mccmod::FlightRecord half = MakeRecord(next);
+  half.seq = next;
+  half.commit_seq = next;
+  checks->Expect(WriteSlot(path, options.capacity, half, sizeof(half) / 2), "torn: half record written");
+  RingView view = ReadRing(path);
+  checks->Expect(view.count == options.capacity - 1 && view.whole && view.contiguous &&
+                     view.first == options.records - options.capacity + 2 && view.last == options.records,
+                 "torn: half-written record dropped");
+
+  // The whole payload, but commit_seq never set.
+  mccmod::FlightRecord uncommitted = half;
+  uncommitted.commit_seq = 0;
+  checks->Expect(WriteSlot(path, options.capacity, uncommitted, sizeof(uncommitted)), "torn: record written");
+  view = ReadRing(path);
+  checks->Expect(view.count == options.capacity - 1 && view.whole && view.contiguous && view.last == options.records,
+                 "torn: uncommitted record dropped");
+
+  // A reopened recorder overwrites the torn slot with the seq it would have had.
+  mccmod::FlightRecorder recorder;
+  checks->Expect(recorder.Open(path, options.capacity), "torn: ring reopened");
+  recorder.Append(MakeRecord(next));
+  recorder.Close();
+  view = ReadRing(path);
+  checks->Expect(view.count == options.capacity && view.whole && view.contiguous && view.last == next,
+                 "torn: reopened ring continues at the torn seq");
+}
+
+struct KillResult {
+  int rounds = 0;
+  int torn_seen = 0;
+  uint64_t records = 0;
+};
+
+// Forks a producer that appends as fast as it can, SIGKILLs it mid-loop, and
+// checks the ring it left and that a reopened recorder carries on.
+KillResult CheckKilledProducer(const Options& options, const std::string& path, Checks* checks) {
+  KillResult result;
+  std::mt19937 rng(7);
+  bool whole = true;
+  bool contiguous = true;
+  bool tail_committed = true;
+  bool continues = true;
+  for (int round = 0; round < options.kills; ++round) {
+    std::filesystem::remove(path);
+    int ready[2];
+    if (pipe(ready) != 0) break;
+    const pid_t child = fork();
+    if (child < 0) {
+      close(ready[0]);
+      close(ready[1]);
+      break;
+    }
+    if (child == 0) {
+      close(ready[0]);
+      mccmod::FlightRecorder recorder;
+      if (!recorder.Open(path, options.capacity)) _exit(1);
+      for (uint64_t seq = 1;; ++seq) {
+        recorder.Append(MakeRecord(seq));
+        if (seq == options.capacity) {
+          const char byte = 1;
+          if (write(ready[1], &byte, 1) != 1) _exit(1);
+          close(ready[1]);
+        }
+      }
+    }
+    close(ready[1]);
+    char byte = 0;
+    const bool wrapped = read(ready[0], &byte, 1) == 1;
+    close(ready[0]);
+    std::this_thread::sleep_for(std::chrono::microseconds(rng() % 3000));
+    kill(child, SIGKILL);
+    int status = 0;
+    waitpid(child, &status, 0);
+    if (!wrapped) {
+      checks->Expect(false, "killed producer: child did not fill the ring");
+      continue;
+    }
+    ++result.rounds;
+
+    const size_t torn = CountTornSlots(path, options.capacity);
+    if (torn > 0) ++result.torn_seen;
+    const mccmod::FlightFileHeader header = ReadHeader(path);
+    const RingView view = ReadRing(path);
+    result.records += view.count;
+    whole = whole && view.read && view.whole && torn <= 1;
+    contiguous = contiguous && view.contiguous && view.count + torn == options.capacity;
+    // The kill can land after a commit and before the header moved on, never the other way.
+    tail_committed = tail_committed && (view.last == header.next_seq || view.last == header.next_seq + 1);
+
+    mccmod::FlightRecorder recorder;
+    const bool reopened = recorder.Open(path, options.capacity);
+    recorder.Append(MakeRecord(header.next_seq + 1));
+    recorder.Close();
+    const RingView after = ReadRing(path);
+    continues = continues && reopened && after.whole && after.contiguous && after.last == header.next_seq + 1 &&
+                after.count == options.capacity;
+  }
+  checks->Expect(result.rounds == options.kills, "killed producer: every round ran");
+  checks->Expect(whole, "killed producer: surviving records whole, at most one torn slot");
+  checks->Expect(contiguous, "killed producer: surviving records contiguous");
+  checks->Expect(tail_committed, "killed producer: newest record at the header's seq");
+  checks->Expect(continues, "killed producer: reopened ring continues the seq");
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_flight_check [--capacity N] [--records N] [--kills N] [--dir PATH]" << std::endl;
+    return 2;
+  }
+  std::string dir = options.dir;
+  char dir_template[] = "/tmp/mcc-flight-check-XXXXXX";
+  if (dir.empty()) {
+    if (!mkdtemp(dir_template)) {
+      std::perror("mcc_flight_check: mkdtemp");
+      return 2;
+    }
+    dir = dir_template;
+  }
+  const std::string path = dir + "/flight.bin";
+
+  Checks checks;
+  CheckRoundTrip(options, path, &checks);
+  CheckTornRecords(options, path, &checks);
+  const KillResult kills = CheckKilledProducer(options, path, &checks);
+  if (options.dir.empty()) {
+    std::filesystem::remove_all(dir);
+  } else {
+    std::filesystem::remove(path);
+  }
+
+  std::cout << "{\"capacity\":" << options.capacity << ",\"records\":" << options.records
+            << ",\"kills\":{\"rounds\":" << kills.rounds << ",\"tornSeen\":" << kills.torn_seen
+            << ",\"recordsRead\":" << kills.records << "},\"checks\":{\"passed\":" << checks.passed << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
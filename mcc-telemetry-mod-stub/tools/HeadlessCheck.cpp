@@ -0,0 +1,224 @@
+// Runs mcc_player_overlay --headless against mcc_dummy_target with a tight
+// resource budget and checks the service side of the reader: the budget
+// gauges on /metrics, the throttle stretching the poll interval, the lowered
+// priority, and a clean exit on SIGTERM. Prints JSON; exits 1 if a check
+// fails.
+//
+//   mcc_headless_check [--reader PATH] [--dummy PATH] [--max-wakeups N]
+//
+// The reader measures itself every second (HMCC_READER_BUDGET_WINDOW_MS)
+// against --max-wakeups per second (HMCC_READER_MAX_WAKEUPS). Following one
+// target it wakes about 15 times a second, so the default of 5 puts it over
+// the budget until the throttle reaches its cap; the gauge must pass
+// through every doubling on the way. At the cap, samples are counted over
+// kRateWindow.
+#include "ChildProcess.h"
+#include "MetricsScrape.h"
+
+#include <dirent.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr auto kStartTimeout = std::chrono::seconds(10);
+constexpr auto kThrottleTimeout = std::chrono::seconds(8);
+constexpr auto kScrapeInterval = std::chrono::milliseconds(100);
+constexpr auto kRateWindow = std::chrono::seconds(2);
+// The reader's poll interval, its throttle cap (ResourceBudget::kMaxThrottle)
+// and the niceness LowerProcessPriority() sets.
+constexpr double kPollsPerSecond = 5.0;
+constexpr int64_t kMaxThrottle = 4;
+constexpr int kServiceNice = 10;
+
+struct Options {
+  std::string reader;
+  std::string dummy;
+  int max_wakeups = 5;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--reader" && has_value) {
+      options->reader = argv[++i];
+    } else if (arg == "--dummy" && has_value) {
+      options->dummy = argv[++i];
+    } else if (arg == "--max-wakeups" && has_value) {
+      options->max_wakeups = std::atoi(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  if (options->reader.empty()) options->reader = mcctools::SiblingPath("mcc_player_overlay");
+  if (options->dummy.empty()) options->dummy = mcctools::SiblingPath("mcc_dummy_target");
+  return !options->reader.empty() && !options->dummy.empty() && options->max_wakeups > 0;
+}
+
+// Niceness of every thread of `pid`, from field 19 of /proc/<pid>/task/<tid>/stat.
+std::vector<int> ThreadNiceness(pid_t pid) {
+  std::vector<int> values;
+  const std::string tasks = "/proc/" + std::to_string(pid) + "/task";
+  DIR* dir = opendir(tasks.c_str());
+  if (!dir) return values;
+  while (dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] == '.') continue;
+    std::ifstream stat(tasks + "/" + entry->d_name + "/stat");
+    std::string line;
+    std::getline(stat, line);
+    const size_t comm_end = line.rfind(')');
+    if (comm_end == std::string::npos) continue;
+    // Fields after the command name start at 3 (state).
+    std::istringstream fields(line.substr(comm_end + 1));
+    std::string field;
+    for (int index = 3; index <= 19 && fields >> field; ++index) {
+      if (index == 19) values.push_back(std::atoi(field.c_str()));
+    }
+  }
+  closedir(dir);
+  return values;
+}
+
+struct Gauges {
+  int64_t samples = -1;
+  int64_t throttle = -1;
+  int64_t wakeups_per_second = -1;
+  int64_t cpu_ms_per_minute = -1;
+  int64_t working_set_bytes = -1;
+};
+
+Gauges ReadGauges(uint16_t port) {
+  const std::string text = mcctools::ScrapeMetrics(port);
+  Gauges gauges;
+  gauges.samples = mcctools::MetricValue(text, "mcc_reader_samples_total");
+  gauges.throttle = mcctools::MetricValue(text, "mcc_reader_throttle");
+  gauges.wakeups_per_second = mcctools::MetricValue(text, "mcc_reader_wakeups_per_second");
+  gauges.cpu_ms_per_minute = mcctools::MetricValue(text, "mcc_reader_cpu_ms_per_minute");
+  gauges.working_set_bytes = mcctools::MetricValue(text, "mcc_reader_working_set_bytes");
+  return gauges;
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_headless_check [--reader PATH] [--dummy PATH] [--max-wakeups N]" << std::endl;
+    return 2;
+  }
+
+  char dir_template[] = "/tmp/mcc-headless-check-XXXXXX";
+  if (!mkdtemp(dir_template)) {
+    std::perror("mcc_headless_check: mkdtemp");
+    return 2;
+  }
+  const std::string dir = dir_template;
+  const std::string target = "headless" + std::to_string(getpid());
+  const std::string dummy = dir + "/" + target;
+  if (!mcctools::CopyExecutable(options.dummy, dummy)) {
+    std::cerr << "mcc_headless_check: cannot set up " << dir << std::endl;
+    std::filesystem::remove_all(dir);
+    return 2;
+  }
+  const pid_t dummy_pid = mcctools::Spawn(dummy, {"4", "Sword Base", "Team Slayer"});
+
+  const uint16_t port = mcctools::FreePort();
+  const pid_t reader_pid = mcctools::Spawn(
+      options.reader, {"--headless"},
+      {"HMCC_READER_TARGET=" + target, "HMCC_READER_METRICS_PORT=" + std::to_string(port), "HMCC_READER_PUBSUB=0",
+       "HMCC_READER_ENDPOINT=", "HMCC_READER_FLIGHT=0", "MCC_TELEMETRY_OUT=" + dir + "/state.json",
+       "HMCC_READER_BUDGET_WINDOW_MS=1000", "HMCC_READER_MAX_WAKEUPS=" + std::to_string(options.max_wakeups)});
+
+  Checks checks;
+  checks.Expect(dummy_pid > 0 && reader_pid > 0 && port != 0, "dummy and reader started");
+
+  const auto start_deadline = SteadyClock::now() + kStartTimeout;
+  Gauges gauges;
+  while (reader_pid > 0 && (gauges = ReadGauges(port)).samples <= 0 && SteadyClock::now() < start_deadline) {
+    std::this_thread::sleep_for(kScrapeInterval);
+  }
+  const bool sampling = gauges.samples > 0;
+  checks.Expect(sampling, "reader sampling and serving metrics");
+
+  // Throttle values in the order the gauge showed them, and the busiest window seen.
+  std::vector<int64_t> throttles;
+  int64_t peak_wakeups_per_second = -1;
+  const auto throttle_deadline = SteadyClock::now() + kThrottleTimeout;
+  while (sampling && SteadyClock::now() < throttle_deadline) {
+    gauges = ReadGauges(port);
+    if (throttles.empty() || throttles.back() != gauges.throttle) throttles.push_back(gauges.throttle);
+    if (gauges.wakeups_per_second > peak_wakeups_per_second) peak_wakeups_per_second = gauges.wakeups_per_second;
+    if (gauges.throttle == kMaxThrottle) break;
+    std::this_thread::sleep_for(kScrapeInterval);
+  }
+
+  double throttled_samples_per_second = 0.0;
+  if (!throttles.empty() && throttles.back() == kMaxThrottle) {
+    const int64_t before = ReadGauges(port).samples;
+    const auto window_start = SteadyClock::now();
+    std::this_thread::sleep_for(kRateWindow);
+    const int64_t after = ReadGauges(port).samples;
+    throttled_samples_per_second = static_cast<double>(after - before) /
+                                   std::chrono::duration<double>(SteadyClock::now() - window_start).count();
+  }
+  const std::vector<int> niceness = reader_pid > 0 ? ThreadNiceness(reader_pid) : std::vector<int>();
+
+  const auto stop_start = SteadyClock::now();
+  const int status = mcctools::Terminate(reader_pid);
+  const double stop_ms = std::chrono::duration<double, std::milli>(SteadyClock::now() - stop_start).count();
+  mcctools::Terminate(dummy_pid);
+  std::filesystem::remove_all(dir);
+
+  bool doubled = throttles.size() >= 2 && throttles.back() == kMaxThrottle;
+  for (size_t i = 1; i < throttles.size(); ++i) doubled = doubled && throttles[i] == throttles[i - 1] * 2;
+  bool all_lowered = !niceness.empty();
+  for (int nice : niceness) all_lowered = all_lowered && nice == kServiceNice;
+
+  checks.Expect(peak_wakeups_per_second > options.max_wakeups, "wakeup gauge over the budget");
+  checks.Expect(gauges.cpu_ms_per_minute >= 0 && gauges.working_set_bytes > 0, "CPU and working set gauges");
+  checks.Expect(doubled, "throttle doubled up to its cap");
+  checks.Expect(throttled_samples_per_second > 0 &&
+                    throttled_samples_per_second < kPollsPerSecond * 2 / kMaxThrottle,
+                "sampling slowed by the throttle");
+  checks.Expect(all_lowered, "every reader thread below normal priority");
+  checks.Expect(WIFEXITED(status) && WEXITSTATUS(status) == 0, "SIGTERM exits with status 0");
+
+  std::cout << std::fixed << std::setprecision(2) << "{\"maxWakeups\":" << options.max_wakeups
+            << ",\"peakWakeupsPerSecond\":" << peak_wakeups_per_second << ",\"throttles\":[";
+  for (size_t i = 0; i < throttles.size(); ++i) std::cout << (i ? "," : "") << throttles[i];
+  std::cout << "],\"throttledSamplesPerSecond\":" << throttled_samples_per_second << ",\"threads\":"
+            << niceness.size() << ",\"stopMs\":" << stop_ms << ",\"checks\":{\"passed\":" << checks.passed
+            << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
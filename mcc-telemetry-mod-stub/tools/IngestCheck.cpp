@@ -0,0 +1,172 @@
+// End-to-end check of the reader's receiver mode: runs mcc_player_overlay
+// --headless against mcc_dummy_target, posting to loadgen's stand-in
+// receiver, and measures how long each read takes to reach the receiver.
+// Prints JSON; exits 1 if a check fails or read-to-ingest p99 is over the
+// budget.
+//
+//   mcc_ingest_check [--reader PATH] [--dummy PATH] [--changes N] [--interval-ms N]
+//
+// The dummy (copied under a name only this run uses, so the reader tracks
+// no other) gains a player on every SIGUSR2. readToIngest comes from the
+// trace stamped on each envelope: the sampler's capture time to the
+// stand-in's receipt. changeToIngest is from the signal to the new count
+// arriving, so it also holds the poll interval and the signal filter.
+#include "ChildProcess.h"
+#include "StandInReceiver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr uint64_t kIngestBudgetUs = 100000;
+constexpr int kInitialPlayers = 4;
+constexpr auto kFirstIngestTimeout = std::chrono::seconds(10);
+constexpr auto kChangeTimeout = std::chrono::seconds(3);
+
+struct Options {
+  std::string reader;
+  std::string dummy;
+  int changes = 10;
+  int interval_ms = 300;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--reader" && has_value) {
+      options->reader = argv[++i];
+    } else if (arg == "--dummy" && has_value) {
+      options->dummy = argv[++i];
+    } else if (arg == "--changes" && has_value) {
+      options->changes = std::atoi(argv[++i]);
+    } else if (arg == "--interval-ms" && has_value) {
+      options->interval_ms = std::atoi(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  if (options->reader.empty()) options->reader = mcctools::SiblingPath("mcc_player_overlay");
+  if (options->dummy.empty()) options->dummy = mcctools::SiblingPath("mcc_dummy_target");
+  return !options->reader.empty() && !options->dummy.empty() && options->changes > 0 &&
+         options->interval_ms >= 0;
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+// Waits until the stand-in has applied a snapshot with `players`.
+bool WaitForPlayers(mcctools::StandInReceiver* stand_in, int players, SteadyClock::duration timeout) {
+  const auto deadline = SteadyClock::now() + timeout;
+  while (stand_in->LastApplied().player_count != players) {
+    if (SteadyClock::now() >= deadline) return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  return true;
+}
+
+double Percentile(std::vector<double> samples, double q) {
+  if (samples.empty()) return 0.0;
+  std::sort(samples.begin(), samples.end());
+  const size_t rank = static_cast<size_t>(q * static_cast<double>(samples.size() - 1) + 0.5);
+  return samples[rank];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_ingest_check [--reader PATH] [--dummy PATH] [--changes N] [--interval-ms N]"
+              << std::endl;
+    return 2;
+  }
+
+  char dir_template[] = "/tmp/mcc-ingest-check-XXXXXX";
+  if (!mkdtemp(dir_template)) {
+    std::perror("mcc_ingest_check: mkdtemp");
+    return 2;
+  }
+  const std::string dir = dir_template;
+  const std::string target = "ingest" + std::to_string(getpid());
+  const std::string dummy = dir + "/" + target;
+  mcctools::StandInReceiver stand_in;
+  if (!mcctools::CopyExecutable(options.dummy, dummy) || !stand_in.Start()) {
+    std::cerr << "mcc_ingest_check: cannot set up " << dir << std::endl;
+    std::filesystem::remove_all(dir);
+    return 2;
+  }
+
+  const pid_t dummy_pid = mcctools::Spawn(dummy, {std::to_string(kInitialPlayers), "Sword Base", "Team Slayer"});
+  const pid_t reader_pid = mcctools::Spawn(options.reader, {"--headless"},
+                                           {"HMCC_READER_TARGET=" + target, "HMCC_READER_ENDPOINT=" + stand_in.Url(),
+                                            "HMCC_READER_PUBSUB=0", "HMCC_READER_FLIGHT=0",
+                                            "MCC_TELEMETRY_OUT=" + dir + "/state.json"});
+
+  Checks checks;
+  checks.Expect(dummy_pid > 0 && reader_pid > 0, "dummy and reader started");
+  const bool first = dummy_pid > 0 && reader_pid > 0 && WaitForPlayers(&stand_in, kInitialPlayers, kFirstIngestTimeout);
+  checks.Expect(first, "first snapshot ingested");
+
+  std::vector<double> change_ms;
+  int players = kInitialPlayers;
+  int missed = 0;
+  for (int i = 0; first && i < options.changes; ++i) {
+    players = players % 16 + 1;
+    const auto signaled = SteadyClock::now();
+    kill(dummy_pid, SIGUSR2);
+    if (WaitForPlayers(&stand_in, players, kChangeTimeout)) {
+      change_ms.push_back(std::chrono::duration<double, std::milli>(SteadyClock::now() - signaled).count());
+    } else {
+      ++missed;
+      players = stand_in.LastApplied().player_count;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(options.interval_ms));
+  }
+  checks.Expect(first && missed == 0, "every change ingested");
+
+  const int reader_status = mcctools::Terminate(reader_pid);
+  mcctools::Terminate(dummy_pid);
+  stand_in.Stop();
+  checks.Expect(WIFEXITED(reader_status) && WEXITSTATUS(reader_status) == 0, "reader exited cleanly");
+
+  const mccmod::LatencySummary ingest = stand_in.IngestLatency();
+  checks.Expect(ingest.count > 0, "envelopes carry a latency trace");
+  checks.Expect(ingest.p99 < kIngestBudgetUs, "read to ingest p99 within the budget");
+  std::filesystem::remove_all(dir);
+
+  std::cout << std::fixed << std::setprecision(2) << "{\"changes\":" << options.changes
+            << ",\"posts\":" << stand_in.Requests() << ",\"applied\":" << stand_in.Applied()
+            << ",\"readToIngestUs\":{\"count\":" << ingest.count << ",\"p50\":" << ingest.p50
+            << ",\"p99\":" << ingest.p99 << ",\"max\":" << ingest.max << "},\"changeToIngestMs\":{\"p50\":"
+            << Percentile(change_ms, 0.5) << ",\"p99\":" << Percentile(change_ms, 0.99)
+            << "},\"budgetUs\":" << kIngestBudgetUs << ",\"checks\":{\"passed\":" << checks.passed
+            << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
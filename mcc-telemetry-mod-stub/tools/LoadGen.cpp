@@ -0,0 +1,455 @@
+// Synthetic telemetry load: simulates many independent mod sessions and posts
+// their snapshots to a receiver at a target aggregate rate over keep-alive
+// connections, then reports throughput, errors and latency percentiles.
+//
+//   mcc_telemetry_loadgen [--url URL] [--sessions N] [--rate POSTS_PER_S]
+//                         [--duration S] [--connections C] [--seed N] [--stand-in]
+//                         [--flap UP_S:DOWN_S] [--outbox] [--spool-dir DIR]
+//
+// --stand-in starts a minimal local receiver (Linux only) and targets it.
+// --flap makes that receiver go away for DOWN_S seconds after every UP_S.
+// --outbox delivers through TelemetryOutbox (circuit breaker and spool, on
+// disk under --spool-dir) and, after draining, checks that the stand-in
+// ended on every session's latest state.
+#include "Clock.h"
+#include "HttpClientWinHttp.h"
+#include "TelemetryContract.h"
+#include "TelemetryOutbox.h"
+#include "StandInReceiver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::string url = "http://127.0.0.1:4760/telemetry";
+  int sessions = 2000;
+  double rate = 1000.0;
+  int duration_s = 30;
+  int connections = 16;
+  uint32_t seed = 1;
+  bool stand_in = false;
+  int flap_up_s = 0;
+  int flap_down_s = 0;
+  bool outbox = false;
+  std::string spool_dir;
+};
+
+struct Weighted {
+  const char* name;
+  double weight;
+};
+
+// Rough shares of an evening of Reach customs; only the shape matters for sizing.
+constexpr Weighted kMaps[] = {
+    {"Forge World", 18}, {"Sword Base", 10}, {"Powerhouse", 9}, {"Countdown", 8},
+    {"Boardwalk", 7},    {"Reflection", 7},  {"Zealot", 6},     {"The Cage", 6},
+    {"Asylum", 5},       {"Hemorrhage", 5},  {"Paradiso", 4},   {"Spire", 4},
+    {"Boneyard", 3},     {"Tempest", 3},     {"Anchor 9", 3},   {"Breakpoint", 2},
+};
+constexpr Weighted kModes[] = {
+    {"Slayer", 24},        {"Team Slayer", 20}, {"Infection", 14}, {"Griffball", 8},
+    {"Capture the Flag", 7}, {"King of the Hill", 6}, {"Oddball", 6}, {"Race", 5},
+    {"Invasion", 4},       {"Juggernaut", 3},   {"Headhunter", 3},
+};
+constexpr int kLobbySizes[] = {8, 12, 16, 16, 16};
+
+template <size_t N>
+const char* PickWeighted(const Weighted (&table)[N], std::mt19937& rng) {
+  double total = 0.0;
+  for (const auto& entry : table) total += entry.weight;
+  double roll = std::uniform_real_distribution<double>(0.0, total)(rng);
+  for (const auto& entry : table) {
+    roll -= entry.weight;
+    if (roll <= 0.0) return entry.name;
+  }
+  return table[N - 1].name;
+}
+
+// One simulated custom-games host. Each post advances it by one update: players
+// drift in and out of the lobby, games start and end, and the host eventually
+// closes the session and opens a new one.
+class SimulatedSession {
+ public:
+  SimulatedSession(int index, uint32_t seed) : index_(index), rng_(seed ^ (0x9E3779B9u * (index + 1))) {
+    Open();
+  }
+
+  mccmod::TelemetrySnapshot Next() {
+    mccmod::TelemetrySnapshot snapshot;
+    snapshot.timestamp_utc = mccmod::GetIsoUtcNow();
+    snapshot.session_id = session_id_;
+    snapshot.host_name = "loadgen-host-" + std::to_string(index_);
+    snapshot.max_players = max_players_;
+
+    if (Chance(0.002)) {
+      // Host quits: one inactive snapshot, then a fresh session.
+      Open();
+      return snapshot;
+    }
+
+    Step();
+    snapshot.is_custom_game = in_game_;
+    snapshot.map_name = map_;
+    snapshot.game_mode = mode_;
+    snapshot.player_count = players_;
+    if (modded_) snapshot.mods = {"loadgen_mod"};
+    return snapshot;
+  }
+
+ private:
+  bool Chance(double p) { return std::bernoulli_distribution(p)(rng_); }
+  int Between(int low, int high) { return std::uniform_int_distribution<int>(low, high)(rng_); }
+
+  void Open() {
+    session_id_ = "loadgen-" + std::to_string(index_) + "-" + std::to_string(++generation_);
+    max_players_ = kLobbySizes[Between(0, static_cast<int>(std::size(kLobbySizes)) - 1)];
+    players_ = Between(1, 3);
+    modded_ = Chance(0.15);
+    in_game_ = false;
+    EnterLobby(true);
+  }
+
+  void EnterLobby(bool new_map) {
+    in_game_ = false;
+    remaining_ = Between(5, 30);
+    if (new_map || Chance(0.6)) map_ = PickWeighted(kMaps, rng_);
+    if (new_map || Chance(0.4)) mode_ = PickWeighted(kModes, rng_);
+  }
+
+  void Step() {
+    const double join = in_game_ ? 0.02 : 0.30;
+    const double leave = in_game_ ? 0.03 : 0.10;
+    if (players_ < max_players_ && Chance(join)) ++players_;
+    if (players_ > 1 && Chance(leave)) --players_;
+
+    if (--remaining_ > 0) return;
+    if (in_game_) {
+      EnterLobby(false);
+    } else if (players_ >= 2) {
+      in_game_ = true;
+      remaining_ = Between(40, 120);
+    } else {
+      remaining_ = Between(5, 30);
+    }
+  }
+
+  const int index_;
+  std::mt19937 rng_;
+  int generation_ = 0;
+  std::string session_id_;
+  std::string map_;
+  std::string mode_;
+  int players_ = 0;
+  int max_players_ = 16;
+  int remaining_ = 0;
+  bool in_game_ = false;
+  bool modded_ = false;
+};
+
+struct WorkerResult {
+  uint64_t sent = 0;
+  uint64_t ok = 0;
+  uint64_t http_errors = 0;
+  uint64_t transport_errors = 0;
+  uint64_t invalid = 0;
+  uint64_t connects = 0;
+  mccmod::TelemetryOutboxStats delivery;
+  // Data object of the last envelope generated for each session, for the --outbox check.
+  std::map<std::string, std::string> last_data;
+  // Microseconds from the scheduled send time, so a slow receiver is not hidden by the
+  // generator falling behind, and from the actual send time.
+  std::vector<uint32_t> latency_us;
+  std::vector<uint32_t> service_us;
+};
+
+std::atomic<uint64_t> g_progress_sent{0};
+
+uint32_t MicrosBetween(Clock::time_point start, Clock::time_point end) {
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  return static_cast<uint32_t>(std::clamp<long long>(us, 0, UINT32_MAX));
+}
+
+// Open-loop pacing: worker `worker` owns every sessions[i] with i % workers == worker and
+// posts them round-robin at rate / workers.
+void RunWorker(const Options& options, int worker, int workers, Clock::time_point start,
+               Clock::time_point end, WorkerResult* result) {
+  std::vector<SimulatedSession> sessions;
+  for (int i = worker; i < options.sessions; i += workers) {
+    sessions.emplace_back(i, options.seed);
+  }
+  if (sessions.empty()) return;
+
+  mccmod::HttpConnection connection(options.url);
+  std::unique_ptr<mccmod::TelemetryOutbox> outbox;
+  if (options.outbox) {
+    const std::string spool_path =
+        options.spool_dir.empty() ? "" : options.spool_dir + "/loadgen_spool_" + std::to_string(worker) + ".log";
+    if (!spool_path.empty()) std::remove(spool_path.c_str());
+    outbox = std::make_unique<mccmod::TelemetryOutbox>(options.url, spool_path);
+  }
+  const auto interval = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(static_cast<double>(workers) / options.rate));
+  result->latency_us.reserve(static_cast<size_t>(options.rate / workers * options.duration_s) + 16);
+  result->service_us.reserve(result->latency_us.capacity());
+
+  size_t next_session = 0;
+  for (uint64_t k = 0;; ++k) {
+    const Clock::time_point scheduled = start + interval * static_cast<Clock::rep>(k);
+    if (scheduled >= end) break;
+    std::this_thread::sleep_until(scheduled);
+
+    const mccmod::TelemetrySnapshot snapshot = sessions[next_session].Next();
+    next_session = (next_session + 1) % sessions.size();
+    std::string error;
+    if (!mccmod::ValidateSnapshot(snapshot, &error)) {
+      ++result->invalid;
+      continue;
+    }
+
+    const Clock::time_point sent_at = Clock::now();
+    if (outbox) {
+      // Spooled snapshots are not errors here; the drain below accounts for them.
+      result->last_data[snapshot.session_id] = mcctools::DataObject(mccmod::BuildTelemetryEnvelopeJson(snapshot));
+      if (outbox->Deliver(snapshot)) ++result->ok;
+      const Clock::time_point done = Clock::now();
+      ++result->sent;
+      g_progress_sent.fetch_add(1, std::memory_order_relaxed);
+      result->latency_us.push_back(MicrosBetween(scheduled, done));
+      result->service_us.push_back(MicrosBetween(sent_at, done));
+      continue;
+    }
+    const mccmod::HttpResponse response = connection.PostJson(mccmod::BuildTelemetryEnvelopeJson(snapshot));
+    const Clock::time_point done = Clock::now();
+
+    ++result->sent;
+    g_progress_sent.fetch_add(1, std::memory_order_relaxed);
+    if (response.ok) {
+      ++result->ok;
+    } else if (response.status_code != 0) {
+      ++result->http_errors;
+    } else {
+      ++result->transport_errors;
+    }
+    result->latency_us.push_back(MicrosBetween(scheduled, done));
+    result->service_us.push_back(MicrosBetween(sent_at, done));
+  }
+  result->connects = connection.Connects();
+
+  if (outbox) {
+    // The stand-in stops flapping at the end of the run; give the circuit
+    // time for its next probe and drain what is left.
+    const Clock::time_point give_up = Clock::now() + std::chrono::seconds(90);
+    while (!outbox->Flush() && Clock::now() < give_up) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    result->delivery = outbox->GetStats();
+  }
+}
+
+std::string PercentilesJson(std::vector<uint32_t>* samples) {
+  std::sort(samples->begin(), samples->end());
+  auto at = [samples](double q) -> double {
+    if (samples->empty()) return 0.0;
+    const size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(samples->size())));
+    return (*samples)[std::min(samples->size(), std::max<size_t>(rank, 1)) - 1] / 1000.0;
+  };
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3);
+  out << "{\"p50\":" << at(0.50) << ",\"p90\":" << at(0.90) << ",\"p99\":" << at(0.99)
+      << ",\"p999\":" << at(0.999) << ",\"max\":" << (samples->empty() ? 0.0 : samples->back() / 1000.0)
+      << "}";
+  return out.str();
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--stand-in") {
+      options->stand_in = true;
+    } else if (arg == "--url" && has_value) {
+      options->url = argv[++i];
+    } else if (arg == "--sessions" && has_value) {
+      options->sessions = std::atoi(argv[++i]);
+    } else if (arg == "--rate" && has_value) {
+      options->rate = std::atof(argv[++i]);
+    } else if (arg == "--duration" && has_value) {
+      options->duration_s = std::atoi(argv[++i]);
+    } else if (arg == "--connections" && has_value) {
+      options->connections = std::atoi(argv[++i]);
+    } else if (arg == "--seed" && has_value) {
+      options->seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--flap" && has_value) {
+      if (std::sscanf(argv[++i], "%d:%d", &options->flap_up_s, &options->flap_down_s) != 2) return false;
+    } else if (arg == "--outbox") {
+      options->outbox = true;
+    } else if (arg == "--spool-dir" && has_value) {
+      options->spool_dir = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  const bool flap_ok = (options->flap_up_s == 0 && options->flap_down_s == 0) ||
+                       (options->stand_in && options->flap_up_s > 0 && options->flap_down_s > 0);
+  return options->sessions > 0 && options->rate > 0.0 && options->duration_s > 0 &&
+         options->connections > 0 && flap_ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_telemetry_loadgen [--url URL] [--sessions N] [--rate POSTS_PER_S]\n"
+                 "                             [--duration S] [--connections C] [--seed N] [--stand-in]\n"
+                 "                             [--flap UP_S:DOWN_S] [--outbox] [--spool-dir DIR]"
+              << std::endl;
+    return 2;
+  }
+
+#if !defined(_WIN32)
+  mcctools::StandInReceiver stand_in;
+  if (options.stand_in) {
+    if (!stand_in.Start()) {
+      std::cerr << "mcc_telemetry_loadgen: could not start the stand-in receiver" << std::endl;
+      return 1;
+    }
+    options.url = stand_in.Url();
+    if (options.flap_up_s > 0) stand_in.Flap(options.flap_up_s, options.flap_down_s);
+  }
+#else
+  if (options.stand_in) {
+    std::cerr << "mcc_telemetry_loadgen: --stand-in is Linux only; run `npm run telemetry:receiver`"
+              << std::endl;
+    return 2;
+  }
+#endif
+
+  const int workers = std::min(options.connections, options.sessions);
+  std::cerr << "Posting " << options.rate << "/s from " << options.sessions << " sessions over "
+            << workers << " connections to " << options.url << " for " << options.duration_s << " s"
+            << std::endl;
+
+  const Clock::time_point start = Clock::now() + std::chrono::milliseconds(100);
+  const Clock::time_point end = start + std::chrono::seconds(options.duration_s);
+  std::vector<WorkerResult> results(static_cast<size_t>(workers));
+  std::vector<std::thread> threads;
+  for (int w = 0; w < workers; ++w) {
+    threads.emplace_back(RunWorker, std::cref(options), w, workers, start, end, &results[w]);
+  }
+
+  uint64_t last_sent = 0;
+  for (Clock::time_point tick = start + std::chrono::seconds(5); tick < end; tick += std::chrono::seconds(5)) {
+    std::this_thread::sleep_until(tick);
+    const uint64_t sent = g_progress_sent.load();
+    std::cerr << "  " << std::chrono::duration_cast<std::chrono::seconds>(tick - start).count()
+              << " s: " << (sent - last_sent) / 5 << " posts/s" << std::endl;
+    last_sent = sent;
+  }
+  std::this_thread::sleep_until(end);
+  const double elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+#if !defined(_WIN32)
+  stand_in.StopFlapping();
+#endif
+  for (auto& thread : threads) thread.join();
+
+  WorkerResult total;
+  mccmod::TelemetryOutboxStats delivery;
+  for (auto& result : results) {
+    delivery.posted += result.delivery.posted;
+    delivery.refused += result.delivery.refused;
+    delivery.spooled += result.delivery.spooled;
+    delivery.replayed += result.delivery.replayed;
+    delivery.compacted += result.delivery.compacted;
+    delivery.dropped += result.delivery.dropped;
+    delivery.spool_pending += result.delivery.spool_pending;
+    delivery.circuit_opens += result.delivery.circuit_opens;
+    total.last_data.insert(result.last_data.begin(), result.last_data.end());
+    total.sent += result.sent;
+    total.ok += result.ok;
+    total.http_errors += result.http_errors;
+    total.transport_errors += result.transport_errors;
+    total.invalid += result.invalid;
+    total.connects += result.connects;
+    total.latency_us.insert(total.latency_us.end(), result.latency_us.begin(), result.latency_us.end());
+    total.service_us.insert(total.service_us.end(), result.service_us.begin(), result.service_us.end());
+  }
+
+  const uint64_t failed = total.http_errors + total.transport_errors;
+  std::ostringstream report;
+  report << std::fixed << std::setprecision(2);
+  report << "{";
+  report << "\"url\":\"" << mccmod::EscapeJson(options.url) << "\",";
+  report << "\"sessions\":" << options.sessions << ",";
+  report << "\"connections\":" << workers << ",";
+  report << "\"targetRate\":" << options.rate << ",";
+  report << "\"achievedRate\":" << (elapsed_s > 0.0 ? static_cast<double>(total.sent) / elapsed_s : 0.0) << ",";
+  report << "\"sent\":" << total.sent << ",";
+  report << "\"ok\":" << total.ok << ",";
+  report << "\"httpErrors\":" << total.http_errors << ",";
+  report << "\"transportErrors\":" << total.transport_errors << ",";
+  report << "\"errorRate\":" << std::setprecision(4)
+         << (total.sent > 0 ? static_cast<double>(failed) / static_cast<double>(total.sent) : 0.0) << ",";
+  report << "\"invalid\":" << total.invalid << ",";
+  report << "\"connects\":" << total.connects << ",";
+  report << "\"latencyMs\":" << PercentilesJson(&total.latency_us) << ",";
+  report << "\"serviceMs\":" << PercentilesJson(&total.service_us);
+  bool delivered_all = true;
+  if (options.outbox) {
+    report << ",\"outbox\":{\"posted\":" << delivery.posted << ",\"refused\":" << delivery.refused
+           << ",\"spooled\":" << delivery.spooled << ",\"replayed\":" << delivery.replayed
+           << ",\"compacted\":" << delivery.compacted << ",\"dropped\":" << delivery.dropped
+           << ",\"spoolPending\":" << delivery.spool_pending << ",\"circuitOpens\":" << delivery.circuit_opens
+           << "}";
+    // Per hop of each envelope's trip, from the trace the outbox stamps.
+    const auto latency = mccmod::GetDeliveryLatency();
+    report << ",\"traceUs\":{";
+    for (size_t i = 0; i < latency.size(); ++i) {
+      report << (i ? "," : "") << "\"" << mccmod::DeliveryHopName(static_cast<mccmod::DeliveryHop>(i))
+             << "\":{\"count\":" << latency[i].count << ",\"p50\":" << latency[i].p50
+             << ",\"p99\":" << latency[i].p99 << ",\"max\":" << latency[i].max << "}";
+    }
+    report << "}";
+    delivered_all = delivery.spool_pending == 0;
+  }
+#if !defined(_WIN32)
+  if (options.stand_in) {
+    stand_in.Stop();
+    report << ",\"standIn\":{\"requests\":" << stand_in.Requests() << ",\"rejected\":" << stand_in.Rejected()
+           << ",\"duplicates\":" << stand_in.Duplicates() << ",\"outages\":" << stand_in.Outages();
+    const mccmod::LatencySummary ingest = stand_in.IngestLatency();
+    if (ingest.count > 0) {
+      report << ",\"ingestUs\":{\"count\":" << ingest.count << ",\"p50\":" << ingest.p50 << ",\"p99\":" << ingest.p99
+             << ",\"max\":" << ingest.max << "}";
+    }
+    if (options.outbox) {
+      const uint64_t stale = stand_in.CountStale(total.last_data);
+      report << ",\"staleSessions\":" << stale;
+      delivered_all = delivered_all && stale == 0;
+    }
+    report << "}";
+  }
+#endif
+  report << "}";
+  std::cout << report.str() << std::endl;
+  return failed == 0 && total.invalid == 0 && delivered_all ? 0 : 1;
+}
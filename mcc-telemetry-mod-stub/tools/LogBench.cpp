@@ -0,0 +1,124 @@
+// Measures what a log call costs the calling thread: the old synchronous
+// path (build a std::string, write it out, flush) against Logger::Log() for
+// a queued message, a rate-limited one and one below the level filter.
+// Prints JSON.
+//
+//   mcc_log_bench [--iterations N] [--threads N] [--file PATH]
+//
+// The synchronous path and the logger's writer both append to PATH through
+// a RotatingFileSink, so the I/O is the same; only who waits for it differs.
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using mccmod::LogId;
+using SteadyClock = std::chrono::steady_clock;
+
+struct Options {
+  long iterations = 200000;
+  unsigned threads = 1;
+  std::string file = "mcc_log_bench.log";
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--iterations" && has_value) {
+      options->iterations = std::atol(argv[++i]);
+    } else if (arg == "--threads" && has_value) {
+      options->threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--file" && has_value) {
+      options->file = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  return options->iterations > 0 && options->threads > 0;
+}
+
+// Runs `call` iterations times on each of `threads` threads; ns per call.
+template <typename Call>
+double NsPerCall(long iterations, unsigned threads, const Call& call) {
+  const auto start = SteadyClock::now();
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&call, iterations] {
+      for (long i = 0; i < iterations; ++i) call(i);
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  const double ns = std::chrono::duration<double, std::nano>(SteadyClock::now() - start).count();
+  return ns / static_cast<double>(iterations) / static_cast<double>(threads);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_log_bench [--iterations N] [--threads N] [--file PATH]" << std::endl;
+    return 2;
+  }
+  std::remove(options.file.c_str());
+
+  // Before: what LogLine did, with a file in place of OutputDebugStringA.
+  // Single-threaded; the old path had one caller.
+  mccmod::RotatingFileSink sync_sink(options.file);
+  const long sync_iterations = std::max(1L, options.iterations / 10);
+  const double sync_ns = NsPerCall(sync_iterations, 1, [&sync_sink](long i) {
+    const std::string line = "[MccTelemetryMod] Scanned " + std::to_string(i) + " mod(s), hashed " +
+                             std::to_string(i * 4096) + " bytes in " + std::to_string(i % 100) + " ms.";
+    sync_sink.Write(mccmod::LogLevel::kDebug, line);
+    sync_sink.Flush();
+  });
+
+  mccmod::LoggerOptions logger_options;
+  logger_options.tag = "MccTelemetryMod";
+  logger_options.capacity = 1 << 16;
+  logger_options.min_level = mccmod::LogLevel::kDebug;
+  mccmod::Logger logger(logger_options);
+  logger.AddSink(std::make_unique<mccmod::RotatingFileSink>(options.file));
+  logger.Start();
+
+  // Sized to fit the ring, so every call pays for a real enqueue, not a drop.
+  const long queued_iterations =
+      std::min(options.iterations, static_cast<long>(logger_options.capacity / options.threads));
+  const double queued_ns = NsPerCall(queued_iterations, options.threads, [&logger](long i) {
+    logger.Log(LogId::kModScanDone, {i, i * 4096, i % 100});
+  });
+  logger.Flush();
+  const mccmod::LoggerStats queued = logger.GetStats();
+
+  // The receiver-down case: the same message every tick, limited to one a minute.
+  const double limited_ns = NsPerCall(options.iterations, options.threads, [&logger](long) {
+    logger.Log(LogId::kSnapshotSpooled);
+  });
+
+  logger.SetMinLevel(mccmod::LogLevel::kInfo);
+  const double filtered_ns = NsPerCall(options.iterations, options.threads, [&logger](long i) {
+    logger.Log(LogId::kModScanDone, {i, i, i});
+  });
+  logger.Stop();
+  const mccmod::LoggerStats stats = logger.GetStats();
+
+  std::cout << std::fixed << std::setprecision(1) << "{\"iterations\":" << options.iterations
+            << ",\"threads\":" << options.threads << ",\"ns\":{\"sync\":" << sync_ns << ",\"queued\":" << queued_ns
+            << ",\"rateLimited\":" << limited_ns << ",\"filtered\":" << filtered_ns
+            << "},\"queuedDropped\":" << queued.dropped << ",\"logged\":" << stats.logged
+            << ",\"written\":" << stats.written << ",\"suppressed\":" << stats.suppressed
+            << ",\"dropped\":" << stats.dropped << "}" << std::endl;
+  return 0;
+}
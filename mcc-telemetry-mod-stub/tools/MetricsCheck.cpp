@@ -0,0 +1,217 @@
+// Times metric updates on the hot path, then checks MetricsServer end to end
+// over a loopback socket: GET /metrics, an unknown path and a POST. Prints
+// JSON; exits 1 if any check fails.
+//
+//   mcc_metrics_check [--iterations N] [--threads N]
+//
+// The update costs are per call and per thread. A mutex-guarded counter is
+// timed alongside as the obvious alternative to the atomics.
+#include "Metrics.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+struct Options {
+  long iterations = 5000000;
+  unsigned threads = 4;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--iterations" && has_value) {
+      options->iterations = std::atol(argv[++i]);
+    } else if (arg == "--threads" && has_value) {
+      options->threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else {
+      return false;
+    }
+  }
+  return options->iterations > 0 && options->threads > 0;
+}
+
+// Runs `call` iterations times on each of `threads` threads; ns per call.
+template <typename Call>
+double NsPerCall(long iterations, unsigned threads, const Call& call) {
+  const auto start = SteadyClock::now();
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&call, iterations] {
+      for (long i = 0; i < iterations; ++i) call(i);
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  const double ns = std::chrono::duration<double, std::nano>(SteadyClock::now() - start).count();
+  return ns / static_cast<double>(iterations) / static_cast<double>(threads);
+}
+
+struct HttpResult {
+  int status = 0;
+  std::string headers;
+  std::string body;
+};
+
+// One request over a fresh connection; status 0 if the exchange failed.
+HttpResult Request(uint16_t port, const std::string& method, const std::string& path) {
+  HttpResult result;
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return result;
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    close(fd);
+    return result;
+  }
+  const std::string request = method + " " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+  if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+    close(fd);
+    return result;
+  }
+  std::string response;
+  char buffer[4096];
+  ssize_t n = 0;
+  while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) response.append(buffer, static_cast<size_t>(n));
+  close(fd);
+
+  const size_t header_end = response.find("\r\n\r\n");
+  if (response.compare(0, 9, "HTTP/1.1 ") != 0 || header_end == std::string::npos) return result;
+  result.status = std::atoi(response.c_str() + 9);
+  result.headers = response.substr(0, header_end);
+  result.body = response.substr(header_end + 4);
+  return result;
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const char* what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+bool Contains(const std::string& text, const std::string& needle) { return text.find(needle) != std::string::npos; }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_metrics_check [--iterations N] [--threads N]" << std::endl;
+    return 2;
+  }
+
+  // Timings use their own registry so the endpoint checks see exact values.
+  mccmod::MetricsRegistry bench_registry;
+  mccmod::MetricCounter& counter = bench_registry.Counter("bench_total", "Bench counter.");
+  mccmod::MetricGauge& gauge = bench_registry.Gauge("bench_gauge", "Bench gauge.");
+  mccmod::MetricHistogram& histogram =
+      bench_registry.Histogram("bench_us", "Bench histogram.", {50, 100, 250, 500, 1000, 2500, 5000, 10000});
+  std::mutex locked_mutex;
+  uint64_t locked_value = 0;
+  const auto locked_add = [&](long) {
+    std::lock_guard<std::mutex> lock(locked_mutex);
+    ++locked_value;
+  };
+
+  const long n = options.iterations;
+  const unsigned threads = options.threads;
+  const double counter_ns = NsPerCall(n, 1, [&](long) { counter.Add(); });
+  const double gauge_ns = NsPerCall(n, 1, [&](long i) { gauge.Set(i); });
+  const double histogram_ns = NsPerCall(n, 1, [&](long i) { histogram.Observe(static_cast<uint64_t>(i & 8191)); });
+  const double locked_ns = NsPerCall(n, 1, locked_add);
+  const long contended = std::max(1L, n / threads);
+  const double counter_mt_ns = NsPerCall(contended, threads, [&](long) { counter.Add(); });
+  const double histogram_mt_ns =
+      NsPerCall(contended, threads, [&](long i) { histogram.Observe(static_cast<uint64_t>(i & 8191)); });
+  const double locked_mt_ns = NsPerCall(contended, threads, locked_add);
+  const auto render_start = SteadyClock::now();
+  const size_t render_bytes = bench_registry.Render().size();
+  const double render_us =
+      std::chrono::duration<double, std::micro>(SteadyClock::now() - render_start).count();
+
+  Checks checks;
+  checks.Expect(counter.Value() == static_cast<uint64_t>(n) + contended * threads, "counter lost updates");
+  checks.Expect(histogram.Count() == static_cast<uint64_t>(n) + contended * threads, "histogram lost updates");
+
+  // The endpoint, on an ephemeral port.
+  mccmod::MetricsRegistry registry;
+  registry.Counter("check_requests_total", "Requests.", "result=\"ok\"").Add(3);
+  registry.Counter("check_requests_total", "Requests.", "result=\"failed\"").Add(1);
+  mccmod::MetricHistogram& latency = registry.Histogram("check_latency_ms", "Latency.", {10, 100});
+  latency.Observe(5);
+  latency.Observe(50);
+  latency.Observe(500);
+  int collected = 0;
+  const int collector = registry.AddCollector([&registry, &collected] {
+    registry.Gauge("check_collected", "Times the collector ran.").Set(++collected);
+  });
+
+  mccmod::MetricsServer server;
+  checks.Expect(server.Start(0, registry), "server did not start");
+  checks.Expect(server.Port() != 0, "no port assigned");
+
+  const HttpResult ok = Request(server.Port(), "GET", "/metrics");
+  checks.Expect(ok.status == 200, "GET /metrics status");
+  checks.Expect(Contains(ok.headers, "Content-Type: text/plain; version=0.0.4"), "content type");
+  checks.Expect(Contains(ok.body, "# TYPE check_requests_total counter\n"), "counter TYPE line");
+  checks.Expect(Contains(ok.body, "check_requests_total{result=\"ok\"} 3\n"), "labelled counter value");
+  checks.Expect(Contains(ok.body, "check_requests_total{result=\"failed\"} 1\n"), "second series");
+  checks.Expect(Contains(ok.body, "# TYPE check_latency_ms histogram\n"), "histogram TYPE line");
+  checks.Expect(Contains(ok.body, "check_latency_ms_bucket{le=\"10\"} 1\n"), "first bucket");
+  checks.Expect(Contains(ok.body, "check_latency_ms_bucket{le=\"100\"} 2\n"), "cumulative bucket");
+  checks.Expect(Contains(ok.body, "check_latency_ms_bucket{le=\"+Inf\"} 3\n"), "+Inf bucket");
+  checks.Expect(Contains(ok.body, "check_latency_ms_sum 555\n"), "histogram sum");
+  checks.Expect(Contains(ok.body, "check_latency_ms_count 3\n"), "histogram count");
+  checks.Expect(Contains(ok.body, "check_collected 1\n"), "collector gauge");
+
+  const HttpResult again = Request(server.Port(), "GET", "/metrics?x=1");
+  checks.Expect(again.status == 200 && Contains(again.body, "check_collected 2\n"), "collector reruns per scrape");
+  checks.Expect(Request(server.Port(), "GET", "/nope").status == 404, "unknown path is 404");
+  checks.Expect(Request(server.Port(), "POST", "/metrics").status == 405, "POST is 405");
+  checks.Expect(server.Scrapes() == 2, "scrape count");
+
+  registry.RemoveCollector(collector);
+  checks.Expect(Contains(Request(server.Port(), "GET", "/metrics").body, "check_collected 2\n"),
+                "removed collector stays quiet");
+  const uint16_t port = server.Port();
+  server.Stop();
+  checks.Expect(Request(port, "GET", "/metrics").status == 0, "stopped server refuses");
+
+  std::cout << std::fixed << std::setprecision(1) << "{\"ns\":{\"counterAdd\":" << counter_ns
+            << ",\"gaugeSet\":" << gauge_ns << ",\"histogramObserve\":" << histogram_ns
+            << ",\"mutexCounter\":" << locked_ns << "},\"threads\":" << threads
+            << ",\"contendedNs\":{\"counterAdd\":" << counter_mt_ns << ",\"histogramObserve\":" << histogram_mt_ns
+            << ",\"mutexCounter\":" << locked_mt_ns << "},\"renderUs\":" << render_us
+            << ",\"renderBytes\":" << render_bytes << ",\"checks\":{\"passed\":" << checks.passed
+            << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() && locked_value > 0 ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+// Scans MCC mod folders the way the DLL does and prints the mods, their
+// fingerprints and scan statistics as JSON.
+//
+//   mcc_mod_scan [--threads N] [--cache FILE] [ROOT...]
+//   mcc_mod_scan --synth DIR [--mods N] [--files N] [--pack-mb MB] [--threads N] [--runs N]
+//
+// Without roots it scans DefaultModRoots(). --synth writes a synthetic mod
+// tree under DIR (reused if already there) and benchmarks it: cold scans
+// with an empty hash cache on one thread and on N threads, warm rescans
+// against the cache, and a rescan after one file changed. Cold means the
+// hash cache is empty; the OS page cache is whatever the machine has.
+#include "Hash64.h"
+#include "ModScanner.h"
+#include "TelemetryContract.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+struct Options {
+  size_t threads = 0;
+  std::string cache_path;
+  std::vector<std::string> roots;
+  std::string synth_dir;
+  int mods = 24;
+  int files = 120;
+  // Every fourth synthetic mod carries one map pack this large.
+  int pack_mb = 48;
+  int runs = 3;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--threads" && has_value) {
+      options->threads = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--cache" && has_value) {
+      options->cache_path = argv[++i];
+    } else if (arg == "--synth" && has_value) {
+      options->synth_dir = argv[++i];
+    } else if (arg == "--mods" && has_value) {
+      options->mods = std::atoi(argv[++i]);
+    } else if (arg == "--files" && has_value) {
+      options->files = std::atoi(argv[++i]);
+    } else if (arg == "--pack-mb" && has_value) {
+      options->pack_mb = std::atoi(argv[++i]);
+    } else if (arg == "--runs" && has_value) {
+      options->runs = std::atoi(argv[++i]);
+    } else if (!arg.empty() && arg[0] != '-') {
+      options->roots.push_back(arg);
+    } else {
+      return false;
+    }
+  }
+  return options->mods > 0 && options->files > 0 && options->pack_mb >= 0 && options->runs > 0;
+}
+
+void WriteFile(const fs::path& path, uint64_t bytes, std::mt19937_64& rng) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  std::vector<uint64_t> block(8192);
+  while (bytes > 0) {
+    for (uint64_t& word : block) word = rng();
+    const uint64_t take = std::min<uint64_t>(bytes, block.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(take));
+    bytes -= take;
+  }
+}
+
+// Mod folders shaped like real ones: a few levels of small assets plus the
+// occasional large map pack.
+bool BuildSyntheticTree(const Options& options, const fs::path& root) {
+  std::error_code ec;
+  if (fs::exists(root / ".complete", ec)) return true;
+  fs::remove_all(root, ec);
+
+  std::mt19937_64 rng(41);
+  std::uniform_int_distribution<uint64_t> small_size(1024, 64 * 1024);
+  for (int mod = 0; mod < options.mods; ++mod) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "synthetic_mod_%02d", mod);
+    const fs::path mod_dir = root / name;
+    for (int file = 0; file < options.files; ++file) {
+      const fs::path dir = mod_dir / ("content" + std::to_string(file % 4)) / ("set" + std::to_string(file % 7));
+      fs::create_directories(dir, ec);
+      if (ec) return false;
+      WriteFile(dir / ("asset_" + std::to_string(file) + ".bin"), small_size(rng), rng);
+    }
+    if (options.pack_mb > 0 && mod % 4 == 0) {
+      WriteFile(mod_dir / "maps.pck", static_cast<uint64_t>(options.pack_mb) * 1024 * 1024, rng);
+    }
+  }
+  std::ofstream(root / ".complete") << "ok\n";
+  return true;
+}
+
+std::string StatsJson(const mccmod::ModScanStats& stats) {
+  std::ostringstream out;
+  out << "{\"directories\":" << stats.directories << ",\"files\":" << stats.files
+      << ",\"bytes\":" << stats.bytes << ",\"bytesHashed\":" << stats.bytes_hashed
+      << ",\"filesHashed\":" << stats.files_hashed << ",\"cacheHits\":" << stats.cache_hits
+      << ",\"errors\":" << stats.errors << ",\"walkMs\":" << stats.walk_ms
+      << ",\"hashMs\":" << stats.hash_ms << "}";
+  return out.str();
+}
+
+struct BenchResult {
+  double best_ms = 0.0;
+  double median_ms = 0.0;
+  mccmod::ModScanResult last;
+};
+
+// `before` runs ahead of every timed scan and is not timed.
+template <typename Before>
+BenchResult TimeScans(mccmod::ModScanner* scanner, const std::vector<std::string>& roots, int runs,
+                      const Before& before) {
+  std::vector<double> times;
+  BenchResult result;
+  for (int run = 0; run < runs; ++run) {
+    before();
+    const auto start = std::chrono::steady_clock::now();
+    result.last = scanner->Scan(roots);
+    times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  }
+  std::sort(times.begin(), times.end());
+  result.best_ms = times.front();
+  result.median_ms = times[times.size() / 2];
+  return result;
+}
+
+std::string BenchJson(const char* name, size_t threads, const BenchResult& result) {
+  const double mib_s = result.best_ms > 0.0
+                           ? static_cast<double>(result.last.stats.bytes) / (1024.0 * 1024.0) /
+                                 (result.best_ms / 1000.0)
+                           : 0.0;
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "\"" << name << "\":{\"threads\":" << threads << ",\"bestMs\":" << result.best_ms
+      << ",\"medianMs\":" << result.median_ms << ",\"treeMiBPerS\":" << mib_s
+      << ",\"fingerprint\":\"" << mccmod::FormatModFingerprint(result.last.fingerprint)
+      << "\",\"stats\":" << StatsJson(result.last.stats) << "}";
+  return out.str();
+}
+
+int RunBench(const Options& options) {
+  const fs::path root = fs::absolute(options.synth_dir);
+  std::cerr << "Preparing synthetic mod tree in " << root.string() << std::endl;
+  if (!BuildSyntheticTree(options, root)) {
+    std::cerr << "mcc_mod_scan: could not write " << root.string() << std::endl;
+    return 1;
+  }
+  const std::vector<std::string> roots = {root.u8string()};
+
+  mccmod::ModScanner single(1);
+  mccmod::ModScanner parallel(options.threads);
+  const auto clear = [&] {
+    single.ClearCache();
+    parallel.ClearCache();
+  };
+  const BenchResult cold_single = TimeScans(&single, roots, options.runs, clear);
+  const BenchResult cold = TimeScans(&parallel, roots, options.runs, clear);
+  parallel.Scan(roots);
+  const BenchResult warm = TimeScans(&parallel, roots, options.runs, [] {});
+
+  // One asset rewritten: only it is hashed again, and the set fingerprint moves.
+  const fs::path edited = root / "synthetic_mod_00" / "content0" / "set0" / "asset_0.bin";
+  std::mt19937_64 rng(static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+  const BenchResult edit = TimeScans(&parallel, roots, 1, [&] { WriteFile(edited, 4096, rng); });
+
+  const bool consistent = cold_single.last.fingerprint == cold.last.fingerprint &&
+                          cold.last.fingerprint == warm.last.fingerprint;
+  std::cout << "{" << BenchJson("coldSingleThread", single.Threads(), cold_single) << ","
+            << BenchJson("cold", parallel.Threads(), cold) << ","
+            << BenchJson("warm", parallel.Threads(), warm) << ","
+            << BenchJson("afterEdit", parallel.Threads(), edit) << ",\"mods\":" << cold.last.mods.size()
+            << ",\"fingerprintsMatch\":" << (consistent ? "true" : "false") << "}" << std::endl;
+  return consistent ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_mod_scan [--threads N] [--cache FILE] [ROOT...]\n"
+                 "       mcc_mod_scan --synth DIR [--mods N] [--files N] [--pack-mb MB]\n"
+                 "                    [--threads N] [--runs N]"
+              << std::endl;
+    return 2;
+  }
+  if (!options.synth_dir.empty()) return RunBench(options);
+
+  const std::vector<std::string> roots = options.roots.empty() ? mccmod::DefaultModRoots() : options.roots;
+  mccmod::ModScanner scanner(options.threads);
+  if (!options.cache_path.empty()) scanner.LoadCache(options.cache_path);
+  const mccmod::ModScanResult result = scanner.Scan(roots);
+  if (!options.cache_path.empty() && !scanner.SaveCache(options.cache_path)) {
+    std::cerr << "mcc_mod_scan: could not write " << options.cache_path << std::endl;
+  }
+
+  std::cout << "{\"fingerprint\":\"" << mccmod::FormatModFingerprint(result.fingerprint) << "\",\"mods\":[";
+  for (size_t i = 0; i < result.mods.size(); ++i) {
+    const mccmod::ModInfo& mod = result.mods[i];
+    if (i > 0) std::cout << ",";
+    std::cout << "{\"name\":\"" << mccmod::EscapeJson(mod.name) << "\",\"root\":\""
+              << mccmod::EscapeJson(mod.root) << "\",\"files\":" << mod.files << ",\"bytes\":" << mod.bytes
+              << ",\"fingerprint\":\"" << mccmod::FormatModFingerprint(mod.fingerprint) << "\"}";
+  }
+  std::cout << "],\"stats\":" << StatsJson(result.stats) << "}" << std::endl;
+  return 0;
+}
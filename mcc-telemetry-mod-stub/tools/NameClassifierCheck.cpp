@@ -0,0 +1,236 @@
+// Checks the reader's name classifier (NameClassifier.h) against the
+// std::isalnum/isalpha/isspace checks it replaced, then times both. Prints
+// JSON; exits 1 on any mismatch.
+//
+//   mcc_name_classifier [--fuzz N] [--bench ITERATIONS] [--seed S]
+//
+// Before the random cases it runs every string of up to two bytes, and
+// every byte value at every position of a valid 64-byte name, so each
+// vector lane and the overlapping tail chunk see every input.
+#include "NameClassifier.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+  long fuzz = 2000000;
+  long bench = 2000000;
+  uint64_t seed = 1;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--fuzz" && has_value) {
+      options->fuzz = std::atol(argv[++i]);
+    } else if (arg == "--bench" && has_value) {
+      options->bench = std::atol(argv[++i]);
+    } else if (arg == "--seed" && has_value) {
+      options->seed = std::strtoull(argv[++i], nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+  return options->fuzz >= 0 && options->bench >= 0;
+}
+
+// The reader's IsLikelyMapName/IsLikelyGameMode character check before the
+// classifier, verbatim.
+bool LegacyIsLikelyName(const std::string& name) {
+  if (name.empty() || name.size() > 64) {
+    return false;
+  }
+
+  bool hasAlpha = false;
+  for (char c : name) {
+    unsigned char uc = static_cast<unsigned char>(c);
+    if (std::isalnum(uc)) {
+      if (std::isalpha(uc)) {
+        hasAlpha = true;
+      }
+      continue;
+    }
+    if (c == '_' || c == '-' || c == ' ') {
+      continue;
+    }
+    if (uc >= 32 && uc <= 126) {
+      continue;
+    }
+    return false;
+  }
+
+  return hasAlpha;
+}
+
+std::string LegacyTrimCopy(const std::string& input) {
+  size_t start = 0;
+  while (start < input.size() && std::isspace(static_cast<unsigned char>(input[start]))) {
+    ++start;
+  }
+  size_t end = input.size();
+  while (end > start && std::isspace(static_cast<unsigned char>(input[end - 1]))) {
+    --end;
+  }
+  return input.substr(start, end - start);
+}
+
+struct Mismatch {
+  uint64_t count = 0;
+  std::string first;
+};
+
+void Check(const std::string& input, Mismatch* mismatch) {
+  const bool expected = LegacyIsLikelyName(input);
+  std::string trimmed = input;
+  mccmod::TrimInPlace(&trimmed);
+  const bool ok = mccmod::IsLikelyNameText(input) == expected && mccmod::IsLikelyNameTextScalar(input) == expected &&
+                  trimmed == LegacyTrimCopy(input) &&
+                  mccmod::IsLikelyNameText(trimmed) == LegacyIsLikelyName(trimmed);
+  if (ok) return;
+  if (mismatch->count++ == 0) {
+    std::ostringstream hex;
+    for (unsigned char c : input) hex << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(c);
+    mismatch->first = hex.str();
+  }
+}
+
+// Names, near misses, and what the reader actually sees when an offset is
+// wrong: control bytes, high bytes, UTF-16 zeros, digits and padding.
+std::string RandomInput(std::mt19937_64& rng) {
+  static const char kNameBytes[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789 _-'.:()";
+  static const char kSpaceBytes[] = " \t\n\v\f\r";
+  const size_t length = static_cast<size_t>(rng() % 81);
+  const unsigned flavor = static_cast<unsigned>(rng() % 4);
+  std::string out;
+  out.reserve(length);
+  for (size_t i = 0; i < length; ++i) {
+    const uint64_t roll = rng();
+    switch (flavor) {
+      case 0:  // any byte
+        out.push_back(static_cast<char>(roll & 0xFF));
+        break;
+      case 1:  // mostly name bytes, rarely anything
+        out.push_back((roll >> 8) % 64 == 0 ? static_cast<char>(roll & 0xFF)
+                                            : kNameBytes[(roll >> 16) % (sizeof(kNameBytes) - 1)]);
+        break;
+      case 2:  // printable without letters, sometimes one letter
+        out.push_back((roll >> 8) % 40 == 0 ? 'x' : static_cast<char>(0x20 + (roll % 33)));
+        break;
+      default:  // names padded with whitespace
+        out.push_back(i < 2 || i + 2 >= length ? kSpaceBytes[(roll >> 8) % 6]
+                                               : kNameBytes[(roll >> 16) % (sizeof(kNameBytes) - 1)]);
+        break;
+    }
+  }
+  return out;
+}
+
+template <typename Fn>
+double NsPerCall(const std::vector<std::string>& probes, long iterations, size_t* hits, const Fn& fn) {
+  size_t found = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; ++i) {
+    found += fn(probes[static_cast<size_t>(i) % probes.size()]) ? 1 : 0;
+  }
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  *hits = found;
+  return ns / static_cast<double>(iterations);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_name_classifier [--fuzz N] [--bench ITERATIONS] [--seed S]" << std::endl;
+    return 2;
+  }
+
+  Mismatch mismatch;
+  uint64_t cases = 0;
+  Check(std::string(), &mismatch);
+  for (int a = 0; a < 256; ++a) {
+    Check(std::string(1, static_cast<char>(a)), &mismatch);
+    for (int b = 0; b < 256; ++b) {
+      Check(std::string{static_cast<char>(a), static_cast<char>(b)}, &mismatch);
+    }
+  }
+  cases += 1 + 256 + 256 * 256;
+  for (size_t length = 1; length <= 64; ++length) {
+    for (size_t position = 0; position < length; ++position) {
+      for (int byte = 0; byte < 256; ++byte) {
+        std::string input(length, '7');
+        input[length - 1 - position] = 'k';
+        input[position] = static_cast<char>(byte);
+        Check(input, &mismatch);
+        ++cases;
+      }
+    }
+  }
+  std::mt19937_64 rng(options.seed);
+  for (long i = 0; i < options.fuzz; ++i) {
+    Check(RandomInput(rng), &mismatch);
+    ++cases;
+  }
+
+  // Reads the reader validates: real names, names with padding, and garbage
+  // from a stale or wrong offset.
+  std::vector<std::string> probes = {
+      "Sword Base",  "Countdown", "Forge World", "Team Slayer", "Capture the Flag", "  Headlong  ",
+      "Blood Gulch", "Lockout",   "Anchor 9",    "Unknown",     "mp_convoy",        "Invasion"};
+  std::mt19937_64 probe_rng(options.seed + 1);
+  for (int i = 0; i < 4; ++i) {
+    std::string garbage(64, '\0');
+    for (char& c : garbage) c = static_cast<char>(probe_rng() & 0xFF);
+    probes.push_back(garbage);
+    probes.push_back(std::string(48, 'A') + std::string(1, static_cast<char>(0x80 + i)));
+    probes.push_back(std::string(63, '5') + "x");
+  }
+
+  size_t legacy_hits = 0;
+  size_t table_hits = 0;
+  size_t vector_hits = 0;
+  size_t legacy_trim_hits = 0;
+  size_t trim_hits = 0;
+  double legacy_ns = 0.0;
+  double table_ns = 0.0;
+  double vector_ns = 0.0;
+  double legacy_trim_ns = 0.0;
+  double trim_ns = 0.0;
+  if (options.bench > 0) {
+    legacy_ns = NsPerCall(probes, options.bench, &legacy_hits, LegacyIsLikelyName);
+    table_ns = NsPerCall(probes, options.bench, &table_hits,
+                         [](const std::string& s) { return mccmod::IsLikelyNameTextScalar(s); });
+    vector_ns = NsPerCall(probes, options.bench, &vector_hits,
+                          [](const std::string& s) { return mccmod::IsLikelyNameText(s); });
+    // What a candidate costs end to end: trim, then validate.
+    legacy_trim_ns = NsPerCall(probes, options.bench, &legacy_trim_hits,
+                               [](const std::string& s) { return LegacyIsLikelyName(LegacyTrimCopy(s)); });
+    trim_ns = NsPerCall(probes, options.bench, &trim_hits, [](const std::string& s) {
+      const mccmod::TextBounds bounds = mccmod::TrimmedBounds(s);
+      return mccmod::IsLikelyNameText(std::string_view(s).substr(bounds.begin, bounds.end - bounds.begin));
+    });
+  }
+  const bool hits_agree =
+      legacy_hits == table_hits && legacy_hits == vector_hits && legacy_trim_hits == trim_hits;
+
+  std::cout << std::fixed << std::setprecision(1) << "{\"isa\":\"" << mccmod::NameClassifierIsa()
+            << "\",\"cases\":" << cases << ",\"mismatches\":" << mismatch.count;
+  if (mismatch.count > 0) std::cout << ",\"firstMismatchHex\":\"" << mismatch.first << "\"";
+  std::cout << ",\"ns\":{\"legacy\":" << legacy_ns << ",\"table\":" << table_ns << ",\"vector\":" << vector_ns
+            << ",\"legacyTrimAndCheck\":" << legacy_trim_ns << ",\"trimAndCheck\":" << trim_ns
+            << "},\"speedup\":" << (vector_ns > 0.0 ? legacy_ns / vector_ns : 0.0)
+            << ",\"hitsAgree\":" << (hits_agree ? "true" : "false") << "}" << std::endl;
+  return mismatch.count == 0 && hits_agree ? 0 : 1;
+}
@@ -0,0 +1,297 @@
+// Fans reader snapshots out through SnapshotPublisher to 1..100 local
+// subscribers and reports publish-to-receive latency, then checks the
+// endpoint rules: a live socket is never taken over, a stale one is. Prints
+// JSON; exits 1 if a check fails.
+//
+//   mcc_pubsub_bench [--subscribers N,N,...] [--messages N] [--interval-us N] [--endpoint PATH]
+//
+// Every subscriber must see the snapshot published before it connected
+// first, the last one published at the end, and sequence numbers in order
+// in between; drops to latest are counted, not failed.
+#include "LatencyHistogram.h"
+#include "SnapshotPublisher.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr auto kConnectTimeout = std::chrono::seconds(5);
+constexpr auto kDrainTimeout = std::chrono::seconds(5);
+
+struct Options {
+  std::vector<size_t> subscribers = {1, 10, 100};
+  uint64_t messages = 200;
+  uint64_t interval_us = 1000;
+  std::string endpoint;
+};
+
+bool ParseCounts(const std::string& text, std::vector<size_t>* counts) {
+  counts->clear();
+  std::istringstream in(text);
+  std::string item;
+  while (std::getline(in, item, ',')) {
+    const size_t count = std::strtoul(item.c_str(), nullptr, 10);
+    if (count == 0) return false;
+    counts->push_back(count);
+  }
+  return !counts->empty();
+}
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--subscribers" && has_value) {
+      if (!ParseCounts(argv[++i], &options->subscribers)) return false;
+    } else if (arg == "--messages" && has_value) {
+      options->messages = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--interval-us" && has_value) {
+      options->interval_us = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--endpoint" && has_value) {
+      options->endpoint = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  return options->messages > 0;
+}
+
+uint64_t NowNs() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now().time_since_epoch()).count());
+}
+
+uint64_t FieldValue(const std::string& line, const char* key) {
+  const size_t at = line.find(key);
+  return at == std::string::npos ? 0 : std::strtoull(line.c_str() + at + std::strlen(key), nullptr, 10);
+}
+
+std::string Snapshot(uint64_t seq) {
+  return "{\"seq\":" + std::to_string(seq) + ",\"sentNs\":" + std::to_string(NowNs()) + "}";
+}
+
+int ConnectTo(const std::string& endpoint) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::memcpy(address.sun_path, endpoint.c_str(), endpoint.size() + 1);
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+  if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+struct Subscriber {
+  int fd = -1;
+  std::thread thread;
+  std::atomic<uint64_t> last_seq{0};
+  std::atomic<uint64_t> received{0};
+  uint64_t first_seq = UINT64_MAX;
+  bool in_order = true;
+};
+
+// Reads newline-delimited snapshots until the publisher hangs up.
+void ReadSnapshots(Subscriber* subscriber, mccmod::LatencyHistogram* latency) {
+  std::string pending;
+  char buffer[4096];
+  ssize_t n = 0;
+  bool first = true;
+  while ((n = recv(subscriber->fd, buffer, sizeof(buffer), 0)) > 0) {
+    const uint64_t now = NowNs();
+    pending.append(buffer, static_cast<size_t>(n));
+    size_t start = 0;
+    for (size_t end = pending.find('\n'); end != std::string::npos; end = pending.find('\n', start)) {
+      const std::string line = pending.substr(start, end - start);
+      start = end + 1;
+      const uint64_t seq = FieldValue(line, "\"seq\":");
+      if (first) {
+        subscriber->first_seq = seq;
+        first = false;
+      } else {
+        // The snapshot waiting at connect time is not a publish to time.
+        if (seq <= subscriber->last_seq.load()) subscriber->in_order = false;
+        const uint64_t sent = FieldValue(line, "\"sentNs\":");
+        latency->Record(now > sent ? now - sent : 0);
+      }
+      subscriber->last_seq.store(seq);
+      subscriber->received.fetch_add(1);
+    }
+    pending.erase(0, start);
+  }
+  close(subscriber->fd);
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+template <typename Predicate>
+bool WaitFor(std::chrono::milliseconds timeout, const Predicate& done) {
+  const auto deadline = SteadyClock::now() + timeout;
+  while (!done()) {
+    if (SteadyClock::now() >= deadline) return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+std::string RunFanOut(const Options& options, const std::string& endpoint, size_t count, Checks* checks) {
+  const std::string tag = std::to_string(count) + " subscribers: ";
+  mccmod::SnapshotPublisher publisher;
+  if (!publisher.Start(endpoint)) {
+    checks->Expect(false, tag + "publisher did not start");
+    return "{}";
+  }
+  publisher.Publish(Snapshot(0));
+
+  mccmod::LatencyHistogram latency;
+  std::vector<std::unique_ptr<Subscriber>> subscribers;
+  for (size_t i = 0; i < count; ++i) {
+    auto subscriber = std::make_unique<Subscriber>();
+    subscriber->fd = ConnectTo(endpoint);
+    if (subscriber->fd < 0) break;
+    subscriber->thread = std::thread(ReadSnapshots, subscriber.get(), &latency);
+    subscribers.push_back(std::move(subscriber));
+  }
+  checks->Expect(subscribers.size() == count, tag + "connect failed");
+  const bool attached = WaitFor(kConnectTimeout, [&] {
+    if (publisher.GetStats().subscribers != subscribers.size()) return false;
+    for (const auto& subscriber : subscribers) {
+      if (subscriber->received.load() == 0) return false;
+    }
+    return true;
+  });
+  checks->Expect(attached, tag + "initial snapshot not delivered");
+
+  double publish_ns = 0;
+  const auto start = SteadyClock::now();
+  for (uint64_t seq = 1; seq <= options.messages; ++seq) {
+    const std::string snapshot = Snapshot(seq);
+    const auto before = SteadyClock::now();
+    publisher.Publish(snapshot);
+    publish_ns += std::chrono::duration<double, std::nano>(SteadyClock::now() - before).count();
+    std::this_thread::sleep_until(start + std::chrono::microseconds(options.interval_us * seq));
+  }
+  const bool drained = WaitFor(kDrainTimeout, [&] {
+    for (const auto& subscriber : subscribers) {
+      if (subscriber->last_seq.load() != options.messages) return false;
+    }
+    return true;
+  });
+  checks->Expect(drained, tag + "latest snapshot not delivered");
+
+  const mccmod::PublisherStats stats = publisher.GetStats();
+  publisher.Stop();
+  uint64_t received = 0;
+  bool first_is_latest = true;
+  bool in_order = true;
+  for (auto& subscriber : subscribers) {
+    subscriber->thread.join();
+    received += subscriber->received.load() - 1;
+    first_is_latest = first_is_latest && subscriber->first_seq == 0;
+    in_order = in_order && subscriber->in_order;
+  }
+  checks->Expect(first_is_latest, tag + "first snapshot was not the latest");
+  checks->Expect(in_order, tag + "snapshots out of order");
+
+  const mccmod::LatencySummary summary = latency.Summary();
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(1) << "{\"subscribers\":" << count << ",\"published\":" << options.messages
+      << ",\"received\":" << received << ",\"dropped\":" << stats.dropped
+      << ",\"publishNs\":" << publish_ns / static_cast<double>(options.messages)
+      << ",\"latencyUs\":{\"p50\":" << summary.p50 / 1000.0 << ",\"p99\":" << summary.p99 / 1000.0
+      << ",\"max\":" << summary.max / 1000.0 << "}}";
+  return out.str();
+}
+
+void CheckEndpointRules(const std::string& endpoint, Checks* checks) {
+  mccmod::SnapshotPublisher live;
+  checks->Expect(live.Start(endpoint), "endpoint: first publisher did not start");
+  live.Publish(Snapshot(7));
+  mccmod::SnapshotPublisher second;
+  checks->Expect(!second.Start(endpoint), "endpoint: live socket taken over");
+  const int fd = ConnectTo(endpoint);
+  char buffer[256] = {};
+  const bool still_served = fd >= 0 && recv(fd, buffer, sizeof(buffer) - 1, 0) > 0;
+  checks->Expect(still_served && FieldValue(buffer, "\"seq\":") == 7, "endpoint: live publisher lost its socket");
+  if (fd >= 0) close(fd);
+  live.Stop();
+
+  // A socket file left behind by a reader that died without cleaning up.
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::memcpy(address.sun_path, endpoint.c_str(), endpoint.size() + 1);
+  const int stale = socket(AF_UNIX, SOCK_STREAM, 0);
+  const bool left = stale >= 0 && bind(stale, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+  if (stale >= 0) close(stale);
+  checks->Expect(left, "endpoint: could not leave a stale socket");
+  mccmod::SnapshotPublisher replacement;
+  checks->Expect(replacement.Start(endpoint), "endpoint: stale socket not replaced");
+  replacement.Stop();
+
+  std::ofstream(endpoint) << "not a socket\n";
+  mccmod::SnapshotPublisher blocked;
+  checks->Expect(!blocked.Start(endpoint), "endpoint: regular file replaced");
+  checks->Expect(std::ifstream(endpoint).good(), "endpoint: regular file removed");
+  unlink(endpoint.c_str());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_pubsub_bench [--subscribers N,N,...] [--messages N] [--interval-us N]"
+                 " [--endpoint PATH]"
+              << std::endl;
+    return 2;
+  }
+  const std::string endpoint = options.endpoint.empty()
+                                   ? "/tmp/mcc_pubsub_bench." + std::to_string(getpid()) + ".sock"
+                                   : options.endpoint;
+
+  Checks checks;
+  std::vector<std::string> runs;
+  for (const size_t count : options.subscribers) {
+    runs.push_back(RunFanOut(options, endpoint, count, &checks));
+  }
+  CheckEndpointRules(endpoint, &checks);
+
+  std::cout << "{\"runs\":[";
+  for (size_t i = 0; i < runs.size(); ++i) std::cout << (i ? "," : "") << runs[i];
+  std::cout << "],\"checks\":{\"passed\":" << checks.passed << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
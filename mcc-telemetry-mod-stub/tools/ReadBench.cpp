@@ -0,0 +1,293 @@
+// End-to-end check of the Linux read path against mcc_dummy_target posing as
+// MCC under Proton, and a benchmark of one tick's remote reads made field by
+// field against the reader's two batches. Prints JSON; exits 1 if a check
+// fails or a batched tick reaches the budget.
+//
+//   mcc_read_bench [--dummy PATH] [--players N] [--iterations N]
+//
+// The dummy (default: mcc_dummy_target next to this binary) is copied to a
+// temporary wine64-preloader and started with --wine, so discovery has to go
+// through the truncated comm and the Wine check, and the module bases have
+// to pass over the lower section views to the PE headers.
+#include "ProcessAccess.h"
+#include "ReaderLayout.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char** environ;
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr double kTickBudgetUs = 1000.0;
+constexpr size_t kNameBytes = 64;
+constexpr char kMap[] = "Sword Base";
+constexpr char kMode[] = "Team Slayer";
+// The reader's per-field tick: four player counts, then the shared block
+// pointer again before the map, the two modes and the player table.
+constexpr int kPerFieldReads = 11;
+constexpr int kBatchedReads = 2;
+
+struct Options {
+  std::string dummy;
+  int players = 6;
+  long iterations = 20000;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--dummy" && has_value) {
+      options->dummy = argv[++i];
+    } else if (arg == "--players" && has_value) {
+      options->players = std::atoi(argv[++i]);
+    } else if (arg == "--iterations" && has_value) {
+      options->iterations = std::atol(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  if (options->dummy.empty()) {
+    char self[4096];
+    const ssize_t length = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (length <= 0) return false;
+    const std::string path(self, static_cast<size_t>(length));
+    options->dummy = path.substr(0, path.find_last_of('/') + 1) + "mcc_dummy_target";
+  }
+  return options->players >= 0 && options->players <= 16 && options->iterations > 0;
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+// The fields of one tick, laid out as the reader keeps them.
+struct TickBuffers {
+  uintptr_t shared_base = 0;
+  std::array<int32_t, 4> players{};
+  std::array<std::array<char, kNameBytes>, 3> names{};
+  std::array<uint8_t, mccmod::kPlayerTableBytes> table{};
+};
+
+struct Modules {
+  uintptr_t mcc = 0;
+  uintptr_t reach = 0;
+};
+
+bool ReadOne(const mccmod::RemoteProcess& process, uintptr_t address, void* buffer, size_t size) {
+  size_t bytes_read = 0;
+  return process.Read(address, buffer, size, &bytes_read);
+}
+
+bool ReadPerField(const mccmod::RemoteProcess& process, const Modules& modules, TickBuffers* tick) {
+  bool ok = ReadOne(process, modules.mcc + mccmod::kMccPlayerCountOffset, &tick->players[0], sizeof(int32_t));
+  for (size_t i = 0; i < 3; ++i) {
+    ok &= ReadOne(process, modules.reach + mccmod::kReachPlayerCountOffsets[i], &tick->players[i + 1],
+                  sizeof(int32_t));
+  }
+  const uintptr_t pointer = modules.mcc + mccmod::kSharedTelemetryBaseOffset;
+  ok &= ReadOne(process, pointer, &tick->shared_base, sizeof(uintptr_t));
+  ok &= ReadOne(process, tick->shared_base + mccmod::kMapNameOffset, tick->names[0].data(), kNameBytes);
+  ok &= ReadOne(process, pointer, &tick->shared_base, sizeof(uintptr_t));
+  ok &= ReadOne(process, tick->shared_base + mccmod::kModeNameOffsetPrimary, tick->names[1].data(), kNameBytes);
+  ok &= ReadOne(process, tick->shared_base + mccmod::kModeNameOffsetSecondary, tick->names[2].data(), kNameBytes);
+  ok &= ReadOne(process, pointer, &tick->shared_base, sizeof(uintptr_t));
+  ok &= ReadOne(process, tick->shared_base + mccmod::kPlayerTableOffset, tick->table.data(), tick->table.size());
+  return ok;
+}
+
+bool ReadBatched(const mccmod::RemoteProcess& process, const Modules& modules, TickBuffers* tick) {
+  std::array<mccmod::RemoteRead, 5> first;
+  first[0] = {modules.mcc + mccmod::kSharedTelemetryBaseOffset, &tick->shared_base, sizeof(uintptr_t)};
+  first[1] = {modules.mcc + mccmod::kMccPlayerCountOffset, &tick->players[0], sizeof(int32_t)};
+  for (size_t i = 0; i < 3; ++i) {
+    first[i + 2] = {modules.reach + mccmod::kReachPlayerCountOffsets[i], &tick->players[i + 1], sizeof(int32_t)};
+  }
+  if (process.ReadBatch(first.data(), first.size()) != first.size()) return false;
+
+  std::array<mccmod::RemoteRead, 4> second;
+  second[0] = {tick->shared_base + mccmod::kMapNameOffset, tick->names[0].data(), kNameBytes};
+  second[1] = {tick->shared_base + mccmod::kModeNameOffsetPrimary, tick->names[1].data(), kNameBytes};
+  second[2] = {tick->shared_base + mccmod::kModeNameOffsetSecondary, tick->names[2].data(), kNameBytes};
+  second[3] = {tick->shared_base + mccmod::kPlayerTableOffset, tick->table.data(), tick->table.size()};
+  return process.ReadBatch(second.data(), second.size()) == second.size();
+}
+
+bool HoldsExpected(const TickBuffers& tick, int players) {
+  for (const int32_t count : tick.players) {
+    if (count != players) return false;
+  }
+  const uint8_t* first = tick.table.data();
+  const bool roster_ok = players == 0 || (first[0] == 'P' && first[1] == 0 &&
+                                          (first[mccmod::kPlayerEntryFlagsOffset] & mccmod::kPlayerEntryActive));
+  return std::strcmp(tick.names[0].data(), kMap) == 0 && std::strcmp(tick.names[1].data(), kMode) == 0 &&
+         std::strcmp(tick.names[2].data(), kMode) == 0 && roster_ok;
+}
+
+bool CopyExecutable(const std::string& from, const std::string& to) {
+  std::ifstream in(from, std::ios::binary);
+  std::ofstream out(to, std::ios::binary | std::ios::trunc);
+  if (!in || !out) return false;
+  out << in.rdbuf();
+  out.close();
+  return out.good() && chmod(to.c_str(), 0700) == 0;
+}
+
+template <typename Call>
+double NsPerCall(long iterations, const Call& call) {
+  const auto start = SteadyClock::now();
+  for (long i = 0; i < iterations; ++i) call();
+  return std::chrono::duration<double, std::nano>(SteadyClock::now() - start).count() /
+         static_cast<double>(iterations);
+}
+
+std::string Hex(uintptr_t value) {
+  char text[24];
+  std::snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(value));
+  return text;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_read_bench [--dummy PATH] [--players N] [--iterations N]" << std::endl;
+    return 2;
+  }
+
+  char dir_template[] = "/tmp/mcc-read-bench-XXXXXX";
+  if (!mkdtemp(dir_template)) {
+    std::perror("mcc_read_bench: mkdtemp");
+    return 2;
+  }
+  const std::string dir = dir_template;
+  const std::string preloader = dir + "/wine64-preloader";
+  if (!CopyExecutable(options.dummy, preloader)) {
+    std::cerr << "mcc_read_bench: cannot copy " << options.dummy << std::endl;
+    rmdir(dir.c_str());
+    return 2;
+  }
+
+  const std::string players = std::to_string(options.players);
+  std::vector<char*> child_argv = {const_cast<char*>("wine64-preloader"), const_cast<char*>("--wine"),
+                                   const_cast<char*>(players.c_str()), const_cast<char*>(kMap),
+                                   const_cast<char*>(kMode), nullptr};
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+  pid_t child = 0;
+  const int spawned = posix_spawn(&child, preloader.c_str(), &actions, nullptr, child_argv.data(), environ);
+  posix_spawn_file_actions_destroy(&actions);
+  if (spawned != 0) {
+    std::cerr << "mcc_read_bench: cannot start " << preloader << ": " << std::strerror(spawned) << std::endl;
+    unlink(preloader.c_str());
+    rmdir(dir.c_str());
+    return 2;
+  }
+  const mccmod::ProcessId pid = static_cast<mccmod::ProcessId>(child);
+
+  // The reader's default target names; the dummy answers to them only once
+  // it has renamed itself, after its modules are mapped.
+  const std::vector<std::string> names = {"MCC-Win64-Shipping.exe", "MCC-Win64-Shipping"};
+  Checks checks;
+  bool found = false;
+  const auto deadline = SteadyClock::now() + std::chrono::seconds(3);
+  while (!found && SteadyClock::now() < deadline) {
+    const std::vector<mccmod::ProcessId> pids = mccmod::FindProcessesByName(names);
+    found = std::find(pids.begin(), pids.end(), pid) != pids.end();
+    if (!found) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  checks.Expect(found, "found by its truncated comm");
+  checks.Expect(mccmod::IsWineHosted(pid), "seen as Wine-hosted");
+
+  mccmod::RemoteProcess process;
+  Modules modules;
+  if (found && process.Open(pid)) {
+    modules.mcc = process.FindModuleBase(mccmod::kMccModuleName);
+    modules.reach = process.FindModuleBase(mccmod::kReachModuleName);
+  }
+  char header[2] = {};
+  checks.Expect(modules.mcc != 0 && modules.reach != 0, "both module bases resolved");
+  checks.Expect(ReadOne(process, modules.mcc, header, sizeof(header)) && header[0] == 'M' && header[1] == 'Z',
+                "module base is the PE header");
+
+  TickBuffers per_field;
+  TickBuffers batched;
+  checks.Expect(ReadPerField(process, modules, &per_field) && HoldsExpected(per_field, options.players),
+                "per-field tick reads the dummy's fields");
+  checks.Expect(ReadBatched(process, modules, &batched) && HoldsExpected(batched, options.players),
+                "batched tick reads the dummy's fields");
+
+  // An unmapped entry fails alone; the batch carries on after it.
+  int32_t before = 0;
+  int32_t missing = 0;
+  int32_t after = 0;
+  std::array<mccmod::RemoteRead, 3> faulting;
+  faulting[0] = {modules.mcc + mccmod::kMccPlayerCountOffset, &before, sizeof(int32_t)};
+  faulting[1] = {4096, &missing, sizeof(int32_t)};
+  faulting[2] = {modules.reach + mccmod::kReachPlayerCountOffsets[0], &after, sizeof(int32_t)};
+  const size_t faulting_ok = process.ReadBatch(faulting.data(), faulting.size());
+  checks.Expect(faulting_ok == 2 && faulting[0].ok && !faulting[1].ok && faulting[2].ok &&
+                    after == options.players,
+                "faulting entry fails alone");
+  checks.Expect(faulting[0].error == 0 && faulting[1].error == EFAULT && faulting[2].error == 0,
+                "faulting entry reports EFAULT");
+
+  double per_field_ns = 0.0;
+  double batched_ns = 0.0;
+  if (checks.failed.empty()) {
+    per_field_ns = NsPerCall(options.iterations, [&] { ReadPerField(process, modules, &per_field); });
+    batched_ns = NsPerCall(options.iterations, [&] { ReadBatched(process, modules, &batched); });
+    checks.Expect(batched_ns / 1000.0 < kTickBudgetUs, "batched tick within the budget");
+  }
+
+  kill(child, SIGTERM);
+  int status = 0;
+  waitpid(child, &status, 0);
+  unlink(preloader.c_str());
+  rmdir(dir.c_str());
+
+  std::cout << std::fixed << std::setprecision(2) << "{\"pid\":" << pid << ",\"mccBase\":\"" << Hex(modules.mcc)
+            << "\",\"reachBase\":\"" << Hex(modules.reach) << "\",\"readsPerTick\":{\"perField\":" << kPerFieldReads
+            << ",\"batched\":" << kBatchedReads << "},\"usPerTick\":{\"perField\":" << per_field_ns / 1000.0
+            << ",\"batched\":" << batched_ns / 1000.0
+            << "},\"speedup\":" << (batched_ns > 0.0 ? per_field_ns / batched_ns : 0.0)
+            << ",\"budgetUs\":" << kTickBudgetUs << ",\"checks\":{\"passed\":" << checks.passed << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
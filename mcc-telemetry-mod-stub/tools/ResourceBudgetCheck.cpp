@@ -0,0 +1,142 @@
+// Feeds ResourceBudget scripted usage, one budget window at a time, and
+// checks the rates it derives, the throttle's doubling and halving, and when
+// it trims. Prints JSON; exits 1 if a check fails.
+//
+//   mcc_resource_budget_check
+//
+// The script runs against the default ResourceLimits: 1500 ms of CPU per
+// minute, 50 wakeups per second and 64 MB. Between half a limit and the
+// limit itself the throttle must hold where it is.
+#include "ServiceHost.h"
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t kWindowMs = 10000;
+constexpr uint64_t kMegabyte = 1024 * 1024;
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+bool Near(double value, double expected) {
+  return std::fabs(value - expected) < 0.01;
+}
+
+// Drives a budget through windows of kWindowMs, each with the CPU time,
+// wakeups and working set it is told about.
+class Script {
+ public:
+  Script() : budget_(mccmod::ResourceLimits{}) {
+    usage_.working_set_bytes = 16 * kMegabyte;
+    budget_.Update(now_ms_, wakeups_, usage_);
+  }
+
+  const mccmod::ResourceReport& Window(double cpu_ms_per_minute, double wakeups_per_second,
+                                       uint64_t working_set_mb = 16) {
+    now_ms_ += kWindowMs;
+    usage_.cpu_ms += static_cast<uint64_t>(cpu_ms_per_minute * kWindowMs / 60000.0);
+    wakeups_ += static_cast<uint64_t>(wakeups_per_second * kWindowMs / 1000.0);
+    usage_.working_set_bytes = working_set_mb * kMegabyte;
+    const mccmod::ResourceReport& report = budget_.Update(now_ms_, wakeups_, usage_);
+    throttles_.push_back(report.throttle);
+    return report;
+  }
+
+  // The same instant again: no elapsed time to measure a rate over.
+  const mccmod::ResourceReport& Repeat() { return budget_.Update(now_ms_, wakeups_, usage_); }
+
+  const std::vector<uint32_t>& Throttles() const { return throttles_; }
+
+ private:
+  mccmod::ResourceBudget budget_;
+  mccmod::ResourceUsage usage_;
+  uint64_t now_ms_ = 1000;
+  uint64_t wakeups_ = 0;
+  std::vector<uint32_t> throttles_;
+};
+
+std::string ThrottlesJson(const std::vector<uint32_t>& throttles) {
+  std::string json = "[";
+  for (size_t i = 0; i < throttles.size(); ++i) {
+    json += (i ? "," : "") + std::to_string(throttles[i]);
+  }
+  return json + "]";
+}
+
+}  // namespace
+
+int main(int argc, char**) {
+  if (argc > 1) {
+    std::cerr << "usage: mcc_resource_budget_check" << std::endl;
+    return 2;
+  }
+
+  Checks checks;
+
+  // CPU: over the limit doubles the throttle up to its cap, inside the band
+  // it holds, under half the limit it halves back to 1.
+  Script cpu;
+  const mccmod::ResourceReport first = cpu.Window(3000, 5);
+  checks.Expect(Near(first.cpu_ms_per_minute, 3000) && Near(first.wakeups_per_second, 5), "rates per window");
+  checks.Expect(first.over_cpu && !first.over_wakeups && !first.over_memory, "over the CPU budget only");
+  cpu.Window(3000, 5);
+  cpu.Window(3000, 5);
+  cpu.Window(1000, 5);
+  cpu.Window(760, 5);
+  cpu.Window(600, 5);
+  cpu.Window(600, 5);
+  cpu.Window(600, 5);
+  checks.Expect(cpu.Throttles() == std::vector<uint32_t>({2, 4, 4, 4, 4, 2, 1, 1}),
+                "CPU throttle doubles to the cap, holds in the band, halves under half");
+
+  // Wakeups: the same, and halving needs both rates under half their limits.
+  Script wakeups;
+  const mccmod::ResourceReport over = wakeups.Window(100, 60);
+  checks.Expect(over.over_wakeups && !over.over_cpu && Near(over.wakeups_per_second, 60), "over the wakeup budget");
+  wakeups.Window(100, 30);
+  wakeups.Window(100, 20);
+  wakeups.Window(100, 20);
+  checks.Expect(wakeups.Throttles() == std::vector<uint32_t>({2, 2, 1, 1}),
+                "wakeup throttle holds in the band, halves under half");
+  Script both;
+  both.Window(100, 60);
+  both.Window(1000, 10);
+  both.Window(100, 10);
+  checks.Expect(both.Throttles() == std::vector<uint32_t>({2, 2, 1}), "halving waits for CPU and wakeups");
+
+  // Memory: a trim per window over the limit, none under it, and no throttle.
+  Script memory;
+  const mccmod::ResourceReport heavy = memory.Window(600, 5, 100);
+  checks.Expect(heavy.over_memory && heavy.trims == 1 && heavy.throttle == 1, "over the memory budget trims");
+  memory.Window(600, 5, 100);
+  const mccmod::ResourceReport light = memory.Window(600, 5, 32);
+  checks.Expect(!light.over_memory && light.trims == 2, "trims only while over the memory budget");
+
+  // A window with no elapsed time rebaselines and leaves the report alone.
+  const mccmod::ResourceReport repeated = memory.Repeat();
+  checks.Expect(repeated.trims == 2 && Near(repeated.cpu_ms_per_minute, 600), "no rate over an empty window");
+
+  std::cout << "{\"cpuThrottles\":" << ThrottlesJson(cpu.Throttles())
+            << ",\"wakeupThrottles\":" << ThrottlesJson(wakeups.Throttles())
+            << ",\"checks\":{\"passed\":" << checks.passed << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
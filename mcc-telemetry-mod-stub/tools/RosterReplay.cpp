@@ -0,0 +1,259 @@
+// Replays scripted player-table traces through RosterTracker and checks the
+// decoded roster and its change flag at every step: joins, leaves, team
+// swaps, stats churn, unusual gamertags. Then times the per-tick roster work
+// against the reader's one-millisecond budget. Prints JSON; exits 1 if a
+// check fails or a tick's roster work reaches the budget.
+//
+//   mcc_roster_replay [--iterations N]
+//
+// The timed tick is the worst case: a 960-byte read of this process through
+// RemoteProcess, an update whose table changed, and the roster section of
+// the envelope.
+#include "PlayerRoster.h"
+#include "ProcessAccess.h"
+#include "ReaderLayout.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+using Table = std::array<uint8_t, mccmod::kPlayerTableBytes>;
+
+constexpr double kTickBudgetUs = 1000.0;
+
+struct Options {
+  long iterations = 200000;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--iterations" && has_value) {
+      options->iterations = std::atol(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  return options->iterations > 0;
+}
+
+uint8_t* Entry(Table* table, size_t slot) { return table->data() + slot * mccmod::kPlayerEntryStride; }
+
+void SetName(Table* table, size_t slot, const std::u16string& name) {
+  uint8_t* entry = Entry(table, slot);
+  std::memset(entry, 0, mccmod::kPlayerEntryNameChars * 2);
+  for (size_t i = 0; i < name.size() && i < mccmod::kPlayerEntryNameChars; ++i) {
+    entry[i * 2] = static_cast<uint8_t>(name[i] & 0xFF);
+    entry[i * 2 + 1] = static_cast<uint8_t>(name[i] >> 8);
+  }
+}
+
+void Join(Table* table, size_t slot, const std::u16string& name, uint8_t team) {
+  SetName(table, slot, name);
+  Entry(table, slot)[mccmod::kPlayerEntryFlagsOffset] = mccmod::kPlayerEntryActive;
+  Entry(table, slot)[mccmod::kPlayerEntryTeamOffset] = team;
+}
+
+void Leave(Table* table, size_t slot) { Entry(table, slot)[mccmod::kPlayerEntryFlagsOffset] = 0; }
+
+void AddKill(Table* table, size_t slot) { ++Entry(table, slot)[mccmod::kPlayerEntryKillsOffset]; }
+
+std::u16string PlayerName(size_t slot) {
+  const std::string ascii = "Spartan " + std::to_string(slot);
+  return std::u16string(ascii.begin(), ascii.end());
+}
+
+std::string Name(const mccmod::PlayerRoster& roster, size_t row) {
+  return std::string(roster.names[row], roster.name_lengths[row]);
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+// Each trace starts from an empty table and a fresh tracker.
+void RunTraces(Checks* checks) {
+  {
+    Table table{};
+    mccmod::RosterTracker tracker;
+    checks->Expect(tracker.Update(table.data()) && tracker.Roster().count == 0, "empty lobby reported once");
+    bool joins_ok = true;
+    for (size_t slot = 0; slot < mccmod::kPlayerTableEntries; ++slot) {
+      Join(&table, slot, PlayerName(slot), static_cast<uint8_t>(slot % 2));
+      const bool changed = tracker.Update(table.data());
+      const mccmod::PlayerRoster& roster = tracker.Roster();
+      joins_ok = joins_ok && changed && roster.count == slot + 1 && roster.slots[slot] == slot &&
+                 roster.teams[slot] == slot % 2 && Name(roster, slot) == "Spartan " + std::to_string(slot);
+    }
+    checks->Expect(joins_ok, "24 joins, one change each");
+    checks->Expect(tracker.Version() == 1 + mccmod::kPlayerTableEntries, "version counts changes");
+
+    const uint64_t decodes = tracker.Stats().decodes;
+    bool idle_ok = true;
+    for (int i = 0; i < 100; ++i) idle_ok = idle_ok && !tracker.Update(table.data());
+    checks->Expect(idle_ok && tracker.Stats().decodes == decodes, "unchanged table is not decoded");
+
+    bool churn_ok = true;
+    for (int i = 0; i < 100; ++i) {
+      AddKill(&table, static_cast<size_t>(i) % mccmod::kPlayerTableEntries);
+      churn_ok = churn_ok && !tracker.Update(table.data());
+    }
+    checks->Expect(churn_ok, "stats churn is not a roster change");
+    checks->Expect(tracker.Stats().decodes == decodes + 100, "stats churn is decoded");
+
+    Entry(&table, 5)[mccmod::kPlayerEntryTeamOffset] = 0;
+    checks->Expect(tracker.Update(table.data()) && tracker.Roster().teams[5] == 0, "team swap");
+
+    Leave(&table, 3);
+    const bool left = tracker.Update(table.data());
+    const mccmod::PlayerRoster& after_leave = tracker.Roster();
+    checks->Expect(left && after_leave.count == mccmod::kPlayerTableEntries - 1, "leave drops a row");
+    checks->Expect(after_leave.slots[2] == 2 && after_leave.slots[3] == 4 && Name(after_leave, 3) == "Spartan 4",
+                   "rows after a leave keep their slots");
+
+    Join(&table, 3, u"Newcomer", 1);
+    checks->Expect(tracker.Update(table.data()) && Name(tracker.Roster(), 3) == "Newcomer", "slot reused by new name");
+
+    tracker.Reset();
+    checks->Expect(tracker.Update(table.data()), "reset reports the table again");
+  }
+
+  {
+    Table table{};
+    mccmod::RosterTracker tracker;
+    Join(&table, 0, u"\u00DCmlaut \U0001F600", mccmod::kPlayerNoTeam);
+    Join(&table, 1, u"SixteenCharsLong", 0);
+    Join(&table, 2, u"bad\u0007name", 0);
+    Join(&table, 3, u"", 0);
+    Join(&table, 4, u"   ", 0);
+    Join(&table, 5, std::u16string(u"lone ") + static_cast<char16_t>(0xD800) + u"x", 1);
+    tracker.Update(table.data());
+    const mccmod::PlayerRoster& roster = tracker.Roster();
+    checks->Expect(roster.count == 3, "control, empty and blank names are skipped");
+    checks->Expect(Name(roster, 0) == "\xC3\x9Cmlaut \xF0\x9F\x98\x80", "UTF-16 surrogate pair to UTF-8");
+    checks->Expect(Name(roster, 1) == "SixteenCharsLong", "unterminated 16-unit name");
+    checks->Expect(Name(roster, 2) == "lone \xEF\xBF\xBDx" && roster.slots[2] == 5, "unpaired surrogate");
+
+    std::string json;
+    mccmod::AppendRosterJson(roster, &json);
+    checks->Expect(json.rfind("[{\"name\":\"\xC3\x9Cmlaut \xF0\x9F\x98\x80\",\"team\":-1,\"slot\":0},", 0) == 0,
+                   "JSON row, no team as -1");
+    checks->Expect(json.find("{\"name\":\"SixteenCharsLong\",\"team\":0,\"slot\":1}") != std::string::npos,
+                   "JSON team and slot");
+  }
+
+  {
+    mccmod::PlayerRoster empty;
+    std::string json;
+    mccmod::AppendRosterJson(empty, &json);
+    checks->Expect(json == "[]", "empty roster JSON");
+  }
+}
+
+template <typename Call>
+double NsPerCall(long iterations, const Call& call) {
+  const auto start = SteadyClock::now();
+  for (long i = 0; i < iterations; ++i) call(i);
+  return std::chrono::duration<double, std::nano>(SteadyClock::now() - start).count() /
+         static_cast<double>(iterations);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_roster_replay [--iterations N]" << std::endl;
+    return 2;
+  }
+
+  Checks checks;
+  RunTraces(&checks);
+
+  // A full lobby, the most decode and JSON work a tick can have.
+  Table table{};
+  for (size_t slot = 0; slot < mccmod::kPlayerTableEntries; ++slot) {
+    Join(&table, slot, PlayerName(slot), static_cast<uint8_t>(slot % 2));
+  }
+  mccmod::RosterTracker tracker;
+  tracker.Update(table.data());
+  const long n = options.iterations;
+  const double unchanged_ns = NsPerCall(n, [&](long) { tracker.Update(table.data()); });
+  const double churn_ns = NsPerCall(n, [&](long i) {
+    AddKill(&table, static_cast<size_t>(i) % mccmod::kPlayerTableEntries);
+    tracker.Update(table.data());
+  });
+  const double change_ns = NsPerCall(n, [&](long i) {
+    Entry(&table, 0)[mccmod::kPlayerEntryTeamOffset] = static_cast<uint8_t>(i & 1);
+    tracker.Update(table.data());
+  });
+  std::string json;
+  const double json_ns = NsPerCall(n, [&](long) {
+    json.clear();
+    mccmod::AppendRosterJson(tracker.Roster(), &json);
+  });
+  // Into heap slots that are read afterwards, so the copies cannot be optimized away.
+  std::vector<mccmod::PlayerRoster> slots(3);
+  const double copy_ns = NsPerCall(n, [&](long i) { slots[static_cast<size_t>(i) % slots.size()] = tracker.Roster(); });
+  checks.Expect(mccmod::SameRoster(slots[0], tracker.Roster()), "tick copy");
+
+  // The bulk read, against this process as the target.
+  mccmod::RemoteProcess self;
+#if defined(_WIN32)
+  const bool opened = self.Open(static_cast<mccmod::ProcessId>(GetCurrentProcessId()));
+#else
+  const bool opened = self.Open(static_cast<mccmod::ProcessId>(getpid()));
+#endif
+  Table remote{};
+  size_t bytes_read = 0;
+  const bool read_ok =
+      opened && self.Read(reinterpret_cast<uintptr_t>(table.data()), remote.data(), remote.size(), &bytes_read) &&
+      bytes_read == remote.size();
+  checks.Expect(read_ok, "bulk read of the table");
+  const double read_ns = read_ok ? NsPerCall(std::max(1L, n / 10), [&](long) {
+    self.Read(reinterpret_cast<uintptr_t>(table.data()), remote.data(), remote.size(), &bytes_read);
+  })
+                                 : 0.0;
+
+  const double tick_us = (read_ns + change_ns + json_ns + copy_ns) / 1000.0;
+  checks.Expect(tick_us < kTickBudgetUs, "roster work within the tick budget");
+
+  std::cout << std::fixed << std::setprecision(1) << "{\"ns\":{\"bulkRead\":" << read_ns
+            << ",\"updateUnchanged\":" << unchanged_ns << ",\"updateStatsChurn\":" << churn_ns
+            << ",\"updateRosterChange\":" << change_ns << ",\"rosterJson\":" << json_ns
+            << ",\"tickCopy\":" << copy_ns << "},\"worstTickUs\":" << tick_us
+            << ",\"budgetUs\":" << kTickBudgetUs << ",\"tableBytes\":" << mccmod::kPlayerTableBytes
+            << ",\"rosterBytes\":" << sizeof(mccmod::PlayerRoster) << ",\"checks\":{\"passed\":" << checks.passed
+            << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
@@ -0,0 +1,291 @@
+// Multi-target scaling of the reader: runs one mcc_player_overlay --headless
+// while 1, 2, 4 and then 8 copies of mcc_dummy_target are up, and measures
+// the per-instance sample rate, sample time and reader CPU at each step from
+// its /metrics endpoint and /proc. Also checks WorkerPool::Stop's timeout
+// against a task that never returns in time. Prints JSON; exits 1 if a check
+// fails.
+//
+//   mcc_scaling_bench [--reader PATH] [--dummy PATH] [--max-targets N] [--window-ms N]
+//
+// The dummies share a name only this run uses, so the reader follows them and
+// nothing else. Each step waits for mcc_reader_instances to reach the target
+// count, then reads the counters across --window-ms. With a sampler per
+// instance on the worker pool, the per-instance rate should hold at one
+// sample per 200 ms poll as targets are added.
+#include "ChildProcess.h"
+#include "MetricsScrape.h"
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr auto kInstanceTimeout = std::chrono::seconds(10);
+constexpr auto kSettle = std::chrono::milliseconds(500);
+constexpr double kPollsPerSecond = 1000.0 / 200.0;
+constexpr uint64_t kStopTimeoutMs = 100;
+constexpr auto kHungTask = std::chrono::milliseconds(1000);
+
+struct Options {
+  std::string reader;
+  std::string dummy;
+  int max_targets = 8;
+  int window_ms = 3000;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--reader" && has_value) {
+      options->reader = argv[++i];
+    } else if (arg == "--dummy" && has_value) {
+      options->dummy = argv[++i];
+    } else if (arg == "--max-targets" && has_value) {
+      options->max_targets = std::atoi(argv[++i]);
+    } else if (arg == "--window-ms" && has_value) {
+      options->window_ms = std::atoi(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  if (options->reader.empty()) options->reader = mcctools::SiblingPath("mcc_player_overlay");
+  if (options->dummy.empty()) options->dummy = mcctools::SiblingPath("mcc_dummy_target");
+  return !options->reader.empty() && !options->dummy.empty() && options->max_targets > 0 && options->window_ms > 0;
+}
+
+// utime + stime of a process in milliseconds; -1 if it cannot be read.
+int64_t CpuMs(pid_t pid) {
+  std::ifstream in("/proc/" + std::to_string(pid) + "/stat");
+  std::string stat;
+  std::getline(in, stat);
+  // Fields after the parenthesised comm, which may itself hold spaces.
+  const size_t close = stat.rfind(')');
+  if (close == std::string::npos) return -1;
+  std::istringstream fields(stat.substr(close + 2));
+  std::string field;
+  unsigned long long utime = 0;
+  unsigned long long stime = 0;
+  for (int i = 3; i <= 15 && fields >> field; ++i) {
+    if (i == 14) utime = std::strtoull(field.c_str(), nullptr, 10);
+    if (i == 15) stime = std::strtoull(field.c_str(), nullptr, 10);
+  }
+  return static_cast<int64_t>((utime + stime) * 1000 / static_cast<unsigned long long>(sysconf(_SC_CLK_TCK)));
+}
+
+struct Counters {
+  int64_t instances = -1;
+  int64_t samples = -1;
+  int64_t sample_us_sum = -1;
+  int64_t missed = -1;
+  int64_t scheduler_ticks = -1;
+  int64_t cpu_ms = -1;
+  SteadyClock::time_point at;
+};
+
+Counters ReadCounters(uint16_t port, pid_t reader_pid) {
+  const std::string text = mcctools::ScrapeMetrics(port);
+  Counters counters;
+  counters.instances = mcctools::MetricValue(text, "mcc_reader_instances");
+  counters.samples = mcctools::MetricValue(text, "mcc_reader_samples_total");
+  counters.sample_us_sum = mcctools::MetricValue(text, "mcc_reader_sample_duration_us_sum");
+  counters.missed = mcctools::MetricValue(text, "mcc_reader_scheduler_missed");
+  counters.scheduler_ticks = mcctools::MetricValue(text, "mcc_reader_scheduler_ticks");
+  counters.cpu_ms = CpuMs(reader_pid);
+  counters.at = SteadyClock::now();
+  return counters;
+}
+
+struct StepResult {
+  int targets = 0;
+  bool reached = false;
+  double samples_per_second = 0.0;
+  double per_instance_rate = 0.0;
+  double mean_sample_us = 0.0;
+  double cpu_ms_per_second = 0.0;
+  int64_t scheduler_ticks = 0;
+  int64_t missed = 0;
+};
+
+StepResult MeasureStep(const Options& options, uint16_t port, pid_t reader_pid, int targets) {
+  StepResult result;
+  result.targets = targets;
+  const auto deadline = SteadyClock::now() + kInstanceTimeout;
+  while (ReadCounters(port, reader_pid).instances != targets && SteadyClock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  std::this_thread::sleep_for(kSettle);
+  const Counters before = ReadCounters(port, reader_pid);
+  result.reached = before.instances == targets;
+  if (!result.reached) return result;
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(options.window_ms));
+  const Counters after = ReadCounters(port, reader_pid);
+  const double seconds = std::chrono::duration<double>(after.at - before.at).count();
+  const int64_t samples = after.samples - before.samples;
+  result.samples_per_second = static_cast<double>(samples) / seconds;
+  result.per_instance_rate = result.samples_per_second / targets;
+  result.mean_sample_us =
+      samples > 0 ? static_cast<double>(after.sample_us_sum - before.sample_us_sum) / static_cast<double>(samples) : 0.0;
+  result.cpu_ms_per_second = static_cast<double>(after.cpu_ms - before.cpu_ms) / seconds;
+  result.scheduler_ticks = after.scheduler_ticks - before.scheduler_ticks;
+  result.missed = after.missed - before.missed;
+  return result;
+}
+
+std::string StepJson(const StepResult& step) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2) << "{\"targets\":" << step.targets
+      << ",\"reached\":" << (step.reached ? "true" : "false") << ",\"samplesPerSecond\":" << step.samples_per_second
+      << ",\"perInstanceRate\":" << step.per_instance_rate << ",\"meanSampleUs\":" << step.mean_sample_us
+      << ",\"cpuMsPerSecond\":" << step.cpu_ms_per_second << ",\"schedulerTicks\":" << step.scheduler_ticks
+      << ",\"missed\":" << step.missed << "}";
+  return out.str();
+}
+
+struct PoolStopResult {
+  bool timed_out = false;
+  int64_t stop_ms = 0;
+  bool restarted = false;
+  bool hung_task_finished = false;
+};
+
+// A task that outlasts Stop's timeout is left on a detached worker, which
+// keeps the pool's shared state alive until it returns; the pool can start
+// again meanwhile.
+PoolStopResult CheckPoolStop() {
+  PoolStopResult result;
+  auto finished = std::make_shared<std::atomic<bool>>(false);
+  std::atomic<bool> entered{false};
+  {
+    mccmod::WorkerPool pool;
+    pool.Start(2);
+    pool.Submit([finished, &entered] {
+      entered.store(true);
+      std::this_thread::sleep_for(kHungTask);
+      finished->store(true);
+    });
+    while (!entered.load()) std::this_thread::yield();
+
+    const auto start = SteadyClock::now();
+    result.timed_out = !pool.Stop(kStopTimeoutMs);
+    result.stop_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - start).count();
+
+    std::atomic<bool> ran{false};
+    pool.Start(1);
+    pool.Submit([&ran] { ran.store(true); });
+    const auto deadline = SteadyClock::now() + std::chrono::seconds(1);
+    while (!ran.load() && SteadyClock::now() < deadline) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    result.restarted = ran.load();
+    pool.Stop();
+  }
+  // The pool is gone; the detached worker finishes its task and exits.
+  const auto deadline = SteadyClock::now() + kHungTask * 3;
+  while (!finished->load() && SteadyClock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  result.hung_task_finished = finished->load();
+  return result;
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_scaling_bench [--reader PATH] [--dummy PATH] [--max-targets N] [--window-ms N]"
+              << std::endl;
+    return 2;
+  }
+
+  Checks checks;
+  const PoolStopResult pool = CheckPoolStop();
+  checks.Expect(pool.timed_out && pool.stop_ms < static_cast<int64_t>(kStopTimeoutMs) * 5,
+                "pool: stop gives up on a hung task after its timeout");
+  checks.Expect(pool.restarted, "pool: restarts while the hung task runs");
+  checks.Expect(pool.hung_task_finished, "pool: detached task finishes after the pool is gone");
+
+  char dir_template[] = "/tmp/mcc-scaling-bench-XXXXXX";
+  if (!mkdtemp(dir_template)) {
+    std::perror("mcc_scaling_bench: mkdtemp");
+    return 2;
+  }
+  const std::string dir = dir_template;
+  const std::string target = "scale" + std::to_string(getpid());
+  const std::string dummy = dir + "/" + target;
+  if (!mcctools::CopyExecutable(options.dummy, dummy)) {
+    std::cerr << "mcc_scaling_bench: cannot set up " << dir << std::endl;
+    std::filesystem::remove_all(dir);
+    return 2;
+  }
+
+  const uint16_t port = mcctools::FreePort();
+  const pid_t reader_pid = mcctools::Spawn(
+      options.reader, {"--headless"},
+      {"HMCC_READER_TARGET=" + target, "HMCC_READER_METRICS_PORT=" + std::to_string(port), "HMCC_READER_PUBSUB=0",
+       "HMCC_READER_ENDPOINT=", "HMCC_READER_DEBUG=0", "HMCC_READER_FLIGHT=" + dir + "/flight.bin",
+       "MCC_TELEMETRY_OUT=" + dir + "/state.json"});
+  checks.Expect(reader_pid > 0 && port != 0, "reader started");
+
+  std::vector<pid_t> dummies;
+  std::vector<StepResult> steps;
+  for (int targets = 1; reader_pid > 0 && targets <= options.max_targets; targets *= 2) {
+    while (static_cast<int>(dummies.size()) < targets) {
+      const int players = 2 + static_cast<int>(dummies.size()) % 14;
+      dummies.push_back(mcctools::Spawn(dummy, {std::to_string(players), "Sword Base", "Team Slayer"}));
+    }
+    steps.push_back(MeasureStep(options, port, reader_pid, targets));
+  }
+  for (const pid_t pid : dummies) mcctools::Terminate(pid);
+  const int status = mcctools::Terminate(reader_pid);
+  std::filesystem::remove_all(dir);
+
+  checks.Expect(WIFEXITED(status) && WEXITSTATUS(status) == 0, "reader exited cleanly");
+  for (const StepResult& step : steps) {
+    const std::string label = std::to_string(step.targets) + " targets: ";
+    checks.Expect(step.reached, label + "an instance per target");
+    checks.Expect(step.per_instance_rate >= kPollsPerSecond * 0.8, label + "each instance sampled every poll");
+    checks.Expect(step.missed * 10 <= step.scheduler_ticks, label + "scheduler kept pace");
+  }
+
+  std::cout << "{\"windowMs\":" << options.window_ms << ",\"pool\":{\"timedOut\":"
+            << (pool.timed_out ? "true" : "false") << ",\"stopMs\":" << pool.stop_ms
+            << ",\"restarted\":" << (pool.restarted ? "true" : "false")
+            << ",\"hungTaskFinished\":" << (pool.hung_task_finished ? "true" : "false") << "},\"steps\":[";
+  for (size_t i = 0; i < steps.size(); ++i) std::cout << (i ? "," : "") << StepJson(steps[i]);
+  std::cout << "],\"checks\":{\"passed\":" << checks.passed << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
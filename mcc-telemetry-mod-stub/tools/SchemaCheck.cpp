@@ -0,0 +1,206 @@
+// Round-trips snapshots through everything MCC_TELEMETRY_SCHEMA generates:
+// the JSON envelope writer and parser, the binary encoder and decoder, and
+// ValidateSnapshot at every field's bounds. Prints JSON; exits 1 if a check
+// fails.
+//
+//   mcc_telemetry_schema_check
+//
+// The bounds checks are expanded from the schema list itself, so a field
+// added there is checked here without touching this tool.
+#include "TelemetryContract.h"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using mccmod::TelemetrySnapshot;
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+// A custom game with every field set, including characters the JSON writer
+// must escape and UTF-8 it must pass through.
+TelemetrySnapshot SampleSnapshot() {
+  TelemetrySnapshot snapshot;
+  snapshot.is_custom_game = true;
+  snapshot.map_name = "Zealot \"night\"\x01";
+  snapshot.game_mode = "Slayer\\Pro";
+  snapshot.playlist = "Customs\t";
+  snapshot.player_count = 7;
+  snapshot.max_players = 16;
+  snapshot.host_name = "h\xc3\xa9te";
+  snapshot.mods = {"alpha", "beta\n", "\xe2\x9c\x93"};
+  snapshot.mods_fingerprint = "0123456789abcdef";
+  snapshot.timestamp_utc = "2024-01-01T00:00:00Z";
+  snapshot.session_id = "mcc-1234";
+  return snapshot;
+}
+
+void CheckJson(Checks* checks) {
+  const TelemetrySnapshot snapshot = SampleSnapshot();
+  const mccmod::DeliveryId id{"producer", 42};
+  const std::string json = mccmod::BuildTelemetryEnvelopeJson(snapshot, &id);
+
+  TelemetrySnapshot parsed;
+  mccmod::DeliveryId parsed_id;
+  std::string error;
+  const bool ok = mccmod::ParseTelemetryEnvelopeJson(json, &parsed, &parsed_id, &error);
+  checks->Expect(ok && parsed_id.producer == id.producer && parsed_id.seq == id.seq,
+                 "json: envelope parses with its delivery id");
+  checks->Expect(ok && mccmod::BuildTelemetryEnvelopeJson(parsed, &parsed_id) == json,
+                 "json: parse then build reproduces the envelope");
+  checks->Expect(json.find("\\u0001") != std::string::npos && json.find("\\\"night\\\"") != std::string::npos,
+                 "json: control characters and quotes escaped");
+
+  // Unknown keys, nested ones included, are skipped; \u escapes decode to UTF-8.
+  const bool lenient = mccmod::ParseTelemetryEnvelopeJson(
+      "{\"isCustomGame\":false,\"extra\":{\"a\":[1,2,{\"b\":null}]},\"mapName\":\"\\u00e9\\ud83d\\ude00\"}", &parsed,
+      nullptr, &error);
+  checks->Expect(lenient && parsed.map_name == "\xc3\xa9\xf0\x9f\x98\x80", "json: unknown keys skipped, \\u decoded");
+  checks->Expect(!mccmod::ParseTelemetryEnvelopeJson("{\"version\":\"1.0\",\"data\":{\"playerCount\":\"x\"}}",
+                                                     &parsed, nullptr, &error),
+                 "json: wrong field type rejected");
+
+  // The state file embeds the same fields; they must match the envelope's data.
+  std::string fields;
+  mccmod::AppendTelemetryFieldsJson(snapshot, &fields);
+  checks->Expect(json.find("\"data\":{" + fields + "}") != std::string::npos,
+                 "json: embedded fields match the envelope's data object");
+}
+
+void CheckBinary(Checks* checks) {
+  const TelemetrySnapshot snapshot = SampleSnapshot();
+  std::string encoded;
+  mccmod::EncodeTelemetrySnapshot(snapshot, &encoded);
+
+  TelemetrySnapshot decoded;
+  checks->Expect(mccmod::DecodeTelemetrySnapshot(encoded.data(), encoded.size(), &decoded) == encoded.size() &&
+                     mccmod::BuildTelemetryEnvelopeJson(decoded) == mccmod::BuildTelemetryEnvelopeJson(snapshot),
+                 "binary: decode reproduces the snapshot");
+
+  bool rejects_truncated = true;
+  for (size_t size = 0; size < encoded.size(); ++size) {
+    rejects_truncated = rejects_truncated && mccmod::DecodeTelemetrySnapshot(encoded.data(), size, &decoded) == 0;
+  }
+  checks->Expect(rejects_truncated, "binary: every truncation rejected");
+
+  std::string other_schema = encoded;
+  other_schema[0] = static_cast<char>(other_schema[0] ^ 0x01);
+  checks->Expect(mccmod::DecodeTelemetrySnapshot(other_schema.data(), other_schema.size(), &decoded) == 0,
+                 "binary: another schema's fingerprint rejected");
+
+  // Two records back to back decode one at a time.
+  std::string two = encoded;
+  mccmod::EncodeTelemetrySnapshot(TelemetrySnapshot{}, &two);
+  const size_t first = mccmod::DecodeTelemetrySnapshot(two.data(), two.size(), &decoded);
+  checks->Expect(first == encoded.size() &&
+                     mccmod::DecodeTelemetrySnapshot(two.data() + first, two.size() - first, &decoded) ==
+                         two.size() - first &&
+                     !decoded.is_custom_game && decoded.map_name.empty(),
+                 "binary: consecutive records decode in turn");
+}
+
+// A valid snapshot with `set` applied; `valid` is what ValidateSnapshot should say.
+template <typename Set>
+bool ValidatesAs(bool valid, Set set) {
+  TelemetrySnapshot snapshot = SampleSnapshot();
+  snapshot.max_players = 0;
+  set(&snapshot);
+  std::string error;
+  return mccmod::ValidateSnapshot(snapshot, &error) == valid && (valid || !error.empty());
+}
+
+void CheckBounds_Bool(const char*, int, int, void (*)(TelemetrySnapshot*, int), Checks*) {}
+
+void CheckBounds_Int(const char* key, int min, int max, void (*set)(TelemetrySnapshot*, int), Checks* checks) {
+  auto at = [set](int value) { return [set, value](TelemetrySnapshot* s) { set(s, value); }; };
+  checks->Expect(ValidatesAs(true, at(min)) && ValidatesAs(true, at(max)), std::string(key) + ": bounds accepted");
+  checks->Expect(ValidatesAs(false, at(min - 1)) && ValidatesAs(false, at(max + 1)),
+                 std::string(key) + ": outside bounds rejected");
+}
+
+void CheckBounds_String(const char* key, int, int max, void (*set)(TelemetrySnapshot*, int), Checks* checks) {
+  auto length = [set](int bytes) { return [set, bytes](TelemetrySnapshot* s) { set(s, bytes); }; };
+  checks->Expect(ValidatesAs(true, length(max)), std::string(key) + ": longest value accepted");
+  checks->Expect(ValidatesAs(false, length(max + 1)), std::string(key) + ": one byte over rejected");
+}
+
+void CheckBounds_StringList(const char* key, int, int max, void (*set)(TelemetrySnapshot*, int), Checks* checks) {
+  auto items = [set](int count) { return [set, count](TelemetrySnapshot* s) { set(s, count); }; };
+  checks->Expect(ValidatesAs(true, items(max)), std::string(key) + ": most items accepted");
+  checks->Expect(ValidatesAs(false, items(max + 1)), std::string(key) + ": one item over rejected");
+}
+
+// Setters for each type: ints take the value, strings a length in bytes,
+// lists a count of distinct short items.
+void Assign(int* member, int value) { *member = value; }
+void Assign(std::string* member, int bytes) { member->assign(static_cast<size_t>(bytes), 'a'); }
+void Assign(std::vector<std::string>* member, int count) {
+  member->clear();
+  for (int i = 0; i < count; ++i) member->push_back("m" + std::to_string(i));
+}
+void Assign(bool* member, int value) { *member = value != 0; }
+
+void CheckSchemaBounds(Checks* checks) {
+#define MCC_SCHEMA_CHECK_BOUNDS(type, member, key, min, max, flags)                                          \
+  CheckBounds_##type(                                                                                        \
+      key, min, max, [](TelemetrySnapshot* s, int value) { Assign(&s->member, value); }, checks);
+  MCC_TELEMETRY_SCHEMA(MCC_SCHEMA_CHECK_BOUNDS)
+#undef MCC_SCHEMA_CHECK_BOUNDS
+
+  // Rules beyond single-field bounds.
+  checks->Expect(ValidatesAs(false, [](TelemetrySnapshot* s) { s->map_name.clear(); }),
+                 "custom game requires mapName");
+  checks->Expect(ValidatesAs(true, [](TelemetrySnapshot* s) {
+                   s->is_custom_game = false;
+                   s->map_name.clear();
+                   s->game_mode.clear();
+                 }),
+                 "outside a custom game mapName and gameMode may be empty");
+  checks->Expect(ValidatesAs(false, [](TelemetrySnapshot* s) { s->mods = {"a", "a"}; }), "duplicate mods rejected");
+  checks->Expect(ValidatesAs(false, [](TelemetrySnapshot* s) {
+                   s->mods.clear();
+                   for (char c = 'a'; c < 'f'; ++c) s->mods.push_back(std::string(120, c));
+                 }),
+                 "mods over their total byte bound rejected");
+  checks->Expect(ValidatesAs(false, [](TelemetrySnapshot* s) {
+                   s->max_players = 8;
+                   s->player_count = 9;
+                 }),
+                 "playerCount over maxPlayers rejected");
+}
+
+}  // namespace
+
+int main(int argc, char**) {
+  if (argc > 1) {
+    std::cerr << "usage: mcc_telemetry_schema_check" << std::endl;
+    return 2;
+  }
+
+  Checks checks;
+  CheckJson(&checks);
+  CheckBinary(&checks);
+  CheckSchemaBounds(&checks);
+
+  std::cout << "{\"fields\":" << mccmod::kTelemetryFieldCount << ",\"fingerprint\":" << mccmod::kTelemetrySchemaFingerprint
+            << ",\"checks\":{\"passed\":" << checks.passed << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
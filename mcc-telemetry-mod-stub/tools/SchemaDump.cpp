@@ -0,0 +1,130 @@
+// Writes the telemetry envelope JSON Schema generated from MCC_TELEMETRY_SCHEMA.
+// The receiver's contract, pc-app/contracts/telemetry.schema.json, is this
+// tool's output; regenerate it after changing the schema:
+//
+//   mcc_telemetry_schema > pc-app/contracts/telemetry.schema.json
+#include "TelemetryContract.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using mccmod::SchemaType;
+using mccmod::TelemetryFieldInfo;
+
+std::string Quote(const char* text) {
+  return "\"" + mccmod::EscapeJson(text) + "\"";
+}
+
+std::string JoinQuoted(const std::vector<const char*>& keys) {
+  std::string out;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (i > 0) out += ", ";
+    out += Quote(keys[i]);
+  }
+  return out;
+}
+
+std::string FieldSchema(const TelemetryFieldInfo& field) {
+  std::ostringstream out;
+  switch (field.type) {
+    case SchemaType::kBool:
+      out << "{ \"type\": \"boolean\" }";
+      break;
+    case SchemaType::kInt:
+      out << "{ \"type\": \"integer\", \"minimum\": " << field.min << ", \"maximum\": " << field.max << " }";
+      break;
+    case SchemaType::kString:
+      out << "{ \"type\": \"string\", \"maxLength\": " << field.max;
+      if (field.flags & mccmod::kFieldDateTime) out << ", \"format\": \"date-time\"";
+      out << " }";
+      break;
+    case SchemaType::kStringList:
+      out << "{\n"
+          << "          \"type\": \"array\",\n"
+          << "          \"items\": { \"type\": \"string\", \"maxLength\": " << mccmod::kTelemetryItemMaxBytes
+          << " },\n"
+          << "          \"maxItems\": " << field.max << ",\n"
+          << "          \"x-maxTotalBytes\": " << mccmod::kTelemetryListMaxBytes;
+      if (field.flags & mccmod::kFieldUniqueItems) out << ",\n          \"uniqueItems\": true";
+      out << "\n        }";
+      break;
+  }
+  return out.str();
+}
+
+}  // namespace
+
+int main() {
+  std::vector<const char*> required;
+  std::vector<const char*> required_in_custom;
+  for (const TelemetryFieldInfo& field : mccmod::kTelemetryFields) {
+    if (field.flags & mccmod::kFieldRequired) required.push_back(field.json_key);
+    if (field.flags & mccmod::kFieldRequiredInCustomGame) required_in_custom.push_back(field.json_key);
+  }
+
+  std::ostringstream out;
+  out << "{\n"
+      << "  \"$schema\": \"https://json-schema.org/draft/2020-12/schema\",\n"
+      << "  \"$id\": \"mcc-telemetry.schema.json\",\n"
+      << "  \"$comment\": \"Generated by mcc_telemetry_schema from MCC_TELEMETRY_SCHEMA in "
+         "mcc-telemetry-mod-stub/include/TelemetrySchema.h. String limits are in UTF-8 bytes. "
+         "Do not edit by hand.\",\n"
+      << "  \"title\": \"MCC Telemetry Envelope\",\n"
+      << "  \"type\": \"object\",\n"
+      << "  \"required\": [\"version\", \"data\"],\n"
+      << "  \"properties\": {\n"
+      << "    \"version\": {\n"
+      << "      \"type\": \"string\",\n"
+      << "      \"const\": \"1.0\"\n"
+      << "    },\n"
+      << "    \"producer\": { \"type\": \"string\" },\n"
+      << "    \"seq\": { \"type\": \"integer\", \"minimum\": 1 },\n"
+      << "    \"trace\": {\n"
+      << "      \"type\": \"object\",\n"
+      << "      \"$comment\": \"Latency stamps in the producer's monotonic clock (µs), and the wall clock at send.\",\n"
+      << "      \"properties\": {\n"
+      << "        \"captureUs\": { \"type\": \"integer\", \"minimum\": 0 },\n"
+      << "        \"serializedUs\": { \"type\": \"integer\", \"minimum\": 0 },\n"
+      << "        \"sentUs\": { \"type\": \"integer\", \"minimum\": 0 },\n"
+      << "        \"sentWallUs\": { \"type\": \"integer\", \"minimum\": 0 }\n"
+      << "      },\n"
+      << "      \"additionalProperties\": false\n"
+      << "    },\n"
+      << "    \"data\": {\n"
+      << "      \"type\": \"object\",\n"
+      << "      \"required\": [" << JoinQuoted(required) << "],\n"
+      << "      \"properties\": {\n";
+  for (size_t i = 0; i < mccmod::kTelemetryFieldCount; ++i) {
+    const TelemetryFieldInfo& field = mccmod::kTelemetryFields[i];
+    out << "        " << Quote(field.json_key) << ": " << FieldSchema(field)
+        << (i + 1 < mccmod::kTelemetryFieldCount ? "," : "") << "\n";
+  }
+  out << "      },\n";
+  if (!required_in_custom.empty()) {
+    out << "      \"if\": {\n"
+        << "        \"properties\": { \"isCustomGame\": { \"const\": true } },\n"
+        << "        \"required\": [\"isCustomGame\"]\n"
+        << "      },\n"
+        << "      \"then\": {\n"
+        << "        \"required\": [" << JoinQuoted(required_in_custom) << "],\n"
+        << "        \"properties\": {\n";
+    for (size_t i = 0; i < required_in_custom.size(); ++i) {
+      out << "          " << Quote(required_in_custom[i]) << ": { \"minLength\": 1 }"
+          << (i + 1 < required_in_custom.size() ? "," : "") << "\n";
+    }
+    out << "        }\n"
+        << "      },\n";
+  }
+  out << "      \"additionalProperties\": true\n"
+      << "    }\n"
+      << "  },\n"
+      << "  \"additionalProperties\": false\n"
+      << "}\n";
+
+  std::cout << out.str();
+  return 0;
+}
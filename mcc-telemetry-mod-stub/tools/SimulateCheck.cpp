@@ -0,0 +1,158 @@
+// Runs mcc_player_overlay --simulate for a simulated day and checks the tick
+// count, the simulated time the last state file carries, and how long the
+// run took for real. Prints JSON; exits 1 if a check fails.
+//
+//   mcc_simulate_check [--reader PATH] [--seconds N] [--max-real-s N]
+//
+// The reader runs with no target to find, pub/sub, receiver and flight
+// recorder off, so the run is its tick loop, the state file and the clock.
+// The state file goes to /dev/shm when there is one: replacing it on every
+// tick is most of a run's cost on a real disk.
+#include "ChildProcess.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+// The reader's poll interval and VirtualClock's default epoch.
+constexpr uint64_t kPollIntervalMs = 200;
+constexpr int64_t kEpochSeconds = 1704067200;
+
+struct Options {
+  std::string reader;
+  uint64_t seconds = 86400;
+  double max_real_s = 60.0;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--reader" && has_value) {
+      options->reader = argv[++i];
+    } else if (arg == "--seconds" && has_value) {
+      options->seconds = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--max-real-s" && has_value) {
+      options->max_real_s = std::atof(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  if (options->reader.empty()) options->reader = mcctools::SiblingPath("mcc_player_overlay");
+  return !options->reader.empty() && options->seconds > 0 && options->max_real_s > 0;
+}
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::ostringstream text;
+  text << in.rdbuf();
+  return text.str();
+}
+
+// The tick count from "[reader] simulated N s in X s (T ticks)"; -1 if absent.
+int64_t ReportedTicks(const std::string& log) {
+  const size_t at = log.find("[reader] simulated ");
+  if (at == std::string::npos) return -1;
+  const size_t open = log.find('(', at);
+  return open == std::string::npos ? -1 : std::strtoll(log.c_str() + open + 1, nullptr, 10);
+}
+
+std::string JsonString(const std::string& json, const std::string& key) {
+  const std::string needle = "\"" + key + "\":\"";
+  const size_t at = json.rfind(needle);
+  if (at == std::string::npos) return std::string();
+  const size_t start = at + needle.size();
+  const size_t end = json.find('"', start);
+  return end == std::string::npos ? std::string() : json.substr(start, end - start);
+}
+
+// GetIsoUtcNow()'s form of `seconds` after the epoch.
+std::string IsoUtc(int64_t seconds) {
+  const std::time_t raw_time = static_cast<std::time_t>(kEpochSeconds + seconds);
+  std::tm utc{};
+  gmtime_r(&raw_time, &utc);
+  char text[32];
+  std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+  return text;
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_simulate_check [--reader PATH] [--seconds N] [--max-real-s N]" << std::endl;
+    return 2;
+  }
+
+  std::string dir_template = std::filesystem::is_directory("/dev/shm") ? "/dev/shm" : "/tmp";
+  dir_template += "/mcc-simulate-check-XXXXXX";
+  if (!mkdtemp(dir_template.data())) {
+    std::perror("mcc_simulate_check: mkdtemp");
+    return 2;
+  }
+  const std::string dir = dir_template;
+  const std::string log_path = dir + "/reader.log";
+  const std::string state_path = dir + "/state.json";
+
+  const auto start = SteadyClock::now();
+  const pid_t reader_pid = mcctools::Spawn(
+      options.reader, {"--simulate", std::to_string(options.seconds)},
+      {"HMCC_READER_TARGET=simulate" + std::to_string(getpid()), "HMCC_READER_PUBSUB=0", "HMCC_READER_ENDPOINT=",
+       "HMCC_READER_FLIGHT=0", "HMCC_READER_METRICS_PORT=0", "MCC_TELEMETRY_OUT=" + state_path},
+      log_path);
+  int status = 0;
+  const bool exited = reader_pid > 0 && waitpid(reader_pid, &status, 0) == reader_pid;
+  const double real_s = std::chrono::duration<double>(SteadyClock::now() - start).count();
+
+  const int64_t ticks = ReportedTicks(ReadFile(log_path));
+  const std::string last_timestamp = JsonString(ReadFile(state_path), "timestamp");
+  std::filesystem::remove_all(dir);
+
+  // The last tick starts one poll interval before the end; its timestamp is in whole seconds.
+  const uint64_t expected_ticks = options.seconds * 1000 / kPollIntervalMs;
+  const std::string expected_timestamp =
+      IsoUtc(static_cast<int64_t>((options.seconds * 1000 - kPollIntervalMs) / 1000));
+
+  Checks checks;
+  checks.Expect(exited && WIFEXITED(status) && WEXITSTATUS(status) == 0, "reader exited cleanly");
+  checks.Expect(ticks == static_cast<int64_t>(expected_ticks), "one tick per simulated poll interval");
+  checks.Expect(last_timestamp == expected_timestamp, "last state stamped at the simulated end");
+  checks.Expect(real_s <= options.max_real_s, "simulated run within the real-time budget");
+
+  std::cout << "{\"simulatedSeconds\":" << options.seconds << ",\"ticks\":" << ticks
+            << ",\"expectedTicks\":" << expected_ticks << ",\"lastTimestamp\":\"" << last_timestamp
+            << "\",\"expectedTimestamp\":\"" << expected_timestamp << "\",\"realSeconds\":" << real_s
+            << ",\"ticksPerRealSecond\":" << (real_s > 0 ? static_cast<double>(ticks) / real_s : 0.0)
+            << ",\"checks\":{\"passed\":" << checks.passed << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
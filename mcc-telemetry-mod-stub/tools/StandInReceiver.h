@@ -0,0 +1,296 @@
+#pragma once
+
+// Pieces of mcc_telemetry_loadgen's --stand-in receiver, shared with the
+// check tools that post through the real reader.
+#include "Clock.h"
+#include "LatencyHistogram.h"
+#include "TelemetryContract.h"
+
+#if !defined(_WIN32)
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mcctools {
+
+// The envelope's data object, which the receiver keeps per session.
+inline std::string DataObject(const std::string& envelope) {
+  const size_t at = envelope.find("\"data\":");
+  if (at == std::string::npos) return std::string();
+  // The latency trace after the data differs on every attempt; leave it out.
+  const size_t trace = envelope.rfind(",\"trace\":{");
+  return trace == std::string::npos || trace < at ? envelope.substr(at) : envelope.substr(at, trace - at) + "}";
+}
+
+#if !defined(_WIN32)
+
+// One envelope the stand-in applied, for checks of delivery order.
+struct AppliedEnvelope {
+  mccmod::DeliveryId delivery;
+  mccmod::TelemetrySnapshot snapshot;
+};
+
+// Minimal keep-alive HTTP/1.1 receiver: accepts any request whose body is a
+// version 1.0 envelope and answers {"ok":true} with its receipt time in
+// receivedWallUs, as the Node receiver does. Stands in for the Node
+// receiver so the generator measures itself rather than the backend.
+// Like the Node receiver it drops envelopes whose producer/seq it has
+// already applied, and it remembers each session's last applied data.
+// Envelopes carrying a latency trace add their capture-to-ingest time to
+// IngestLatency(). With Flap() it stops listening and cuts every open connection for
+// `down_s` seconds after each `up_s`, as a receiver that keeps restarting.
+class StandInReceiver {
+ public:
+  // Port 0 picks a free one. A fixed port brings the receiver up where a
+  // client already points, as a restarted receiver would.
+  explicit StandInReceiver(uint16_t port = 0) : port_(port) {}
+  ~StandInReceiver() { Stop(); }
+
+  // Keeps every applied envelope, in the order applied. Call before Start().
+  void KeepAppliedLog() { keep_log_ = true; }
+
+  bool Start() {
+    if (!Listen()) return false;
+    accept_thread_ = std::thread(&StandInReceiver::AcceptLoop, this, listen_fd_);
+    return true;
+  }
+
+  void Flap(int up_s, int down_s) {
+    flap_thread_ = std::thread(&StandInReceiver::FlapLoop, this, up_s, down_s);
+  }
+
+  // Ends flapping with the receiver up.
+  void StopFlapping() {
+    if (!flap_thread_.joinable()) return;
+    {
+      std::lock_guard<std::mutex> lock(flap_mutex_);
+      flapping_ = false;
+    }
+    flap_wake_.notify_all();
+    flap_thread_.join();
+  }
+
+  void Stop() {
+    StopFlapping();
+    GoDown();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& thread : threads_) thread.join();
+    threads_.clear();
+  }
+
+  uint16_t Port() const { return port_; }
+  std::string Url() const { return "http://127.0.0.1:" + std::to_string(port_) + "/telemetry"; }
+  uint64_t Requests() const { return requests_.load(); }
+  uint64_t Rejected() const { return rejected_.load(); }
+  uint64_t Duplicates() const { return duplicates_.load(); }
+  uint64_t Outages() const { return outages_.load(); }
+  uint64_t Applied() const { return applied_.load(); }
+  // Microseconds from the producer reading each traced snapshot to its receipt here.
+  mccmod::LatencySummary IngestLatency() const { return ingest_us_.Summary(); }
+
+  mccmod::TelemetrySnapshot LastApplied() {
+    std::lock_guard<std::mutex> lock(applied_mutex_);
+    return last_snapshot_;
+  }
+
+  std::vector<AppliedEnvelope> AppliedLog() {
+    std::lock_guard<std::mutex> lock(applied_mutex_);
+    return applied_log_;
+  }
+
+  // Sessions whose last applied data differs from `expected`.
+  uint64_t CountStale(const std::map<std::string, std::string>& expected) {
+    std::lock_guard<std::mutex> lock(applied_mutex_);
+    uint64_t stale = 0;
+    for (const auto& [session, data] : expected) {
+      auto it = last_data_.find(session);
+      if (it == last_data_.end() || it->second != data) ++stale;
+    }
+    return stale;
+  }
+
+ private:
+  bool Listen() {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) return false;
+    const int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port_);
+    socklen_t length = sizeof(address);
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd_, 256) != 0 ||
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+      close(listen_fd_);
+      listen_fd_ = -1;
+      return false;
+    }
+    port_ = ntohs(address.sin_port);
+    return true;
+  }
+
+  void GoDown() {
+    if (listen_fd_ < 0) return;
+    shutdown(listen_fd_, SHUT_RDWR);
+    close(listen_fd_);
+    listen_fd_ = -1;
+    accept_thread_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int fd : connections_) shutdown(fd, SHUT_RDWR);
+  }
+
+  void FlapLoop(int up_s, int down_s) {
+    std::unique_lock<std::mutex> lock(flap_mutex_);
+    while (true) {
+      if (flap_wake_.wait_for(lock, std::chrono::seconds(up_s), [this] { return !flapping_; })) return;
+      GoDown();
+      outages_.fetch_add(1, std::memory_order_relaxed);
+      flap_wake_.wait_for(lock, std::chrono::seconds(down_s), [this] { return !flapping_; });
+      // Same port, as a restarted receiver would use.
+      if (Listen()) {
+        accept_thread_ = std::thread(&StandInReceiver::AcceptLoop, this, listen_fd_);
+      }
+      if (!flapping_) return;
+    }
+  }
+
+  // Returns false if the envelope's producer/seq was already applied.
+  bool Apply(const std::string& body, int64_t received_wall_us) {
+    mccmod::TelemetrySnapshot snapshot;
+    mccmod::DeliveryId delivery;
+    mccmod::ParseTelemetryEnvelopeJson(body, &snapshot, &delivery, nullptr);
+    const std::string& producer = delivery.producer;
+    const uint64_t seq = delivery.seq;
+    const std::string& session = snapshot.session_id;
+
+    std::lock_guard<std::mutex> lock(applied_mutex_);
+    if (!producer.empty()) {
+      uint64_t& applied = applied_seq_[producer];
+      if (seq <= applied) return false;
+      applied = seq;
+    }
+    last_data_[session] = DataObject(body);
+    last_snapshot_ = snapshot;
+    if (keep_log_) applied_log_.push_back(AppliedEnvelope{delivery, snapshot});
+    applied_.fetch_add(1, std::memory_order_relaxed);
+
+    // sent_wall_us and sent_us are one instant on the two clocks, which puts
+    // the capture on the wall clock this host stamps receipts with.
+    mccmod::DeliveryTrace trace;
+    if (mccmod::ParseEnvelopeTrace(body, &trace) && trace.capture_us != 0 && trace.sent_wall_us != 0 &&
+        trace.sent_us >= trace.capture_us) {
+      const int64_t captured_wall_us = trace.sent_wall_us - static_cast<int64_t>(trace.sent_us - trace.capture_us);
+      ingest_us_.Record(static_cast<uint64_t>(std::max<int64_t>(received_wall_us - captured_wall_us, 0)));
+    }
+    return true;
+  }
+
+  void AcceptLoop(int listen_fd) {
+    while (true) {
+      const int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+      if (fd < 0) return;
+      std::lock_guard<std::mutex> lock(mutex_);
+      connections_.push_back(fd);
+      threads_.emplace_back(&StandInReceiver::Serve, this, fd);
+    }
+  }
+
+  void Serve(int fd) {
+    static const std::string kBad =
+        "HTTP/1.1 400 Bad Request\r\nContent-Type: application/json\r\nContent-Length: 12\r\n\r\n{\"ok\":false}";
+
+    std::string buffer;
+    char chunk[8192];
+    while (true) {
+      size_t header_end;
+      while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+        const ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) return Close(fd);
+        buffer.append(chunk, static_cast<size_t>(received));
+      }
+
+      size_t body_length = 0;
+      const std::string headers = buffer.substr(0, header_end);
+      const size_t length_at = headers.find("Content-Length:");
+      if (length_at != std::string::npos) {
+        body_length = std::strtoul(headers.c_str() + length_at + 15, nullptr, 10);
+      }
+      const size_t total = header_end + 4 + body_length;
+      while (buffer.size() < total) {
+        const ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) return Close(fd);
+        buffer.append(chunk, static_cast<size_t>(received));
+      }
+
+      const int64_t received_wall_us = mccmod::SystemClock().WallUs();
+      const bool valid = buffer.compare(header_end + 4, 16, "{\"version\":\"1.0\"") == 0;
+      requests_.fetch_add(1, std::memory_order_relaxed);
+      if (!valid) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+      } else if (!Apply(buffer.substr(header_end + 4, body_length), received_wall_us)) {
+        duplicates_.fetch_add(1, std::memory_order_relaxed);
+      }
+      const std::string reply = valid ? OkReply(received_wall_us) : kBad;
+      if (send(fd, reply.data(), reply.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(reply.size())) {
+        return Close(fd);
+      }
+      buffer.erase(0, total);
+    }
+  }
+
+  static std::string OkReply(int64_t received_wall_us) {
+    const std::string body = "{\"ok\":true,\"receivedWallUs\":" + std::to_string(received_wall_us) + "}";
+    return "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) +
+           "\r\n\r\n" + body;
+  }
+
+  void Close(int fd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_.erase(std::remove(connections_.begin(), connections_.end(), fd), connections_.end());
+    close(fd);
+  }
+
+  int listen_fd_ = -1;
+  uint16_t port_ = 0;
+  std::thread accept_thread_;
+  std::mutex mutex_;
+  std::vector<int> connections_;
+  std::vector<std::thread> threads_;
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> rejected_{0};
+  std::atomic<uint64_t> duplicates_{0};
+  std::atomic<uint64_t> outages_{0};
+
+  std::thread flap_thread_;
+  std::mutex flap_mutex_;
+  std::condition_variable flap_wake_;
+  bool flapping_ = true;
+
+  std::mutex applied_mutex_;
+  std::map<std::string, uint64_t> applied_seq_;
+  std::map<std::string, std::string> last_data_;
+  mccmod::TelemetrySnapshot last_snapshot_;
+  bool keep_log_ = false;
+  std::vector<AppliedEnvelope> applied_log_;
+  std::atomic<uint64_t> applied_{0};
+  mccmod::LatencyHistogram ingest_us_;
+};
+
+#endif
+
+}  // namespace mcctools
@@ -0,0 +1,253 @@
+// Replays map and mode field bytes through the reader's name decode twice:
+// once decoding every tick, once through StringFieldCache. Reports the
+// decode work the cache avoided and checks that both runs see every change
+// on the same tick. Prints JSON; exits 1 if the runs ever disagree.
+//
+//   mcc_string_replay [--flight PATH] [--ticks N] [--match-ticks N]
+//                     [--verify-every N] [--seed S]
+//
+// Without --flight the timeline is synthetic: a match on a random catalog
+// map and gametype every --match-ticks ticks, with a short lobby between
+// matches where the map field is blank. The secondary mode field is
+// UTF-16LE, and shorter names leave the old tail behind the NUL, as the
+// game does. Halfway through each match it takes a long custom gametype
+// name, and later a second one that differs only past byte 64. With --flight the candidates of a reader flight file are
+// replayed as the field contents instead.
+#include "FlightRecorder.h"
+#include "NameClassifier.h"
+#include "StringFieldCache.h"
+#include "TitleCatalog.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+constexpr size_t kFieldBytes = mccmod::kNameFieldUtf16Bytes;
+constexpr size_t kFieldCount = 3;
+constexpr size_t kLobbyTicks = 25;
+// The reader's field addresses: the map name sits at an odd offset.
+constexpr uintptr_t kFieldAddresses[kFieldCount] = {0x1044D, 0x103B4, 0x10434};
+constexpr const char* kFieldNames[kFieldCount] = {"map", "modePrimary", "modeSecondary"};
+// 36 characters, so in UTF-16LE a change to the character after them lands
+// past byte 64. The bracket makes the UTF-8 reading, "[", fail the
+// classifier, so the field goes through the UTF-16 decode.
+constexpr const char* kLongModeName = "[Community] Slayer Variant Revision ";
+
+struct Options {
+  std::string flight_path;
+  size_t ticks = 18000;
+  size_t match_ticks = 3000;
+  uint32_t verify_every = mccmod::kStringVerifyEvery;
+  uint64_t seed = 1;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--flight" && has_value) {
+      options->flight_path = argv[++i];
+    } else if (arg == "--ticks" && has_value) {
+      options->ticks = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--match-ticks" && has_value) {
+      options->match_ticks = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--verify-every" && has_value) {
+      options->verify_every = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--seed" && has_value) {
+      options->seed = std::strtoull(argv[++i], nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+  return options->ticks > 0 && options->match_ticks > kLobbyTicks;
+}
+
+// As the reader reads them: 128 bytes on aligned fields, 64 on the map's.
+struct Field {
+  std::array<char, kFieldBytes> bytes{};
+};
+
+using Tick = std::array<Field, kFieldCount>;
+
+// Writes `name` and a terminator over the field, leaving the bytes after it.
+void WriteName(const std::string& name, bool utf16, Field* field) {
+  if (utf16) {
+    const size_t units = std::min(name.size(), kFieldBytes / 2 - 1);
+    for (size_t i = 0; i < units; ++i) {
+      field->bytes[i * 2] = name[i];
+      field->bytes[i * 2 + 1] = 0;
+    }
+    field->bytes[units * 2] = 0;
+    field->bytes[units * 2 + 1] = 0;
+  } else {
+    const size_t length = std::min(name.size(), mccmod::kMaxNameTextBytes - 1);
+    std::memcpy(field->bytes.data(), name.data(), length);
+    field->bytes[length] = 0;
+  }
+}
+
+std::vector<Tick> SyntheticTimeline(const Options& options) {
+  std::mt19937_64 rng(options.seed);
+  const size_t map_count = sizeof(mccmod::kCatalogMaps) / sizeof(mccmod::kCatalogMaps[0]);
+  const size_t mode_count = sizeof(mccmod::kCatalogGameModes) / sizeof(mccmod::kCatalogGameModes[0]);
+  std::vector<Tick> timeline(options.ticks);
+  Tick current{};
+  std::string map_name;
+  for (size_t t = 0; t < options.ticks; ++t) {
+    const size_t phase = t % options.match_ticks;
+    if (phase == 0) {
+      map_name = mccmod::kCatalogMaps[rng() % map_count].display_name;
+      const std::string mode_name = mccmod::kCatalogGameModes[rng() % mode_count].display_name;
+      WriteName(mode_name, false, &current[1]);
+      WriteName(mode_name, true, &current[2]);
+      WriteName("", false, &current[0]);
+    } else if (phase == kLobbyTicks) {
+      WriteName(map_name, false, &current[0]);
+    } else if (phase == options.match_ticks / 2) {
+      WriteName(kLongModeName + std::string("A"), true, &current[2]);
+    } else if (phase == options.match_ticks * 3 / 4) {
+      WriteName(kLongModeName + std::string("B"), true, &current[2]);
+    }
+    timeline[t] = current;
+  }
+  return timeline;
+}
+
+bool FlightTimeline(const std::string& path, std::vector<Tick>* timeline, std::string* error) {
+  std::vector<mccmod::FlightRecord> records;
+  if (!mccmod::ReadFlightRecords(path, &records, error)) return false;
+  Tick current{};
+  for (const auto& record : records) {
+    WriteName(std::string(record.map_candidate, strnlen(record.map_candidate, sizeof(record.map_candidate))), false,
+              &current[0]);
+    for (size_t i = 0; i < mccmod::kFlightModeSources; ++i) {
+      const char* mode = record.mode_candidates[i];
+      WriteName(std::string(mode, strnlen(mode, sizeof(record.mode_candidates[i]))), false, &current[1 + i]);
+    }
+    timeline->push_back(current);
+  }
+  return true;
+}
+
+// The reader's decode (DecodeNameField), trim, classify and catalog intern.
+bool DecodeName(size_t field, const Field& raw, std::string* out) {
+  const uintptr_t address = kFieldAddresses[field];
+  mccmod::DecodeNameField(raw.bytes.data(), mccmod::NameFieldReadBytes(address), address,
+                          mccmod::IsLikelyNameText, out);
+  mccmod::TrimInPlace(out);
+  if (!mccmod::IsLikelyNameText(*out)) return false;
+  const mccmod::CatalogEntry* entry =
+      field == 0 ? mccmod::FindCatalogMap(*out) : mccmod::FindCatalogGameMode(*out);
+  if (entry) out->assign(entry->display_name);
+  return true;
+}
+
+struct Decoded {
+  bool accepted = false;
+  std::string value;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_string_replay [--flight PATH] [--ticks N] [--match-ticks N] [--verify-every N] "
+                 "[--seed S]"
+              << std::endl;
+    return 2;
+  }
+
+  std::vector<Tick> timeline;
+  if (options.flight_path.empty()) {
+    timeline = SyntheticTimeline(options);
+  } else {
+    std::string error;
+    if (!FlightTimeline(options.flight_path, &timeline, &error)) {
+      std::cerr << "mcc_string_replay: " << error << std::endl;
+      return 2;
+    }
+  }
+
+  // Full decode every tick: the reference, and the baseline timing.
+  std::vector<std::array<Decoded, kFieldCount>> reference(timeline.size());
+  const auto full_start = SteadyClock::now();
+  for (size_t t = 0; t < timeline.size(); ++t) {
+    for (size_t f = 0; f < kFieldCount; ++f) {
+      reference[t][f].accepted = DecodeName(f, timeline[t][f], &reference[t][f].value);
+    }
+  }
+  const double full_ns = std::chrono::duration<double, std::nano>(SteadyClock::now() - full_start).count();
+
+  std::array<mccmod::StringFieldCache, kFieldCount> caches;
+  caches.fill(mccmod::StringFieldCache(options.verify_every));
+  std::vector<std::array<Decoded, kFieldCount>> incremental(timeline.size());
+  const auto incremental_start = SteadyClock::now();
+  for (size_t t = 0; t < timeline.size(); ++t) {
+    for (size_t f = 0; f < kFieldCount; ++f) {
+      Decoded& out = incremental[t][f];
+      const Field& raw = timeline[t][f];
+      const size_t size = mccmod::NameFieldReadBytes(kFieldAddresses[f]);
+      if (!caches[f].Lookup(kFieldAddresses[f], raw.bytes.data(), size, &out.accepted, &out.value)) {
+        out.accepted = DecodeName(f, raw, &out.value);
+        caches[f].Store(out.accepted, out.value);
+      }
+    }
+  }
+  const double incremental_ns =
+      std::chrono::duration<double, std::nano>(SteadyClock::now() - incremental_start).count();
+
+  // A tick where the runs disagree is a tick the cache saw a change late.
+  size_t changes = 0;
+  size_t mismatched_ticks = 0;
+  size_t max_lag_ticks = 0;
+  std::array<size_t, kFieldCount> lag{};
+  for (size_t t = 0; t < timeline.size(); ++t) {
+    for (size_t f = 0; f < kFieldCount; ++f) {
+      const Decoded& want = reference[t][f];
+      const Decoded& got = incremental[t][f];
+      if (t > 0 && (want.accepted != reference[t - 1][f].accepted || want.value != reference[t - 1][f].value)) {
+        ++changes;
+      }
+      if (want.accepted != got.accepted || want.value != got.value) {
+        ++mismatched_ticks;
+        max_lag_ticks = std::max(max_lag_ticks, ++lag[f]);
+      } else {
+        lag[f] = 0;
+      }
+    }
+  }
+
+  mccmod::StringFieldStats total;
+  std::cout << "{\"source\":\"" << (options.flight_path.empty() ? "synthetic" : "flight")
+            << "\",\"ticks\":" << timeline.size() << ",\"verifyEvery\":" << options.verify_every
+            << ",\"changes\":" << changes << ",\"fields\":{";
+  for (size_t f = 0; f < kFieldCount; ++f) {
+    const mccmod::StringFieldStats& stats = caches[f].Stats();
+    total.lookups += stats.lookups;
+    total.reused += stats.reused;
+    total.decoded += stats.decoded;
+    total.verified += stats.verified;
+    total.verify_changed += stats.verify_changed;
+    std::cout << (f ? "," : "") << "\"" << kFieldNames[f] << "\":{\"reused\":" << stats.reused
+              << ",\"decoded\":" << stats.decoded << ",\"verified\":" << stats.verified << "}";
+  }
+  const double ticks = static_cast<double>(timeline.size());
+  const double avoided = total.lookups ? 100.0 * static_cast<double>(total.reused) / total.lookups : 0.0;
+  std::cout << std::fixed << std::setprecision(1) << "},\"decodesAvoidedPct\":" << avoided
+            << ",\"verifyChanged\":" << total.verify_changed << ",\"nsPerTick\":{\"full\":" << full_ns / ticks
+            << ",\"incremental\":" << incremental_ns / ticks << "},\"mismatchedTicks\":" << mismatched_ticks
+            << ",\"maxLagTicks\":" << max_lag_ticks << "}" << std::endl;
+  return mismatched_ticks == 0 ? 0 : 1;
+}
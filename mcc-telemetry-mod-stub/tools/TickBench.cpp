@@ -0,0 +1,141 @@
+// Measures how late loop ticks start, TickScheduler against the relative
+// sleep_for pacing the reader and the DLL used before, and prints p50/p99
+// lateness as JSON.
+//
+//   mcc_tick_bench [--period-ms N] [--ticks N] [--work-us N] [--contention N] [--policy skip|catch-up]
+//
+// Each tick busy-works for --work-us, like a sample or a delivery would,
+// while --contention threads spin on every core they can get. Lateness is
+// measured against the ideal schedule (start + n * period), so drift from
+// relative sleeps shows up as growing lateness rather than hiding in it.
+#include "LatencyHistogram.h"
+#include "TickScheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+struct Options {
+  uint64_t period_ms = 10;
+  uint64_t ticks = 300;
+  uint64_t work_us = 1000;
+  unsigned contention = 0;
+  mccmod::MissedTickPolicy policy = mccmod::MissedTickPolicy::kSkip;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--period-ms" && has_value) {
+      options->period_ms = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--ticks" && has_value) {
+      options->ticks = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--work-us" && has_value) {
+      options->work_us = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--contention" && has_value) {
+      options->contention = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--policy" && has_value) {
+      const std::string policy = argv[++i];
+      if (policy == "skip") {
+        options->policy = mccmod::MissedTickPolicy::kSkip;
+      } else if (policy == "catch-up") {
+        options->policy = mccmod::MissedTickPolicy::kCatchUp;
+      } else {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return options->period_ms > 0 && options->ticks > 0;
+}
+
+uint64_t MicrosSince(SteadyClock::time_point start) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - start).count());
+}
+
+void BusyWork(uint64_t work_us) {
+  const auto until = SteadyClock::now() + std::chrono::microseconds(work_us);
+  while (SteadyClock::now() < until) {
+  }
+}
+
+// Lateness of a tick that started at `elapsed_us` against the ideal schedule.
+void RecordLateness(uint64_t elapsed_us, uint64_t tick, uint64_t period_us, mccmod::LatencyHistogram* histogram) {
+  const uint64_t ideal_us = tick * period_us;
+  histogram->Record(elapsed_us > ideal_us ? elapsed_us - ideal_us : 0);
+}
+
+void PrintSummary(const char* name, const mccmod::LatencySummary& summary) {
+  std::cout << "\"" << name << "\":{\"p50\":" << summary.p50 << ",\"p90\":" << summary.p90
+            << ",\"p99\":" << summary.p99 << ",\"max\":" << summary.max << "}";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_tick_bench [--period-ms N] [--ticks N] [--work-us N] [--contention N]\n"
+                 "                      [--policy skip|catch-up]"
+              << std::endl;
+    return 2;
+  }
+  const uint64_t period_us = options.period_ms * 1000;
+
+  std::atomic<bool> spinning{true};
+  std::vector<std::thread> spinners;
+  for (unsigned i = 0; i < options.contention; ++i) {
+    spinners.emplace_back([&spinning] {
+      while (spinning.load(std::memory_order_relaxed)) {
+      }
+    });
+  }
+
+  // Before: work, then sleep one period, so every tick's work and oversleep
+  // pushes all later ticks back.
+  mccmod::LatencyHistogram sleep_for_lateness;
+  const auto sleep_for_start = SteadyClock::now();
+  for (uint64_t tick = 0; tick < options.ticks; ++tick) {
+    RecordLateness(MicrosSince(sleep_for_start), tick, period_us, &sleep_for_lateness);
+    BusyWork(options.work_us);
+    std::this_thread::sleep_for(std::chrono::microseconds(period_us));
+  }
+
+  // After: the scheduler's own lateness histogram is per deadline it kept;
+  // skipped deadlines are counted in `missed` instead.
+  mccmod::TickSchedulerOptions scheduler_options;
+  scheduler_options.period_us = period_us;
+  scheduler_options.missed = options.policy;
+  mccmod::TickScheduler scheduler(scheduler_options);
+  for (uint64_t tick = 0; tick < options.ticks; ++tick) {
+    scheduler.WaitNextTick();
+    BusyWork(options.work_us);
+  }
+
+  spinning.store(false);
+  for (auto& spinner : spinners) spinner.join();
+
+  const mccmod::TickSchedulerStats stats = scheduler.GetStats();
+  std::cout << "{\"periodMs\":" << options.period_ms << ",\"ticks\":" << options.ticks
+            << ",\"workUs\":" << options.work_us << ",\"contention\":" << options.contention
+            << ",\"hardwareThreads\":" << std::thread::hardware_concurrency() << ",\"policy\":\""
+            << mccmod::MissedTickPolicyName(options.policy) << "\",\"latenessUs\":{";
+  PrintSummary("sleepFor", sleep_for_lateness.Summary());
+  std::cout << ",";
+  PrintSummary("scheduler", stats.lateness_us);
+  std::cout << "},\"scheduler\":{\"missed\":" << stats.missed << ",\"caughtUp\":" << stats.caught_up
+            << ",\"highResolution\":" << (stats.high_resolution ? "true" : "false") << "}}" << std::endl;
+  return 0;
+}
@@ -0,0 +1,213 @@
+// Prints the MCC map and gametype catalog (TitleCatalog.h) as JSON. With
+// --bench it times catalog lookups against the reader's previous Reach-only
+// whitelist check; with --check it verifies every entry resolves by name and
+// ID and exits 1 if a check fails.
+//
+//   mcc_title_catalog [--bench [ITERATIONS] | --check]
+#include "TelemetryContract.h"
+#include "TitleCatalog.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+using mccmod::CatalogEntry;
+
+// The whitelist check the reader used before the catalog: normalize the
+// input, then re-normalize and compare all 25 Reach maps on every call.
+std::string LegacyNormalizeMapName(const std::string& name) {
+  std::string out;
+  out.reserve(name.size());
+  for (char c : name) {
+    if (std::isalnum(static_cast<unsigned char>(c))) {
+      out.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+  }
+  return out;
+}
+
+bool LegacyIsReachMapName(const std::string& name) {
+  static const std::vector<std::string> kReachMaps = {
+      "Boardwalk",  "Boneyard",   "Countdown", "Powerhouse", "Reflection", "Spire",         "Sword Base",
+      "Zealot",     "Forge World", "Asylum",   "Hemorrhage", "Paradiso",   "Pinnacle",      "The Cage",
+      "Anchor 9",   "Breakpoint", "Tempest",   "Condemned",  "Highlands",  "Battle Canyon", "Breakneck",
+      "High Noon",  "Penance",    "Ridgeline", "Solitary"};
+
+  const std::string normalized = LegacyNormalizeMapName(name);
+  for (const auto& entry : kReachMaps) {
+    if (LegacyNormalizeMapName(entry) == normalized) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AppendEntries(const CatalogEntry* begin, const CatalogEntry* end, std::ostream& out) {
+  for (const CatalogEntry* entry = begin; entry != end; ++entry) {
+    if (entry != begin) out << ",";
+    out << "{\"id\":" << entry->id << ",\"name\":\"" << mccmod::EscapeJson(entry->display_name)
+        << "\",\"titles\":[";
+    bool first = true;
+    for (uint8_t title = 0; title < static_cast<uint8_t>(mccmod::MccTitle::kCount); ++title) {
+      if (!(entry->titles & (1u << title))) continue;
+      if (!first) out << ",";
+      first = false;
+      out << "\"" << mccmod::TitleTag(static_cast<mccmod::MccTitle>(title)) << "\"";
+    }
+    out << "]}";
+  }
+}
+
+template <typename Lookup>
+double NsPerLookup(const std::vector<std::string>& probes, long iterations, size_t* hits, const Lookup& lookup) {
+  size_t found = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; ++i) {
+    found += lookup(probes[static_cast<size_t>(i) % probes.size()]) ? 1 : 0;
+  }
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  *hits = found;
+  return ns / static_cast<double>(iterations);
+}
+
+int RunBench(long iterations) {
+  // What the reader sees: canonical names, other spellings, and misses that
+  // pass the character checks (menu text, other titles' strings).
+  const std::vector<std::string> probes = {
+      "Sword Base", "sword_base", "FORGE WORLD", "The Cage", "Anchor 9", "Solitary", "Highlands",
+      "Unknown",    "Main Menu",  "Loading...",  "mp_convoy", "Slayer",  "Zealot",   "Spire"};
+
+  size_t legacy_hits = 0;
+  size_t catalog_hits = 0;
+  size_t reach_hits = 0;
+  const double legacy_ns = NsPerLookup(probes, iterations, &legacy_hits, LegacyIsReachMapName);
+  const double catalog_ns = NsPerLookup(probes, iterations, &catalog_hits, [](const std::string& name) {
+    return mccmod::FindCatalogMap(name) != nullptr;
+  });
+  // Same answer set as the legacy check: a catalog hit on a Reach map.
+  NsPerLookup(probes, iterations, &reach_hits, [](const std::string& name) {
+    const CatalogEntry* entry = mccmod::FindCatalogMap(name);
+    return entry && entry->Title() == mccmod::MccTitle::kHaloReach;
+  });
+
+  std::cout << std::fixed << std::setprecision(1) << "{\"iterations\":" << iterations
+            << ",\"legacyReachNs\":" << legacy_ns << ",\"catalogNs\":" << catalog_ns
+            << ",\"speedup\":" << (catalog_ns > 0.0 ? legacy_ns / catalog_ns : 0.0)
+            << ",\"legacyHits\":" << legacy_hits << ",\"catalogReachHits\":" << reach_hits
+            << ",\"catalogHits\":" << catalog_hits << "}" << std::endl;
+  return legacy_hits == reach_hits ? 0 : 1;
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+// Every entry must come back from its own display name and its ID; anything
+// else means the perfect hash or the normalization dropped or merged one.
+template <typename Find>
+void CheckEntries(const CatalogEntry* begin, const CatalogEntry* end, const char* kind, const Find& find,
+                  Checks* checks) {
+  std::vector<std::string> by_name;
+  std::vector<std::string> by_id;
+  for (const CatalogEntry* entry = begin; entry != end; ++entry) {
+    if (find(entry->display_name) != entry) by_name.push_back(entry->display_name);
+    if (mccmod::FindCatalogId(entry->id) != entry) by_id.push_back(std::to_string(entry->id));
+  }
+  // Failures name the entries, escaped for the JSON report.
+  const auto listed = [](const std::vector<std::string>& items) {
+    std::string out;
+    for (const std::string& item : items) out += (out.empty() ? " (" : ", ") + mccmod::EscapeJson(item);
+    return out.empty() ? out : out + ")";
+  };
+  checks->Expect(by_name.empty(), std::string(kind) + ": every display name resolves to its entry" + listed(by_name));
+  checks->Expect(by_id.empty(), std::string(kind) + ": every id resolves to its entry" + listed(by_id));
+}
+
+int RunCheck() {
+  Checks checks;
+  CheckEntries(std::begin(mccmod::kCatalogMaps), std::end(mccmod::kCatalogMaps), "maps", mccmod::FindCatalogMap,
+               &checks);
+  CheckEntries(std::begin(mccmod::kCatalogGameModes), std::end(mccmod::kCatalogGameModes), "gameModes",
+               mccmod::FindCatalogGameMode, &checks);
+
+  // Spellings the reader sees: internal names, other case, punctuation dropped.
+  const auto map_named = [](const char* probe, const char* name) {
+    const CatalogEntry* entry = mccmod::FindCatalogMap(probe);
+    return entry && std::string(entry->display_name) == name;
+  };
+  checks.Expect(map_named("sword_base", "Sword Base") && map_named("SWORD BASE", "Sword Base") &&
+                    mccmod::FindCatalogMap("Sword Base")->Title() == mccmod::MccTitle::kHaloReach,
+                "other spellings of a Reach map resolve");
+  checks.Expect(map_named("hang em high", "Hang 'Em High"), "apostrophes ignored");
+  const CatalogEntry* ctf = mccmod::FindCatalogGameMode("capture the flag");
+  checks.Expect(ctf && std::string(ctf->display_name) == "Capture the Flag", "gametype resolves in lowercase");
+
+  bool misses = true;
+  for (const char* probe : {"Unknown", "", "swordbasex", "Main Menu", "mp_convoy"}) {
+    misses = misses && !mccmod::FindCatalogMap(probe) && !mccmod::FindCatalogGameMode(probe);
+  }
+  checks.Expect(misses, "names outside the catalog do not resolve");
+  checks.Expect(!mccmod::FindCatalogMap("Slayer") && !mccmod::FindCatalogGameMode("Sword Base"),
+                "maps and gametypes do not cross");
+  checks.Expect(!mccmod::FindCatalogId(0) && !mccmod::FindCatalogId(65535), "unknown ids do not resolve");
+
+  std::cout << "{\"maps\":" << std::size(mccmod::kCatalogMaps) << ",\"gameModes\":"
+            << std::size(mccmod::kCatalogGameModes) << ",\"checks\":{\"passed\":" << checks.passed
+            << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::string mode = argc > 1 ? argv[1] : "";
+  if (mode == "--bench") {
+    const long iterations = argc > 2 ? std::atol(argv[2]) : 2000000;
+    if (iterations <= 0) {
+      std::cerr << "usage: mcc_title_catalog [--bench [ITERATIONS] | --check]" << std::endl;
+      return 2;
+    }
+    return RunBench(iterations);
+  }
+  if (mode == "--check" && argc == 2) {
+    return RunCheck();
+  }
+  if (!mode.empty()) {
+    std::cerr << "usage: mcc_title_catalog [--bench [ITERATIONS] | --check]" << std::endl;
+    return 2;
+  }
+
+  std::cout << "{\"titles\":[";
+  for (uint8_t title = 0; title < static_cast<uint8_t>(mccmod::MccTitle::kCount); ++title) {
+    const auto value = static_cast<mccmod::MccTitle>(title);
+    if (title > 0) std::cout << ",";
+    std::cout << "{\"tag\":\"" << mccmod::TitleTag(value) << "\",\"name\":\""
+              << mccmod::EscapeJson(mccmod::TitleDisplayName(value)) << "\"}";
+  }
+  std::cout << "],\"maps\":[";
+  AppendEntries(std::begin(mccmod::kCatalogMaps), std::end(mccmod::kCatalogMaps), std::cout);
+  std::cout << "],\"gameModes\":[";
+  AppendEntries(std::begin(mccmod::kCatalogGameModes), std::end(mccmod::kCatalogGameModes), std::cout);
+  std::cout << "]}" << std::endl;
+  return 0;
+}
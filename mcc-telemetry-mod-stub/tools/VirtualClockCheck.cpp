@@ -0,0 +1,219 @@
+// Drives VirtualClock from several participant threads and checks that time
+// only moves once all of them sleep. Prints JSON; exits 1 if a check fails.
+//
+//   mcc_virtual_clock_check [--ticks N]
+//
+// Each scenario registers its threads before starting them, as TelemetryMod
+// does. The last one runs --ticks sleeps on each of four threads with
+// different periods and reports how many simulated wakeups a real second
+// buys.
+#include "Clock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+// Long enough for the other thread to be asleep on the clock.
+constexpr auto kSettle = std::chrono::milliseconds(50);
+
+struct Options {
+  uint64_t ticks = 100000;
+};
+
+bool ParseOptions(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "--ticks" && has_value) {
+      options->ticks = std::strtoull(argv[++i], nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+  return options->ticks > 0;
+}
+
+struct Checks {
+  int passed = 0;
+  std::vector<std::string> failed;
+
+  void Expect(bool ok, const std::string& what) {
+    if (ok) {
+      ++passed;
+    } else {
+      failed.push_back(what);
+    }
+  }
+};
+
+// Sleeps on `clock` every `period_ms` until `end_ms`, with a little real work
+// after each wake, and returns the time seen on waking.
+std::vector<uint64_t> RunPeriodic(mccmod::VirtualClock* clock, uint64_t period_ms, uint64_t end_ms) {
+  std::vector<uint64_t> woke_at;
+  for (uint64_t deadline = period_ms; deadline <= end_ms; deadline += period_ms) {
+    clock->SleepUntil(deadline);
+    woke_at.push_back(clock->SteadyMs());
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  clock->RemoveParticipant();
+  return woke_at;
+}
+
+std::vector<uint64_t> Multiples(uint64_t period_ms, uint64_t end_ms) {
+  std::vector<uint64_t> values;
+  for (uint64_t value = period_ms; value <= end_ms; value += period_ms) values.push_back(value);
+  return values;
+}
+
+// Two loops with coprime periods: each must wake exactly on its own deadlines.
+void CheckInterleave(Checks* checks) {
+  mccmod::VirtualClock clock;
+  clock.AddParticipant();
+  clock.AddParticipant();
+  std::vector<uint64_t> threes;
+  std::vector<uint64_t> fives;
+  std::thread a([&] { threes = RunPeriodic(&clock, 3, 60); });
+  std::thread b([&] { fives = RunPeriodic(&clock, 5, 60); });
+  a.join();
+  b.join();
+  checks->Expect(threes == Multiples(3, 60) && fives == Multiples(5, 60), "participants wake on their own deadlines");
+  checks->Expect(clock.SteadyMs() == 60 && clock.Wakeups() == threes.size() + fives.size(), "wakeups counted");
+}
+
+// One participant asleep, the other busy in real time: time must not move.
+void CheckFrozenWhileRunning(Checks* checks) {
+  mccmod::VirtualClock clock;
+  clock.AddParticipant();
+  clock.AddParticipant();
+  uint64_t sleeper_woke = 0;
+  uint64_t seen_while_working = 0;
+  std::thread sleeper([&] {
+    clock.SleepUntil(10);
+    sleeper_woke = clock.SteadyMs();
+    clock.RemoveParticipant();
+  });
+  std::thread worker([&] {
+    std::this_thread::sleep_for(kSettle);
+    seen_while_working = clock.SteadyMs();
+    clock.SleepUntil(20);
+    clock.RemoveParticipant();
+  });
+  sleeper.join();
+  worker.join();
+  checks->Expect(seen_while_working == 0, "time frozen while a participant runs");
+  checks->Expect(sleeper_woke == 10 && clock.SteadyMs() == 20, "time advanced once both slept");
+}
+
+// A participant that leaves without sleeping releases the others.
+void CheckRemoveReleases(Checks* checks) {
+  mccmod::VirtualClock clock;
+  clock.AddParticipant();
+  clock.AddParticipant();
+  uint64_t sleeper_woke = 0;
+  std::thread sleeper([&] {
+    clock.SleepUntil(10);
+    sleeper_woke = clock.SteadyMs();
+    clock.RemoveParticipant();
+  });
+  std::this_thread::sleep_for(kSettle);
+  const uint64_t before_remove = clock.Wakeups();
+  clock.RemoveParticipant();
+  sleeper.join();
+  checks->Expect(before_remove == 0 && sleeper_woke == 10, "removing a participant releases the sleepers");
+}
+
+// A registered driver that never sleeps moves time only through Advance().
+void CheckAdvance(Checks* checks) {
+  mccmod::VirtualClock clock;
+  clock.AddParticipant();
+  clock.AddParticipant();
+  uint64_t sleeper_woke = 0;
+  std::thread sleeper([&] {
+    clock.SleepUntil(100);
+    sleeper_woke = clock.SteadyMs();
+    clock.RemoveParticipant();
+  });
+  std::this_thread::sleep_for(kSettle);
+  clock.Advance(40);
+  std::this_thread::sleep_for(kSettle);
+  const bool short_of_deadline = clock.SteadyMs() == 40 && clock.Wakeups() == 0;
+  clock.Advance(60);
+  sleeper.join();
+  clock.RemoveParticipant();
+  checks->Expect(short_of_deadline, "Advance() short of a deadline wakes nobody");
+  checks->Expect(sleeper_woke == 100 && clock.Wakeups() == 1, "Advance() to a deadline wakes its sleeper");
+}
+
+struct Throughput {
+  uint64_t wakeups = 0;
+  uint64_t simulated_ms = 0;
+  double real_seconds = 0.0;
+};
+
+// Four loops sleeping back to back, as fast as the clock hands out time.
+Throughput MeasureThroughput(uint64_t ticks, Checks* checks) {
+  const std::vector<uint64_t> periods = {200, 250, 1000, 1000};
+  mccmod::VirtualClock clock;
+  for (size_t i = 0; i < periods.size(); ++i) clock.AddParticipant();
+  std::vector<char> on_schedule(periods.size(), 1);
+  std::vector<std::thread> loops;
+  const auto start = SteadyClock::now();
+  for (size_t i = 0; i < periods.size(); ++i) {
+    loops.emplace_back([&clock, &on_schedule, &periods, i, ticks] {
+      for (uint64_t tick = 1; tick <= ticks; ++tick) {
+        clock.SleepUntil(tick * periods[i]);
+        if (clock.SteadyMs() != tick * periods[i]) on_schedule[i] = 0;
+      }
+      clock.RemoveParticipant();
+    });
+  }
+  for (std::thread& loop : loops) loop.join();
+
+  Throughput result;
+  result.real_seconds = std::chrono::duration<double>(SteadyClock::now() - start).count();
+  result.wakeups = clock.Wakeups();
+  result.simulated_ms = clock.SteadyMs();
+  checks->Expect(std::all_of(on_schedule.begin(), on_schedule.end(), [](char ok) { return ok != 0; }),
+                 "every loop woke on schedule");
+  checks->Expect(result.wakeups == ticks * periods.size() &&
+                     result.simulated_ms == ticks * *std::max_element(periods.begin(), periods.end()),
+                 "simulated schedule complete");
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: mcc_virtual_clock_check [--ticks N]" << std::endl;
+    return 2;
+  }
+
+  Checks checks;
+  CheckInterleave(&checks);
+  CheckFrozenWhileRunning(&checks);
+  CheckRemoveReleases(&checks);
+  CheckAdvance(&checks);
+  const Throughput throughput = MeasureThroughput(options.ticks, &checks);
+
+  std::cout << "{\"ticks\":" << options.ticks << ",\"wakeups\":" << throughput.wakeups
+            << ",\"simulatedSeconds\":" << throughput.simulated_ms / 1000 << ",\"realSeconds\":"
+            << throughput.real_seconds << ",\"wakeupsPerRealSecond\":"
+            << (throughput.real_seconds > 0 ? static_cast<double>(throughput.wakeups) / throughput.real_seconds : 0.0)
+            << ",\"checks\":{\"passed\":" << checks.passed << ",\"failed\":[";
+  for (size_t i = 0; i < checks.failed.size(); ++i) {
+    std::cout << (i ? "," : "") << "\"" << checks.failed[i] << "\"";
+  }
+  std::cout << "]}}" << std::endl;
+  return checks.failed.empty() ? 0 : 1;
+}
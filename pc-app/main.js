@@ -1221,6 +1221,7 @@ function buildTelemetryState() {
         : null,
     hostName: state.hostName || "Host",
     requiredMods: Array.isArray(state.requiredMods) ? state.requiredMods : [],
+    roster: state.roster || null,
     sessionId: state.sessionId || "",
     timestamp: state.timestamp || null,
     lastUpdatedAt: telemetry?.lastUpdatedAt || null,
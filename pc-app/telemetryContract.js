@@ -29,6 +29,86 @@ function normalizeUpdatedFlag(value) {
   return null;
 }
 
+// The reader's optional roster section: { version, players: [{ name, team, slot }] }.
+// Team is -1 when the mode has none. Null when the section is absent.
+function normalizeRoster(roster) {
+  if (!roster || typeof roster !== "object" || !Array.isArray(roster.players)) {
+    return null;
+  }
+  return {
+    version: Number(roster.version) || 0,
+    players: roster.players
+      .filter((player) => player && typeof player.name === "string" && player.name)
+      .map((player) => ({
+        name: player.name,
+        team: Number.isInteger(player.team) ? player.team : -1,
+        slot: Number.isInteger(player.slot) ? player.slot : 0,
+      })),
+  };
+}
+
+// Field types and bounds come from the generated contract, so the receiver
+// checks exactly what the native validator checks (lengths in UTF-8 bytes).
+const TELEMETRY_SCHEMA = require("./contracts/telemetry.schema.json");
+const DATA_SCHEMA = TELEMETRY_SCHEMA.properties.data;
+const REQUIRED_IN_CUSTOM_GAME = (DATA_SCHEMA.then && DATA_SCHEMA.then.required) || [];
+
+// Older producers use short keys; they satisfy the same fields.
+const FIELD_ALIASES = {
+  mapName: ["map"],
+  gameMode: ["mode"],
+  playerCount: ["players", "currentPlayers"],
+};
+
+function readField(payload, key) {
+  if (payload[key] !== undefined) return payload[key];
+  for (const alias of FIELD_ALIASES[key] || []) {
+    if (payload[alias] !== undefined) return payload[alias];
+  }
+  return undefined;
+}
+
+function validateField(key, spec, value, issues) {
+  if (spec.type === "boolean") {
+    if (value !== undefined && typeof value !== "boolean") {
+      issues.push(`${key} must be a boolean.`);
+    }
+    return;
+  }
+  if (spec.type === "integer") {
+    const number = Number(value ?? 0);
+    if (Number.isNaN(number) || number < spec.minimum || number > spec.maximum) {
+      issues.push(`${key} out of range (${spec.minimum}-${spec.maximum}).`);
+    }
+    return;
+  }
+  if (spec.type === "string") {
+    if (value !== undefined && Buffer.byteLength(String(value), "utf8") > spec.maxLength) {
+      issues.push(`${key} longer than ${spec.maxLength} bytes.`);
+    }
+    return;
+  }
+  if (spec.type === "array" && value !== undefined) {
+    if (!Array.isArray(value)) {
+      issues.push(`${key} must be an array.`);
+    } else if (value.length > spec.maxItems) {
+      issues.push(`${key} has more than ${spec.maxItems} items.`);
+    } else if (
+      value.some(
+        (item) => Buffer.byteLength(String(item ?? ""), "utf8") > spec.items.maxLength
+      )
+    ) {
+      issues.push(`${key} item longer than ${spec.items.maxLength} bytes.`);
+    } else if (
+      spec["x-maxTotalBytes"] !== undefined &&
+      value.reduce((sum, item) => sum + Buffer.byteLength(String(item ?? ""), "utf8"), 0) >
+        spec["x-maxTotalBytes"]
+    ) {
+      issues.push(`${key} longer than ${spec["x-maxTotalBytes"]} bytes in total.`);
+    }
+  }
+}
+
 function validatePayload(payload) {
   const issues = [];
   if (!payload || typeof payload !== "object") {
@@ -36,36 +116,28 @@ function validatePayload(payload) {
     return issues;
   }
 
-  if (typeof payload.isCustomGame !== "boolean") {
-    issues.push("isCustomGame must be a boolean.");
+  for (const key of DATA_SCHEMA.required) {
+    if (readField(payload, key) === undefined) {
+      issues.push(`${key} is required.`);
+    }
   }
 
-  if (payload.isCustomGame === true) {
-    if (!payload.mapName && !payload.map) issues.push("Missing map name.");
-    if (!payload.gameMode && !payload.mode) issues.push("Missing game mode.");
+  for (const [key, spec] of Object.entries(DATA_SCHEMA.properties)) {
+    validateField(key, spec, readField(payload, key), issues);
   }
 
-  const playerCount = Number(
-    payload.playerCount ?? payload.players ?? payload.currentPlayers ?? 0
-  );
-  const maxPlayers = Number(payload.maxPlayers ?? 0);
-
-  if (Number.isNaN(playerCount) || playerCount < 0 || playerCount > 32) {
-    issues.push("playerCount out of range (0-32).");
-  }
-
-  if (Number.isNaN(maxPlayers) || maxPlayers < 0 || maxPlayers > 32) {
-    issues.push("maxPlayers out of range (0-32).");
+  if (payload.isCustomGame === true) {
+    for (const key of REQUIRED_IN_CUSTOM_GAME) {
+      if (!readField(payload, key)) issues.push(`Missing ${key} while in custom game.`);
+    }
   }
 
+  const playerCount = Number(readField(payload, "playerCount") ?? 0);
+  const maxPlayers = Number(payload.maxPlayers ?? 0);
   if (maxPlayers > 0 && playerCount > maxPlayers) {
     issues.push("playerCount exceeds maxPlayers.");
   }
 
-  if (payload.mods !== undefined && !Array.isArray(payload.mods)) {
-    issues.push("mods must be an array.");
-  }
-
   return issues;
 }
 
@@ -83,9 +155,11 @@ function normalizeState(payload, version) {
       maxPlayers: 0,
       isModded: false,
       requiredMods: [],
+      modsFingerprint: "",
       sessionId: "",
       timestamp: null,
       schemaVersion: version || DEFAULT_SCHEMA_VERSION,
+      roster: null,
     };
   }
 
@@ -114,6 +188,7 @@ function normalizeState(payload, version) {
     maxPlayers: Number(payload.maxPlayers || 0),
     isModded,
     requiredMods,
+    modsFingerprint: String(payload.modsFingerprint || ""),
     sessionId: String(payload.sessionID || payload.sessionId || "").trim(),
     timestamp: payload.timestamp || null,
     schemaVersion: version || DEFAULT_SCHEMA_VERSION,
@@ -122,6 +197,7 @@ function normalizeState(payload, version) {
     mapUpdatedThisTick: normalizeUpdatedFlag(payload.mapUpdatedThisTick),
     modeUpdatedThisTick: normalizeUpdatedFlag(payload.modeUpdatedThisTick),
     playersUpdatedThisTick: normalizeUpdatedFlag(payload.playersUpdatedThisTick),
+    roster: normalizeRoster(payload.roster),
   };
 }
 
@@ -148,6 +224,7 @@ function toCanonicalEnvelope(raw) {
 module.exports = {
   DEFAULT_SCHEMA_VERSION,
   normalizeMods,
+  normalizeRoster,
   unwrapEnvelope,
   validatePayload,
   normalizeState,
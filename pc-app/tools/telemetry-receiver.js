@@ -1,6 +1,7 @@
 const fs = require("fs");
 const http = require("http");
 const path = require("path");
+const { performance } = require("perf_hooks");
 const { getCustomsStatePath } = require("../paths");
 const {
   DEFAULT_SCHEMA_VERSION,
@@ -16,6 +17,40 @@ const outputPath =
 
 let lastWriteAt = null;
 
+// Highest applied seq per producer. Senders stamp each envelope with a
+// producer id and a seq that only grows, and replay spooled envelopes
+// byte for byte, so anything at or below the mark is a retry to drop.
+const MAX_TRACKED_PRODUCERS = 256;
+const appliedSeqByProducer = new Map();
+let duplicatesDropped = 0;
+
+function deliveryKey(incoming) {
+  if (!incoming || typeof incoming.producer !== "string") return null;
+  if (!Number.isSafeInteger(incoming.seq) || incoming.seq <= 0) return null;
+  return { producer: incoming.producer, seq: incoming.seq };
+}
+
+function isDuplicate(key) {
+  if (!key) return false;
+  const applied = appliedSeqByProducer.get(key.producer);
+  return applied !== undefined && key.seq <= applied;
+}
+
+function markApplied(key) {
+  if (!key) return;
+  appliedSeqByProducer.delete(key.producer);
+  appliedSeqByProducer.set(key.producer, key.seq);
+  if (appliedSeqByProducer.size > MAX_TRACKED_PRODUCERS) {
+    appliedSeqByProducer.delete(appliedSeqByProducer.keys().next().value);
+  }
+}
+
+// Wall clock in microseconds. Acknowledgements carry it as receivedWallUs so
+// a producer can split its envelope's latency at the receiver.
+function wallNowUs() {
+  return Math.round((performance.timeOrigin + performance.now()) * 1000);
+}
+
 function ensureDir(filePath) {
   const dir = path.dirname(filePath);
   if (!fs.existsSync(dir)) {
@@ -61,13 +96,21 @@ const server = http.createServer(async (req, res) => {
       ok: true,
       outputPath,
       lastWriteAt,
+      duplicatesDropped,
       schemaVersion: DEFAULT_SCHEMA_VERSION,
     });
   }
 
   if (req.method === "POST" && req.url === "/telemetry") {
+    const receivedWallUs = wallNowUs();
     try {
       const incoming = await parseBody(req);
+      const key = deliveryKey(incoming);
+      if (isDuplicate(key)) {
+        duplicatesDropped += 1;
+        return sendJson(res, 200, { ok: true, duplicate: true, receivedWallUs });
+      }
+
       const parsed = parseTelemetryDocument(incoming);
       if (parsed.validationIssues.length > 0) {
         return sendJson(res, 422, {
@@ -84,12 +127,14 @@ const server = http.createServer(async (req, res) => {
 
       writeJsonAtomic(outputPath, envelope);
       lastWriteAt = new Date().toISOString();
+      markApplied(key);
 
       return sendJson(res, 200, {
         ok: true,
         outputPath,
         sessionID: envelope.data.sessionID || null,
         version: envelope.version,
+        receivedWallUs,
       });
     } catch (error) {
       return sendJson(res, 400, {